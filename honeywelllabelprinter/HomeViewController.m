@@ -11,13 +11,15 @@
 #import <printersdk/ITCLinePrinter.h>
 #import <printersdk/ITCLinePrinterException.h>
 #import "HoneywellPrinterUtilities.h"
+#import "HoneywellBarcodeValidator.h"
 
 @interface HomeViewController ()
 {
     NSInputStream *inputStream;
     NSOutputStream *outputStream;
     HoneywellPrinterUtilities * printer;
-    NSMutableArray * barCodeTypeArray;
+    // HONEYWELL_SYMBOLOGY_COUNT until a row is picked
+    HoneywellSymbology selectedSymbology;
 }
 @end
 
@@ -34,28 +36,9 @@ NSString * PRINTER_IP_KEY = @"PRINTER_IP_ADDRESS";
     
     printer = [[HoneywellPrinterUtilities alloc]init];
     [printer initNetworkCommunication:printerIP port:9100];
+    [printer openJournalAtPath:[HoneywellPrinterUtilities journalPathForHost:printerIP port:9100]];
     
-    barCodeTypeArray = [[NSMutableArray alloc]init];
-    [barCodeTypeArray addObject:@"EAN8"];
-    [barCodeTypeArray addObject:@"EAN8_CC"];
-    [barCodeTypeArray addObject:@"EAN13"];
-    [barCodeTypeArray addObject:@"EAN13_CC"];
-    [barCodeTypeArray addObject:@"EAN128"];
-    [barCodeTypeArray addObject:@"EAN128A"];
-    [barCodeTypeArray addObject:@"EAN128B"];
-    [barCodeTypeArray addObject:@"EAN128C"];
-    [barCodeTypeArray addObject:@"EAN128_CCAB"];
-    [barCodeTypeArray addObject:@"EAN128_CCC"];
-    [barCodeTypeArray addObject:@"UPCA"];
-    [barCodeTypeArray addObject:@"UPCA_CC"];
-    [barCodeTypeArray addObject:@"UPCD1"];
-    [barCodeTypeArray addObject:@"UPCD2"];
-    [barCodeTypeArray addObject:@"UPCD3"];
-    [barCodeTypeArray addObject:@"UPCD4"];
-    [barCodeTypeArray addObject:@"UPCD5"];
-    [barCodeTypeArray addObject:@"UPCE"];
-    [barCodeTypeArray addObject:@"UPCE-CC"];
-    [barCodeTypeArray addObject:@"UPCSCC"];
+    selectedSymbology = HONEYWELL_SYMBOLOGY_COUNT;
     
     [_barCodeTypeTextField setUserInteractionEnabled:NO];
 }
@@ -64,9 +47,19 @@ NSString * PRINTER_IP_KEY = @"PRINTER_IP_ADDRESS";
 
 - (IBAction)didPressPrint:(id)sender {
    
+    /* a wrong length or check digit would only show up as a wasted label */
+    const char * barcode = _inputTextField.text.UTF8String ?: "";
+    size_t barcodeLength = strlen(barcode);
+    char completedBarcode[barcodeLength + 3];
+    HoneywellBarcodeValidity validity = HoneywellBarcodeValidate(selectedSymbology, barcode, barcodeLength, completedBarcode);
+    if (validity != HONEYWELL_BARCODE_VALID) {
+        [self showInvalidBarcodeAlert:validity];
+        return;
+    }
+    
     NSMutableDictionary * dic = [[NSMutableDictionary alloc]init];
-    [dic setObject:_inputTextField.text forKey:HONEYWELLPRT_KEY_BARCODE_INPUT];
-    [dic setObject:_barCodeTypeTextField.text forKey:HONEYWELLPRT_KEY_BARCODETYPE_CODE];
+    [dic setObject:@(completedBarcode) forKey:HONEYWELLPRT_KEY_BARCODE_INPUT];
+    [dic setObject:@(selectedSymbology) forKey:HONEYWELLPRT_KEY_BARCODETYPE_CODE];
     [dic setObject:@"A&W Orange-Strawberry-Kiwi-Grapefruit Flavour 250ml Can" forKey:HONEYWELLPRT_KEY_ITEM_DESC];
     [dic setObject:@"RM28080.88" forKey:HONEYWELLPRT_KEY_ITEM_PRICE];
     
@@ -84,6 +77,7 @@ NSString * PRINTER_IP_KEY = @"PRINTER_IP_ADDRESS";
         NSString * newPrinterIP = alert.textFields[0].text;
         [printer closeNetworkConnection];
         [printer initNetworkCommunication:newPrinterIP port:9100];
+        [printer openJournalAtPath:[HoneywellPrinterUtilities journalPathForHost:newPrinterIP port:9100]];
         
         [[NSUserDefaults standardUserDefaults] setObject:newPrinterIP forKey:PRINTER_IP_KEY];
         
@@ -105,6 +99,15 @@ NSString * PRINTER_IP_KEY = @"PRINTER_IP_ADDRESS";
     
 }
 
+-(void)showInvalidBarcodeAlert:(HoneywellBarcodeValidity)validity
+{
+    NSString * message = [NSString stringWithFormat:@"%@: %s", _barCodeTypeTextField.text, HoneywellBarcodeValidityDescription(validity)];
+    UIAlertController * alert = [UIAlertController alertControllerWithTitle:@"Invalid Barcode" message:message preferredStyle:UIAlertControllerStyleAlert];
+    [alert addAction:[UIAlertAction actionWithTitle:@"OK" style:UIAlertActionStyleCancel handler:nil]];
+    
+    [self showViewController:alert sender:nil];
+}
+
 #pragma mark picker delegates
 
 // The number of columns of data
@@ -116,19 +119,20 @@ NSString * PRINTER_IP_KEY = @"PRINTER_IP_ADDRESS";
 // The number of rows of data
 - (NSInteger)pickerView:(UIPickerView *)pickerView numberOfRowsInComponent:(NSInteger)component
 {
-    return barCodeTypeArray.count;
+    return HONEYWELL_SYMBOLOGY_COUNT;
 }
 
 // The data to return for the row and component (column) that's being passed in
 - (NSString*)pickerView:(UIPickerView *)pickerView titleForRow:(NSInteger)row forComponent:(NSInteger)component
 {
-    return barCodeTypeArray[row];
+    return @(HoneywellSymbologyInfoFor((HoneywellSymbology)row)->name);
 }
 
 // Capture the picker view selection
 - (void)pickerView:(UIPickerView *)pickerView didSelectRow:(NSInteger)row inComponent:(NSInteger)component
 {
-    _barCodeTypeTextField.text = barCodeTypeArray[row];
+    selectedSymbology = (HoneywellSymbology)row;
+    _barCodeTypeTextField.text = @(HoneywellSymbologyInfoFor(selectedSymbology)->name);
 }
 
 #pragma mark general functions
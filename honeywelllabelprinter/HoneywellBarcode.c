@@ -0,0 +1,554 @@
+//
+//  HoneywellBarcode.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#include "HoneywellBarcode.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_DATA_LENGTH 128
+
+/* EAN/UPC digit widths in the L set, space first. R is the same starting
+   with a bar, G is L reversed. */
+static const uint8_t eanWidths[10][4] = {
+    { 3, 2, 1, 1 }, { 2, 2, 2, 1 }, { 2, 1, 2, 2 }, { 1, 4, 1, 1 }, { 1, 1, 3, 2 },
+    { 1, 2, 3, 1 }, { 1, 1, 1, 4 }, { 1, 3, 1, 2 }, { 1, 2, 1, 3 }, { 3, 1, 1, 2 },
+};
+
+// L or G for the six left digits of EAN13, by the first digit
+static const char * const ean13Parity[10] = {
+    "LLLLLL", "LLGLGG", "LLGGLG", "LLGGGL", "LGLLGG",
+    "LGGLLG", "LGGGLL", "LGLGLG", "LGLGGL", "LGGLGL",
+};
+
+// UPCE parity for number system 0 by check digit, number system 1 swaps L and G
+static const char * const upceParity[10] = {
+    "GGGLLL", "GGLGLL", "GGLLGL", "GGLLLG", "GLGGLL",
+    "GLLGGL", "GLLLGG", "GLGLGL", "GLGLLG", "GLLGLG",
+};
+
+/* Code 128 symbols 0 to 105 in bar, space order, then the stop symbol */
+static const char * const code128Patterns[107] = {
+    "212222", "222122", "222221", "121223", "121322", "131222", "122213", "122312", "132212", "221213",
+    "221312", "231212", "112232", "122132", "122231", "113222", "123122", "123221", "223211", "221132",
+    "221231", "213212", "223112", "312131", "311222", "321122", "321221", "312212", "322112", "322211",
+    "212123", "212321", "232121", "111323", "131123", "131321", "112313", "132113", "132311", "211313",
+    "231113", "231311", "112133", "112331", "132131", "113123", "113321", "133121", "313121", "211331",
+    "231131", "213113", "213311", "213131", "311123", "311321", "331121", "312113", "312311", "332111",
+    "314111", "221411", "431111", "111224", "111422", "121124", "121421", "141122", "141221", "112214",
+    "112412", "122114", "122411", "142112", "142211", "241211", "221114", "413111", "241112", "134111",
+    "111242", "121142", "121241", "114212", "124112", "124211", "411212", "421112", "421211", "212141",
+    "214121", "412121", "111143", "111341", "131141", "114113", "114311", "411113", "411311", "113141",
+    "114131", "311141", "411131", "211412", "211214", "211232", "2331112",
+};
+
+#define CODE128_SHIFT_B 100
+#define CODE128_SHIFT_A 101
+#define CODE128_CODE_C 99
+#define CODE128_FNC1 102
+#define CODE128_START_A 103
+#define CODE128_STOP 106
+
+#pragma mark - types
+
+/* composites print their linear part */
+static const HoneywellBarcodeType symbologyTypes[HONEYWELL_SYMBOLOGY_COUNT] = {
+    [HONEYWELL_SYMBOLOGY_EAN8] = HONEYWELL_BARCODE_EAN8,
+    [HONEYWELL_SYMBOLOGY_EAN8_CC] = HONEYWELL_BARCODE_EAN8,
+    [HONEYWELL_SYMBOLOGY_EAN13] = HONEYWELL_BARCODE_EAN13,
+    [HONEYWELL_SYMBOLOGY_EAN13_CC] = HONEYWELL_BARCODE_EAN13,
+    [HONEYWELL_SYMBOLOGY_EAN128] = HONEYWELL_BARCODE_EAN128,
+    [HONEYWELL_SYMBOLOGY_EAN128A] = HONEYWELL_BARCODE_EAN128A,
+    [HONEYWELL_SYMBOLOGY_EAN128B] = HONEYWELL_BARCODE_EAN128B,
+    [HONEYWELL_SYMBOLOGY_EAN128C] = HONEYWELL_BARCODE_EAN128C,
+    [HONEYWELL_SYMBOLOGY_EAN128_CCAB] = HONEYWELL_BARCODE_EAN128,
+    [HONEYWELL_SYMBOLOGY_EAN128_CCC] = HONEYWELL_BARCODE_EAN128,
+    [HONEYWELL_SYMBOLOGY_UPCA] = HONEYWELL_BARCODE_UPCA,
+    [HONEYWELL_SYMBOLOGY_UPCA_CC] = HONEYWELL_BARCODE_UPCA,
+    [HONEYWELL_SYMBOLOGY_UPCE] = HONEYWELL_BARCODE_UPCE,
+    [HONEYWELL_SYMBOLOGY_UPCE_CC] = HONEYWELL_BARCODE_UPCE,
+};
+
+/* BARSET names outside the symbology table, without a composite suffix */
+static const struct {
+    const char * name;
+    HoneywellBarcodeType type;
+} linearTypes[] = {
+    { "EAN8", HONEYWELL_BARCODE_EAN8 },
+    { "EAN13", HONEYWELL_BARCODE_EAN13 },
+    { "UPCA", HONEYWELL_BARCODE_UPCA },
+    { "UPCE", HONEYWELL_BARCODE_UPCE },
+    { "CODE128", HONEYWELL_BARCODE_CODE128 },
+    { "CODE128A", HONEYWELL_BARCODE_CODE128A },
+    { "CODE128B", HONEYWELL_BARCODE_CODE128B },
+    { "CODE128C", HONEYWELL_BARCODE_CODE128C },
+    { "EAN128", HONEYWELL_BARCODE_EAN128 },
+    { "EAN128A", HONEYWELL_BARCODE_EAN128A },
+    { "EAN128B", HONEYWELL_BARCODE_EAN128B },
+    { "EAN128C", HONEYWELL_BARCODE_EAN128C },
+};
+
+HoneywellBarcodeType HoneywellBarcodeTypeForSymbology(HoneywellSymbology symbology)
+{
+    if ((int)symbology < 0 || symbology >= HONEYWELL_SYMBOLOGY_COUNT) {
+        return HONEYWELL_BARCODE_UNSUPPORTED;
+    }
+    return symbologyTypes[symbology];
+}
+
+HoneywellBarcodeType HoneywellBarcodeTypeNamed(const char * name)
+{
+    /* what the picker offers is found in the symbology index */
+    int symbology = HoneywellSymbologyNamed(name);
+    if (symbology >= 0) {
+        return symbologyTypes[symbology];
+    }
+    
+    char base[16];
+    size_t length = 0;
+    while (name[length] != '\0' && name[length] != '_' && length + 1 < sizeof(base)) {
+        base[length] = (char)toupper((unsigned char)name[length]);
+        length++;
+    }
+    base[length] = '\0';
+    
+    /* composites print their linear part, the suffix is only checked */
+    const char * suffix = name + length;
+    if (*suffix != '\0' && strcmp(suffix, "_CC") != 0 && strcmp(suffix, "_CCAB") != 0 && strcmp(suffix, "_CCC") != 0) {
+        return HONEYWELL_BARCODE_UNSUPPORTED;
+    }
+    
+    for (size_t i = 0; i < sizeof(linearTypes) / sizeof(linearTypes[0]); i++) {
+        if (strcmp(base, linearTypes[i].name) == 0) {
+            return linearTypes[i].type;
+        }
+    }
+    return HONEYWELL_BARCODE_UNSUPPORTED;
+}
+
+/* 'A', 'B' or 'C' for the forced Code 128 variants, else 0 */
+static char code128StartSet(HoneywellBarcodeType type)
+{
+    switch (type) {
+        case HONEYWELL_BARCODE_CODE128A:
+        case HONEYWELL_BARCODE_EAN128A:
+            return 'A';
+        case HONEYWELL_BARCODE_CODE128B:
+        case HONEYWELL_BARCODE_EAN128B:
+            return 'B';
+        case HONEYWELL_BARCODE_CODE128C:
+        case HONEYWELL_BARCODE_EAN128C:
+            return 'C';
+        default:
+            return 0;
+    }
+}
+
+void HoneywellBarcodeQuietZone(HoneywellBarcodeType type, int * left, int * right)
+{
+    switch (type) {
+        case HONEYWELL_BARCODE_EAN8:
+            *left = 7;
+            *right = 7;
+            break;
+        
+        case HONEYWELL_BARCODE_EAN13:
+            *left = 11;
+            *right = 7;
+            break;
+        
+        case HONEYWELL_BARCODE_UPCA:
+            *left = 9;
+            *right = 9;
+            break;
+        
+        case HONEYWELL_BARCODE_UPCE:
+            *left = 9;
+            *right = 7;
+            break;
+        
+        default:
+            *left = 10;
+            *right = 10;
+            break;
+    }
+}
+
+#pragma mark - EAN and UPC
+
+int HoneywellMod10CheckDigit(const uint8_t * digits, int count)
+{
+    int sum = 0;
+    for (int i = 0; i < count; i++) {
+        sum += digits[i] * (((count - i) & 1) ? 3 : 1);
+    }
+    return (10 - sum % 10) % 10;
+}
+
+int HoneywellUPCECheckDigit(int system, const uint8_t * body)
+{
+    /* the check digit is that of the equivalent UPC-A */
+    uint8_t upca[11] = { (uint8_t)system };
+    int last = body[5];
+    if (last <= 2) {
+        upca[1] = body[0];
+        upca[2] = body[1];
+        upca[3] = (uint8_t)last;
+        upca[8] = body[2];
+        upca[9] = body[3];
+        upca[10] = body[4];
+    }
+    else if (last == 3) {
+        memcpy(upca + 1, body, 3);
+        upca[9] = body[3];
+        upca[10] = body[4];
+    }
+    else if (last == 4) {
+        memcpy(upca + 1, body, 4);
+        upca[10] = body[4];
+    }
+    else {
+        memcpy(upca + 1, body, 5);
+        upca[10] = (uint8_t)last;
+    }
+    return HoneywellMod10CheckDigit(upca, 11);
+}
+
+/* reads length - 1 digits and adds the check digit, or length digits and
+   checks it */
+static int readDigits(const char * data, int length, uint8_t * digits)
+{
+    int count = 0;
+    for (; data[count] != '\0'; count++) {
+        if (count >= length || !isdigit((unsigned char)data[count])) {
+            return -1;
+        }
+        digits[count] = (uint8_t)(data[count] - '0');
+    }
+    
+    if (count == length - 1) {
+        digits[count] = (uint8_t)HoneywellMod10CheckDigit(digits, count);
+        return 0;
+    }
+    if (count == length && digits[length - 1] == HoneywellMod10CheckDigit(digits, length - 1)) {
+        return 0;
+    }
+    return -1;
+}
+
+/* parity L and R give the table widths, G reverses them */
+static uint8_t * appendDigit(uint8_t * out, int digit, char parity)
+{
+    const uint8_t * widths = eanWidths[digit];
+    if (parity == 'G') {
+        for (int i = 3; i >= 0; i--) {
+            *out++ = widths[i];
+        }
+    }
+    else {
+        memcpy(out, widths, 4);
+        out += 4;
+    }
+    return out;
+}
+
+static uint8_t * appendGuard(uint8_t * out, int count)
+{
+    memset(out, 1, (size_t)count);
+    return out + count;
+}
+
+static int encodeEAN(const uint8_t * digits, int count, uint8_t * widths)
+{
+    uint8_t * out = appendGuard(widths, 3);
+    
+    /* EAN13 hides its first digit in the parity of the left half */
+    const char * parity = count == 13 ? ean13Parity[digits[0]] : "LLLL";
+    const uint8_t * left = count == 13 ? digits + 1 : digits;
+    int half = count / 2;
+    
+    for (int i = 0; i < half; i++) {
+        out = appendDigit(out, left[i], parity[i]);
+    }
+    out = appendGuard(out, 5);
+    for (int i = 0; i < half; i++) {
+        out = appendDigit(out, left[half + i], 'R');
+    }
+    out = appendGuard(out, 3);
+    return (int)(out - widths);
+}
+
+/* six digit body, with or without number system and check digit */
+static int encodeUPCE(const char * data, uint8_t * widths)
+{
+    uint8_t digits[8];
+    int count = 0;
+    for (; data[count] != '\0'; count++) {
+        if (count >= 8 || !isdigit((unsigned char)data[count])) {
+            return -1;
+        }
+        digits[count] = (uint8_t)(data[count] - '0');
+    }
+    if (count < 6) {
+        return -1;
+    }
+    
+    int system = count == 6 ? 0 : digits[0];
+    const uint8_t * body = count == 6 ? digits : digits + 1;
+    if (system > 1) {
+        return -1;
+    }
+    
+    int check = HoneywellUPCECheckDigit(system, body);
+    if (count == 8 && digits[7] != check) {
+        return -1;
+    }
+    
+    uint8_t * out = appendGuard(widths, 3);
+    for (int i = 0; i < 6; i++) {
+        char parity = upceParity[check][i];
+        if (system == 1) {
+            parity = parity == 'G' ? 'L' : 'G';
+        }
+        out = appendDigit(out, body[i], parity);
+    }
+    out = appendGuard(out, 6);
+    return (int)(out - widths);
+}
+
+#pragma mark - Code 128
+
+static size_t digitRun(const char * data)
+{
+    size_t run = 0;
+    while (isdigit((unsigned char)data[run])) {
+        run++;
+    }
+    return run;
+}
+
+static int code128Value(char set, unsigned char c)
+{
+    if (set == 'A') {
+        return c < 32 ? c + 64 : c - 32;
+    }
+    return c - 32;
+}
+
+/* symbol values from start to check symbol, picking set C for runs of
+   digits long enough to pay for the switch */
+static int code128Values(const char * data, char startSet, int gs1, uint8_t * values, int capacity)
+{
+    size_t length = strlen(data);
+    int count = 0;
+    
+    char set = startSet;
+    if (set == 0) {
+        size_t run = digitRun(data);
+        if (run >= 4 || (run == length && run >= 2 && !(run & 1))) {
+            set = 'C';
+        }
+        else {
+            set = (unsigned char)data[0] < 32 ? 'A' : 'B';
+        }
+    }
+    values[count++] = (uint8_t)(CODE128_START_A + (set - 'A'));
+    if (gs1) {
+        values[count++] = CODE128_FNC1;
+    }
+    
+    size_t i = 0;
+    while (i < length) {
+        
+        /* leaves room for a switch, a value, the check symbol */
+        if (count + 3 > capacity) {
+            return -1;
+        }
+        
+        unsigned char c = (unsigned char)data[i];
+        if (c > 127) {
+            return -1;
+        }
+        
+        if (set == 'C') {
+            if (isdigit(c) && isdigit((unsigned char)data[i + 1])) {
+                values[count++] = (uint8_t)((c - '0') * 10 + (data[i + 1] - '0'));
+                i += 2;
+                continue;
+            }
+            set = c < 32 ? 'A' : 'B';
+            values[count++] = set == 'A' ? CODE128_SHIFT_A : CODE128_SHIFT_B;
+            continue;
+        }
+        
+        size_t run = digitRun(data + i);
+        if (run >= 6 || (run >= 4 && i + run == length)) {
+            if (run & 1) {
+                values[count++] = (uint8_t)code128Value(set, c);
+                i++;
+            }
+            values[count++] = CODE128_CODE_C;
+            set = 'C';
+            continue;
+        }
+        
+        if (set == 'B' && c < 32) {
+            values[count++] = CODE128_SHIFT_A;
+            set = 'A';
+        }
+        else if (set == 'A' && c >= 96) {
+            values[count++] = CODE128_SHIFT_B;
+            set = 'B';
+        }
+        values[count++] = (uint8_t)code128Value(set, c);
+        i++;
+    }
+    
+    int sum = values[0];
+    for (int k = 1; k < count; k++) {
+        sum += values[k] * k;
+    }
+    values[count++] = (uint8_t)(sum % 103);
+    return count;
+}
+
+static int encodeCode128(const char * data, char startSet, int gs1, uint8_t * widths, int capacity)
+{
+    /* GS1 application identifiers are often written in brackets for the
+       human readable line, they are not part of the symbol */
+    char stripped[MAX_DATA_LENGTH];
+    size_t length = 0;
+    for (const char * p = data; *p != '\0'; p++) {
+        if (gs1 && (*p == '(' || *p == ')')) {
+            continue;
+        }
+        if (length + 1 >= sizeof(stripped)) {
+            return -1;
+        }
+        stripped[length++] = *p;
+    }
+    stripped[length] = '\0';
+    if (length == 0) {
+        return -1;
+    }
+    
+    uint8_t values[MAX_DATA_LENGTH * 2 + 4];
+    int count = code128Values(stripped, startSet, gs1, values, (int)sizeof(values));
+    if (count < 0 || count * 6 + 7 > capacity) {
+        return -1;
+    }
+    
+    uint8_t * out = widths;
+    for (int i = 0; i < count; i++) {
+        for (const char * p = code128Patterns[values[i]]; *p != '\0'; p++) {
+            *out++ = (uint8_t)(*p - '0');
+        }
+    }
+    for (const char * p = code128Patterns[CODE128_STOP]; *p != '\0'; p++) {
+        *out++ = (uint8_t)(*p - '0');
+    }
+    return (int)(out - widths);
+}
+
+#pragma mark - encoding
+
+int HoneywellBarcodeEncode(HoneywellBarcodeType type, const char * data, uint8_t * widths, int capacity)
+{
+    uint8_t digits[13];
+    
+    switch (type) {
+        case HONEYWELL_BARCODE_EAN8:
+            if (capacity < 43 || readDigits(data, 8, digits) != 0) {
+                return -1;
+            }
+            return encodeEAN(digits, 8, widths);
+        
+        case HONEYWELL_BARCODE_EAN13:
+            if (capacity < 59 || readDigits(data, 13, digits) != 0) {
+                return -1;
+            }
+            return encodeEAN(digits, 13, widths);
+        
+        case HONEYWELL_BARCODE_UPCA:
+            /* UPC-A is EAN13 with a leading 0 */
+            digits[0] = 0;
+            if (capacity < 59 || readDigits(data, 12, digits + 1) != 0) {
+                return -1;
+            }
+            return encodeEAN(digits, 13, widths);
+        
+        case HONEYWELL_BARCODE_UPCE:
+            return capacity < 33 ? -1 : encodeUPCE(data, widths);
+        
+        case HONEYWELL_BARCODE_CODE128:
+        case HONEYWELL_BARCODE_CODE128A:
+        case HONEYWELL_BARCODE_CODE128B:
+        case HONEYWELL_BARCODE_CODE128C:
+            return encodeCode128(data, code128StartSet(type), 0, widths, capacity);
+        
+        case HONEYWELL_BARCODE_EAN128:
+        case HONEYWELL_BARCODE_EAN128A:
+        case HONEYWELL_BARCODE_EAN128B:
+        case HONEYWELL_BARCODE_EAN128C:
+            return encodeCode128(data, code128StartSet(type), 1, widths, capacity);
+        
+        default:
+            return -1;
+    }
+}
+
+#pragma mark - rendering
+
+static void blackenSpan(uint8_t * row, uint32_t x0, uint32_t x1)
+{
+    uint32_t first = x0 >> 3;
+    uint32_t last = (x1 - 1) >> 3;
+    uint8_t firstMask = (uint8_t)(0xff >> (x0 & 7));
+    uint8_t lastMask = (uint8_t)(0xff << (7 - ((x1 - 1) & 7)));
+    
+    if (first == last) {
+        row[first] &= (uint8_t)~(firstMask & lastMask);
+        return;
+    }
+    row[first] &= (uint8_t)~firstMask;
+    memset(row + first + 1, 0, last - first - 1);
+    row[last] &= (uint8_t)~lastMask;
+}
+
+int HoneywellBarcodeRender(HoneywellBarcodeType type, const uint8_t * widths, int count, uint32_t moduleWidth, uint32_t height, HoneywellMonoImage * image)
+{
+    int left;
+    int right;
+    HoneywellBarcodeQuietZone(type, &left, &right);
+    
+    uint32_t modules = (uint32_t)(left + right);
+    for (int i = 0; i < count; i++) {
+        modules += widths[i];
+    }
+    if (moduleWidth == 0 || count <= 0 || HoneywellMonoImageCreate(image, modules * moduleWidth, height) != 0) {
+        return -1;
+    }
+    
+    /* a linear barcode is the same in every row, draw one and copy it */
+    uint8_t * first = image->bits;
+    memset(first, 0xff, image->bytesPerLine);
+    
+    uint32_t x = (uint32_t)left * moduleWidth;
+    for (int i = 0; i < count; i++) {
+        uint32_t width = widths[i] * moduleWidth;
+        if ((i & 1) == 0) {
+            blackenSpan(first, x, x + width);
+        }
+        x += width;
+    }
+    
+    for (uint32_t y = 1; y < height; y++) {
+        memcpy(image->bits + (size_t)y * image->bytesPerLine, first, image->bytesPerLine);
+    }
+    return 0;
+}
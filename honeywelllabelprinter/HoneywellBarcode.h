@@ -0,0 +1,73 @@
+//
+//  HoneywellBarcode.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#ifndef HoneywellBarcode_h
+#define HoneywellBarcode_h
+
+#include "HoneywellBitmap.h"
+#include "HoneywellSymbology.h"
+
+/*
+
+ Encodes linear barcodes into bar and space widths on the device, for
+ printers that can only print graphics. The line printer SDK draws just
+ Code 39 and Code 128, this covers the retail symbologies the label screen
+ offers through Direct Protocol.
+
+ The encoder is keyed by HoneywellBarcodeType. A label's HoneywellSymbology
+ maps to it by table, a Direct Protocol BARSET name is resolved once with
+ HoneywellBarcodeTypeNamed: EAN8, EAN13, UPCA, UPCE, CODE128 and EAN128
+ (GS1-128) with the A, B and C variants picking the start set. For the _CC
+ composite types only the linear part is encoded, the 2D component is left
+ out. UPCD1 to UPCD5 and UPCSCC are not supported.
+
+ EAN and UPC data may leave out the check digit, it is added. When given it
+ has to be right.
+
+ */
+
+typedef enum {
+    HONEYWELL_BARCODE_UNSUPPORTED = 0,
+    HONEYWELL_BARCODE_EAN8,
+    HONEYWELL_BARCODE_EAN13,
+    HONEYWELL_BARCODE_UPCA,
+    HONEYWELL_BARCODE_UPCE,
+    HONEYWELL_BARCODE_CODE128,
+    HONEYWELL_BARCODE_CODE128A,
+    HONEYWELL_BARCODE_CODE128B,
+    HONEYWELL_BARCODE_CODE128C,
+    HONEYWELL_BARCODE_EAN128,
+    HONEYWELL_BARCODE_EAN128A,
+    HONEYWELL_BARCODE_EAN128B,
+    HONEYWELL_BARCODE_EAN128C
+} HoneywellBarcodeType;
+
+HoneywellBarcodeType HoneywellBarcodeTypeForSymbology(HoneywellSymbology symbology);
+
+// BARSET or picker name ignoring case, HONEYWELL_BARCODE_UNSUPPORTED if unknown
+HoneywellBarcodeType HoneywellBarcodeTypeNamed(const char * name);
+
+// modules of quiet zone the type needs on each side, left then right
+void HoneywellBarcodeQuietZone(HoneywellBarcodeType type, int * left, int * right);
+
+/* writes the bar and space widths in modules, starting with a bar, without
+   quiet zones. Returns their count or -1 if the type is not supported or
+   the data can not be encoded, e.g. letters for EAN13. */
+int HoneywellBarcodeEncode(HoneywellBarcodeType type, const char * data, uint8_t * widths, int capacity);
+
+/* draws widths into a new mono image, each module moduleWidth dots wide,
+   with quiet zones on both sides. Every row is a copy of the first. */
+int HoneywellBarcodeRender(HoneywellBarcodeType type, const uint8_t * widths, int count, uint32_t moduleWidth, uint32_t height, HoneywellMonoImage * image);
+
+// EAN / UPC check digit of count digits, weights 3 and 1 from the right
+int HoneywellMod10CheckDigit(const uint8_t * digits, int count);
+
+// check digit of a six digit UPC-E body in number system 0 or 1
+int HoneywellUPCECheckDigit(int system, const uint8_t * body);
+
+#endif /* HoneywellBarcode_h */
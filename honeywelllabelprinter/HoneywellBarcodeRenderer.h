@@ -0,0 +1,41 @@
+//
+//  HoneywellBarcodeRenderer.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#include "HoneywellBarcode.h"
+
+@class ITCLinePrinter;
+
+/*
+
+ Draws EAN, UPC and Code 128 barcodes as 1-bit BMP graphics for the line
+ printers (PR2, PR3, PB series), whose SDK only prints Code 39 and Code 128
+ by itself. Types come from the label's HoneywellSymbology or BARSET name,
+ see HoneywellBarcode.h for the encoder.
+
+ Images are cached by type and value, so reprinting the same product
+ costs only the Bluetooth transfer.
+
+ */
+
+@interface HoneywellBarcodeRenderer : NSObject
+
+// dots per module, defaults to 3 (0.375 mm at 203 dpi)
+@property (nonatomic) NSUInteger moduleWidth;
+
+// bar height in dots, defaults to 100
+@property (nonatomic) NSUInteger height;
+
+// base64 BMP for writeGraphicBase64:, nil if value can not be encoded
+-(NSString *)base64ImageForValue:(NSString *)value type:(HoneywellBarcodeType)type;
+
+/* writes the barcode at xOffset dots and returns the size of the BMP sent,
+   0 if it can not be encoded or the printer raised an exception */
+-(NSUInteger)writeValue:(NSString *)value type:(HoneywellBarcodeType)type xOffset:(NSInteger)xOffset toLinePrinter:(ITCLinePrinter *)printer;
+
+@end
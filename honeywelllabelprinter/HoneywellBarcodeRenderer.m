@@ -0,0 +1,124 @@
+//
+//  HoneywellBarcodeRenderer.m
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import "HoneywellBarcodeRenderer.h"
+#import <printersdk/ITCLinePrinter.h>
+#import <printersdk/ITCLinePrinterException.h>
+
+/* PR2 / PR3 print resolution */
+static const uint16_t kLinePrinterDPI = 203;
+
+/* bars and spaces of the longest Code 128 the encoder accepts */
+enum { kMaxBarcodeWidths = 1024 };
+
+@interface HoneywellBarcodeRenderer()
+{
+    NSCache * images;
+}
+@end
+
+@implementation HoneywellBarcodeRenderer
+
+-(instancetype)init
+{
+    self = [super init];
+    if (self) {
+        _moduleWidth = 3;
+        _height = 100;
+        images = [[NSCache alloc] init];
+        images.countLimit = 256;
+    }
+    return self;
+}
+
+-(void)setModuleWidth:(NSUInteger)moduleWidth
+{
+    _moduleWidth = moduleWidth;
+    [images removeAllObjects];
+}
+
+-(void)setHeight:(NSUInteger)height
+{
+    _height = height;
+    [images removeAllObjects];
+}
+
+-(NSString *)base64ImageForValue:(NSString *)value type:(HoneywellBarcodeType)type
+{
+    return [self base64ImageForValue:value type:type width:NULL byteCount:NULL];
+}
+
+/* cached entries are the base64 BMP, its width in dots and its size in bytes */
+-(NSString *)base64ImageForValue:(NSString *)value type:(HoneywellBarcodeType)type width:(NSUInteger *)width byteCount:(NSUInteger *)byteCount
+{
+    NSString * key = [NSString stringWithFormat:@"%d:%@", (int)type, value];
+    NSArray * cached = [images objectForKey:key];
+    if (cached != nil) {
+        if (width != NULL) {
+            *width = [cached[1] unsignedIntegerValue];
+        }
+        if (byteCount != NULL) {
+            *byteCount = [cached[2] unsignedIntegerValue];
+        }
+        return cached[0];
+    }
+    
+    uint8_t widths[kMaxBarcodeWidths];
+    int count = HoneywellBarcodeEncode(type, value.UTF8String, widths, kMaxBarcodeWidths);
+    if (count < 0) {
+        NSLog(@"%@ can not be encoded as barcode type %d", value, (int)type);
+        return nil;
+    }
+    
+    HoneywellMonoImage image;
+    if (HoneywellBarcodeRender(type, widths, count, (uint32_t)_moduleWidth, (uint32_t)_height, &image) != 0) {
+        return nil;
+    }
+    
+    size_t length = 0;
+    uint8_t * bmp = HoneywellBMPEncodeMono(&image, kLinePrinterDPI, &length);
+    uint32_t imageWidth = image.width;
+    HoneywellMonoImageDestroy(&image);
+    if (bmp == NULL) {
+        return nil;
+    }
+    
+    NSData * data = [NSData dataWithBytesNoCopy:bmp length:length freeWhenDone:YES];
+    NSString * encoded = [data base64EncodedStringWithOptions:0];
+    [images setObject:@[ encoded, @(imageWidth), @(length) ] forKey:key];
+    if (width != NULL) {
+        *width = imageWidth;
+    }
+    if (byteCount != NULL) {
+        *byteCount = length;
+    }
+    return encoded;
+}
+
+-(NSUInteger)writeValue:(NSString *)value type:(HoneywellBarcodeType)type xOffset:(NSInteger)xOffset toLinePrinter:(ITCLinePrinter *)printer
+{
+    NSUInteger width = 0;
+    NSUInteger byteCount = 0;
+    NSString * encoded = [self base64ImageForValue:value type:type width:&width byteCount:&byteCount];
+    if (encoded == nil) {
+        return 0;
+    }
+    
+    /* the image is already at printer resolution, passing its size keeps
+       the SDK from scaling it */
+    @try {
+        [printer writeGraphicBase64:encoded rotation:DEGREE_0 xOffset:xOffset width:width height:_height];
+    }
+    @catch (ITCLinePrinterException * exception) {
+        NSLog(@"Line printer barcode failed: %@", exception.reason);
+        return 0;
+    }
+    return byteCount;
+}
+
+@end
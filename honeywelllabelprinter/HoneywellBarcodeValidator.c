@@ -0,0 +1,267 @@
+//
+//  HoneywellBarcodeValidator.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#include "HoneywellBarcodeValidator.h"
+#include "HoneywellBarcode.h"
+#include "HoneywellDither.h"
+#include "HoneywellSymbology.h"
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#define HONEYWELL_HAS_X86 1
+#endif
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#define HONEYWELL_HAS_NEON64 1
+#endif
+
+static const HoneywellSymbologyInfo * symbologyInfo(HoneywellSymbology symbology)
+{
+    if ((unsigned)symbology >= HONEYWELL_SYMBOLOGY_COUNT) {
+        return NULL;
+    }
+    return HoneywellSymbologyInfoFor(symbology);
+}
+
+#pragma mark - scalar
+
+static int allDigits(const char * value, size_t length, uint8_t * digits)
+{
+    for (size_t i = 0; i < length; i++) {
+        unsigned char d = (unsigned char)(value[i] - '0');
+        if (d > 9) {
+            return 0;
+        }
+        digits[i] = d;
+    }
+    return 1;
+}
+
+/* validates value and stores its check digit, or -1 if it has its own */
+static HoneywellBarcodeValidity validateScalar(const HoneywellSymbologyInfo * info, const char * value, size_t length, int * addedCheck)
+{
+    *addedCheck = -1;
+    
+    /* mod 10 values may leave out the check digit */
+    size_t minLength = info->checkDigit == HONEYWELL_CHECK_MOD10 ? info->minLength - 1u : info->minLength;
+    if (length < minLength || length > info->maxLength) {
+        return HONEYWELL_BARCODE_BAD_LENGTH;
+    }
+    
+    if (info->charset == HONEYWELL_CHARSET_ASCII) {
+        for (size_t i = 0; i < length; i++) {
+            if ((unsigned char)value[i] > 127) {
+                return HONEYWELL_BARCODE_BAD_CHARACTER;
+            }
+        }
+        return HONEYWELL_BARCODE_VALID;
+    }
+    
+    uint8_t digits[256] = {0};
+    if (!allDigits(value, length, digits)) {
+        return HONEYWELL_BARCODE_BAD_CHARACTER;
+    }
+    
+    if (info->checkDigit == HONEYWELL_CHECK_MOD10) {
+        if (length == info->maxLength) {
+            return digits[length - 1] == HoneywellMod10CheckDigit(digits, (int)length - 1) ? HONEYWELL_BARCODE_VALID : HONEYWELL_BARCODE_BAD_CHECK_DIGIT;
+        }
+        *addedCheck = HoneywellMod10CheckDigit(digits, (int)length);
+    }
+    else if (info->checkDigit == HONEYWELL_CHECK_UPCE) {
+        int system = length == 6 ? 0 : digits[0];
+        const uint8_t * body = length == 6 ? digits : digits + 1;
+        if (system > 1) {
+            return HONEYWELL_BARCODE_BAD_CHARACTER;
+        }
+        int check = HoneywellUPCECheckDigit(system, body);
+        if (length == 8) {
+            return digits[7] == check ? HONEYWELL_BARCODE_VALID : HONEYWELL_BARCODE_BAD_CHECK_DIGIT;
+        }
+        *addedCheck = check;
+    }
+    return HONEYWELL_BARCODE_VALID;
+}
+
+#pragma mark - vector
+
+/* values are copied right aligned into 16 zero digits so one weight vector
+   fits every length. With the check digit in the last lane the weighted sum
+   of a valid value ends in 0. Returns -1 for anything but digits. */
+
+static inline void rightAlignDigits(const char * value, size_t length, char * buffer)
+{
+    memset(buffer, '0', 16);
+    
+    /* two overlapping fixed size copies instead of a variable one */
+    if (length >= 8) {
+        memcpy(buffer + 16 - length, value, 8);
+        memcpy(buffer + 8, value + length - 8, 8);
+    }
+    else {
+        memcpy(buffer + 16 - length, value, length);
+    }
+}
+
+#ifdef HONEYWELL_HAS_X86
+
+static int weightedSumSSE2(const char * value, size_t length)
+{
+    char buffer[16];
+    rightAlignDigits(value, length, buffer);
+    
+    const __m128i zero = _mm_setzero_si128();
+    __m128i digits = _mm_sub_epi8(_mm_loadu_si128((const __m128i *)buffer), _mm_set1_epi8('0'));
+    
+    /* anything outside '0'..'9' wraps above 9 */
+    __m128i above = _mm_subs_epu8(digits, _mm_set1_epi8(9));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(above, zero)) != 0xffff) {
+        return -1;
+    }
+    
+    const __m128i weights = _mm_setr_epi16(3, 1, 3, 1, 3, 1, 3, 1);
+    __m128i sums = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi8(digits, zero), weights),
+                                 _mm_madd_epi16(_mm_unpackhi_epi8(digits, zero), weights));
+    sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(1, 0, 3, 2)));
+    sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sums);
+}
+
+#endif
+
+#ifdef HONEYWELL_HAS_NEON64
+
+static int weightedSumNEON(const char * value, size_t length)
+{
+    char buffer[16];
+    rightAlignDigits(value, length, buffer);
+    
+    uint8x16_t digits = vsubq_u8(vld1q_u8((const uint8_t *)buffer), vdupq_n_u8('0'));
+    if (vmaxvq_u8(digits) > 9) {
+        return -1;
+    }
+    
+    static const uint8_t weightValues[16] = { 3, 1, 3, 1, 3, 1, 3, 1, 3, 1, 3, 1, 3, 1, 3, 1 };
+    uint8x16_t weights = vld1q_u8(weightValues);
+    
+    /* at most 16 * 27, fits 16-bit lanes */
+    uint16x8_t sums = vmull_u8(vget_low_u8(digits), vget_low_u8(weights));
+    sums = vmlal_u8(sums, vget_high_u8(digits), vget_high_u8(weights));
+    return vaddvq_u16(sums);
+}
+
+#endif
+
+/* returns NULL when no vector path applies */
+static int (*weightedSumKernel(void))(const char *, size_t)
+{
+    switch (HoneywellCurrentKernelSet()) {
+#ifdef HONEYWELL_HAS_X86
+        case HONEYWELL_KERNEL_SSE2:
+        case HONEYWELL_KERNEL_AVX2:
+            return weightedSumSSE2;
+#endif
+#ifdef HONEYWELL_HAS_NEON64
+        case HONEYWELL_KERNEL_NEON:
+            return weightedSumNEON;
+#endif
+        default:
+            return NULL;
+    }
+}
+
+#pragma mark - validation
+
+HoneywellBarcodeValidity HoneywellBarcodeValidate(HoneywellSymbology symbology, const char * value, size_t length, char * completed)
+{
+    const HoneywellSymbologyInfo * info = symbologyInfo(symbology);
+    if (info == NULL) {
+        return HONEYWELL_BARCODE_UNKNOWN_TYPE;
+    }
+    
+    int addedCheck;
+    HoneywellBarcodeValidity validity = validateScalar(info, value, length, &addedCheck);
+    
+    if (completed != NULL && validity == HONEYWELL_BARCODE_VALID) {
+        
+        /* a bare UPC-E body gets its number system too */
+        if (info->checkDigit == HONEYWELL_CHECK_UPCE && length == 6) {
+            *completed++ = '0';
+        }
+        memcpy(completed, value, length);
+        if (addedCheck >= 0) {
+            completed[length++] = (char)('0' + addedCheck);
+        }
+        completed[length] = '\0';
+    }
+    return validity;
+}
+
+size_t HoneywellBarcodeValidateBatch(HoneywellSymbology symbology, const char * const * values, const size_t * lengths, size_t count, uint8_t * results)
+{
+    const HoneywellSymbologyInfo * info = symbologyInfo(symbology);
+    if (info == NULL) {
+        memset(results, HONEYWELL_BARCODE_UNKNOWN_TYPE, count);
+        return 0;
+    }
+    
+    size_t valid = 0;
+    int (*weightedSum)(const char *, size_t) = info->checkDigit == HONEYWELL_CHECK_MOD10 && info->maxLength <= 16 ? weightedSumKernel() : NULL;
+    
+    if (weightedSum == NULL) {
+        for (size_t i = 0; i < count; i++) {
+            int addedCheck;
+            results[i] = (uint8_t)validateScalar(info, values[i], lengths[i], &addedCheck);
+            valid += results[i] == HONEYWELL_BARCODE_VALID;
+        }
+        return valid;
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        
+        size_t length = lengths[i];
+        if (length != info->maxLength && length != info->maxLength - 1u) {
+            results[i] = HONEYWELL_BARCODE_BAD_LENGTH;
+            continue;
+        }
+        
+        /* a value without its check digit only needs the digit test */
+        int withCheck = length == info->maxLength;
+        int sum = weightedSum(values[i], length);
+        if (sum < 0) {
+            results[i] = HONEYWELL_BARCODE_BAD_CHARACTER;
+        }
+        else if (withCheck && sum % 10 != 0) {
+            results[i] = HONEYWELL_BARCODE_BAD_CHECK_DIGIT;
+        }
+        else {
+            results[i] = HONEYWELL_BARCODE_VALID;
+            valid++;
+        }
+    }
+    return valid;
+}
+
+const char * HoneywellBarcodeValidityDescription(HoneywellBarcodeValidity validity)
+{
+    switch (validity) {
+        case HONEYWELL_BARCODE_VALID:
+            return "valid";
+        case HONEYWELL_BARCODE_UNKNOWN_TYPE:
+            return "unknown barcode type";
+        case HONEYWELL_BARCODE_BAD_LENGTH:
+            return "wrong length";
+        case HONEYWELL_BARCODE_BAD_CHARACTER:
+            return "invalid character";
+        case HONEYWELL_BARCODE_BAD_CHECK_DIGIT:
+            return "wrong check digit";
+    }
+    return "unknown";
+}
@@ -0,0 +1,50 @@
+//
+//  HoneywellBarcodeValidator.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#ifndef HoneywellBarcodeValidator_h
+#define HoneywellBarcodeValidator_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include "HoneywellSymbology.h"
+
+/*
+
+ Checks barcode values before they are sent, so a wrong length or check
+ digit is reported instead of printing a blank or unreadable label. The
+ rules per symbology come from HoneywellSymbology.h.
+
+ EAN, UPC and UPCSCC values may leave out their mod 10 check digit, the
+ printer adds it. UPCE takes 6 digits, or 7 or 8 with number system and
+ check digit. EAN128 takes up to 48 ASCII characters. For UPCD1 to UPCD5
+ only the characters are checked.
+
+ The batch call runs the fixed length mod 10 types through SSE2 or NEON,
+ following the kernel set chosen in HoneywellDither.h, so a large import
+ is checked in a few milliseconds.
+
+ */
+
+typedef enum {
+    HONEYWELL_BARCODE_VALID = 0,
+    HONEYWELL_BARCODE_UNKNOWN_TYPE,
+    HONEYWELL_BARCODE_BAD_LENGTH,
+    HONEYWELL_BARCODE_BAD_CHARACTER,
+    HONEYWELL_BARCODE_BAD_CHECK_DIGIT,
+} HoneywellBarcodeValidity;
+
+/* completed, if not NULL, gets the value with its check digit added when
+   it was left out, or a copy of it. It needs length + 3 bytes. */
+HoneywellBarcodeValidity HoneywellBarcodeValidate(HoneywellSymbology symbology, const char * value, size_t length, char * completed);
+
+// writes a HoneywellBarcodeValidity per value, returns the number of valid ones
+size_t HoneywellBarcodeValidateBatch(HoneywellSymbology symbology, const char * const * values, const size_t * lengths, size_t count, uint8_t * results);
+
+const char * HoneywellBarcodeValidityDescription(HoneywellBarcodeValidity validity);
+
+#endif /* HoneywellBarcodeValidator_h */
@@ -0,0 +1,373 @@
+//
+//  HoneywellBitmap.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#include "HoneywellBitmap.h"
+#include "HoneywellDither.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define PCX_HEADER_LENGTH 128
+#define PCX_PALETTE_256_LENGTH 769
+#define BMP_HEADER_LENGTH 62
+
+static uint16_t readLE16(const uint8_t * p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static void writeLE16(uint8_t * p, uint16_t value)
+{
+    p[0] = (uint8_t)(value & 0xff);
+    p[1] = (uint8_t)(value >> 8);
+}
+
+static void writeLE32(uint8_t * p, uint32_t value)
+{
+    writeLE16(p, (uint16_t)(value & 0xffff));
+    writeLE16(p + 2, (uint16_t)(value >> 16));
+}
+
+/* integer BT.601 luma, weights sum to 256 */
+static uint8_t luma(uint8_t r, uint8_t g, uint8_t b)
+{
+    return (uint8_t)((77 * r + 150 * g + 29 * b) >> 8);
+}
+
+#pragma mark - image storage
+
+int HoneywellGreyImageCreate(HoneywellGreyImage * image, uint32_t width, uint32_t height)
+{
+    memset(image, 0, sizeof(*image));
+    if (width == 0 || height == 0) {
+        return -1;
+    }
+    
+    image->pixels = malloc((size_t)width * height);
+    if (image->pixels == NULL) {
+        return -1;
+    }
+    image->width = width;
+    image->height = height;
+    image->stride = width;
+    return 0;
+}
+
+void HoneywellGreyImageDestroy(HoneywellGreyImage * image)
+{
+    free(image->pixels);
+    memset(image, 0, sizeof(*image));
+}
+
+int HoneywellMonoImageCreate(HoneywellMonoImage * image, uint32_t width, uint32_t height)
+{
+    memset(image, 0, sizeof(*image));
+    if (width == 0 || height == 0) {
+        return -1;
+    }
+    
+    size_t bytesPerLine = ((size_t)width + 15) / 16 * 2;
+    image->bits = malloc(bytesPerLine * height);
+    if (image->bits == NULL) {
+        return -1;
+    }
+    image->width = width;
+    image->height = height;
+    image->bytesPerLine = bytesPerLine;
+    return 0;
+}
+
+void HoneywellMonoImageDestroy(HoneywellMonoImage * image)
+{
+    free(image->bits);
+    memset(image, 0, sizeof(*image));
+}
+
+#pragma mark - PCX decoding
+
+int HoneywellPCXDecode(const uint8_t * data, size_t length, HoneywellGreyImage * image)
+{
+    memset(image, 0, sizeof(*image));
+    
+    if (length < PCX_HEADER_LENGTH || data[0] != 0x0a || data[2] != 1) {
+        return -1;
+    }
+    
+    uint8_t bitsPerPixel = data[3];
+    uint32_t width = readLE16(data + 8) - readLE16(data + 4) + 1u;
+    uint32_t height = readLE16(data + 10) - readLE16(data + 6) + 1u;
+    uint8_t planes = data[65];
+    size_t bytesPerLine = readLE16(data + 66);
+    
+    if (planes < 1 || planes > 4 || (bitsPerPixel != 1 && bitsPerPixel != 8)) {
+        return -1;
+    }
+    if (width > 0xffff || height > 0xffff || bytesPerLine * 8 < (size_t)width * bitsPerPixel) {
+        return -1;
+    }
+    
+    /* build a grey lookup for indexed formats */
+    uint8_t greyForIndex[256];
+    const uint8_t * headerPalette = data + 16;
+    
+    if (bitsPerPixel == 8 && planes == 1) {
+        if (length < PCX_HEADER_LENGTH + PCX_PALETTE_256_LENGTH || data[length - PCX_PALETTE_256_LENGTH] != 0x0c) {
+            return -1;
+        }
+        const uint8_t * palette = data + length - PCX_PALETTE_256_LENGTH + 1;
+        for (int i = 0; i < 256; i++) {
+            greyForIndex[i] = luma(palette[3 * i], palette[3 * i + 1], palette[3 * i + 2]);
+        }
+    }
+    else if (bitsPerPixel == 1 && planes == 1) {
+        /* mono files often leave the header palette empty, 1 is white */
+        greyForIndex[0] = 0;
+        greyForIndex[1] = 255;
+    }
+    else if (bitsPerPixel == 1) {
+        for (int i = 0; i < 16; i++) {
+            greyForIndex[i] = luma(headerPalette[3 * i], headerPalette[3 * i + 1], headerPalette[3 * i + 2]);
+        }
+    }
+    
+    size_t lineLength = bytesPerLine * planes;
+    uint8_t * line = malloc(lineLength);
+    if (line == NULL || HoneywellGreyImageCreate(image, width, height) != 0) {
+        free(line);
+        return -1;
+    }
+    
+    const uint8_t * in = data + PCX_HEADER_LENGTH;
+    const uint8_t * end = data + length;
+    if (bitsPerPixel == 8 && planes == 1) {
+        end -= PCX_PALETTE_256_LENGTH;
+    }
+    
+    /* a run may carry over into the next scan line */
+    uint8_t runValue = 0;
+    size_t runLeft = 0;
+    
+    for (uint32_t y = 0; y < height; y++) {
+        
+        for (size_t i = 0; i < lineLength; i++) {
+            if (runLeft == 0) {
+                if (in >= end) {
+                    free(line);
+                    HoneywellGreyImageDestroy(image);
+                    return -1;
+                }
+                uint8_t c = *in++;
+                if ((c & 0xc0) == 0xc0) {
+                    if (in >= end) {
+                        free(line);
+                        HoneywellGreyImageDestroy(image);
+                        return -1;
+                    }
+                    runLeft = c & 0x3f;
+                    runValue = *in++;
+                }
+                else {
+                    runLeft = 1;
+                    runValue = c;
+                }
+                if (runLeft == 0) {
+                    i--;
+                    continue;
+                }
+            }
+            line[i] = runValue;
+            runLeft--;
+        }
+        
+        uint8_t * out = image->pixels + (size_t)y * image->stride;
+        
+        if (bitsPerPixel == 8 && planes >= 3) {
+            const uint8_t * r = line;
+            const uint8_t * g = line + bytesPerLine;
+            const uint8_t * b = line + 2 * bytesPerLine;
+            HoneywellGreyFromPlanes(r, g, b, width, out);
+        }
+        else if (bitsPerPixel == 8) {
+            for (uint32_t x = 0; x < width; x++) {
+                out[x] = greyForIndex[line[x]];
+            }
+        }
+        else {
+            for (uint32_t x = 0; x < width; x++) {
+                unsigned index = 0;
+                for (unsigned p = 0; p < planes; p++) {
+                    unsigned bit = (line[p * bytesPerLine + x / 8] >> (7 - x % 8)) & 1;
+                    index |= bit << p;
+                }
+                out[x] = greyForIndex[index];
+            }
+        }
+    }
+    
+    free(line);
+    return 0;
+}
+
+#pragma mark - thresholding
+
+uint8_t HoneywellOtsuThreshold(const HoneywellGreyImage * image)
+{
+    uint64_t histogram[256] = { 0 };
+    for (uint32_t y = 0; y < image->height; y++) {
+        const uint8_t * row = image->pixels + (size_t)y * image->stride;
+        for (uint32_t x = 0; x < image->width; x++) {
+            histogram[row[x]]++;
+        }
+    }
+    
+    uint64_t total = (uint64_t)image->width * image->height;
+    double sumAll = 0;
+    for (int i = 0; i < 256; i++) {
+        sumAll += (double)i * histogram[i];
+    }
+    
+    double sumBackground = 0;
+    uint64_t weightBackground = 0;
+    double bestVariance = -1;
+    int bestThreshold = 128;
+    
+    for (int t = 0; t < 256; t++) {
+        weightBackground += histogram[t];
+        if (weightBackground == 0) {
+            continue;
+        }
+        uint64_t weightForeground = total - weightBackground;
+        if (weightForeground == 0) {
+            break;
+        }
+        sumBackground += (double)t * histogram[t];
+        
+        double meanBackground = sumBackground / weightBackground;
+        double meanForeground = (sumAll - sumBackground) / weightForeground;
+        double variance = (double)weightBackground * weightForeground * (meanBackground - meanForeground) * (meanBackground - meanForeground);
+        
+        if (variance > bestVariance) {
+            bestVariance = variance;
+            bestThreshold = t + 1;
+        }
+    }
+    
+    return (uint8_t)(bestThreshold > 255 ? 255 : bestThreshold);
+}
+
+void HoneywellThreshold(const HoneywellGreyImage * grey, uint8_t threshold, HoneywellMonoImage * mono)
+{
+    for (uint32_t y = 0; y < grey->height; y++) {
+        
+        const uint8_t * in = grey->pixels + (size_t)y * grey->stride;
+        uint8_t * out = mono->bits + (size_t)y * mono->bytesPerLine;
+        
+        /* padding bits stay white so nothing prints past the edge */
+        memset(out, 0xff, mono->bytesPerLine);
+        
+        for (uint32_t x = 0; x < grey->width; x++) {
+            if (in[x] < threshold) {
+                out[x >> 3] &= (uint8_t)~(0x80 >> (x & 7));
+            }
+        }
+    }
+}
+
+#pragma mark - PCX encoding
+
+uint8_t * HoneywellPCXEncodeMono(const HoneywellMonoImage * mono, uint16_t dpi, size_t * length)
+{
+    /* worst case every byte needs a 0xc1 prefix */
+    size_t capacity = PCX_HEADER_LENGTH + 2 * mono->bytesPerLine * mono->height;
+    uint8_t * buffer = calloc(1, capacity);
+    if (buffer == NULL) {
+        return NULL;
+    }
+    
+    buffer[0] = 0x0a;   // manufacturer
+    buffer[1] = 5;      // version 3.0 and up
+    buffer[2] = 1;      // RLE
+    buffer[3] = 1;      // bits per pixel
+    writeLE16(buffer + 8, (uint16_t)(mono->width - 1));
+    writeLE16(buffer + 10, (uint16_t)(mono->height - 1));
+    writeLE16(buffer + 12, dpi);
+    writeLE16(buffer + 14, dpi);
+    /* palette entry 0 black, entry 1 white */
+    memset(buffer + 19, 0xff, 3);
+    buffer[65] = 1;
+    writeLE16(buffer + 66, (uint16_t)mono->bytesPerLine);
+    writeLE16(buffer + 68, 1);
+    
+    uint8_t * out = buffer + PCX_HEADER_LENGTH;
+    
+    /* runs stop at the end of each scan line */
+    for (uint32_t y = 0; y < mono->height; y++) {
+        
+        const uint8_t * in = mono->bits + (size_t)y * mono->bytesPerLine;
+        size_t x = 0;
+        
+        while (x < mono->bytesPerLine) {
+            uint8_t value = in[x];
+            size_t run = 1;
+            while (x + run < mono->bytesPerLine && in[x + run] == value && run < 63) {
+                run++;
+            }
+            
+            if (run > 1 || (value & 0xc0) == 0xc0) {
+                *out++ = (uint8_t)(0xc0 | run);
+            }
+            *out++ = value;
+            x += run;
+        }
+    }
+    
+    *length = (size_t)(out - buffer);
+    return buffer;
+}
+
+#pragma mark - BMP encoding
+
+uint8_t * HoneywellBMPEncodeMono(const HoneywellMonoImage * mono, uint16_t dpi, size_t * length)
+{
+    /* BMP rows are padded to 4 bytes and stored bottom up */
+    size_t rowLength = ((size_t)mono->width + 31) / 32 * 4;
+    size_t imageLength = rowLength * mono->height;
+    uint8_t * buffer = calloc(1, BMP_HEADER_LENGTH + imageLength);
+    if (buffer == NULL) {
+        return NULL;
+    }
+    
+    uint32_t pixelsPerMetre = (uint32_t)(dpi * 10000u / 254u);
+    
+    buffer[0] = 'B';
+    buffer[1] = 'M';
+    writeLE32(buffer + 2, (uint32_t)(BMP_HEADER_LENGTH + imageLength));
+    writeLE32(buffer + 10, BMP_HEADER_LENGTH);
+    writeLE32(buffer + 14, 40);     // BITMAPINFOHEADER
+    writeLE32(buffer + 18, mono->width);
+    writeLE32(buffer + 22, mono->height);
+    writeLE16(buffer + 26, 1);      // planes
+    writeLE16(buffer + 28, 1);      // bits per pixel
+    writeLE32(buffer + 34, (uint32_t)imageLength);
+    writeLE32(buffer + 38, pixelsPerMetre);
+    writeLE32(buffer + 42, pixelsPerMetre);
+    writeLE32(buffer + 46, 2);      // palette entries
+    /* palette entry 0 black, entry 1 white, as in the mono image */
+    memset(buffer + 58, 0xff, 3);
+    
+    uint8_t * out = buffer + BMP_HEADER_LENGTH;
+    size_t copied = rowLength < mono->bytesPerLine ? rowLength : mono->bytesPerLine;
+    
+    for (uint32_t y = 0; y < mono->height; y++) {
+        const uint8_t * in = mono->bits + (size_t)(mono->height - 1 - y) * mono->bytesPerLine;
+        memcpy(out, in, copied);
+        out += rowLength;
+    }
+    
+    *length = BMP_HEADER_LENGTH + imageLength;
+    return buffer;
+}
@@ -0,0 +1,65 @@
+//
+//  HoneywellBitmap.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#ifndef HoneywellBitmap_h
+#define HoneywellBitmap_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+
+ Plain C image helpers for preparing label graphics, kept free of Foundation
+ so they can be reused outside the app.
+
+ A greyscale image holds one byte per pixel, 0 black to 255 white. A mono
+ image packs 8 pixels per byte, most significant bit first, with a set bit
+ meaning white as in a 1-bit PCX with the black/white palette.
+
+ Functions returning int return 0 on success and -1 on bad input or when
+ memory runs out.
+
+ */
+
+typedef struct {
+    uint32_t width;
+    uint32_t height;
+    size_t stride;
+    uint8_t * pixels;
+} HoneywellGreyImage;
+
+typedef struct {
+    uint32_t width;
+    uint32_t height;
+    // always even, PCX scan lines are word aligned
+    size_t bytesPerLine;
+    uint8_t * bits;
+} HoneywellMonoImage;
+
+int HoneywellGreyImageCreate(HoneywellGreyImage * image, uint32_t width, uint32_t height);
+void HoneywellGreyImageDestroy(HoneywellGreyImage * image);
+
+int HoneywellMonoImageCreate(HoneywellMonoImage * image, uint32_t width, uint32_t height);
+void HoneywellMonoImageDestroy(HoneywellMonoImage * image);
+
+// decodes RLE PCX with 1 or 8 bits per pixel and 1 to 4 planes into greyscale
+int HoneywellPCXDecode(const uint8_t * data, size_t length, HoneywellGreyImage * image);
+
+// picks the threshold that best separates the histogram into two classes (Otsu)
+uint8_t HoneywellOtsuThreshold(const HoneywellGreyImage * image);
+
+// pixels at or above threshold become white, mono must match the grey size
+void HoneywellThreshold(const HoneywellGreyImage * grey, uint8_t threshold, HoneywellMonoImage * mono);
+
+// 1-bit, 1 plane RLE PCX at the given resolution, caller frees the result
+uint8_t * HoneywellPCXEncodeMono(const HoneywellMonoImage * mono, uint16_t dpi, size_t * length);
+
+// uncompressed 1-bit BMP for the line printer SDK, caller frees the result
+uint8_t * HoneywellBMPEncodeMono(const HoneywellMonoImage * mono, uint16_t dpi, size_t * length);
+
+#endif /* HoneywellBitmap_h */
@@ -0,0 +1,70 @@
+//
+//  HoneywellByteBuffer.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#include "HoneywellByteBuffer.h"
+#include <stdlib.h>
+#include <string.h>
+
+int HoneywellByteBufferReserve(HoneywellByteBuffer * buffer, size_t additional)
+{
+    if (buffer->capacity - buffer->length >= additional) {
+        return 0;
+    }
+    if (additional > SIZE_MAX / 2 - buffer->length) {
+        return -1;
+    }
+    
+    size_t capacity = buffer->capacity > 0 ? buffer->capacity : 256;
+    while (capacity - buffer->length < additional) {
+        capacity *= 2;
+    }
+    
+    uint8_t * bytes = realloc(buffer->bytes, capacity);
+    if (bytes == NULL) {
+        return -1;
+    }
+    buffer->bytes = bytes;
+    buffer->capacity = capacity;
+    return 0;
+}
+
+int HoneywellByteBufferAppend(HoneywellByteBuffer * buffer, const void * bytes, size_t length)
+{
+    if (length == 0) {
+        return 0;
+    }
+    if (HoneywellByteBufferReserve(buffer, length) != 0) {
+        return -1;
+    }
+    memcpy(buffer->bytes + buffer->length, bytes, length);
+    buffer->length += length;
+    return 0;
+}
+
+int HoneywellByteBufferAppendString(HoneywellByteBuffer * buffer, const char * string)
+{
+    return HoneywellByteBufferAppend(buffer, string, strlen(string));
+}
+
+uint8_t * HoneywellByteBufferDetach(HoneywellByteBuffer * buffer, size_t * length)
+{
+    uint8_t * bytes = buffer->bytes;
+    *length = buffer->length;
+    buffer->bytes = NULL;
+    buffer->length = 0;
+    buffer->capacity = 0;
+    return bytes;
+}
+
+void HoneywellByteBufferDestroy(HoneywellByteBuffer * buffer)
+{
+    free(buffer->bytes);
+    buffer->bytes = NULL;
+    buffer->length = 0;
+    buffer->capacity = 0;
+}
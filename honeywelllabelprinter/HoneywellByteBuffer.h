@@ -0,0 +1,40 @@
+//
+//  HoneywellByteBuffer.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#ifndef HoneywellByteBuffer_h
+#define HoneywellByteBuffer_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+
+ Growable byte buffer the encoders append printer commands to. A zeroed
+ struct is an empty buffer. Functions returning int return 0 on success and
+ -1 when memory runs out, leaving the buffer as it was.
+
+ */
+
+typedef struct {
+    uint8_t * bytes;
+    size_t length;
+    size_t capacity;
+} HoneywellByteBuffer;
+
+// makes room for at least additional bytes past length
+int HoneywellByteBufferReserve(HoneywellByteBuffer * buffer, size_t additional);
+
+int HoneywellByteBufferAppend(HoneywellByteBuffer * buffer, const void * bytes, size_t length);
+int HoneywellByteBufferAppendString(HoneywellByteBuffer * buffer, const char * string);
+
+// hands the bytes to the caller, who frees them, and leaves the buffer empty
+uint8_t * HoneywellByteBufferDetach(HoneywellByteBuffer * buffer, size_t * length);
+
+void HoneywellByteBufferDestroy(HoneywellByteBuffer * buffer);
+
+#endif /* HoneywellByteBuffer_h */
@@ -0,0 +1,223 @@
+//
+//  HoneywellCommandOptimizer.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#include "HoneywellCommandOptimizer.h"
+#include "HoneywellLabelTemplate.h"
+#include "HoneywellPrinterState.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char * const kPositionKey = "PP";
+
+typedef struct {
+    const char * text;
+    size_t length;
+    char command[HONEYWELL_COMMAND_CAPACITY];
+    const char * argument;
+    size_t argumentLength;
+    // empty if the statement sets no state
+    char stateKey[HONEYWELL_STATE_KEY_CAPACITY];
+    int hasSlot;
+    int removed;
+} HoneywellOptimizerStatement;
+
+/* settings each print statement depends on, keyed by command */
+static const char * const textState[] = { "PP", "AN", "DIR", "FT", "MAG", NULL };
+static const char * const lineState[] = { "PP", "AN", "DIR", NULL };
+static const char * const imageState[] = { "PP", "AN", "DIR", "MAG", NULL };
+static const char * const barcodeState[] = { "PP", "AN", "DIR", "MAG", "BF", "BF ON|OFF",
+                                             "BARSET", "BARTYPE", "BARHEIGHT", "BARMAG", "BARRATIO", NULL };
+
+static const struct {
+    const char * command;
+    const char * const * consumed;
+} consumedState[] = {
+    { "PT", textState }, { "PRTXT", textState },
+    { "PX", textState }, { "PRBOX", textState },
+    { "PL", lineState }, { "PRLINE", lineState },
+    { "PM", imageState }, { "PRIMAGE", imageState },
+    { "PB", barcodeState }, { "PRBAR", barcodeState }
+};
+
+/* what a print feed resets */
+static const char * const layoutKeys[] = { "PP", "AN", "DIR", "FT", "MAG", "BF", "BF ON|OFF",
+                                           "BARSET", "BARTYPE", "BARHEIGHT", "BARMAG", "BARRATIO", NULL };
+
+static const char * const * consumedStateForCommand(const char * command)
+{
+    for (size_t i = 0; i < sizeof(consumedState) / sizeof(consumedState[0]); i++) {
+        if (strcmp(consumedState[i].command, command) == 0) {
+            return consumedState[i].consumed;
+        }
+    }
+    return NULL;
+}
+
+static int isPrintFeed(const char * command)
+{
+    return strcmp(command, "PF") == 0 || strcmp(command, "PRINTFEED") == 0;
+}
+
+#pragma mark - key set
+
+#define KEY_SET_CAPACITY 32
+
+/* a key that does not fit is never in the set, so its statement is kept */
+typedef struct {
+    char keys[KEY_SET_CAPACITY][HONEYWELL_STATE_KEY_CAPACITY];
+    int count;
+} HoneywellKeySet;
+
+static int keySetIndex(const HoneywellKeySet * set, const char * key)
+{
+    for (int i = 0; i < set->count; i++) {
+        if (strcmp(set->keys[i], key) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void keySetAdd(HoneywellKeySet * set, const char * key)
+{
+    if (keySetIndex(set, key) < 0 && set->count < KEY_SET_CAPACITY) {
+        strcpy(set->keys[set->count++], key);
+    }
+}
+
+static void keySetRemove(HoneywellKeySet * set, const char * key)
+{
+    int i = keySetIndex(set, key);
+    if (i >= 0) {
+        memcpy(set->keys[i], set->keys[--set->count], HONEYWELL_STATE_KEY_CAPACITY);
+    }
+}
+
+#pragma mark - passes
+
+/* forward pass, a setting equal to what the stream already set is a no-op */
+static void findRedundantStatements(HoneywellOptimizerStatement * statements, size_t count)
+{
+    HoneywellPrinterState state;
+    memset(&state, 0, sizeof(state));
+    
+    for (size_t i = 0; i < count; i++) {
+        
+        HoneywellOptimizerStatement * statement = &statements[i];
+        
+        if (isPrintFeed(statement->command)) {
+            HoneywellPrinterStatePrintFeed(&state);
+            continue;
+        }
+        
+        if (statement->stateKey[0] == '\0') {
+            if (consumedStateForCommand(statement->command) == NULL) {
+                HoneywellPrinterStateReset(&state);
+            }
+            continue;
+        }
+        
+        /* positions are left to the dead store pass, printing may move them */
+        if (strcmp(statement->stateKey, kPositionKey) == 0) {
+            continue;
+        }
+        
+        if (statement->hasSlot) {
+            HoneywellPrinterStateInvalidate(&state, statement->stateKey);
+        } else if (HoneywellPrinterStateHasValue(&state, statement->stateKey, statement->argument, statement->argumentLength)) {
+            statement->removed = 1;
+        } else {
+            HoneywellPrinterStateSetValue(&state, statement->stateKey, statement->argument, statement->argumentLength);
+        }
+    }
+}
+
+/* backward pass, a setting overridden or reset before any use is dead */
+static void findDeadStatements(HoneywellOptimizerStatement * statements, size_t count)
+{
+    HoneywellKeySet overridden;
+    overridden.count = 0;
+    
+    for (size_t i = count; i-- > 0;) {
+        
+        HoneywellOptimizerStatement * statement = &statements[i];
+        if (statement->removed) {
+            continue;
+        }
+        
+        if (isPrintFeed(statement->command)) {
+            for (const char * const * key = layoutKeys; *key != NULL; key++) {
+                keySetAdd(&overridden, *key);
+            }
+            continue;
+        }
+        
+        const char * const * consumed = consumedStateForCommand(statement->command);
+        if (consumed != NULL) {
+            for (const char * const * key = consumed; *key != NULL; key++) {
+                keySetRemove(&overridden, *key);
+            }
+            continue;
+        }
+        
+        if (statement->stateKey[0] == '\0') {
+            overridden.count = 0;
+            continue;
+        }
+        
+        if (keySetIndex(&overridden, statement->stateKey) >= 0) {
+            statement->removed = 1;
+        } else {
+            keySetAdd(&overridden, statement->stateKey);
+        }
+    }
+}
+
+int HoneywellOptimizeCommands(const char * source, size_t length, HoneywellByteBuffer * buffer)
+{
+    size_t capacity = 0;
+    for (size_t position = 0; position < length; capacity++) {
+        position += HoneywellNextStatement(source + position, length - position);
+    }
+    
+    HoneywellOptimizerStatement * statements = calloc(capacity > 0 ? capacity : 1, sizeof(HoneywellOptimizerStatement));
+    if (statements == NULL) {
+        return -1;
+    }
+    
+    size_t count = 0;
+    for (size_t position = 0; position < length; count++) {
+        
+        HoneywellOptimizerStatement * statement = &statements[count];
+        statement->text = source + position;
+        statement->length = HoneywellNextStatement(statement->text, length - position);
+        position += statement->length;
+        
+        HoneywellParseStatement(statement->text, statement->length, statement->command, &statement->argument, &statement->argumentLength);
+        statement->hasSlot = memchr(statement->text, '{', statement->length) != NULL;
+        
+        if (strcmp(statement->command, "PP") == 0 || strcmp(statement->command, "PRPOS") == 0) {
+            strcpy(statement->stateKey, kPositionKey);
+        } else if (HoneywellStateKeyForCommand(statement->command, statement->argument, statement->argumentLength, statement->stateKey) != 0) {
+            statement->stateKey[0] = '\0';
+        }
+    }
+    
+    findRedundantStatements(statements, count);
+    findDeadStatements(statements, count);
+    
+    int result = HoneywellByteBufferReserve(buffer, length);
+    for (size_t i = 0; i < count && result == 0; i++) {
+        if (!statements[i].removed) {
+            result = HoneywellByteBufferAppend(buffer, statements[i].text, statements[i].length);
+        }
+    }
+    
+    free(statements);
+    return result;
+}
@@ -0,0 +1,35 @@
+//
+//  HoneywellCommandOptimizer.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#ifndef HoneywellCommandOptimizer_h
+#define HoneywellCommandOptimizer_h
+
+#include <stddef.h>
+#include "HoneywellByteBuffer.h"
+
+/*
+
+ Peephole pass over a Direct Protocol statement stream, run on the template
+ source before it is compiled. It removes
+
+ - state statements setting a value the stream already set, e.g. a second
+   AN 1 with no other AN in between
+ - dead state statements that are overridden, or reset by PF, before any
+   print statement uses them, e.g. MAG 1,1 right before PF
+ - PP moves followed by another PP before anything is printed
+
+ Print statements (PT, PX, PL, PB, PM) only keep the settings they actually
+ use alive. Any statement the pass does not know is treated as using and
+ changing everything, so unknown commands are never reordered around.
+
+ */
+
+// appends the statements of source that survive the pass to buffer, 0 or -1 if out of memory
+int HoneywellOptimizeCommands(const char * source, size_t length, HoneywellByteBuffer * buffer);
+
+#endif /* HoneywellCommandOptimizer_h */
@@ -0,0 +1,733 @@
+//
+//  HoneywellDither.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+/* clock_gettime and CLOCK_MONOTONIC under -std=c11 on Linux */
+#define _POSIX_C_SOURCE 199309L
+
+#include "HoneywellDither.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HONEYWELL_HAS_X86 1
+#define HONEYWELL_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define HONEYWELL_HAS_NEON 1
+#endif
+
+/* BT.601 luma weights, sum to 256 as in HoneywellBitmap.c */
+#define LUMA_R 77
+#define LUMA_G 150
+#define LUMA_B 29
+
+/* resampling weights are 8.8 fixed point so sums fit 16-bit lanes */
+#define WEIGHT_ONE 256
+
+static const uint8_t bayer8x8[8][8] = {
+    {  0, 32,  8, 40,  2, 34, 10, 42 },
+    { 48, 16, 56, 24, 50, 18, 58, 26 },
+    { 12, 44,  4, 36, 14, 46,  6, 38 },
+    { 60, 28, 52, 20, 62, 30, 54, 22 },
+    {  3, 35, 11, 43,  1, 33,  9, 41 },
+    { 51, 19, 59, 27, 49, 17, 57, 25 },
+    { 15, 47,  7, 39, 13, 45,  5, 37 },
+    { 63, 31, 55, 23, 61, 29, 53, 21 },
+};
+
+typedef void (*LumaRowKernel)(const uint8_t * r, const uint8_t * g, const uint8_t * b, uint32_t width, uint8_t * out);
+typedef void (*WeightedRowKernel)(const uint8_t * const * rows, const uint16_t * weights, uint32_t taps, uint32_t width, uint8_t * out);
+typedef void (*PackRowKernel)(const uint8_t * pixels, const uint8_t * thresholds, uint32_t width, uint8_t * out);
+
+typedef struct {
+    LumaRowKernel lumaRow;
+    WeightedRowKernel weightedRow;
+    PackRowKernel packRow;
+} KernelTable;
+
+static KernelTable kernels;
+static HoneywellKernelSet currentSet;
+static pthread_once_t kernelsOnce = PTHREAD_ONCE_INIT;
+
+/* movemask puts the first pixel in bit 0, PCX wants it in bit 7 */
+static uint8_t reversedBits[256];
+
+#pragma mark - scalar kernels
+
+static void lumaRowScalar(const uint8_t * r, const uint8_t * g, const uint8_t * b, uint32_t width, uint8_t * out)
+{
+    for (uint32_t x = 0; x < width; x++) {
+        out[x] = (uint8_t)((LUMA_R * r[x] + LUMA_G * g[x] + LUMA_B * b[x]) >> 8);
+    }
+}
+
+static void weightedRowScalar(const uint8_t * const * rows, const uint16_t * weights, uint32_t taps, uint32_t width, uint8_t * out)
+{
+    for (uint32_t x = 0; x < width; x++) {
+        unsigned sum = WEIGHT_ONE / 2;
+        for (uint32_t k = 0; k < taps; k++) {
+            sum += weights[k] * rows[k][x];
+        }
+        out[x] = (uint8_t)(sum >> 8);
+    }
+}
+
+static void packRowScalar(const uint8_t * pixels, const uint8_t * thresholds, uint32_t width, uint8_t * out)
+{
+    uint32_t x = 0;
+    for (; x + 8 <= width; x += 8) {
+        uint8_t byte = 0;
+        for (unsigned i = 0; i < 8; i++) {
+            byte |= (uint8_t)((pixels[x + i] >= thresholds[x + i]) << (7 - i));
+        }
+        out[x >> 3] = byte;
+    }
+    
+    /* padding bits stay white so nothing prints past the edge */
+    if (x < width) {
+        uint8_t byte = 0xff;
+        for (unsigned i = 0; x + i < width; i++) {
+            if (pixels[x + i] < thresholds[x + i]) {
+                byte &= (uint8_t)~(0x80 >> i);
+            }
+        }
+        out[x >> 3] = byte;
+    }
+}
+
+#pragma mark - SSE2 / AVX2 kernels
+
+#ifdef HONEYWELL_HAS_X86
+
+static void lumaRowSSE2(const uint8_t * r, const uint8_t * g, const uint8_t * b, uint32_t width, uint8_t * out)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i wr = _mm_set1_epi16(LUMA_R);
+    const __m128i wg = _mm_set1_epi16(LUMA_G);
+    const __m128i wb = _mm_set1_epi16(LUMA_B);
+    
+    uint32_t x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m128i vr = _mm_loadu_si128((const __m128i *)(r + x));
+        __m128i vg = _mm_loadu_si128((const __m128i *)(g + x));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + x));
+        
+        /* sums stay below 65536 so unsigned 16-bit lanes are enough */
+        __m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(vr, zero), wr);
+        lo = _mm_add_epi16(lo, _mm_mullo_epi16(_mm_unpacklo_epi8(vg, zero), wg));
+        lo = _mm_add_epi16(lo, _mm_mullo_epi16(_mm_unpacklo_epi8(vb, zero), wb));
+        __m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(vr, zero), wr);
+        hi = _mm_add_epi16(hi, _mm_mullo_epi16(_mm_unpackhi_epi8(vg, zero), wg));
+        hi = _mm_add_epi16(hi, _mm_mullo_epi16(_mm_unpackhi_epi8(vb, zero), wb));
+        
+        _mm_storeu_si128((__m128i *)(out + x), _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8)));
+    }
+    lumaRowScalar(r + x, g + x, b + x, width - x, out + x);
+}
+
+static void weightedRowSSE2(const uint8_t * const * rows, const uint16_t * weights, uint32_t taps, uint32_t width, uint8_t * out)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i half = _mm_set1_epi16(WEIGHT_ONE / 2);
+    
+    uint32_t x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m128i lo = half;
+        __m128i hi = half;
+        for (uint32_t k = 0; k < taps; k++) {
+            if (weights[k] == 0) {
+                continue;
+            }
+            __m128i w = _mm_set1_epi16((short)weights[k]);
+            __m128i p = _mm_loadu_si128((const __m128i *)(rows[k] + x));
+            lo = _mm_add_epi16(lo, _mm_mullo_epi16(_mm_unpacklo_epi8(p, zero), w));
+            hi = _mm_add_epi16(hi, _mm_mullo_epi16(_mm_unpackhi_epi8(p, zero), w));
+        }
+        _mm_storeu_si128((__m128i *)(out + x), _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8)));
+    }
+    
+    if (x < width) {
+        const uint8_t * tail[taps];
+        for (uint32_t k = 0; k < taps; k++) {
+            tail[k] = rows[k] + x;
+        }
+        weightedRowScalar(tail, weights, taps, width - x, out + x);
+    }
+}
+
+static void packRowSSE2(const uint8_t * pixels, const uint8_t * thresholds, uint32_t width, uint8_t * out)
+{
+    uint32_t x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m128i p = _mm_loadu_si128((const __m128i *)(pixels + x));
+        __m128i t = _mm_loadu_si128((const __m128i *)(thresholds + x));
+        
+        /* no unsigned compare in SSE2, p >= t exactly when max(p, t) == p */
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(p, t), p));
+        out[(x >> 3)] = reversedBits[mask & 0xff];
+        out[(x >> 3) + 1] = reversedBits[mask >> 8];
+    }
+    packRowScalar(pixels + x, thresholds + x, width - x, out + (x >> 3));
+}
+
+HONEYWELL_AVX2_TARGET
+static void lumaRowAVX2(const uint8_t * r, const uint8_t * g, const uint8_t * b, uint32_t width, uint8_t * out)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i wr = _mm256_set1_epi16(LUMA_R);
+    const __m256i wg = _mm256_set1_epi16(LUMA_G);
+    const __m256i wb = _mm256_set1_epi16(LUMA_B);
+    
+    /* unpack and pack both work within 128-bit lanes so the order comes back */
+    uint32_t x = 0;
+    for (; x + 32 <= width; x += 32) {
+        __m256i vr = _mm256_loadu_si256((const __m256i *)(r + x));
+        __m256i vg = _mm256_loadu_si256((const __m256i *)(g + x));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + x));
+        
+        __m256i lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(vr, zero), wr);
+        lo = _mm256_add_epi16(lo, _mm256_mullo_epi16(_mm256_unpacklo_epi8(vg, zero), wg));
+        lo = _mm256_add_epi16(lo, _mm256_mullo_epi16(_mm256_unpacklo_epi8(vb, zero), wb));
+        __m256i hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(vr, zero), wr);
+        hi = _mm256_add_epi16(hi, _mm256_mullo_epi16(_mm256_unpackhi_epi8(vg, zero), wg));
+        hi = _mm256_add_epi16(hi, _mm256_mullo_epi16(_mm256_unpackhi_epi8(vb, zero), wb));
+        
+        _mm256_storeu_si256((__m256i *)(out + x), _mm256_packus_epi16(_mm256_srli_epi16(lo, 8), _mm256_srli_epi16(hi, 8)));
+    }
+    lumaRowSSE2(r + x, g + x, b + x, width - x, out + x);
+}
+
+HONEYWELL_AVX2_TARGET
+static void weightedRowAVX2(const uint8_t * const * rows, const uint16_t * weights, uint32_t taps, uint32_t width, uint8_t * out)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i half = _mm256_set1_epi16(WEIGHT_ONE / 2);
+    
+    uint32_t x = 0;
+    for (; x + 32 <= width; x += 32) {
+        __m256i lo = half;
+        __m256i hi = half;
+        for (uint32_t k = 0; k < taps; k++) {
+            if (weights[k] == 0) {
+                continue;
+            }
+            __m256i w = _mm256_set1_epi16((short)weights[k]);
+            __m256i p = _mm256_loadu_si256((const __m256i *)(rows[k] + x));
+            lo = _mm256_add_epi16(lo, _mm256_mullo_epi16(_mm256_unpacklo_epi8(p, zero), w));
+            hi = _mm256_add_epi16(hi, _mm256_mullo_epi16(_mm256_unpackhi_epi8(p, zero), w));
+        }
+        _mm256_storeu_si256((__m256i *)(out + x), _mm256_packus_epi16(_mm256_srli_epi16(lo, 8), _mm256_srli_epi16(hi, 8)));
+    }
+    
+    if (x < width) {
+        const uint8_t * tail[taps];
+        for (uint32_t k = 0; k < taps; k++) {
+            tail[k] = rows[k] + x;
+        }
+        weightedRowSSE2(tail, weights, taps, width - x, out + x);
+    }
+}
+
+HONEYWELL_AVX2_TARGET
+static void packRowAVX2(const uint8_t * pixels, const uint8_t * thresholds, uint32_t width, uint8_t * out)
+{
+    uint32_t x = 0;
+    for (; x + 32 <= width; x += 32) {
+        __m256i p = _mm256_loadu_si256((const __m256i *)(pixels + x));
+        __m256i t = _mm256_loadu_si256((const __m256i *)(thresholds + x));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(p, t), p));
+        
+        uint8_t * o = out + (x >> 3);
+        o[0] = reversedBits[mask & 0xff];
+        o[1] = reversedBits[(mask >> 8) & 0xff];
+        o[2] = reversedBits[(mask >> 16) & 0xff];
+        o[3] = reversedBits[mask >> 24];
+    }
+    packRowSSE2(pixels + x, thresholds + x, width - x, out + (x >> 3));
+}
+
+#endif
+
+#pragma mark - NEON kernels
+
+#ifdef HONEYWELL_HAS_NEON
+
+static void lumaRowNEON(const uint8_t * r, const uint8_t * g, const uint8_t * b, uint32_t width, uint8_t * out)
+{
+    const uint8x8_t wr = vdup_n_u8(LUMA_R);
+    const uint8x8_t wg = vdup_n_u8(LUMA_G);
+    const uint8x8_t wb = vdup_n_u8(LUMA_B);
+    
+    uint32_t x = 0;
+    for (; x + 16 <= width; x += 16) {
+        uint8x16_t vr = vld1q_u8(r + x);
+        uint8x16_t vg = vld1q_u8(g + x);
+        uint8x16_t vb = vld1q_u8(b + x);
+        
+        uint16x8_t lo = vmull_u8(vget_low_u8(vr), wr);
+        lo = vmlal_u8(lo, vget_low_u8(vg), wg);
+        lo = vmlal_u8(lo, vget_low_u8(vb), wb);
+        uint16x8_t hi = vmull_u8(vget_high_u8(vr), wr);
+        hi = vmlal_u8(hi, vget_high_u8(vg), wg);
+        hi = vmlal_u8(hi, vget_high_u8(vb), wb);
+        
+        vst1q_u8(out + x, vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8)));
+    }
+    lumaRowScalar(r + x, g + x, b + x, width - x, out + x);
+}
+
+static void weightedRowNEON(const uint8_t * const * rows, const uint16_t * weights, uint32_t taps, uint32_t width, uint8_t * out)
+{
+    uint32_t x = 0;
+    for (; x + 16 <= width; x += 16) {
+        uint16x8_t lo = vdupq_n_u16(WEIGHT_ONE / 2);
+        uint16x8_t hi = lo;
+        for (uint32_t k = 0; k < taps; k++) {
+            if (weights[k] == 0) {
+                continue;
+            }
+            uint16x8_t w = vdupq_n_u16(weights[k]);
+            uint8x16_t p = vld1q_u8(rows[k] + x);
+            lo = vmlaq_u16(lo, vmovl_u8(vget_low_u8(p)), w);
+            hi = vmlaq_u16(hi, vmovl_u8(vget_high_u8(p)), w);
+        }
+        vst1q_u8(out + x, vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8)));
+    }
+    
+    if (x < width) {
+        const uint8_t * tail[taps];
+        for (uint32_t k = 0; k < taps; k++) {
+            tail[k] = rows[k] + x;
+        }
+        weightedRowScalar(tail, weights, taps, width - x, out + x);
+    }
+}
+
+static void packRowNEON(const uint8_t * pixels, const uint8_t * thresholds, uint32_t width, uint8_t * out)
+{
+    /* no movemask on NEON, keep each lane's own bit and add the lanes up */
+    static const uint8_t bitWeights[16] = { 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+                                            0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01 };
+    const uint8x16_t bitsForLane = vld1q_u8(bitWeights);
+    
+    uint32_t x = 0;
+    for (; x + 16 <= width; x += 16) {
+        uint8x16_t white = vcgeq_u8(vld1q_u8(pixels + x), vld1q_u8(thresholds + x));
+        uint8x16_t bits = vandq_u8(white, bitsForLane);
+        
+        uint8x8_t sum = vpadd_u8(vget_low_u8(bits), vget_high_u8(bits));
+        sum = vpadd_u8(sum, sum);
+        sum = vpadd_u8(sum, sum);
+        out[(x >> 3)] = vget_lane_u8(sum, 0);
+        out[(x >> 3) + 1] = vget_lane_u8(sum, 1);
+    }
+    packRowScalar(pixels + x, thresholds + x, width - x, out + (x >> 3));
+}
+
+#endif
+
+#pragma mark - dispatch
+
+static int selectKernels(HoneywellKernelSet set)
+{
+    switch (set) {
+        case HONEYWELL_KERNEL_SCALAR:
+            kernels = (KernelTable){ lumaRowScalar, weightedRowScalar, packRowScalar };
+            break;
+#ifdef HONEYWELL_HAS_X86
+        case HONEYWELL_KERNEL_SSE2:
+            kernels = (KernelTable){ lumaRowSSE2, weightedRowSSE2, packRowSSE2 };
+            break;
+        case HONEYWELL_KERNEL_AVX2:
+            if (HoneywellBestKernelSet() != HONEYWELL_KERNEL_AVX2) {
+                return -1;
+            }
+            kernels = (KernelTable){ lumaRowAVX2, weightedRowAVX2, packRowAVX2 };
+            break;
+#endif
+#ifdef HONEYWELL_HAS_NEON
+        case HONEYWELL_KERNEL_NEON:
+            kernels = (KernelTable){ lumaRowNEON, weightedRowNEON, packRowNEON };
+            break;
+#endif
+        default:
+            return -1;
+    }
+    currentSet = set;
+    return 0;
+}
+
+static void initKernels(void)
+{
+    for (unsigned i = 0; i < 256; i++) {
+        uint8_t reversed = 0;
+        for (unsigned bit = 0; bit < 8; bit++) {
+            reversed |= (uint8_t)(((i >> bit) & 1) << (7 - bit));
+        }
+        reversedBits[i] = reversed;
+    }
+    
+    selectKernels(HoneywellBestKernelSet());
+}
+
+static const KernelTable * currentKernels(void)
+{
+    pthread_once(&kernelsOnce, initKernels);
+    return &kernels;
+}
+
+HoneywellKernelSet HoneywellBestKernelSet(void)
+{
+#if defined(HONEYWELL_HAS_X86)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? HONEYWELL_KERNEL_AVX2 : HONEYWELL_KERNEL_SSE2;
+#elif defined(HONEYWELL_HAS_NEON)
+    return HONEYWELL_KERNEL_NEON;
+#else
+    return HONEYWELL_KERNEL_SCALAR;
+#endif
+}
+
+HoneywellKernelSet HoneywellCurrentKernelSet(void)
+{
+    currentKernels();
+    return currentSet;
+}
+
+const char * HoneywellKernelSetName(HoneywellKernelSet set)
+{
+    switch (set) {
+        case HONEYWELL_KERNEL_SCALAR:
+            return "scalar";
+        case HONEYWELL_KERNEL_SSE2:
+            return "SSE2";
+        case HONEYWELL_KERNEL_AVX2:
+            return "AVX2";
+        case HONEYWELL_KERNEL_NEON:
+            return "NEON";
+    }
+    return "unknown";
+}
+
+int HoneywellUseKernelSet(HoneywellKernelSet set)
+{
+    currentKernels();
+    
+    /* switching is meant for benchmarks, not while other threads convert images */
+    return selectKernels(set);
+}
+
+#pragma mark - greyscale
+
+void HoneywellGreyFromPlanes(const uint8_t * r, const uint8_t * g, const uint8_t * b, uint32_t width, uint8_t * out)
+{
+    currentKernels()->lumaRow(r, g, b, width, out);
+}
+
+#pragma mark - scaling
+
+typedef struct {
+    uint32_t taps;
+    // first source index for each output, taps weights follow from there
+    uint32_t * first;
+    uint16_t * weights;
+} Contributions;
+
+static void freeContributions(Contributions * c)
+{
+    free(c->first);
+    free(c->weights);
+    memset(c, 0, sizeof(*c));
+}
+
+static int buildContributions(uint32_t srcLength, uint32_t dstLength, Contributions * c)
+{
+    double scale = (double)srcLength / dstLength;
+    uint32_t taps = scale > 1.0 ? (uint32_t)ceil(scale) + 1 : 2;
+    if (taps > srcLength) {
+        taps = srcLength;
+    }
+    
+    c->taps = taps;
+    c->first = malloc(dstLength * sizeof(uint32_t));
+    c->weights = calloc((size_t)dstLength * taps, sizeof(uint16_t));
+    double * coverage = malloc(taps * sizeof(double));
+    if (c->first == NULL || c->weights == NULL || coverage == NULL) {
+        free(coverage);
+        freeContributions(c);
+        return -1;
+    }
+    
+    for (uint32_t i = 0; i < dstLength; i++) {
+        
+        memset(coverage, 0, taps * sizeof(double));
+        uint32_t first;
+        
+        if (scale > 1.0) {
+            /* each output pixel averages the source span it covers */
+            double start = i * scale;
+            double end = start + scale;
+            first = (uint32_t)start;
+            if (first + taps > srcLength) {
+                first = srcLength - taps;
+            }
+            for (uint32_t k = 0; k < taps; k++) {
+                double left = fmax(start, first + k);
+                double right = fmin(end, first + k + 1.0);
+                if (right > left) {
+                    coverage[k] = (right - left) / scale;
+                }
+            }
+        }
+        else {
+            double center = (i + 0.5) * scale - 0.5;
+            center = fmin(fmax(center, 0.0), srcLength - 1.0);
+            uint32_t left = (uint32_t)center;
+            double fraction = center - left;
+            first = left;
+            if (first + taps > srcLength) {
+                first = srcLength - taps;
+            }
+            coverage[left - first] += 1.0 - fraction;
+            if (left + 1 < srcLength) {
+                coverage[left + 1 - first] += fraction;
+            }
+        }
+        
+        /* round to fixed point and give the remainder to the heaviest tap */
+        uint16_t * weights = c->weights + (size_t)i * taps;
+        int sum = 0;
+        uint32_t heaviest = 0;
+        for (uint32_t k = 0; k < taps; k++) {
+            weights[k] = (uint16_t)lround(coverage[k] * WEIGHT_ONE);
+            sum += weights[k];
+            if (weights[k] > weights[heaviest]) {
+                heaviest = k;
+            }
+        }
+        weights[heaviest] = (uint16_t)(weights[heaviest] + WEIGHT_ONE - sum);
+        c->first[i] = first;
+    }
+    
+    free(coverage);
+    return 0;
+}
+
+int HoneywellScaleToWidth(const HoneywellGreyImage * src, uint32_t width, HoneywellGreyImage * dst)
+{
+    memset(dst, 0, sizeof(*dst));
+    if (src->width == 0 || src->height == 0 || width == 0) {
+        return -1;
+    }
+    
+    uint64_t height = ((uint64_t)src->height * width + src->width / 2) / src->width;
+    if (height == 0) {
+        height = 1;
+    }
+    if (height > 0xffff) {
+        return -1;
+    }
+    
+    const KernelTable * k = currentKernels();
+    Contributions columns = { 0 };
+    Contributions rows = { 0 };
+    HoneywellGreyImage tall = { 0 };
+    
+    if (buildContributions(src->width, width, &columns) != 0 ||
+        buildContributions(src->height, (uint32_t)height, &rows) != 0 ||
+        HoneywellGreyImageCreate(&tall, src->width, (uint32_t)height) != 0 ||
+        HoneywellGreyImageCreate(dst, width, (uint32_t)height) != 0) {
+        freeContributions(&columns);
+        freeContributions(&rows);
+        HoneywellGreyImageDestroy(&tall);
+        return -1;
+    }
+    
+    /* vertical pass first, it runs along whole rows and vectorizes */
+    const uint8_t * taps[rows.taps];
+    for (uint32_t y = 0; y < tall.height; y++) {
+        for (uint32_t t = 0; t < rows.taps; t++) {
+            taps[t] = src->pixels + (size_t)(rows.first[y] + t) * src->stride;
+        }
+        k->weightedRow(taps, rows.weights + (size_t)y * rows.taps, rows.taps, tall.width, tall.pixels + (size_t)y * tall.stride);
+    }
+    
+    /* horizontal pass gathers neighbouring pixels, scalar */
+    for (uint32_t y = 0; y < dst->height; y++) {
+        const uint8_t * in = tall.pixels + (size_t)y * tall.stride;
+        uint8_t * out = dst->pixels + (size_t)y * dst->stride;
+        for (uint32_t x = 0; x < width; x++) {
+            const uint8_t * p = in + columns.first[x];
+            const uint16_t * w = columns.weights + (size_t)x * columns.taps;
+            unsigned sum = WEIGHT_ONE / 2;
+            for (uint32_t t = 0; t < columns.taps; t++) {
+                sum += w[t] * p[t];
+            }
+            out[x] = (uint8_t)(sum >> 8);
+        }
+    }
+    
+    freeContributions(&columns);
+    freeContributions(&rows);
+    HoneywellGreyImageDestroy(&tall);
+    return 0;
+}
+
+#pragma mark - dithering
+
+void HoneywellOrderedDither(const HoneywellGreyImage * grey, HoneywellMonoImage * mono)
+{
+    const KernelTable * k = currentKernels();
+    
+    /* one threshold row per matrix row, the pattern repeated across the width */
+    uint8_t * thresholds = malloc((size_t)grey->width * 8);
+    if (thresholds == NULL) {
+        HoneywellThreshold(grey, 128, mono);
+        return;
+    }
+    for (unsigned row = 0; row < 8; row++) {
+        for (uint32_t x = 0; x < grey->width; x++) {
+            thresholds[(size_t)row * grey->width + x] = (uint8_t)(bayer8x8[row][x & 7] * 4 + 2);
+        }
+    }
+    
+    for (uint32_t y = 0; y < grey->height; y++) {
+        uint8_t * out = mono->bits + (size_t)y * mono->bytesPerLine;
+        memset(out, 0xff, mono->bytesPerLine);
+        k->packRow(grey->pixels + (size_t)y * grey->stride, thresholds + (size_t)(y & 7) * grey->width, grey->width, out);
+    }
+    
+    free(thresholds);
+}
+
+int HoneywellErrorDiffusionDither(const HoneywellGreyImage * grey, HoneywellMonoImage * mono)
+{
+    uint32_t width = grey->width;
+    
+    /* errors are kept in sixteenths, with a spare cell at each end */
+    size_t errorLength = (size_t)width + 2;
+    int16_t * errors = calloc(2 * errorLength, sizeof(int16_t));
+    if (errors == NULL) {
+        return -1;
+    }
+    
+    for (uint32_t y = 0; y < grey->height; y++) {
+        
+        const uint8_t * in = grey->pixels + (size_t)y * grey->stride;
+        uint8_t * out = mono->bits + (size_t)y * mono->bytesPerLine;
+        int16_t * current = errors + (y & 1) * errorLength + 1;
+        int16_t * next = errors + ((y + 1) & 1) * errorLength + 1;
+        
+        memset(next - 1, 0, errorLength * sizeof(int16_t));
+        memset(out, 0xff, mono->bytesPerLine);
+        
+        /* serpentine, odd rows run right to left */
+        int step = (y & 1) ? -1 : 1;
+        int32_t x = (y & 1) ? (int32_t)width - 1 : 0;
+        
+        for (uint32_t i = 0; i < width; i++, x += step) {
+            int value = in[x] + ((current[x] + 8) >> 4);
+            if (value < 0) {
+                value = 0;
+            }
+            else if (value > 255) {
+                value = 255;
+            }
+            
+            int error = value;
+            if (value < 128) {
+                out[x >> 3] &= (uint8_t)~(0x80 >> (x & 7));
+            }
+            else {
+                error = value - 255;
+            }
+            
+            current[x + step] += (int16_t)(7 * error);
+            next[x - step] += (int16_t)(3 * error);
+            next[x] += (int16_t)(5 * error);
+            next[x + step] += (int16_t)error;
+        }
+    }
+    
+    free(errors);
+    return 0;
+}
+
+#pragma mark - benchmark
+
+static double nowMilliseconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+int HoneywellBenchmarkKernels(const uint8_t * pcx, size_t length, uint32_t width, unsigned iterations, HoneywellKernelTimings * timings)
+{
+    memset(timings, 0, sizeof(*timings));
+    if (iterations == 0) {
+        return -1;
+    }
+    
+    HoneywellGreyImage grey;
+    HoneywellGreyImage scaled;
+    HoneywellMonoImage mono;
+    
+    double start = nowMilliseconds();
+    for (unsigned i = 0; i < iterations; i++) {
+        if (HoneywellPCXDecode(pcx, length, &grey) != 0) {
+            return -1;
+        }
+        if (i + 1 < iterations) {
+            HoneywellGreyImageDestroy(&grey);
+        }
+    }
+    timings->decode = (nowMilliseconds() - start) / iterations;
+    
+    start = nowMilliseconds();
+    for (unsigned i = 0; i < iterations; i++) {
+        if (HoneywellScaleToWidth(&grey, width, &scaled) != 0) {
+            HoneywellGreyImageDestroy(&grey);
+            return -1;
+        }
+        if (i + 1 < iterations) {
+            HoneywellGreyImageDestroy(&scaled);
+        }
+    }
+    timings->scale = (nowMilliseconds() - start) / iterations;
+    HoneywellGreyImageDestroy(&grey);
+    
+    if (HoneywellMonoImageCreate(&mono, scaled.width, scaled.height) != 0) {
+        HoneywellGreyImageDestroy(&scaled);
+        return -1;
+    }
+    
+    start = nowMilliseconds();
+    for (unsigned i = 0; i < iterations; i++) {
+        HoneywellOrderedDither(&scaled, &mono);
+    }
+    timings->ordered = (nowMilliseconds() - start) / iterations;
+    
+    start = nowMilliseconds();
+    for (unsigned i = 0; i < iterations; i++) {
+        HoneywellErrorDiffusionDither(&scaled, &mono);
+    }
+    timings->diffusion = (nowMilliseconds() - start) / iterations;
+    
+    timings->width = scaled.width;
+    timings->height = scaled.height;
+    HoneywellMonoImageDestroy(&mono);
+    HoneywellGreyImageDestroy(&scaled);
+    return 0;
+}
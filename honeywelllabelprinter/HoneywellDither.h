@@ -0,0 +1,77 @@
+//
+//  HoneywellDither.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#ifndef HoneywellDither_h
+#define HoneywellDither_h
+
+#include "HoneywellBitmap.h"
+
+/*
+
+ Row kernels for turning photos and logos into label graphics: greyscale
+ conversion, resampling to the print head width and ordered or error
+ diffusion dithering.
+
+ Each kernel has a scalar version plus SSE2 / AVX2 on Intel (simulator and
+ Linux builds) and NEON on ARM. The best set the CPU supports is picked on
+ first use, all sets give bit-identical output.
+
+ Floyd-Steinberg carries the error from one pixel into the next so it stays
+ scalar, it works on 16-bit integer errors in serpentine order. Ordered
+ dithering has no such dependency and is the fast choice for large images.
+
+ */
+
+typedef enum {
+    HONEYWELL_KERNEL_SCALAR = 0,
+    HONEYWELL_KERNEL_SSE2,
+    HONEYWELL_KERNEL_AVX2,
+    HONEYWELL_KERNEL_NEON,
+} HoneywellKernelSet;
+
+typedef enum {
+    HONEYWELL_DITHER_THRESHOLD = 0,
+    HONEYWELL_DITHER_ORDERED,
+    HONEYWELL_DITHER_ERROR_DIFFUSION,
+} HoneywellDitherMode;
+
+HoneywellKernelSet HoneywellBestKernelSet(void);
+HoneywellKernelSet HoneywellCurrentKernelSet(void);
+const char * HoneywellKernelSetName(HoneywellKernelSet set);
+
+// for benchmarks, returns -1 and keeps the current set if the CPU lacks it
+int HoneywellUseKernelSet(HoneywellKernelSet set);
+
+// one row of BT.601 luma from separate red, green and blue planes
+void HoneywellGreyFromPlanes(const uint8_t * r, const uint8_t * g, const uint8_t * b, uint32_t width, uint8_t * out);
+
+// area average when shrinking, bilinear when enlarging, height keeps the aspect ratio
+int HoneywellScaleToWidth(const HoneywellGreyImage * src, uint32_t width, HoneywellGreyImage * dst);
+
+// 8x8 Bayer matrix, mono must match the grey size
+void HoneywellOrderedDither(const HoneywellGreyImage * grey, HoneywellMonoImage * mono);
+
+// serpentine Floyd-Steinberg, mono must match the grey size
+int HoneywellErrorDiffusionDither(const HoneywellGreyImage * grey, HoneywellMonoImage * mono);
+
+#pragma mark - benchmark
+
+// average milliseconds per run with the current kernel set
+typedef struct {
+    double decode;      // PCX decode including greyscale conversion
+    double scale;
+    double ordered;
+    double diffusion;
+    uint32_t width;
+    uint32_t height;
+} HoneywellKernelTimings;
+
+// decodes a PCX and times each stage scaled to width
+int HoneywellBenchmarkKernels(const uint8_t * pcx, size_t length, uint32_t width, unsigned iterations, HoneywellKernelTimings * timings);
+
+#endif /* HoneywellDither_h */
@@ -0,0 +1,70 @@
+//
+//  HoneywellImageLibrary.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/*
+
+ The images labels refer to, by logical name, and which of them one printer
+ holds. A label's image is its record's "image" value, which is both the
+ logical name and the file name on the printer, e.g. PM {^image}.
+
+ Before a label is encoded its image is prepared: an image the printer has
+ is ready at once, a missing or changed one is uploaded and the label waits.
+ Uploads are kept within storageCapacity bytes per printer by removing the
+ least recently used images first with REMOVE IMAGE, so departments sharing
+ a printer each keep their logos until space actually runs out.
+
+ A name that was never registered is looked up as a bundle resource of the
+ same name, so the bundled logos need no registration.
+
+ Everything except registration runs on the printer I/O thread. Commands
+ for the printer are appended to the caller's buffer so they stay in order
+ with the labels around them.
+
+ */
+
+typedef NS_ENUM (NSInteger,HoneywellImageState) {
+    // on the printer, labels can use it now
+    HONEYWELL_IMAGE_READY = 0,
+    // being checked or uploaded, hold the label
+    HONEYWELL_IMAGE_PENDING,
+    // unknown or the upload failed, the label goes without it
+    HONEYWELL_IMAGE_UNAVAILABLE
+};
+
+@interface HoneywellImageLibrary : NSObject
+
+// image memory the library may fill on each printer, defaults to 512 KB
+@property (nonatomic) unsigned long long storageCapacity;
+
+/* with YES, defaults, the printer's IMAGES listing is checked on connect in
+   case it lost images, with NO the local registry is trusted */
+@property (nonatomic) BOOL verifyStoredImages;
+
+// called on the I/O thread when pending images became ready or unavailable
+@property (nonatomic, copy) void (^imagesSettledHandler)(void);
+
+// names are printer file names, letters, digits, '_' and '-' only
+-(void)registerImageNamed:(NSString *)name resource:(NSString *)resource;
+-(void)registerImageNamed:(NSString *)name imageData:(NSData *)imageData;
+
+-(void)connectToPrinter:(NSString *)host commands:(NSMutableData *)commands;
+-(void)disconnect;
+
+-(HoneywellImageState)prepareImageNamed:(NSString *)name commands:(NSMutableData *)commands;
+
+/* the 1-bit PCX for name as it is uploaded, nil if it can not be loaded.
+   Any thread, kept in a cache of its own so previews never wait for the I/O
+   thread. */
+-(NSData *)previewImageNamed:(NSString *)name;
+
+// returns YES for lines that answer the library's own commands
+-(BOOL)handleTextLine:(const char *)line length:(NSUInteger)length;
+
+@end
@@ -0,0 +1,436 @@
+//
+//  HoneywellImageLibrary.m
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import "HoneywellImageLibrary.h"
+#import "HoneywellImageRegistry.h"
+#import "HoneywellImagePreparer.h"
+#import "HoneywellMultipartBody.h"
+#import "HoneywellPrinterIOThread.h"
+
+/* printed around IMAGES so its listing can be told apart from other text */
+static const char kImageListingBegin[] = "IMAGES BEGIN";
+static const char kImageListingEnd[] = "IMAGES END";
+/* printed after REMOVE IMAGE, the upload waits for it */
+static const char kImagesRemoved[] = "IMAGES REMOVED";
+
+@interface HoneywellImageLibrary ()
+{
+    /* logical name -> bundle resource name or image data, any thread */
+    NSMutableDictionary * sources;
+    /* prepared images for previews, guarded by sources, so previews never
+       wait for the I/O thread */
+    NSMutableDictionary * previewImages;
+    
+    /* everything below is only touched on the I/O thread */
+    HoneywellPrinterIOThread * ioThread;
+    HoneywellImageRegistry * registry;
+    NSMutableDictionary * preparedImages;
+    NSMutableDictionary * contentHashes;
+    
+    NSString * printerHost;
+    // bumped per connection, late upload results of an old one are ignored
+    NSUInteger connectionGeneration;
+    // image names from the printer's IMAGES listing while it is being read
+    NSMutableSet * listedImages;
+    BOOL verifying;
+    NSMutableSet * readyImages;
+    NSMutableSet * unavailableImages;
+    NSMutableSet * uploadingImages;
+    // uploads waiting for their IMAGES REMOVED line, one line each
+    NSMutableArray * uploadsWaitingForSpace;
+}
+
+// the 1-bit PCX uploaded for name, nil if it can not be loaded, I/O thread only
+-(NSData *)preparedImageNamed:(NSString *)name;
+
+@end
+
+@implementation HoneywellImageLibrary
+
+-(instancetype)init
+{
+    self = [super init];
+    if (self) {
+        _storageCapacity = 512 * 1024;
+        _verifyStoredImages = YES;
+        sources = [[NSMutableDictionary alloc] init];
+        previewImages = [[NSMutableDictionary alloc] init];
+        ioThread = [HoneywellPrinterIOThread sharedIOThread];
+        registry = [HoneywellImageRegistry sharedRegistry];
+        preparedImages = [[NSMutableDictionary alloc] init];
+        contentHashes = [[NSMutableDictionary alloc] init];
+        readyImages = [[NSMutableSet alloc] init];
+        unavailableImages = [[NSMutableSet alloc] init];
+        uploadingImages = [[NSMutableSet alloc] init];
+        uploadsWaitingForSpace = [[NSMutableArray alloc] init];
+    }
+    return self;
+}
+
+#pragma mark registration
+
+-(void)registerImageNamed:(NSString *)name resource:(NSString *)resource
+{
+    [self registerImageNamed:name source:resource];
+}
+
+-(void)registerImageNamed:(NSString *)name imageData:(NSData *)imageData
+{
+    [self registerImageNamed:name source:[imageData copy]];
+}
+
+-(void)registerImageNamed:(NSString *)name source:(id)source
+{
+    NSCharacterSet * invalid = [[NSCharacterSet characterSetWithCharactersInString:
+                                 @"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_-"] invertedSet];
+    if (name.length == 0 || [name rangeOfCharacterFromSet:invalid].location != NSNotFound) {
+        NSLog(@"Image name %@ can not be used as a printer file name", name);
+        return;
+    }
+    
+    @synchronized (sources) {
+        sources[name] = source;
+        [previewImages removeObjectForKey:name];
+    }
+    
+    /* a changed source is prepared and hashed again on next use */
+    [ioThread performBlock:^{
+        [preparedImages removeObjectForKey:name];
+        [contentHashes removeObjectForKey:name];
+        [readyImages removeObject:name];
+        [unavailableImages removeObject:name];
+    }];
+}
+
+-(NSData *)preparedImageNamed:(NSString *)name
+{
+    NSAssert([ioThread isCurrentThread], @"prepared images belong to the I/O thread");
+    
+    NSData * prepared = preparedImages[name];
+    if (prepared != nil) {
+        return prepared;
+    }
+    
+    id source;
+    @synchronized (sources) {
+        source = sources[name] ?: name;
+    }
+    
+    prepared = [self monochromeImageFromSource:source];
+    if (prepared != nil) {
+        preparedImages[name] = prepared;
+        contentHashes[name] = [HoneywellImageRegistry contentHashForData:prepared];
+    }
+    return prepared;
+}
+
+-(NSData *)previewImageNamed:(NSString *)name
+{
+    id source;
+    @synchronized (sources) {
+        NSData * prepared = previewImages[name];
+        if (prepared != nil) {
+            return prepared;
+        }
+        source = sources[name] ?: name;
+    }
+    
+    /* prepared outside the lock, a source registered meanwhile wins */
+    NSData * prepared = [self monochromeImageFromSource:source];
+    if (prepared != nil) {
+        @synchronized (sources) {
+            if ([(sources[name] ?: name) isEqual:source]) {
+                previewImages[name] = prepared;
+            }
+        }
+    }
+    return prepared;
+}
+
+/* the printer only prints black and white, send the 1-bit version */
+-(NSData *)monochromeImageFromSource:(id)source
+{
+    if ([source isKindOfClass:[NSData class]]) {
+        return [HoneywellImagePreparer monochromePCXFromImageData:source threshold:HONEYWELL_AUTO_THRESHOLD];
+    }
+    return [HoneywellImagePreparer monochromePCXForResource:source];
+}
+
+#pragma mark connection
+
+-(void)connectToPrinter:(NSString *)host commands:(NSMutableData *)commands
+{
+    [self disconnect];
+    printerHost = [host copy];
+    
+    if (!_verifyStoredImages || [registry imageNamesOnPrinter:printerHost].count == 0) {
+        return;
+    }
+    
+    /* labels with images wait until collectImageListingLine:length: has the answer */
+    verifying = YES;
+    NSString * listing = [NSString stringWithFormat:@"PRINT \"%s\"\r\nIMAGES\r\nPRINT \"%s\"\r\n", kImageListingBegin, kImageListingEnd];
+    [commands appendData:[listing dataUsingEncoding:NSASCIIStringEncoding]];
+}
+
+/* uploads still running are recorded in the registry when they finish */
+-(void)disconnect
+{
+    connectionGeneration++;
+    verifying = NO;
+    listedImages = nil;
+    [readyImages removeAllObjects];
+    [unavailableImages removeAllObjects];
+    [uploadingImages removeAllObjects];
+    [uploadsWaitingForSpace removeAllObjects];
+    [registry synchronize];
+}
+
+#pragma mark preparing
+
+-(HoneywellImageState)prepareImageNamed:(NSString *)name commands:(NSMutableData *)commands
+{
+    if (verifying) {
+        return HONEYWELL_IMAGE_PENDING;
+    }
+    if ([readyImages containsObject:name]) {
+        [registry markImageNamed:name usedOnPrinter:printerHost];
+        return HONEYWELL_IMAGE_READY;
+    }
+    if ([unavailableImages containsObject:name]) {
+        return HONEYWELL_IMAGE_UNAVAILABLE;
+    }
+    if ([uploadingImages containsObject:name]) {
+        return HONEYWELL_IMAGE_PENDING;
+    }
+    
+    NSData * prepared = [self preparedImageNamed:name];
+    if (prepared == nil) {
+        NSLog(@"Image %@ is not registered and not in the bundle", name);
+        [unavailableImages addObject:name];
+        return HONEYWELL_IMAGE_UNAVAILABLE;
+    }
+    
+    if ([registry printer:printerHost hasImageNamed:name contentHash:contentHashes[name]]) {
+        [readyImages addObject:name];
+        [registry markImageNamed:name usedOnPrinter:printerHost];
+        return HONEYWELL_IMAGE_READY;
+    }
+    
+    [uploadingImages addObject:name];
+    if ([self removeImagesToFit:name commands:commands]) {
+        [uploadsWaitingForSpace addObject:name];
+        [commands appendData:[[NSString stringWithFormat:@"PRINT \"%s\"\r\n", kImagesRemoved] dataUsingEncoding:NSASCIIStringEncoding]];
+    }
+    else {
+        [self uploadImageNamed:name];
+    }
+    return HONEYWELL_IMAGE_PENDING;
+}
+
+/* least recently used first, labels already written ahead of REMOVE IMAGE
+   have been imaged by the time the printer gets to it */
+-(BOOL)removeImagesToFit:(NSString *)name commands:(NSMutableData *)commands
+{
+    unsigned long long stored = [registry storedBytesOnPrinter:printerHost] - [registry sizeOfImageNamed:name onPrinter:printerHost];
+    unsigned long long needed = [preparedImages[name] length];
+    BOOL removed = NO;
+    
+    for (NSString * victim in [registry leastRecentlyUsedImageNamesOnPrinter:printerHost]) {
+        if (stored + needed <= _storageCapacity) {
+            break;
+        }
+        if ([victim isEqualToString:name] || [uploadingImages containsObject:victim]) {
+            continue;
+        }
+        
+        NSLog(@"Removing image %@ from printer to make room for %@", victim, name);
+        [commands appendData:[[NSString stringWithFormat:@"REMOVE IMAGE \"%@\"\r\n", victim.uppercaseString] dataUsingEncoding:NSASCIIStringEncoding]];
+        stored -= [registry sizeOfImageNamed:victim onPrinter:printerHost];
+        [registry forgetImageNamed:victim onPrinter:printerHost];
+        [readyImages removeObject:victim];
+        removed = YES;
+    }
+    
+    if (stored + needed > _storageCapacity) {
+        NSLog(@"Image %@ does not fit in %llu bytes, uploading anyway", name, _storageCapacity);
+    }
+    return removed;
+}
+
+#pragma mark printer responses
+
+-(BOOL)handleTextLine:(const char *)line length:(NSUInteger)length
+{
+    if (length == strlen(kImagesRemoved) && memcmp(line, kImagesRemoved, length) == 0) {
+        if (uploadsWaitingForSpace.count > 0) {
+            NSString * name = uploadsWaitingForSpace[0];
+            [uploadsWaitingForSpace removeObjectAtIndex:0];
+            [self uploadImageNamed:name];
+        }
+        return YES;
+    }
+    
+    if (length == strlen(kImageListingBegin) && memcmp(line, kImageListingBegin, length) == 0) {
+        listedImages = [[NSMutableSet alloc] init];
+        return YES;
+    }
+    if (listedImages == nil) {
+        return NO;
+    }
+    
+    if (length == strlen(kImageListingEnd) && memcmp(line, kImageListingEnd, length) == 0) {
+        [self finishVerification];
+        return YES;
+    }
+    
+    /* names may be listed several per line and with a type suffix, e.g. 1BITLEAF.1 */
+    NSString * text = [[NSString alloc] initWithBytes:line length:length encoding:NSASCIIStringEncoding];
+    for (NSString * token in [text componentsSeparatedByCharactersInSet:[NSCharacterSet whitespaceCharacterSet]]) {
+        if (token.length > 0) {
+            [listedImages addObject:token.stringByDeletingPathExtension.uppercaseString];
+        }
+    }
+    return YES;
+}
+
+/* images the printer lost are forgotten and get uploaded on next use, if
+   IMAGES is not understood the listing is empty and everything uploads */
+-(void)finishVerification
+{
+    for (NSString * name in [registry imageNamesOnPrinter:printerHost]) {
+        if (![listedImages containsObject:name.uppercaseString]) {
+            NSLog(@"Image %@ missing on printer, will upload again", name);
+            [registry forgetImageNamed:name onPrinter:printerHost];
+        }
+    }
+    listedImages = nil;
+    verifying = NO;
+    
+    if (_imagesSettledHandler) {
+        _imagesSettledHandler();
+    }
+}
+
+#pragma mark upload image
+
+-(void)uploadImageNamed:(NSString *)name
+{
+    NSData * imageData = preparedImages[name];
+    NSString * contentHash = contentHashes[name];
+    NSString * host = printerHost;
+    NSUInteger generation = connectionGeneration;
+    
+    NSString * urlString = [NSString stringWithFormat:@"http://%@/manage/upload.lp?type=image",host];
+    NSMutableURLRequest *request = [[NSMutableURLRequest alloc] initWithURL:[NSURL URLWithString:urlString]];
+    
+    [request setCachePolicy:NSURLRequestReloadIgnoringLocalCacheData];
+    [request setHTTPShouldHandleCookies:NO];
+    [request setTimeoutInterval:120];
+    [request setHTTPMethod:@"POST"];
+    
+    // body is streamed from imageData, no copy of the image is made
+    HoneywellMultipartBody * body = [[HoneywellMultipartBody alloc] initWithBoundary:@"------WebKitFormBoundary"];
+    [body appendFileField:@"file" filename:name data:imageData];
+    [body applyToRequest:request];
+    
+    NSLog(@"Uploading %@: %llu bytes", name, body.contentLength);
+    
+    void (^finished)(BOOL) = ^(BOOL stored) {
+        if (stored) {
+            [registry recordImageNamed:name contentHash:contentHash size:imageData.length onPrinter:host];
+        }
+        else {
+            NSLog(@"Image %@ upload to %@ failed", name, host);
+        }
+        [ioThread performBlock:^{
+            [self uploadOfImageNamed:name stored:stored generation:generation];
+        }];
+    };
+    
+    NSURLSession *session = [NSURLSession sharedSession];
+    NSURLSessionDataTask *task = [session dataTaskWithRequest:request completionHandler: ^(NSData *data, NSURLResponse *response, NSError *error) {
+        
+        if(data.length > 0)
+        {
+            //success
+            NSString * responseString = [[NSString alloc]initWithData:data encoding:NSASCIIStringEncoding];
+            NSString * redirectUri = [self getRedirectURIFromHTMLString:responseString];
+            [self onUploadImageComplete:redirectUri host:host finished:finished];
+        }
+        else
+        {
+            finished(NO);
+        }
+    }];
+    
+    [task resume];
+}
+
+- (void)onUploadImageComplete:(NSString*)redirectURI host:(NSString *)host finished:(void (^)(BOOL stored))finished
+{
+    NSString * urlString = [NSString stringWithFormat:@"http://%@/manage/%@",host,redirectURI];
+    NSMutableURLRequest *request = [[NSMutableURLRequest alloc] initWithURL:[NSURL URLWithString:urlString]];
+    
+    [request setCachePolicy:NSURLRequestReloadIgnoringLocalCacheData];
+    [request setHTTPShouldHandleCookies:NO];
+    [request setTimeoutInterval:120];
+    [request setHTTPMethod:@"GET"];
+    
+    NSURLSession *session = [NSURLSession sharedSession];
+    NSURLSessionDataTask *task = [session dataTaskWithRequest:request completionHandler: ^(NSData *data, NSURLResponse *response, NSError *error) {
+        finished(error == nil && [response isKindOfClass:[NSHTTPURLResponse class]] && ((NSHTTPURLResponse *)response).statusCode == 200);
+    }];
+    
+    [task resume];
+}
+
+-(void)uploadOfImageNamed:(NSString *)name stored:(BOOL)stored generation:(NSUInteger)generation
+{
+    if (generation != connectionGeneration) {
+        return;
+    }
+    
+    [uploadingImages removeObject:name];
+    if (stored) {
+        [readyImages addObject:name];
+    }
+    else {
+        /* labels go without it rather than waiting forever, the next connection tries again */
+        [unavailableImages addObject:name];
+    }
+    
+    if (_imagesSettledHandler) {
+        _imagesSettledHandler();
+    }
+}
+
+-(NSString *)getRedirectURIFromHTMLString:(NSString*)htmlString
+{
+    NSRange rangePrefix = [htmlString rangeOfString:@"url="];
+    if (rangePrefix.location == NSNotFound) {
+        NSLog(@"Search string was not found");
+        return @"";
+    }
+    
+    NSRange rangeSuffix = [htmlString rangeOfString:@"</head>"];
+    if(rangeSuffix.location == NSNotFound){
+        NSLog(@"Search string was not found");
+        return @"";
+    }
+    
+    NSRange uriStringRange = NSMakeRange(rangePrefix.location + rangePrefix.length,
+                                         rangeSuffix.location - (rangePrefix.location + rangePrefix.length) - 5);
+    
+    NSString *redirectUri = [htmlString substringWithRange:uriStringRange];
+    NSLog(@"redirectUri: %@", redirectUri);
+    
+    return redirectUri;
+}
+
+@end
@@ -0,0 +1,47 @@
+//
+//  HoneywellImagePreparer.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#include "HoneywellDither.h"
+
+/*
+
+ Turns a bundled or user image into a 1-bit monochrome PCX before it is
+ uploaded to the printer. The printer only prints black and white, so a
+ colour PCX just costs upload time, e.g. the bundled 1bitleaf drops from
+ 131606 bytes of 3 plane 8-bit colour to about 6 KB.
+
+ PCX input is decoded directly, anything else (PNG, JPEG, ...) goes through
+ ImageIO. Pixels darker than the threshold print black.
+
+ Photos can instead be shrunk to the print head width of the profile in
+ printer_profiles.JSON (384, 576 or 832 dots) and dithered, see
+ HoneywellDither.h for the kernels.
+
+ */
+
+// pass to use a threshold picked from the image histogram
+#define HONEYWELL_AUTO_THRESHOLD 0
+
+@interface HoneywellImagePreparer : NSObject
+
+// returns nil if the image can not be decoded
++(NSData *)monochromePCXFromImageData:(NSData *)imageData threshold:(uint8_t)threshold;
+
+// images wider than printHeadWidth are scaled down to it, 0 keeps the size
++(NSData *)monochromePCXFromImageData:(NSData *)imageData printHeadWidth:(uint32_t)printHeadWidth dither:(HoneywellDitherMode)dither;
+
+// bundle resource converted once per process and then cached
++(NSData *)monochromePCXForResource:(NSString *)name;
+
+#ifdef DEBUG
+// logs each kernel set on the bundled PCX resources at every print head width
++(void)logKernelBenchmarkForResources:(NSArray<NSString *> *)names iterations:(unsigned)iterations;
+#endif
+
+@end
@@ -0,0 +1,204 @@
+//
+//  HoneywellImagePreparer.m
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import "HoneywellImagePreparer.h"
+#import <ImageIO/ImageIO.h>
+#import <CoreGraphics/CoreGraphics.h>
+#include "HoneywellBitmap.h"
+
+/* PC42t print resolution */
+static const uint16_t kPrinterDPI = 203;
+
+@implementation HoneywellImagePreparer
+
++(NSData *)monochromePCXFromImageData:(NSData *)imageData threshold:(uint8_t)threshold
+{
+    return [self monochromePCXFromImageData:imageData printHeadWidth:0 dither:HONEYWELL_DITHER_THRESHOLD threshold:threshold];
+}
+
++(NSData *)monochromePCXFromImageData:(NSData *)imageData printHeadWidth:(uint32_t)printHeadWidth dither:(HoneywellDitherMode)dither
+{
+    return [self monochromePCXFromImageData:imageData printHeadWidth:printHeadWidth dither:dither threshold:HONEYWELL_AUTO_THRESHOLD];
+}
+
++(NSData *)monochromePCXFromImageData:(NSData *)imageData printHeadWidth:(uint32_t)printHeadWidth dither:(HoneywellDitherMode)dither threshold:(uint8_t)threshold
+{
+#ifdef DEBUG
+    CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+#endif
+    
+    HoneywellGreyImage grey;
+    if (![self decodeImageData:imageData into:&grey]) {
+        NSLog(@"Image can not be decoded");
+        return nil;
+    }
+    
+    if (printHeadWidth > 0 && grey.width > printHeadWidth) {
+        HoneywellGreyImage scaled;
+        int result = HoneywellScaleToWidth(&grey, printHeadWidth, &scaled);
+        HoneywellGreyImageDestroy(&grey);
+        if (result != 0) {
+            return nil;
+        }
+        grey = scaled;
+    }
+    
+    HoneywellMonoImage mono;
+    if (HoneywellMonoImageCreate(&mono, grey.width, grey.height) != 0) {
+        HoneywellGreyImageDestroy(&grey);
+        return nil;
+    }
+    
+    switch (dither) {
+        case HONEYWELL_DITHER_ORDERED:
+            HoneywellOrderedDither(&grey, &mono);
+            break;
+        case HONEYWELL_DITHER_ERROR_DIFFUSION:
+            if (HoneywellErrorDiffusionDither(&grey, &mono) == 0) {
+                break;
+            }
+            // out of memory, fall back to ordered
+            HoneywellOrderedDither(&grey, &mono);
+            break;
+        default:
+            if (threshold == HONEYWELL_AUTO_THRESHOLD) {
+                threshold = HoneywellOtsuThreshold(&grey);
+            }
+            HoneywellThreshold(&grey, threshold, &mono);
+            break;
+    }
+    
+    size_t length = 0;
+    uint8_t * pcx = HoneywellPCXEncodeMono(&mono, kPrinterDPI, &length);
+    
+    HoneywellMonoImageDestroy(&mono);
+    HoneywellGreyImageDestroy(&grey);
+    
+    if (pcx == NULL) {
+        return nil;
+    }
+
+#ifdef DEBUG
+    NSLog(@"Image prepared (%s): %lu -> %lu bytes in %.2f ms", HoneywellKernelSetName(HoneywellCurrentKernelSet()),
+          (unsigned long)imageData.length, (unsigned long)length, (CFAbsoluteTimeGetCurrent() - startTime) * 1000.0);
+#endif
+    
+    return [NSData dataWithBytesNoCopy:pcx length:length freeWhenDone:YES];
+}
+
++(NSData *)monochromePCXForResource:(NSString *)name
+{
+    static NSMutableDictionary * preparedImages;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        preparedImages = [[NSMutableDictionary alloc] init];
+    });
+    
+    @synchronized (preparedImages) {
+        
+        NSData * prepared = preparedImages[name];
+        if (prepared == nil) {
+            NSString * filepath = [[NSBundle mainBundle] pathForResource:name ofType:nil];
+            NSData * imageData = filepath ? [[NSData alloc] initWithContentsOfFile:filepath] : nil;
+            prepared = imageData ? [self monochromePCXFromImageData:imageData threshold:HONEYWELL_AUTO_THRESHOLD] : nil;
+            if (prepared != nil) {
+                preparedImages[name] = prepared;
+            }
+        }
+        return prepared;
+    }
+}
+
+#pragma mark benchmark
+
+#ifdef DEBUG
++(void)logKernelBenchmarkForResources:(NSArray<NSString *> *)names iterations:(unsigned)iterations
+{
+    static const uint32_t printHeadWidths[] = { 384, 576, 832 };
+    static const HoneywellKernelSet kernelSets[] = { HONEYWELL_KERNEL_SCALAR, HONEYWELL_KERNEL_SSE2, HONEYWELL_KERNEL_AVX2, HONEYWELL_KERNEL_NEON };
+    
+    HoneywellKernelSet bestSet = HoneywellBestKernelSet();
+    
+    for (NSString * name in names) {
+        
+        NSString * filepath = [[NSBundle mainBundle] pathForResource:name ofType:nil];
+        NSData * imageData = filepath ? [[NSData alloc] initWithContentsOfFile:filepath] : nil;
+        if (imageData == nil) {
+            NSLog(@"Benchmark: %@ not found", name);
+            continue;
+        }
+        
+        for (size_t w = 0; w < sizeof(printHeadWidths) / sizeof(printHeadWidths[0]); w++) {
+            for (size_t s = 0; s < sizeof(kernelSets) / sizeof(kernelSets[0]); s++) {
+                
+                if (HoneywellUseKernelSet(kernelSets[s]) != 0) {
+                    continue;
+                }
+                HoneywellKernelTimings timings;
+                if (HoneywellBenchmarkKernels(imageData.bytes, imageData.length, printHeadWidths[w], iterations, &timings) != 0) {
+                    NSLog(@"Benchmark: %@ is not a PCX", name);
+                    break;
+                }
+                NSLog(@"Benchmark %@ %ux%u %-6s decode %.3f scale %.3f ordered %.3f diffusion %.3f ms", name, timings.width, timings.height,
+                      HoneywellKernelSetName(kernelSets[s]), timings.decode, timings.scale, timings.ordered, timings.diffusion);
+            }
+        }
+    }
+    
+    HoneywellUseKernelSet(bestSet);
+}
+#endif
+
+#pragma mark decoding
+
++(BOOL)decodeImageData:(NSData *)imageData into:(HoneywellGreyImage *)grey
+{
+    const uint8_t * bytes = imageData.bytes;
+    
+    /* PCX has no ImageIO decoder, 0x0a is its manufacturer byte */
+    if (imageData.length > 0 && bytes[0] == 0x0a) {
+        return HoneywellPCXDecode(bytes, imageData.length, grey) == 0;
+    }
+    
+    CGImageSourceRef source = CGImageSourceCreateWithData((__bridge CFDataRef)imageData, NULL);
+    if (source == NULL) {
+        return NO;
+    }
+    CGImageRef image = CGImageSourceCreateImageAtIndex(source, 0, NULL);
+    CFRelease(source);
+    if (image == NULL) {
+        return NO;
+    }
+    
+    size_t width = CGImageGetWidth(image);
+    size_t height = CGImageGetHeight(image);
+    if (width > 0xffff || height > 0xffff || HoneywellGreyImageCreate(grey, (uint32_t)width, (uint32_t)height) != 0) {
+        CGImageRelease(image);
+        return NO;
+    }
+    
+    /* transparent areas come out white, like the label behind them */
+    memset(grey->pixels, 0xff, grey->stride * height);
+    
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceGray();
+    CGContextRef context = CGBitmapContextCreate(grey->pixels, width, height, 8, grey->stride, colorSpace, (CGBitmapInfo)kCGImageAlphaNone);
+    CGColorSpaceRelease(colorSpace);
+    
+    if (context == NULL) {
+        CGImageRelease(image);
+        HoneywellGreyImageDestroy(grey);
+        return NO;
+    }
+    
+    CGContextDrawImage(context, CGRectMake(0, 0, width, height), image);
+    CGContextRelease(context);
+    CGImageRelease(image);
+    return YES;
+}
+
+@end
@@ -0,0 +1,49 @@
+//
+//  HoneywellImageRegistry.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/*
+
+ Remembers which images each printer already holds, keyed by the SHA-256 of
+ the uploaded bytes, with their size and when a label last used them. The
+ printer keeps uploaded images in its own memory, so a reconnect only needs
+ to upload again when the image changed or the printer lost it, and the
+ least recently used images are the ones to remove when space runs out.
+
+ The registry is a small property list written atomically after every
+ upload or removal, use times are saved along with those or on synchronize.
+ It is safe to use from any thread.
+
+ */
+
+@interface HoneywellImageRegistry : NSObject
+
+// stored in Application Support
++(instancetype)sharedRegistry;
+
+-(instancetype)initWithFileURL:(NSURL *)fileURL;
+
+// lowercase hex SHA-256
++(NSString *)contentHashForData:(NSData *)data;
+
+-(BOOL)printer:(NSString *)printer hasImageNamed:(NSString *)name contentHash:(NSString *)contentHash;
+
+-(NSArray *)imageNamesOnPrinter:(NSString *)printer;
+-(NSArray *)leastRecentlyUsedImageNamesOnPrinter:(NSString *)printer;
+-(unsigned long long)sizeOfImageNamed:(NSString *)name onPrinter:(NSString *)printer;
+-(unsigned long long)storedBytesOnPrinter:(NSString *)printer;
+
+-(void)recordImageNamed:(NSString *)name contentHash:(NSString *)contentHash size:(unsigned long long)size onPrinter:(NSString *)printer;
+-(void)forgetImageNamed:(NSString *)name onPrinter:(NSString *)printer;
+
+// only kept in memory until the next save
+-(void)markImageNamed:(NSString *)name usedOnPrinter:(NSString *)printer;
+-(void)synchronize;
+
+@end
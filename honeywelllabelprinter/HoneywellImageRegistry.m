@@ -0,0 +1,183 @@
+//
+//  HoneywellImageRegistry.m
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import "HoneywellImageRegistry.h"
+#import <CommonCrypto/CommonDigest.h>
+
+/* keys of each image entry */
+static NSString * const kEntryHash = @"hash";
+static NSString * const kEntrySize = @"size";
+static NSString * const kEntryLastUsed = @"lastUsed";
+
+@interface HoneywellImageRegistry ()
+{
+    NSURL * fileURL;
+    // printer -> image name -> entry
+    NSMutableDictionary * imagesByPrinter;
+    BOOL dirty;
+}
+@end
+
+@implementation HoneywellImageRegistry
+
++(instancetype)sharedRegistry
+{
+    static HoneywellImageRegistry * sharedRegistry;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSFileManager * fileManager = [NSFileManager defaultManager];
+        NSURL * directory = [fileManager URLForDirectory:NSApplicationSupportDirectory inDomain:NSUserDomainMask appropriateForURL:nil create:YES error:nil];
+        if (directory == nil) {
+            directory = [NSURL fileURLWithPath:NSTemporaryDirectory() isDirectory:YES];
+        }
+        sharedRegistry = [[HoneywellImageRegistry alloc] initWithFileURL:[directory URLByAppendingPathComponent:@"HoneywellImageRegistry.plist"]];
+    });
+    return sharedRegistry;
+}
+
+-(instancetype)initWithFileURL:(NSURL *)url
+{
+    self = [super init];
+    if (self) {
+        fileURL = url;
+        imagesByPrinter = [[NSMutableDictionary alloc] init];
+        
+        /* keep only well formed entries, a damaged file just means uploading again */
+        NSDictionary * stored = [NSDictionary dictionaryWithContentsOfURL:url];
+        for (NSString * printer in stored) {
+            NSDictionary * images = stored[printer];
+            if (![printer isKindOfClass:[NSString class]] || ![images isKindOfClass:[NSDictionary class]]) {
+                continue;
+            }
+            
+            NSMutableDictionary * entries = [[NSMutableDictionary alloc] init];
+            for (NSString * name in images) {
+                id entry = images[name];
+                if ([entry isKindOfClass:[NSDictionary class]] && [entry[kEntryHash] isKindOfClass:[NSString class]]) {
+                    entries[name] = [entry mutableCopy];
+                }
+            }
+            imagesByPrinter[printer] = entries;
+        }
+    }
+    return self;
+}
+
++(NSString *)contentHashForData:(NSData *)data
+{
+    unsigned char digest[CC_SHA256_DIGEST_LENGTH];
+    CC_SHA256(data.bytes, (CC_LONG)data.length, digest);
+    
+    NSMutableString * hash = [NSMutableString stringWithCapacity:CC_SHA256_DIGEST_LENGTH * 2];
+    for (int i = 0; i < CC_SHA256_DIGEST_LENGTH; i++) {
+        [hash appendFormat:@"%02x", digest[i]];
+    }
+    return hash;
+}
+
+-(BOOL)printer:(NSString *)printer hasImageNamed:(NSString *)name contentHash:(NSString *)contentHash
+{
+    @synchronized (self) {
+        return [imagesByPrinter[printer][name][kEntryHash] isEqualToString:contentHash];
+    }
+}
+
+-(NSArray *)imageNamesOnPrinter:(NSString *)printer
+{
+    @synchronized (self) {
+        return [imagesByPrinter[printer] allKeys] ?: @[];
+    }
+}
+
+-(NSArray *)leastRecentlyUsedImageNamesOnPrinter:(NSString *)printer
+{
+    @synchronized (self) {
+        NSDictionary * images = imagesByPrinter[printer];
+        return [images keysSortedByValueUsingComparator:^NSComparisonResult(NSDictionary * a, NSDictionary * b) {
+            return [a[kEntryLastUsed] compare:b[kEntryLastUsed]];
+        }] ?: @[];
+    }
+}
+
+-(unsigned long long)sizeOfImageNamed:(NSString *)name onPrinter:(NSString *)printer
+{
+    @synchronized (self) {
+        return [imagesByPrinter[printer][name][kEntrySize] unsignedLongLongValue];
+    }
+}
+
+-(unsigned long long)storedBytesOnPrinter:(NSString *)printer
+{
+    @synchronized (self) {
+        unsigned long long total = 0;
+        for (NSDictionary * entry in [imagesByPrinter[printer] objectEnumerator]) {
+            total += [entry[kEntrySize] unsignedLongLongValue];
+        }
+        return total;
+    }
+}
+
+-(void)recordImageNamed:(NSString *)name contentHash:(NSString *)contentHash size:(unsigned long long)size onPrinter:(NSString *)printer
+{
+    @synchronized (self) {
+        NSMutableDictionary * images = imagesByPrinter[printer];
+        if (images == nil) {
+            images = [[NSMutableDictionary alloc] init];
+            imagesByPrinter[printer] = images;
+        }
+        images[name] = [@{ kEntryHash : contentHash,
+                           kEntrySize : @(size),
+                           kEntryLastUsed : @([NSDate timeIntervalSinceReferenceDate]) } mutableCopy];
+        [self save];
+    }
+}
+
+-(void)forgetImageNamed:(NSString *)name onPrinter:(NSString *)printer
+{
+    @synchronized (self) {
+        NSMutableDictionary * images = imagesByPrinter[printer];
+        if (images[name] == nil) {
+            return;
+        }
+        [images removeObjectForKey:name];
+        if (images.count == 0) {
+            [imagesByPrinter removeObjectForKey:printer];
+        }
+        [self save];
+    }
+}
+
+-(void)markImageNamed:(NSString *)name usedOnPrinter:(NSString *)printer
+{
+    @synchronized (self) {
+        NSMutableDictionary * entry = imagesByPrinter[printer][name];
+        if (entry != nil) {
+            entry[kEntryLastUsed] = @([NSDate timeIntervalSinceReferenceDate]);
+            dirty = YES;
+        }
+    }
+}
+
+-(void)synchronize
+{
+    @synchronized (self) {
+        if (dirty) {
+            [self save];
+        }
+    }
+}
+
+-(void)save
+{
+    dirty = NO;
+    if (![imagesByPrinter writeToURL:fileURL atomically:YES]) {
+        NSLog(@"Image registry could not be saved to %@", fileURL.path);
+    }
+}
+
+@end
@@ -0,0 +1,60 @@
+//
+//  HoneywellJobJournal.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "HoneywellPrintJob.h"
+
+/*
+
+ Append-only write-ahead log of a printer's label jobs, kept in a memory
+ mapped file. Every label gets an ENQUEUED record with its data, followed by
+ SENT and ACKNOWLEDGED (or FAILED) as it moves through the queue.
+
+ Appends are a memcpy into the mapping. A commit timer msync's everything
+ appended since the last commit in one go, so a busy stream costs one flush
+ per commitInterval rather than one per label. A kill loses at most the
+ records of the last interval.
+
+ Opening a journal replays it: labels without ACKNOWLEDGED or FAILED come
+ back from unfinishedJobs in their original order, and the file is rewritten
+ with only those and the highest job id so far. Records carry a checksum and a generation, a torn tail or
+ stale records from before a reset end the replay.
+
+ */
+
+typedef NS_ENUM (NSInteger,HoneywellJournalEntryType) {
+    HONEYWELL_JOURNAL_ENQUEUED = 1,
+    HONEYWELL_JOURNAL_SENT,
+    HONEYWELL_JOURNAL_ACKNOWLEDGED,
+    HONEYWELL_JOURNAL_FAILED
+};
+
+@interface HoneywellJobJournal : NSObject
+
+@property (nonatomic, readonly) NSString * path;
+
+// seconds between group commits, defaults to 0.02
+@property (nonatomic) NSTimeInterval commitInterval;
+
+// jobs found unfinished when the journal was opened, without a group
+@property (nonatomic, readonly) NSArray * unfinishedJobs;
+
+// highest job id ever written, new ids must continue above it
+@property (nonatomic, readonly) NSUInteger lastJobID;
+
+// returns nil and logs the reason if the file can not be opened or mapped
++(instancetype)journalAtPath:(NSString *)path;
+
+-(void)appendEnqueuedJob:(HoneywellPrintJob *)job;
+-(void)appendEntry:(HoneywellJournalEntryType)type forJobID:(NSUInteger)jobID;
+
+// flushes everything appended so far, blocking until it is on disk
+-(void)commit;
+-(void)close;
+
+@end
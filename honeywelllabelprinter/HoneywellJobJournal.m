@@ -0,0 +1,491 @@
+//
+//  HoneywellJobJournal.m
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import "HoneywellJobJournal.h"
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+static const uint32_t kJournalFileMagic = 0x4c4a5748;      // "HWJL"
+static const uint32_t kJournalRecordMagic = 0x52574a48;    // "HJWR"
+static const uint32_t kJournalVersion = 2;
+
+static const size_t kJournalInitialCapacity = 1024 * 1024;
+
+/* once every label is finished and the log is past this size it starts over */
+static const size_t kJournalResetThreshold = 256 * 1024;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t generation;
+    uint32_t reserved;
+    // carried over compactions and resets, which drop the records holding it
+    uint64_t lastJobID;
+} HoneywellJournalFileHeader;
+
+typedef struct {
+    uint32_t magic;
+    // FNV-1a over the rest of the header and the payload
+    uint32_t checksum;
+    uint32_t generation;
+    uint16_t type;
+    uint16_t reserved;
+    uint64_t jobID;
+    uint32_t payloadLength;
+    uint32_t padding;
+} HoneywellJournalRecordHeader;
+
+static size_t recordLength(size_t payloadLength)
+{
+    return (sizeof(HoneywellJournalRecordHeader) + payloadLength + 7) & ~(size_t)7;
+}
+
+static uint32_t fnv1a(uint32_t hash, const void * bytes, size_t length)
+{
+    const uint8_t * p = bytes;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= p[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t recordChecksum(const HoneywellJournalRecordHeader * header, const void * payload)
+{
+    size_t headerTail = sizeof(*header) - offsetof(HoneywellJournalRecordHeader, generation);
+    uint32_t hash = fnv1a(2166136261u, &header->generation, headerTail);
+    return fnv1a(hash, payload, header->payloadLength);
+}
+
+@interface HoneywellJobJournal()
+{
+    /* the mapping and offsets are guarded by lock, appends come from the
+       I/O thread and commits from commitQueue. A commit msync's without the
+       lock, mappings replaced meanwhile are unmapped once no commit runs. */
+    NSLock * lock;
+    int fd;
+    uint8_t * mapping;
+    size_t capacity;
+    size_t writeOffset;
+    size_t committedOffset;
+    uint32_t generation;
+    NSUInteger outstandingJobs;
+    NSUInteger runningCommits;
+    NSMutableArray * retiredMappings;
+    
+    dispatch_queue_t commitQueue;
+    dispatch_source_t commitTimer;
+}
+@end
+
+@implementation HoneywellJobJournal
+
++(instancetype)journalAtPath:(NSString *)path
+{
+    HoneywellJobJournal * journal = [[HoneywellJobJournal alloc] initWithPath:path];
+    return [journal open] ? journal : nil;
+}
+
+-(instancetype)initWithPath:(NSString *)path
+{
+    self = [super init];
+    if (self) {
+        _path = [path copy];
+        _commitInterval = 0.02;
+        lock = [[NSLock alloc] init];
+        retiredMappings = [[NSMutableArray alloc] init];
+        fd = -1;
+        commitQueue = dispatch_queue_create("com.ritebozz.job-journal", DISPATCH_QUEUE_SERIAL);
+    }
+    return self;
+}
+
+-(void)dealloc
+{
+    [self close];
+}
+
+#pragma mark open and replay
+
+-(BOOL)open
+{
+    NSData * existing = [NSData dataWithContentsOfFile:_path options:NSDataReadingMappedIfSafe error:nil];
+    NSMutableArray * payloads = [[NSMutableArray alloc] init];
+    NSMutableArray * jobIDs = [[NSMutableArray alloc] init];
+    [self replayData:existing payloads:payloads jobIDs:jobIDs];
+    
+    /* start from a compacted file holding only the unfinished labels, written
+       aside and renamed so a crash here leaves the old journal intact */
+    generation++;
+    NSMutableData * compacted = [[NSMutableData alloc] init];
+    HoneywellJournalFileHeader fileHeader = { kJournalFileMagic, kJournalVersion, generation, 0, _lastJobID };
+    [compacted appendBytes:&fileHeader length:sizeof(fileHeader)];
+    
+    NSMutableArray * jobs = [[NSMutableArray alloc] init];
+    for (NSUInteger i = 0; i < payloads.count; i++) {
+        HoneywellPrintJob * job = [self jobFromPayload:payloads[i] jobID:[jobIDs[i] unsignedIntegerValue]];
+        if (job == nil) {
+            continue;
+        }
+        [self appendRecordType:HONEYWELL_JOURNAL_ENQUEUED jobID:job.jobID payload:payloads[i] toData:compacted];
+        [jobs addObject:job];
+    }
+    _unfinishedJobs = jobs;
+    outstandingJobs = jobs.count;
+    
+    if (![compacted writeToFile:_path options:NSDataWritingAtomic error:nil]) {
+        NSLog(@"Job journal can not be written at %@", _path);
+        return NO;
+    }
+    
+    fd = open(_path.fileSystemRepresentation, O_RDWR);
+    if (fd < 0) {
+        NSLog(@"Job journal open failed: %s", strerror(errno));
+        return NO;
+    }
+    
+    capacity = kJournalInitialCapacity;
+    while (capacity < compacted.length * 2) {
+        capacity *= 2;
+    }
+    if (![self mapCapacity:capacity]) {
+        close(fd);
+        fd = -1;
+        return NO;
+    }
+    
+    writeOffset = compacted.length;
+    committedOffset = writeOffset;
+    
+    if (jobs.count > 0) {
+        NSLog(@"Job journal has %lu unfinished labels", (unsigned long)jobs.count);
+    }
+    
+    [self startCommitTimer];
+    return YES;
+}
+
+-(void)replayData:(NSData *)data payloads:(NSMutableArray *)payloads jobIDs:(NSMutableArray *)jobIDs
+{
+    if (data.length < sizeof(HoneywellJournalFileHeader)) {
+        return;
+    }
+    
+    HoneywellJournalFileHeader fileHeader;
+    memcpy(&fileHeader, data.bytes, sizeof(fileHeader));
+    if (fileHeader.magic != kJournalFileMagic || fileHeader.version != kJournalVersion) {
+        NSLog(@"Job journal %@ has an unknown format, starting empty", _path);
+        return;
+    }
+    generation = fileHeader.generation;
+    _lastJobID = (NSUInteger)fileHeader.lastJobID;
+    
+    const uint8_t * bytes = data.bytes;
+    size_t length = data.length;
+    size_t offset = sizeof(fileHeader);
+    
+    NSMutableDictionary * enqueuedPayloads = [[NSMutableDictionary alloc] init];
+    NSMutableArray * order = [[NSMutableArray alloc] init];
+    NSMutableSet * finished = [[NSMutableSet alloc] init];
+    
+    while (offset + sizeof(HoneywellJournalRecordHeader) <= length) {
+        
+        HoneywellJournalRecordHeader header;
+        memcpy(&header, bytes + offset, sizeof(header));
+        
+        if (header.magic != kJournalRecordMagic || header.generation != generation) {
+            break;
+        }
+        if (header.payloadLength > length - offset - sizeof(header)) {
+            break;
+        }
+        
+        const uint8_t * payload = bytes + offset + sizeof(header);
+        if (recordChecksum(&header, payload) != header.checksum) {
+            break;
+        }
+        
+        NSNumber * jobID = @(header.jobID);
+        _lastJobID = MAX(_lastJobID, (NSUInteger)header.jobID);
+        
+        switch (header.type) {
+            
+            case HONEYWELL_JOURNAL_ENQUEUED:
+                if (enqueuedPayloads[jobID] == nil) {
+                    enqueuedPayloads[jobID] = [NSData dataWithBytes:payload length:header.payloadLength];
+                    [order addObject:jobID];
+                }
+                break;
+            
+            /* a label sent but never acknowledged is printed again, it may
+               have come out before the kill */
+            case HONEYWELL_JOURNAL_SENT:
+                break;
+            
+            case HONEYWELL_JOURNAL_ACKNOWLEDGED:
+            case HONEYWELL_JOURNAL_FAILED:
+                [finished addObject:jobID];
+                break;
+            
+            default:
+                break;
+        }
+        
+        offset += recordLength(header.payloadLength);
+    }
+    
+    for (NSNumber * jobID in order) {
+        if (![finished containsObject:jobID]) {
+            [payloads addObject:enqueuedPayloads[jobID]];
+            [jobIDs addObject:jobID];
+        }
+    }
+}
+
+-(HoneywellPrintJob *)jobFromPayload:(NSData *)payload jobID:(NSUInteger)jobID
+{
+    NSDictionary * entry = [NSJSONSerialization JSONObjectWithData:payload options:0 error:nil];
+    if (![entry isKindOfClass:[NSDictionary class]] || ![entry[@"record"] isKindOfClass:[NSDictionary class]]) {
+        return nil;
+    }
+    
+    HoneywellPrintJob * job = [HoneywellPrintJob jobWithRecord:entry[@"record"]
+                                                  templateType:[entry[@"template"] integerValue]
+                                                        copies:MAX([entry[@"copies"] unsignedIntegerValue], (NSUInteger)1)];
+    job.jobID = jobID;
+    job.priority = [entry[@"priority"] integerValue];
+    return job;
+}
+
+#pragma mark appending
+
+-(void)appendRecordType:(HoneywellJournalEntryType)type jobID:(NSUInteger)jobID payload:(NSData *)payload toData:(NSMutableData *)data
+{
+    NSUInteger start = data.length;
+    [data increaseLengthBy:recordLength(payload.length)];
+    [self writeRecordType:type jobID:jobID payload:payload at:(uint8_t *)data.mutableBytes + start];
+}
+
+-(void)writeRecordType:(HoneywellJournalEntryType)type jobID:(NSUInteger)jobID payload:(NSData *)payload at:(uint8_t *)destination
+{
+    HoneywellJournalRecordHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = kJournalRecordMagic;
+    header.generation = generation;
+    header.type = (uint16_t)type;
+    header.jobID = jobID;
+    header.payloadLength = (uint32_t)payload.length;
+    header.checksum = recordChecksum(&header, payload.bytes);
+    
+    memcpy(destination, &header, sizeof(header));
+    if (payload.length > 0) {
+        memcpy(destination + sizeof(header), payload.bytes, payload.length);
+    }
+}
+
+-(void)appendEnqueuedJob:(HoneywellPrintJob *)job
+{
+    NSDictionary * entry = @{ @"record" : job.record ?: @{},
+                              @"template" : @(job.templateType),
+                              @"copies" : @(job.copies),
+                              @"priority" : @(job.priority) };
+    
+    if (![NSJSONSerialization isValidJSONObject:entry]) {
+        NSLog(@"Label %lu can not be journaled", (unsigned long)job.jobID);
+        return;
+    }
+    
+    NSData * payload = [NSJSONSerialization dataWithJSONObject:entry options:0 error:nil];
+    [self appendRecordType:HONEYWELL_JOURNAL_ENQUEUED jobID:job.jobID payload:payload];
+}
+
+-(void)appendEntry:(HoneywellJournalEntryType)type forJobID:(NSUInteger)jobID
+{
+    [self appendRecordType:type jobID:jobID payload:nil];
+}
+
+-(void)appendRecordType:(HoneywellJournalEntryType)type jobID:(NSUInteger)jobID payload:(NSData *)payload
+{
+    size_t length = recordLength(payload.length);
+    
+    [lock lock];
+    
+    if (mapping == NULL) {
+        [lock unlock];
+        return;
+    }
+    
+    if (writeOffset + length > capacity) {
+        size_t newCapacity = capacity * 2;
+        while (writeOffset + length > newCapacity) {
+            newCapacity *= 2;
+        }
+        if (![self mapCapacity:newCapacity]) {
+            [lock unlock];
+            return;
+        }
+    }
+    
+    [self writeRecordType:type jobID:jobID payload:payload at:mapping + writeOffset];
+    writeOffset += length;
+    
+    if (type == HONEYWELL_JOURNAL_ENQUEUED) {
+        outstandingJobs++;
+        _lastJobID = MAX(_lastJobID, jobID);
+    }
+    else if ((type == HONEYWELL_JOURNAL_ACKNOWLEDGED || type == HONEYWELL_JOURNAL_FAILED) && outstandingJobs > 0) {
+        outstandingJobs--;
+        if (outstandingJobs == 0 && writeOffset > kJournalResetThreshold) {
+            [self resetLocked];
+        }
+    }
+    
+    [lock unlock];
+}
+
+/* nothing is outstanding, start over under a new generation so the old
+   records are ignored. Flushed right away, new records must never reach the
+   disk before the header that makes them valid. */
+-(void)resetLocked
+{
+    generation++;
+    HoneywellJournalFileHeader fileHeader = { kJournalFileMagic, kJournalVersion, generation, 0, _lastJobID };
+    memcpy(mapping, &fileHeader, sizeof(fileHeader));
+    
+    writeOffset = sizeof(fileHeader);
+    msync(mapping, (size_t)getpagesize(), MS_SYNC);
+    committedOffset = writeOffset;
+}
+
+/* caller holds the lock or is still opening */
+-(BOOL)mapCapacity:(size_t)newCapacity
+{
+    if (ftruncate(fd, (off_t)newCapacity) != 0) {
+        NSLog(@"Job journal can not grow to %zu bytes: %s", newCapacity, strerror(errno));
+        return NO;
+    }
+    
+    /* dirty pages of the old mapping still reach the file after munmap */
+    [self retireMapping];
+    
+    void * newMapping = mmap(NULL, newCapacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (newMapping == MAP_FAILED) {
+        NSLog(@"Job journal mmap failed: %s", strerror(errno));
+        return NO;
+    }
+    
+    mapping = newMapping;
+    capacity = newCapacity;
+    return YES;
+}
+
+/* caller holds the lock, a commit may still be syncing the mapping */
+-(void)retireMapping
+{
+    if (mapping == NULL) {
+        return;
+    }
+    if (runningCommits > 0) {
+        [retiredMappings addObject:@[ [NSValue valueWithPointer:mapping], @(capacity) ]];
+    } else {
+        munmap(mapping, capacity);
+    }
+    mapping = NULL;
+}
+
+#pragma mark group commit
+
+-(void)setCommitInterval:(NSTimeInterval)commitInterval
+{
+    _commitInterval = commitInterval;
+    if (commitTimer != nil) {
+        [self startCommitTimer];
+    }
+}
+
+-(void)startCommitTimer
+{
+    if (commitTimer != nil) {
+        dispatch_source_cancel(commitTimer);
+    }
+    
+    uint64_t interval = (uint64_t)(_commitInterval * NSEC_PER_SEC);
+    commitTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, commitQueue);
+    dispatch_source_set_timer(commitTimer, dispatch_time(DISPATCH_TIME_NOW, interval), interval, interval / 10);
+    
+    __weak HoneywellJobJournal * weakSelf = self;
+    dispatch_source_set_event_handler(commitTimer, ^{
+        [weakSelf commit];
+    });
+    dispatch_resume(commitTimer);
+}
+
+/* the range is taken under the lock and synced without it, so appends on
+   the I/O thread never wait for the flash */
+-(void)commit
+{
+    [lock lock];
+    
+    if (mapping == NULL || writeOffset <= committedOffset) {
+        [lock unlock];
+        return;
+    }
+    
+    size_t pageSize = (size_t)getpagesize();
+    size_t start = committedOffset & ~(pageSize - 1);
+    size_t end = writeOffset;
+    uint8_t * syncedMapping = mapping;
+    uint32_t syncedGeneration = generation;
+    runningCommits++;
+    
+    [lock unlock];
+    
+    int result = msync(syncedMapping + start, end - start, MS_SYNC);
+    if (result != 0) {
+        NSLog(@"Job journal msync failed: %s", strerror(errno));
+    }
+    
+    [lock lock];
+    
+    runningCommits--;
+    if (runningCommits == 0) {
+        for (NSArray * retired in retiredMappings) {
+            munmap([retired[0] pointerValue], [retired[1] unsignedLongValue]);
+        }
+        [retiredMappings removeAllObjects];
+    }
+    
+    /* a reset meanwhile started over at a lower offset and synced itself */
+    if (result == 0 && generation == syncedGeneration && end > committedOffset) {
+        committedOffset = end;
+    }
+    
+    [lock unlock];
+}
+
+-(void)close
+{
+    if (commitTimer != nil) {
+        dispatch_source_cancel(commitTimer);
+        commitTimer = nil;
+    }
+    
+    [self commit];
+    
+    [lock lock];
+    [self retireMapping];
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+    [lock unlock];
+}
+
+@end
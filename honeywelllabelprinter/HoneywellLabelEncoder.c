@@ -0,0 +1,259 @@
+//
+//  HoneywellLabelEncoder.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#include "HoneywellLabelEncoder.h"
+#include "HoneywellCommandOptimizer.h"
+#include <stdlib.h>
+#include <string.h>
+
+#pragma mark - command templates
+
+/* based on 5.0cm x 3.0cm label print area */
+/* width 400 height 241 */
+static const char kStandardPriceTemplate50x30mm[] =
+    // image
+    "PP 0,190: AN 1: MAG 1,4: PM {^image}: MAG 1,1: "
+    // barcode
+    "BF ON: BF \"Andale Mono\",1: PP 200,75: AN 2: BARSET {#barcodeTypeCode}: BARHEIGHT {#barcodeTypeCode.height}: BARMAG {#barcodeTypeCode.mag}: PB {barcodeInput}: "
+    // multiline text item description
+    /* PX box_height, box_width, box_border_thickness, info */
+    "FT \"Andale Mono\",6: PP 5,35: AN 1: PX 40,400,0,{itemDescription}: "
+    // single line text price
+    "FT \"Swiss 721 Bold Condensed BT\",9: PP 260,0: PT {itemPrice}: "
+    // print feed
+    "PF \r\n";
+
+/* based on 5.0cm x 3.0cm label print area */
+/* width 400 height 241 */
+static const char kFoodLabelTemplate50x30mm[] =
+    // multiline text item description
+    /* PX box_height, box_width, box_border_thickness, info */
+    "FT \"Swiss 721 Bold BT\",8: PP 200,200: AN 2: PX 30,400,0,{itemDescription}: "
+    // divider line below item description
+    /* PL line_width, line_thickness */
+    "PP 0,170: AN 1: PL 400,2: "
+    // barcode
+    "BF ON: BF \"Andale Mono\",1: PP 17,35: AN 1: BARSET {#barcodeTypeCode}: BARHEIGHT {#barcodeTypeCode.height}: BARMAG {#barcodeTypeCode.mag}: PB {barcodeInput}: "
+    // multiline text company detail
+    "FT \"Andale Mono\",6: PP 200,0: AN 2: PX 25,400,0,\"Ritebos Sdn Bhd, Genius Income\": "
+    // divider line top company details
+    "PP 0,25: AN 1: PL 400,2: "
+    // print feed
+    "PF \r\n";
+
+/* based on 3.5cm x 2.5cm label print area */
+/* width 280 height 201 */
+static const char kStandardPriceTemplate35x25mm[] =
+    // image
+    "PP 0,150: AN 1: MAG 1,4: PM {^image}: MAG 1,1: "
+    // barcode
+    "BF ON: BF \"Andale Mono\",1: PP 140,50: AN 2: BARSET {#barcode}: BARHEIGHT {#barcode.height}: BARMAG {#barcode.mag}: PB {input}: "
+    // multiline text item description
+    /* PX box_height, box_width, box_border_thickness, info */
+    "FT \"Andale Mono\",6: PP 5,15: AN 1: PX 40,170,0,\"A&W Rootbeer Orange-Berry Flavour 250ml\": "
+    // single line text price
+    "FT \"Swiss 721 Bold Condensed BT\",9: PP 160,20: PT \"RM28000.50\": "
+    // print feed
+    "PF \r\n";
+
+static const char kSettingCommands[] = "SYSVAR(18)=-1 \r\n";
+
+static const HoneywellLabelLayout layouts[] = {
+    { HONEYWELL_LABEL_STANDARD_PRICE, "PRICE50.LAY", 400, 241, kStandardPriceTemplate50x30mm },
+    { HONEYWELL_LABEL_FOOD_INFO, "FOOD50.LAY", 400, 241, kFoodLabelTemplate50x30mm },
+    { HONEYWELL_LABEL_DEFAULT_SIZE, "PRICE35.LAY", 280, 201, kStandardPriceTemplate35x25mm }
+};
+
+#define LAYOUT_COUNT (sizeof(layouts) / sizeof(layouts[0]))
+
+const HoneywellLabelLayout * HoneywellLabelLayoutForType(int type)
+{
+    for (size_t i = 0; i < LAYOUT_COUNT; i++) {
+        if ((int)layouts[i].type == type) {
+            return &layouts[i];
+        }
+    }
+    return NULL;
+}
+
+#pragma mark - encoder
+
+struct HoneywellLabelEncoder {
+    HoneywellLabelTemplate * templates[HONEYWELL_LABEL_TYPE_COUNT];
+    HoneywellLabelTemplate * settingCommands;
+    int useStoredLayouts;
+    
+    /* values records fall back to, the default image */
+    char * defaultImageName;
+    HoneywellRecordField defaultFields[1];
+    HoneywellRecord defaults;
+    
+    /* per connection */
+    HoneywellPrinterState state;
+    int storedLayouts[HONEYWELL_LABEL_TYPE_COUNT];
+    int formatSent;
+};
+
+static HoneywellLabelTemplate * compileLayout(const HoneywellLabelLayout * layout)
+{
+    HoneywellByteBuffer optimized = { 0 };
+    if (HoneywellOptimizeCommands(layout->source, strlen(layout->source), &optimized) != 0) {
+        HoneywellByteBufferDestroy(&optimized);
+        return NULL;
+    }
+    
+    HoneywellLabelTemplate * labelTemplate = HoneywellLabelTemplateCreate((const char *)optimized.bytes, optimized.length, layout->layoutName);
+    HoneywellByteBufferDestroy(&optimized);
+    return labelTemplate;
+}
+
+HoneywellLabelEncoder * HoneywellLabelEncoderCreate(void)
+{
+    HoneywellLabelEncoder * encoder = calloc(1, sizeof(HoneywellLabelEncoder));
+    if (encoder == NULL) {
+        return NULL;
+    }
+    encoder->useStoredLayouts = 1;
+    encoder->defaults.fields = encoder->defaultFields;
+    if (HoneywellLabelEncoderSetDefaultImage(encoder, HONEYWELL_DEFAULT_IMAGE_NAME) != 0) {
+        HoneywellLabelEncoderDestroy(encoder);
+        return NULL;
+    }
+    
+    encoder->settingCommands = HoneywellLabelTemplateCreate(kSettingCommands, sizeof(kSettingCommands) - 1, NULL);
+    if (encoder->settingCommands == NULL) {
+        HoneywellLabelEncoderDestroy(encoder);
+        return NULL;
+    }
+    
+    for (size_t i = 0; i < LAYOUT_COUNT; i++) {
+        encoder->templates[layouts[i].type] = compileLayout(&layouts[i]);
+        if (encoder->templates[layouts[i].type] == NULL) {
+            HoneywellLabelEncoderDestroy(encoder);
+            return NULL;
+        }
+    }
+    return encoder;
+}
+
+void HoneywellLabelEncoderDestroy(HoneywellLabelEncoder * encoder)
+{
+    if (encoder == NULL) {
+        return;
+    }
+    for (int type = 0; type < HONEYWELL_LABEL_TYPE_COUNT; type++) {
+        HoneywellLabelTemplateDestroy(encoder->templates[type]);
+    }
+    HoneywellLabelTemplateDestroy(encoder->settingCommands);
+    free(encoder->defaultImageName);
+    free(encoder);
+}
+
+void HoneywellLabelEncoderSetUseStoredLayouts(HoneywellLabelEncoder * encoder, int useStoredLayouts)
+{
+    encoder->useStoredLayouts = useStoredLayouts;
+}
+
+int HoneywellLabelEncoderSetDefaultImage(HoneywellLabelEncoder * encoder, const char * imageName)
+{
+    char * copy = NULL;
+    if (imageName != NULL) {
+        size_t length = strlen(imageName) + 1;
+        copy = malloc(length);
+        if (copy == NULL) {
+            return -1;
+        }
+        memcpy(copy, imageName, length);
+    }
+    
+    free(encoder->defaultImageName);
+    encoder->defaultImageName = copy;
+    encoder->defaultFields[0].key = HONEYWELL_IMAGE_RECORD_KEY;
+    encoder->defaultFields[0].value = copy;
+    encoder->defaults.count = (copy != NULL) ? 1 : 0;
+    return 0;
+}
+
+HoneywellRecord HoneywellLabelEncoderRecordWithDefaults(const HoneywellLabelEncoder * encoder, const HoneywellRecord * record)
+{
+    HoneywellRecord withDefaults = { NULL, 0, &encoder->defaults };
+    if (record != NULL) {
+        withDefaults = *record;
+        /* a record bringing its own defaults keeps them */
+        if (withDefaults.defaults == NULL) {
+            withDefaults.defaults = &encoder->defaults;
+        }
+    }
+    return withDefaults;
+}
+
+void HoneywellLabelEncoderReset(HoneywellLabelEncoder * encoder)
+{
+    /* stored layouts and printer state do not survive a new connection */
+    HoneywellPrinterStateReset(&encoder->state);
+    memset(encoder->storedLayouts, 0, sizeof(encoder->storedLayouts));
+    encoder->formatSent = 0;
+}
+
+const HoneywellLabelTemplate * HoneywellLabelEncoderTemplate(const HoneywellLabelEncoder * encoder, int type)
+{
+    if (type < 0 || type >= HONEYWELL_LABEL_TYPE_COUNT) {
+        return NULL;
+    }
+    return encoder->templates[type];
+}
+
+int HoneywellLabelEncoderAppendLabel(HoneywellLabelEncoder * encoder, int type, const HoneywellRecord * record, unsigned copies, HoneywellByteBuffer * buffer)
+{
+    const HoneywellLabelTemplate * labelTemplate = HoneywellLabelEncoderTemplate(encoder, type);
+    if (labelTemplate == NULL) {
+        return -1;
+    }
+    
+    /* the label is encoded against a copy of the connection state, which is
+       only taken over once all of it is in the buffer. A label that fails
+       leaves no bytes behind and no layout believed stored that never was. */
+    HoneywellRecord values = HoneywellLabelEncoderRecordWithDefaults(encoder, record);
+    size_t start = buffer->length;
+    HoneywellPrinterState state = encoder->state;
+    int storesLayout = encoder->useStoredLayouts && !encoder->storedLayouts[type];
+    int sendsInline = 1;
+    
+    if (HoneywellLabelTemplateRender(encoder->settingCommands, NULL, 1, &state, buffer) != 0) {
+        return -1;
+    }
+    
+    if (storesLayout) {
+        if ((!encoder->formatSent && HoneywellByteBufferAppendString(buffer, HoneywellLayoutInputFormatCommand) != 0) ||
+            HoneywellLabelTemplateAppendLayoutDefinition(labelTemplate, buffer) != 0) {
+            buffer->length = start;
+            return -1;
+        }
+    }
+    
+    if (encoder->useStoredLayouts) {
+        int result = HoneywellLabelTemplateRenderRecord(labelTemplate, &values, copies, &state, buffer);
+        if (result < 0) {
+            buffer->length = start;
+            return -1;
+        }
+        sendsInline = result > 0;
+    }
+    
+    if (sendsInline && HoneywellLabelTemplateRender(labelTemplate, &values, copies, &state, buffer) != 0) {
+        buffer->length = start;
+        return -1;
+    }
+    
+    encoder->state = state;
+    if (storesLayout) {
+        encoder->formatSent = 1;
+        encoder->storedLayouts[type] = 1;
+    }
+    return 0;
+}
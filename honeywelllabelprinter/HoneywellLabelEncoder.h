@@ -0,0 +1,83 @@
+//
+//  HoneywellLabelEncoder.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#ifndef HoneywellLabelEncoder_h
+#define HoneywellLabelEncoder_h
+
+#include <stdint.h>
+#include "HoneywellLabelTemplate.h"
+
+/*
+
+ The label layouts the app prints and the per connection encoder turning a
+ record into Direct Protocol for one of them. Everything needed to drive a
+ PC42t from a record lives here, so the app and the print gateway daemon
+ send the same bytes.
+
+ Each layout is run through HoneywellOptimizeCommands and compiled once.
+ Per connection the encoder remembers which layouts it stored on the
+ printer and shadows the printer's state, so a label only carries what
+ changed. Reset it whenever the connection is reopened.
+
+ */
+
+// values match LabelTemplateType
+typedef enum {
+    HONEYWELL_LABEL_STANDARD_PRICE = 0,
+    HONEYWELL_LABEL_FOOD_INFO,
+    HONEYWELL_LABEL_OTHER,
+    HONEYWELL_LABEL_DEFAULT_SIZE,
+    HONEYWELL_LABEL_TYPE_COUNT
+} HoneywellLabelType;
+
+typedef struct {
+    HoneywellLabelType type;
+    const char * layoutName;
+    // label size in dots the layout is drawn for
+    uint32_t width;
+    uint32_t height;
+    const char * source;
+} HoneywellLabelLayout;
+
+// NULL for a type without a layout, e.g. OTHER_LABEL
+const HoneywellLabelLayout * HoneywellLabelLayoutForType(int type);
+
+typedef struct HoneywellLabelEncoder HoneywellLabelEncoder;
+
+// the record key naming a label's image, and the image a label without one shows
+#define HONEYWELL_IMAGE_RECORD_KEY "image"
+#define HONEYWELL_DEFAULT_IMAGE_NAME "1bitleaf"
+
+// NULL if out of memory
+HoneywellLabelEncoder * HoneywellLabelEncoderCreate(void);
+void HoneywellLabelEncoderDestroy(HoneywellLabelEncoder * encoder);
+
+/* upload each layout once per connection with LAYOUT INPUT and send only
+   the LAYOUT RUN record per label, defaults to 1 */
+void HoneywellLabelEncoderSetUseStoredLayouts(HoneywellLabelEncoder * encoder, int useStoredLayouts);
+
+/* the image for records that name none, NULL for none. Defaults to
+   HONEYWELL_DEFAULT_IMAGE_NAME, returns -1 if out of memory. */
+int HoneywellLabelEncoderSetDefaultImage(HoneywellLabelEncoder * encoder, const char * imageName);
+
+/* record as the encoder prints it, with the encoder's defaults behind its
+   own values. Valid as long as record and the encoder's settings are. */
+HoneywellRecord HoneywellLabelEncoderRecordWithDefaults(const HoneywellLabelEncoder * encoder, const HoneywellRecord * record);
+
+// a new connection, nothing is stored on the printer and its state is unknown
+void HoneywellLabelEncoderReset(HoneywellLabelEncoder * encoder);
+
+// the compiled layout, NULL for a type without one
+const HoneywellLabelTemplate * HoneywellLabelEncoderTemplate(const HoneywellLabelEncoder * encoder, int type);
+
+/* appends the settings the labels rely on, unless the printer has them,
+   and one label with copies, filled in from the record with defaults. Returns -1 for a type without a layout or
+   when memory runs out, with buffer and the encoder as they were. */
+int HoneywellLabelEncoderAppendLabel(HoneywellLabelEncoder * encoder, int type, const HoneywellRecord * record, unsigned copies, HoneywellByteBuffer * buffer);
+
+#endif /* HoneywellLabelEncoder_h */
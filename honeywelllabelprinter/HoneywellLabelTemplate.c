@@ -0,0 +1,624 @@
+//
+//  HoneywellLabelTemplate.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#include "HoneywellLabelTemplate.h"
+#include "HoneywellSymbology.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* room for a PF n statement or record suffix replacing the single PF */
+#define FEED_COMMAND_CAPACITY 40
+
+typedef enum {
+    HONEYWELL_SEGMENT_PLAIN = 0,
+    HONEYWELL_SEGMENT_SET_STATE,
+    HONEYWELL_SEGMENT_INVALIDATE_STATE,
+    HONEYWELL_SEGMENT_PRINT_FEED
+} HoneywellSegmentAction;
+
+/* static bytes to copy, followed by the slot to render (-1 for none) */
+typedef struct {
+    size_t offset;
+    size_t length;
+    long slot;
+    long state;
+    HoneywellSegmentAction action;
+} HoneywellTemplateSegment;
+
+/* what a state statement sets, the value points into the template's strings */
+typedef struct {
+    char key[HONEYWELL_STATE_KEY_CAPACITY];
+    size_t valueOffset;
+    size_t valueLength;
+} HoneywellTemplateState;
+
+typedef struct {
+    size_t keyOffset;
+    HoneywellTemplateSlotType type;
+} HoneywellTemplateSlot;
+
+struct HoneywellLabelTemplate {
+    HoneywellByteBuffer staticBytes;
+    HoneywellByteBuffer segments;
+    HoneywellByteBuffer slots;
+    HoneywellByteBuffer states;
+    
+    /* slot keys and state values, each NUL terminated */
+    HoneywellByteBuffer strings;
+    
+    HoneywellByteBuffer layoutBody;
+    HoneywellByteBuffer recordPrefix;
+    char * layoutName;
+};
+
+const char HoneywellLayoutInputFormatCommand[] = "INPUT OFF\r\nFORMAT INPUT \"#\",\"@\",\"|\"\r\n";
+
+static const char recordSuffix[] = "@\r\nPF\r\nINPUT OFF\r\n";
+
+const char * HoneywellRecordValue(const HoneywellRecord * record, const char * key)
+{
+    for (; record != NULL; record = record->defaults) {
+        for (size_t i = 0; i < record->count; i++) {
+            if (strcmp(record->fields[i].key, key) == 0) {
+                return record->fields[i].value;
+            }
+        }
+    }
+    return NULL;
+}
+
+#pragma mark - statement parsing
+
+size_t HoneywellNextStatement(const char * source, size_t length)
+{
+    size_t i = 0;
+    int inQuotes = 0;
+    int inSlot = 0;
+    
+    while (i < length) {
+        
+        char c = source[i++];
+        
+        if (inSlot) {
+            inSlot = (c != '}');
+            continue;
+        }
+        if (c == '"') {
+            inQuotes = !inQuotes;
+            continue;
+        }
+        if (inQuotes) {
+            continue;
+        }
+        if (c == '{') {
+            inSlot = 1;
+            continue;
+        }
+        
+        if (c == ':' || c == '\r' || c == '\n') {
+            while (i < length && (source[i] == ' ' || source[i] == '\r' || source[i] == '\n')) {
+                i++;
+            }
+            return i;
+        }
+    }
+    return length;
+}
+
+static int isSeparator(char c)
+{
+    return c == ':' || c == ' ' || c == '\r' || c == '\n';
+}
+
+void HoneywellParseStatement(const char * statement, size_t length, char command[HONEYWELL_COMMAND_CAPACITY], const char ** argument, size_t * argumentLength)
+{
+    const char * text = statement;
+    while (length > 0 && isSeparator(*text)) {
+        text++;
+        length--;
+    }
+    while (length > 0 && isSeparator(text[length - 1])) {
+        length--;
+    }
+    
+    size_t commandLength = 0;
+    while (commandLength < length && text[commandLength] != ' ' && text[commandLength] != '=') {
+        commandLength++;
+    }
+    
+    if (commandLength < HONEYWELL_COMMAND_CAPACITY) {
+        for (size_t i = 0; i < commandLength; i++) {
+            char c = text[i];
+            command[i] = (c >= 'a' && c <= 'z') ? c - ('a' - 'A') : c;
+        }
+        command[commandLength] = '\0';
+    } else {
+        command[0] = '\0';
+    }
+    
+    if (commandLength == length) {
+        *argument = text + length;
+        *argumentLength = 0;
+        return;
+    }
+    
+    const char * rest = text + commandLength + 1;
+    size_t restLength = length - commandLength - 1;
+    while (restLength > 0 && (*rest == ' ' || *rest == '\t')) {
+        rest++;
+        restLength--;
+    }
+    while (restLength > 0 && (rest[restLength - 1] == ' ' || rest[restLength - 1] == '\t')) {
+        restLength--;
+    }
+    *argument = rest;
+    *argumentLength = restLength;
+}
+
+#pragma mark - compiler
+
+static int appendString(HoneywellByteBuffer * strings, const char * bytes, size_t length, size_t * offset)
+{
+    *offset = strings->length;
+    if (HoneywellByteBufferReserve(strings, length + 1) != 0) {
+        return -1;
+    }
+    memcpy(strings->bytes + strings->length, bytes, length);
+    strings->bytes[strings->length + length] = '\0';
+    strings->length += length + 1;
+    return 0;
+}
+
+static int hasSuffix(const char * text, size_t length, const char * suffix)
+{
+    size_t suffixLength = strlen(suffix);
+    return length > suffixLength && memcmp(text + length - suffixLength, suffix, suffixLength) == 0;
+}
+
+static int isNumericSlot(HoneywellTemplateSlotType type)
+{
+    return type == HONEYWELL_SLOT_BAR_HEIGHT || type == HONEYWELL_SLOT_BAR_MAG;
+}
+
+/* one statement becomes one segment per slot plus a trailing segment, the
+   statement's action is carried by its first segment */
+static int compileStatement(HoneywellLabelTemplate * labelTemplate, const char * statement, size_t statementLength, HoneywellSegmentAction action, long state)
+{
+    size_t position = 0;
+    int firstSegment = 1;
+    
+    while (position <= statementLength) {
+        
+        const char * slotStart = memchr(statement + position, '{', statementLength - position);
+        const char * slotEnd = NULL;
+        if (slotStart != NULL) {
+            slotEnd = memchr(slotStart + 1, '}', statement + statementLength - (slotStart + 1));
+        }
+        
+        size_t literalEnd = (slotEnd == NULL) ? statementLength : (size_t)(slotStart - statement);
+        
+        HoneywellTemplateSegment segment;
+        segment.offset = labelTemplate->staticBytes.length;
+        segment.length = literalEnd - position;
+        segment.slot = -1;
+        segment.state = firstSegment ? state : -1;
+        segment.action = firstSegment ? action : HONEYWELL_SEGMENT_PLAIN;
+        if (HoneywellByteBufferAppend(&labelTemplate->staticBytes, statement + position, segment.length) != 0 ||
+            HoneywellByteBufferAppend(&labelTemplate->layoutBody, statement + position, segment.length) != 0) {
+            return -1;
+        }
+        firstSegment = 0;
+        
+        if (slotEnd != NULL) {
+            const char * key = slotStart + 1;
+            HoneywellTemplateSlot slot = { 0, HONEYWELL_SLOT_TEXT };
+            
+            if (*key == '^') {
+                key++;
+                slot.type = HONEYWELL_SLOT_UPPERCASE_TEXT;
+            } else if (*key == '#') {
+                key++;
+                slot.type = HONEYWELL_SLOT_SYMBOLOGY;
+            }
+            
+            /* {#key.height} and {#key.mag} print a number of the key's symbology */
+            size_t keyLength = slotEnd - key;
+            if (slot.type == HONEYWELL_SLOT_SYMBOLOGY) {
+                if (hasSuffix(key, keyLength, ".height")) {
+                    slot.type = HONEYWELL_SLOT_BAR_HEIGHT;
+                    keyLength -= strlen(".height");
+                } else if (hasSuffix(key, keyLength, ".mag")) {
+                    slot.type = HONEYWELL_SLOT_BAR_MAG;
+                    keyLength -= strlen(".mag");
+                }
+            }
+            
+            segment.slot = (long)HoneywellLabelTemplateSlotCount(labelTemplate);
+            
+            char variable[32];
+            int variableLength = snprintf(variable, sizeof(variable), isNumericSlot(slot.type) ? "VAL(VAR%ld$)" : "VAR%ld$", segment.slot + 1);
+            if (appendString(&labelTemplate->strings, key, keyLength, &slot.keyOffset) != 0 ||
+                HoneywellByteBufferAppend(&labelTemplate->slots, &slot, sizeof(slot)) != 0 ||
+                HoneywellByteBufferAppend(&labelTemplate->layoutBody, variable, variableLength) != 0) {
+                return -1;
+            }
+        }
+        
+        if (HoneywellByteBufferAppend(&labelTemplate->segments, &segment, sizeof(segment)) != 0) {
+            return -1;
+        }
+        
+        if (slotEnd == NULL) {
+            break;
+        }
+        position = slotEnd + 1 - statement;
+    }
+    return 0;
+}
+
+static int isCommand(const char * command, const char * name)
+{
+    return strcmp(command, name) == 0;
+}
+
+static int compile(HoneywellLabelTemplate * labelTemplate, const char * source, size_t length)
+{
+    size_t position = 0;
+    
+    while (position < length) {
+        
+        const char * statement = source + position;
+        size_t statementLength = HoneywellNextStatement(statement, length - position);
+        position += statementLength;
+        
+        char command[HONEYWELL_COMMAND_CAPACITY];
+        const char * argument;
+        size_t argumentLength;
+        HoneywellParseStatement(statement, statementLength, command, &argument, &argumentLength);
+        
+        int hasSlot = memchr(statement, '{', statementLength) != NULL;
+        HoneywellTemplateState state;
+        memset(&state, 0, sizeof(state));
+        
+        HoneywellSegmentAction action = HONEYWELL_SEGMENT_PLAIN;
+        long stateIndex = -1;
+        
+        if (isCommand(command, "PF") || isCommand(command, "PRINTFEED")) {
+            action = HONEYWELL_SEGMENT_PRINT_FEED;
+        } else if (HoneywellStateKeyForCommand(command, argument, argumentLength, state.key) == 0) {
+            action = hasSlot ? HONEYWELL_SEGMENT_INVALIDATE_STATE : HONEYWELL_SEGMENT_SET_STATE;
+            stateIndex = (long)(labelTemplate->states.length / sizeof(HoneywellTemplateState));
+            state.valueLength = argumentLength;
+            if (appendString(&labelTemplate->strings, argument, argumentLength, &state.valueOffset) != 0 ||
+                HoneywellByteBufferAppend(&labelTemplate->states, &state, sizeof(state)) != 0) {
+                return -1;
+            }
+        }
+        
+        if (compileStatement(labelTemplate, statement, statementLength, action, stateIndex) != 0) {
+            return -1;
+        }
+    }
+    
+    /* a stored layout ends before the print feed, PF is sent with each record */
+    HoneywellByteBuffer * body = &labelTemplate->layoutBody;
+    size_t start = 0;
+    for (int pass = 0; pass < 2; pass++) {
+        while (start < body->length && isSeparator((char)body->bytes[start])) {
+            start++;
+        }
+        while (body->length > start && isSeparator((char)body->bytes[body->length - 1])) {
+            body->length--;
+        }
+        if (pass == 0 && body->length - start >= 2 && memcmp(body->bytes + body->length - 2, "PF", 2) == 0) {
+            body->length -= 2;
+        } else {
+            break;
+        }
+    }
+    memmove(body->bytes, body->bytes + start, body->length - start);
+    body->length -= start;
+    return 0;
+}
+
+HoneywellLabelTemplate * HoneywellLabelTemplateCreate(const char * source, size_t length, const char * layoutName)
+{
+    HoneywellLabelTemplate * labelTemplate = calloc(1, sizeof(HoneywellLabelTemplate));
+    if (labelTemplate == NULL) {
+        return NULL;
+    }
+    
+    if (layoutName != NULL) {
+        size_t nameLength = strlen(layoutName);
+        labelTemplate->layoutName = malloc(nameLength + 1);
+        if (labelTemplate->layoutName != NULL) {
+            memcpy(labelTemplate->layoutName, layoutName, nameLength + 1);
+        }
+        if (labelTemplate->layoutName == NULL ||
+            HoneywellByteBufferAppendString(&labelTemplate->recordPrefix, "INPUT ON\r\nLAYOUT RUN \"") != 0 ||
+            HoneywellByteBufferAppendString(&labelTemplate->recordPrefix, layoutName) != 0 ||
+            HoneywellByteBufferAppendString(&labelTemplate->recordPrefix, "\"\r\n#") != 0) {
+            HoneywellLabelTemplateDestroy(labelTemplate);
+            return NULL;
+        }
+    }
+    
+    if (compile(labelTemplate, source, length) != 0) {
+        HoneywellLabelTemplateDestroy(labelTemplate);
+        return NULL;
+    }
+    return labelTemplate;
+}
+
+void HoneywellLabelTemplateDestroy(HoneywellLabelTemplate * labelTemplate)
+{
+    if (labelTemplate == NULL) {
+        return;
+    }
+    HoneywellByteBufferDestroy(&labelTemplate->staticBytes);
+    HoneywellByteBufferDestroy(&labelTemplate->segments);
+    HoneywellByteBufferDestroy(&labelTemplate->slots);
+    HoneywellByteBufferDestroy(&labelTemplate->states);
+    HoneywellByteBufferDestroy(&labelTemplate->strings);
+    HoneywellByteBufferDestroy(&labelTemplate->layoutBody);
+    HoneywellByteBufferDestroy(&labelTemplate->recordPrefix);
+    free(labelTemplate->layoutName);
+    free(labelTemplate);
+}
+
+const char * HoneywellLabelTemplateLayoutName(const HoneywellLabelTemplate * labelTemplate)
+{
+    return labelTemplate->layoutName;
+}
+
+size_t HoneywellLabelTemplateSlotCount(const HoneywellLabelTemplate * labelTemplate)
+{
+    return labelTemplate->slots.length / sizeof(HoneywellTemplateSlot);
+}
+
+static const HoneywellTemplateSlot * templateSlot(const HoneywellLabelTemplate * labelTemplate, size_t slot)
+{
+    return (const HoneywellTemplateSlot *)labelTemplate->slots.bytes + slot;
+}
+
+const char * HoneywellLabelTemplateSlotKey(const HoneywellLabelTemplate * labelTemplate, size_t slot)
+{
+    return (const char *)labelTemplate->strings.bytes + templateSlot(labelTemplate, slot)->keyOffset;
+}
+
+int HoneywellLabelTemplateHasSlot(const HoneywellLabelTemplate * labelTemplate, const char * key)
+{
+    for (size_t slot = 0; slot < HoneywellLabelTemplateSlotCount(labelTemplate); slot++) {
+        if (strcmp(HoneywellLabelTemplateSlotKey(labelTemplate, slot), key) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+#pragma mark - renderer
+
+typedef struct {
+    const char * value;
+    size_t length;
+    HoneywellTemplateSlotType type;
+    int quoted;
+    // digits of a numeric slot, value points here
+    char number[12];
+} HoneywellSlotValue;
+
+/* UTF-8 output is never shorter than its ASCII rendering */
+static size_t collectValues(const HoneywellLabelTemplate * labelTemplate, const HoneywellRecord * record, HoneywellSlotValue * values)
+{
+    size_t valueLength = 0;
+    
+    for (size_t slot = 0; slot < HoneywellLabelTemplateSlotCount(labelTemplate); slot++) {
+        
+        const char * value = HoneywellRecordValue(record, HoneywellLabelTemplateSlotKey(labelTemplate, slot));
+        HoneywellTemplateSlotType type = templateSlot(labelTemplate, slot)->type;
+        values[slot].quoted = 1;
+        
+        if (value != NULL && type == HONEYWELL_SLOT_SYMBOLOGY) {
+            int symbology = HoneywellSymbologyForValue(value);
+            if (symbology >= 0) {
+                value = HoneywellSymbologies[symbology].barsetName;
+                type = HONEYWELL_SLOT_TEXT;
+            } else {
+                type = HONEYWELL_SLOT_UPPERCASE_TEXT;
+            }
+        }
+        else if (isNumericSlot(type)) {
+            int symbology = HoneywellSymbologyForValue(value);
+            unsigned number;
+            if (type == HONEYWELL_SLOT_BAR_HEIGHT) {
+                number = symbology >= 0 ? HoneywellSymbologies[symbology].barHeight : HONEYWELL_DEFAULT_BAR_HEIGHT;
+            } else {
+                number = symbology >= 0 ? HoneywellSymbologies[symbology].barMag : HONEYWELL_DEFAULT_BAR_MAG;
+            }
+            snprintf(values[slot].number, sizeof(values[slot].number), "%u", number);
+            value = values[slot].number;
+            type = HONEYWELL_SLOT_TEXT;
+            values[slot].quoted = 0;
+        }
+        
+        values[slot].value = value != NULL ? value : "";
+        values[slot].length = strlen(values[slot].value);
+        values[slot].type = type;
+        valueLength += values[slot].length;
+    }
+    return valueLength;
+}
+
+static uint8_t * encodeSlotValue(const HoneywellSlotValue * value, uint8_t * out)
+{
+    for (size_t i = 0; i < value->length; i++) {
+        
+        uint8_t c = (uint8_t)value->value[i];
+        
+        /* one '?' per character outside ASCII, at its lead byte */
+        if (c >= 0x80) {
+            if (c >= 0xc0) {
+                *out++ = '?';
+            }
+            continue;
+        }
+        if (value->type == HONEYWELL_SLOT_UPPERCASE_TEXT && c >= 'a' && c <= 'z') {
+            c -= 'a' - 'A';
+        }
+        *out++ = c;
+    }
+    return out;
+}
+
+static const HoneywellTemplateState * templateState(const HoneywellLabelTemplate * labelTemplate, long state, const char ** value)
+{
+    const HoneywellTemplateState * entry = (const HoneywellTemplateState *)labelTemplate->states.bytes + state;
+    *value = (const char *)labelTemplate->strings.bytes + entry->valueOffset;
+    return entry;
+}
+
+int HoneywellLabelTemplateRender(const HoneywellLabelTemplate * labelTemplate, const HoneywellRecord * record, unsigned copies, HoneywellPrinterState * state, HoneywellByteBuffer * buffer)
+{
+    size_t slotCount = HoneywellLabelTemplateSlotCount(labelTemplate);
+    HoneywellSlotValue values[slotCount > 0 ? slotCount : 1];
+    
+    size_t capacity = labelTemplate->staticBytes.length + 2 * slotCount + collectValues(labelTemplate, record, values) + FEED_COMMAND_CAPACITY;
+    if (HoneywellByteBufferReserve(buffer, capacity) != 0) {
+        return -1;
+    }
+    
+    uint8_t * out = buffer->bytes + buffer->length;
+    const uint8_t * in = labelTemplate->staticBytes.bytes;
+    const HoneywellTemplateSegment * segments = (const HoneywellTemplateSegment *)labelTemplate->segments.bytes;
+    size_t segmentCount = labelTemplate->segments.length / sizeof(HoneywellTemplateSegment);
+    
+    for (size_t i = 0; i < segmentCount; i++) {
+        
+        const HoneywellTemplateSegment * segment = &segments[i];
+        const HoneywellTemplateState * stateEntry;
+        const char * value;
+        
+        switch (segment->action) {
+            
+            case HONEYWELL_SEGMENT_SET_STATE:
+                if (state != NULL) {
+                    stateEntry = templateState(labelTemplate, segment->state, &value);
+                    if (HoneywellPrinterStateHasValue(state, stateEntry->key, value, stateEntry->valueLength)) {
+                        continue;
+                    }
+                    HoneywellPrinterStateSetValue(state, stateEntry->key, value, stateEntry->valueLength);
+                }
+                break;
+            
+            case HONEYWELL_SEGMENT_INVALIDATE_STATE:
+                if (state != NULL) {
+                    stateEntry = templateState(labelTemplate, segment->state, &value);
+                    HoneywellPrinterStateInvalidate(state, stateEntry->key);
+                }
+                break;
+            
+            case HONEYWELL_SEGMENT_PRINT_FEED:
+                if (state != NULL) {
+                    HoneywellPrinterStatePrintFeed(state);
+                }
+                if (copies > 1) {
+                    out += snprintf((char *)out, FEED_COMMAND_CAPACITY, "PF %u\r\n", copies);
+                    continue;
+                }
+                break;
+            
+            default:
+                break;
+        }
+        
+        memcpy(out, in + segment->offset, segment->length);
+        out += segment->length;
+        
+        if (segment->slot < 0) {
+            continue;
+        }
+        
+        const HoneywellSlotValue * slotValue = &values[segment->slot];
+        if (slotValue->quoted) {
+            *out++ = '"';
+        }
+        out = encodeSlotValue(slotValue, out);
+        if (slotValue->quoted) {
+            *out++ = '"';
+        }
+    }
+    
+    buffer->length = out - buffer->bytes;
+    return 0;
+}
+
+#pragma mark - stored layout
+
+int HoneywellLabelTemplateAppendLayoutDefinition(const HoneywellLabelTemplate * labelTemplate, HoneywellByteBuffer * buffer)
+{
+    size_t start = buffer->length;
+    
+    if (HoneywellByteBufferAppendString(buffer, "INPUT ON\r\nLAYOUT INPUT \"") != 0 ||
+        HoneywellByteBufferAppendString(buffer, labelTemplate->layoutName != NULL ? labelTemplate->layoutName : "") != 0 ||
+        HoneywellByteBufferAppendString(buffer, "\"\r\n") != 0 ||
+        HoneywellByteBufferAppend(buffer, labelTemplate->layoutBody.bytes, labelTemplate->layoutBody.length) != 0 ||
+        HoneywellByteBufferAppendString(buffer, "\r\nLAYOUT END\r\nINPUT OFF\r\n") != 0) {
+        buffer->length = start;
+        return -1;
+    }
+    return 0;
+}
+
+int HoneywellLabelTemplateRenderRecord(const HoneywellLabelTemplate * labelTemplate, const HoneywellRecord * record, unsigned copies, HoneywellPrinterState * state, HoneywellByteBuffer * buffer)
+{
+    size_t slotCount = HoneywellLabelTemplateSlotCount(labelTemplate);
+    HoneywellSlotValue values[slotCount > 0 ? slotCount : 1];
+    
+    const HoneywellByteBuffer * prefix = &labelTemplate->recordPrefix;
+    size_t capacity = prefix->length + sizeof(recordSuffix) + slotCount + collectValues(labelTemplate, record, values) + FEED_COMMAND_CAPACITY;
+    if (HoneywellByteBufferReserve(buffer, capacity) != 0) {
+        return -1;
+    }
+    
+    uint8_t * out = buffer->bytes + buffer->length;
+    
+    memcpy(out, prefix->bytes, prefix->length);
+    out += prefix->length;
+    
+    for (size_t slot = 0; slot < slotCount; slot++) {
+        
+        if (slot > 0) {
+            *out++ = '|';
+        }
+        
+        uint8_t * field = out;
+        out = encodeSlotValue(&values[slot], out);
+        
+        for (uint8_t * c = field; c < out; c++) {
+            if (*c == '#' || *c == '@' || *c == '|' || *c == '\r' || *c == '\n') {
+                return 1;
+            }
+        }
+    }
+    
+    if (copies > 1) {
+        out += snprintf((char *)out, FEED_COMMAND_CAPACITY, "@\r\nPF %u\r\nINPUT OFF\r\n", copies);
+    } else {
+        memcpy(out, recordSuffix, sizeof(recordSuffix) - 1);
+        out += sizeof(recordSuffix) - 1;
+    }
+    
+    /* the stored layout sets its own state and the feed resets it */
+    if (state != NULL) {
+        HoneywellPrinterStatePrintFeed(state);
+    }
+    
+    buffer->length = out - buffer->bytes;
+    return 0;
+}
@@ -0,0 +1,111 @@
+//
+//  HoneywellLabelTemplate.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#ifndef HoneywellLabelTemplate_h
+#define HoneywellLabelTemplate_h
+
+#include <stddef.h>
+#include "HoneywellByteBuffer.h"
+#include "HoneywellPrinterState.h"
+
+/*
+
+ A label layout compiled once into pre-encoded ASCII segments and typed
+ variable slots. Rendering a label is then a single pass of memcpy's into a
+ caller owned buffer instead of rebuilding the Direct Protocol string.
+
+ Template source is plain Direct Protocol with slots written as {key}, where
+ key is the record key of the value to print. {^key} uppercases the value,
+ {#key} prints a HoneywellSymbology number or name as its BARSET name. A
+ slot renders as a quoted string literal, except {#key.height} and
+ {#key.mag}, which print the symbology's barHeight and barMag as numbers,
+ the HONEYWELL_DEFAULT_BAR_ values for a type outside the table, e.g.
+
+    PP 200,75: BARSET {#barcodeTypeCode}: BARHEIGHT {#barcodeTypeCode.height}:
+    BARMAG {#barcodeTypeCode.mag}: PB {barcodeInput}: PF \r\n
+
+ Statements that only set printer state are kept as separate segments. When
+ rendered against a HoneywellPrinterState they are skipped if the printer
+ already has that value.
+
+ A template with a layout name can also be stored on the printer once with
+ LAYOUT INPUT, slots becoming VAR1$..VARn$ in source order, VAL(VARn$) for
+ the numeric ones. Each label is then
+ only a LAYOUT RUN record #field|field|@ followed by PF.
+
+ Values are UTF-8, characters outside ASCII print as '?'. Functions
+ returning int return 0 on success and -1 when memory runs out.
+
+ */
+
+typedef enum {
+    HONEYWELL_SLOT_TEXT = 0,
+    HONEYWELL_SLOT_UPPERCASE_TEXT,
+    HONEYWELL_SLOT_SYMBOLOGY,
+    HONEYWELL_SLOT_BAR_HEIGHT,
+    HONEYWELL_SLOT_BAR_MAG
+} HoneywellTemplateSlotType;
+
+// a label's values, keys are unique
+typedef struct {
+    const char * key;
+    const char * value;
+} HoneywellRecordField;
+
+typedef struct HoneywellRecord {
+    const HoneywellRecordField * fields;
+    size_t count;
+    // values for keys the record has none for, may be NULL
+    const struct HoneywellRecord * defaults;
+} HoneywellRecord;
+
+// NULL if neither the record nor its defaults have such a key
+const char * HoneywellRecordValue(const HoneywellRecord * record, const char * key);
+
+#pragma mark - statements
+
+/* length of the statement at the start of source, including its trailing
+   ":" or line end and the blanks after it. Separators inside quotes or
+   {slots} are ignored. */
+size_t HoneywellNextStatement(const char * source, size_t length);
+
+#define HONEYWELL_COMMAND_CAPACITY 32
+
+/* command is uppercased, e.g. "FT", "SYSVAR(18)", and empty if it does not
+   fit. argument is the trimmed rest, pointing into statement. */
+void HoneywellParseStatement(const char * statement, size_t length, char command[HONEYWELL_COMMAND_CAPACITY], const char ** argument, size_t * argumentLength);
+
+#pragma mark - templates
+
+typedef struct HoneywellLabelTemplate HoneywellLabelTemplate;
+
+// sets the printer's input format for LAYOUT RUN records, once per connection
+extern const char HoneywellLayoutInputFormatCommand[];
+
+// layoutName may be NULL for a template that is never stored, NULL if out of memory
+HoneywellLabelTemplate * HoneywellLabelTemplateCreate(const char * source, size_t length, const char * layoutName);
+void HoneywellLabelTemplateDestroy(HoneywellLabelTemplate * labelTemplate);
+
+const char * HoneywellLabelTemplateLayoutName(const HoneywellLabelTemplate * labelTemplate);
+size_t HoneywellLabelTemplateSlotCount(const HoneywellLabelTemplate * labelTemplate);
+const char * HoneywellLabelTemplateSlotKey(const HoneywellLabelTemplate * labelTemplate, size_t slot);
+int HoneywellLabelTemplateHasSlot(const HoneywellLabelTemplate * labelTemplate, const char * key);
+
+/* appends one encoded label to buffer, missing values render as "". PF is
+   replaced by PF copies and state statements the printer already has are
+   skipped, state may be NULL. */
+int HoneywellLabelTemplateRender(const HoneywellLabelTemplate * labelTemplate, const HoneywellRecord * record, unsigned copies, HoneywellPrinterState * state, HoneywellByteBuffer * buffer);
+
+// LAYOUT INPUT ... LAYOUT END block storing the template under its layout name
+int HoneywellLabelTemplateAppendLayoutDefinition(const HoneywellLabelTemplate * labelTemplate, HoneywellByteBuffer * buffer);
+
+/* appends one LAYOUT RUN record. Returns 1 and leaves buffer untouched if a
+   value contains a record separator and the label must be sent inline. */
+int HoneywellLabelTemplateRenderRecord(const HoneywellLabelTemplate * labelTemplate, const HoneywellRecord * record, unsigned copies, HoneywellPrinterState * state, HoneywellByteBuffer * buffer);
+
+#endif /* HoneywellLabelTemplate_h */
@@ -0,0 +1,47 @@
+//
+//  HoneywellLinePrinterBackend.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "HoneywellPrinterUtilities.h"
+
+@class HoneywellBarcodeRenderer;
+
+/*
+
+ Prints label records on PR2, PR3 and PB series printers through printersdk's
+ ITCLinePrinter. The accessory comes from [ITCExtraSettings retrieveExtraSettings],
+ which the app fills in once it found the printer.
+
+ The SDK blocks on Bluetooth, so every call runs on a serial queue of the
+ backend. Labels are written into the SDK's buffer and sent with one flush
+ per labelsPerFlush labels, and a batch's labels count as printed once their
+ flush returned. A new interactive label is picked up at the next flush.
+
+ A label prints the description in bold, the price and the barcode as a
+ graphic, see HoneywellBarcodeRenderer.h.
+
+ */
+
+@interface HoneywellLinePrinterBackend : NSObject<HoneywellPrinterBackend>
+
+// labels sent with one flush, defaults to 16
+@property (nonatomic) NSUInteger labelsPerFlush;
+
+/* feed to the next label after each one instead of a blank line, for label
+   stock. Every form feed also flushes the SDK buffer. */
+@property (nonatomic) BOOL formFeedAfterEachLabel;
+
+@property (nonatomic, readonly) HoneywellBarcodeRenderer * barcodeRenderer;
+
+// getBytesWritten after the last flush, bytes sent since connecting
+@property (readonly) NSInteger bytesWritten;
+
+// connects on the first label
+-(instancetype)initWithProfilePath:(NSString *)path printerID:(NSString *)printerID;
+
+@end
@@ -0,0 +1,358 @@
+//
+//  HoneywellLinePrinterBackend.m
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import "HoneywellLinePrinterBackend.h"
+#import <printersdk/ITCLinePrinter.h>
+#import <printersdk/ITCLinePrinterException.h>
+#import <printersdk/ITCExtraSettings.h>
+#import "HoneywellPrintJob.h"
+#import "HoneywellBarcodeRenderer.h"
+#include "HoneywellSymbology.h"
+#include <stdatomic.h>
+
+@interface HoneywellLinePrinterBackend()
+{
+    /* written on printQueue, read by the pool from any thread */
+    atomic_size_t queuedBytes;
+    
+    /* everything below is only touched on printQueue */
+    dispatch_queue_t printQueue;
+    NSString * profilePath;
+    ITCLinePrinter * linePrinter;
+    
+    /* jobs not yet written, one lane per priority, then the jobs written
+       into the SDK buffer since the last flush */
+    NSMutableArray * pendingLanes[HONEYWELL_PRINT_PRIORITY_COUNT];
+    NSMutableArray * unflushedJobs;
+    BOOL drainScheduled;
+}
+
+@property (readwrite) NSInteger bytesWritten;
+
+@end
+
+@implementation HoneywellLinePrinterBackend
+
+@synthesize printerHost = _printerHost;
+
+-(instancetype)initWithProfilePath:(NSString *)path printerID:(NSString *)printerID
+{
+    self = [super init];
+    if (self) {
+        _printerHost = [printerID copy];
+        _labelsPerFlush = 16;
+        _barcodeRenderer = [[HoneywellBarcodeRenderer alloc] init];
+        profilePath = [path copy];
+        printQueue = dispatch_queue_create("com.ritebozz.line-printer", DISPATCH_QUEUE_SERIAL);
+        for (NSInteger lane = 0; lane < HONEYWELL_PRINT_PRIORITY_COUNT; lane++) {
+            pendingLanes[lane] = [[NSMutableArray alloc] init];
+        }
+        unflushedJobs = [[NSMutableArray alloc] init];
+        atomic_init(&queuedBytes, 0);
+    }
+    return self;
+}
+
+-(NSUInteger)queuedByteCount
+{
+    return atomic_load(&queuedBytes);
+}
+
+#pragma mark connection
+
+-(BOOL)connect
+{
+    if (linePrinter != nil) {
+        return YES;
+    }
+    
+    /* the SDK retries the Bluetooth connection itself, see BtConnectRetries */
+    @try {
+        linePrinter = [[ITCLinePrinter alloc] init:profilePath printerID:_printerHost extraSettings:[ITCExtraSettings retrieveExtraSettings]];
+        [linePrinter connect];
+    }
+    @catch (ITCLinePrinterException * exception) {
+        NSLog(@"Line printer %@ could not connect: %@", _printerHost, exception.reason);
+        [self disconnect];
+        return NO;
+    }
+    return YES;
+}
+
+-(void)disconnect
+{
+    @try {
+        [linePrinter disconnect];
+        [linePrinter close];
+    }
+    @catch (ITCLinePrinterException * exception) {
+        NSLog(@"Line printer %@ did not close cleanly: %@", _printerHost, exception.reason);
+    }
+    linePrinter = nil;
+}
+
+-(void)closeNetworkConnection
+{
+    dispatch_async(printQueue, ^{
+        [self disconnect];
+        [self failAllJobs];
+    });
+}
+
+#pragma mark job queue
+
+-(void)printBatch:(id<NSFastEnumeration>)records templateType:(LabelTemplateType)type priority:(HoneywellPrintPriority)priority completion:(HoneywellPrintCompletion)completion
+{
+    NSArray * jobs = [HoneywellPrintJob jobsWithRecords:records templateType:type priority:priority transform:nil];
+    if (jobs.count == 0) {
+        if (completion) {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                completion(YES);
+            });
+        }
+        return;
+    }
+    
+    HoneywellPrintJobGroup * group = [[HoneywellPrintJobGroup alloc] initWithJobCount:jobs.count completion:completion];
+    NSTimeInterval now = [NSDate timeIntervalSinceReferenceDate];
+    for (HoneywellPrintJob * job in jobs) {
+        job.group = group;
+        job.enqueueTime = now;
+    }
+    
+    dispatch_async(printQueue, ^{
+        for (HoneywellPrintJob * job in jobs) {
+            [[self laneForJob:job] addObject:job];
+        }
+        [self scheduleDrain];
+    });
+}
+
+-(void)flush
+{
+    dispatch_async(printQueue, ^{
+        [self flushJobs];
+    });
+}
+
+-(NSMutableArray *)laneForJob:(HoneywellPrintJob *)job
+{
+    NSInteger lane = job.priority;
+    if (lane < 0 || lane >= HONEYWELL_PRINT_PRIORITY_COUNT) {
+        lane = PRINT_PRIORITY_NORMAL;
+    }
+    return pendingLanes[lane];
+}
+
+-(HoneywellPrintJob *)dequeuePendingJob
+{
+    for (NSInteger lane = HONEYWELL_PRINT_PRIORITY_COUNT - 1; lane >= 0; lane--) {
+        if (pendingLanes[lane].count > 0) {
+            HoneywellPrintJob * job = pendingLanes[lane][0];
+            [pendingLanes[lane] removeObjectAtIndex:0];
+            return job;
+        }
+    }
+    return nil;
+}
+
+-(BOOL)hasPendingJobs
+{
+    for (NSInteger lane = 0; lane < HONEYWELL_PRINT_PRIORITY_COUNT; lane++) {
+        if (pendingLanes[lane].count > 0) {
+            return YES;
+        }
+    }
+    return NO;
+}
+
+-(void)scheduleDrain
+{
+    if (drainScheduled) {
+        return;
+    }
+    drainScheduled = YES;
+    
+    dispatch_async(printQueue, ^{
+        drainScheduled = NO;
+        [self printNextLabels];
+    });
+}
+
+/* one flush worth of labels per block, so labels queued in the meantime
+   are sorted into their lanes before the next ones are picked */
+-(void)printNextLabels
+{
+    if (![self hasPendingJobs]) {
+        return;
+    }
+    if (![self connect]) {
+        [self failAllJobs];
+        return;
+    }
+    
+    NSUInteger labelsPerFlush = MAX(_labelsPerFlush, 1);
+    
+    while (unflushedJobs.count < labelsPerFlush) {
+        
+        HoneywellPrintJob * job = [self dequeuePendingJob];
+        if (job == nil) {
+            break;
+        }
+        
+        if (job.templateType == OTHER_LABEL) {
+            NSLog(@"Unrecognized Label Type");
+            [job.group jobFinished:NO];
+            continue;
+        }
+        
+        [unflushedJobs addObject:job];
+        if (![self writeJob:job]) {
+            return;
+        }
+    }
+    
+    [self flushJobs];
+    
+    if ([self hasPendingJobs]) {
+        [self scheduleDrain];
+    }
+}
+
+#pragma mark printing
+
+-(BOOL)writeJob:(HoneywellPrintJob *)job
+{
+    @try {
+        for (NSUInteger copy = 0; copy < job.copies; copy++) {
+            [self writeLabel:job.record];
+        }
+    }
+    @catch (ITCLinePrinterException * exception) {
+        [self printerFailed:exception];
+        return NO;
+    }
+    return YES;
+}
+
+/* the record may hold a HoneywellSymbology number, as NSNumber or digits
+   the way the templates read it, or a BARSET name */
+-(HoneywellBarcodeType)barcodeTypeForValue:(id)value
+{
+    if (value == nil) {
+        return HONEYWELL_BARCODE_UNSUPPORTED;
+    }
+    if ([value isKindOfClass:[NSNumber class]]) {
+        return HoneywellBarcodeTypeForSymbology((HoneywellSymbology)[value integerValue]);
+    }
+    
+    const char * name = [value description].UTF8String;
+    int symbology = HoneywellSymbologyForValue(name);
+    return symbology >= 0 ? HoneywellBarcodeTypeForSymbology((HoneywellSymbology)symbology) : HoneywellBarcodeTypeNamed(name);
+}
+
+/* writes a line and returns what it adds to the SDK buffer, the encoded
+   text and a CR LF */
+-(NSUInteger)writeLine:(NSString *)line
+{
+    [linePrinter writeLine:line];
+    return [line lengthOfBytesUsingEncoding:NSUTF8StringEncoding] + 2;
+}
+
+-(void)writeLabel:(NSDictionary *)record
+{
+    NSString * description = [record[HONEYWELLPRT_KEY_ITEM_DESC] description] ?: @"";
+    NSString * price = [record[HONEYWELLPRT_KEY_ITEM_PRICE] description] ?: @"";
+    NSString * barcode = [record[HONEYWELLPRT_KEY_BARCODE_INPUT] description];
+    HoneywellBarcodeType barcodeType = [self barcodeTypeForValue:record[HONEYWELLPRT_KEY_BARCODETYPE_CODE]];
+    
+    NSUInteger byteCount = 0;
+    
+    [linePrinter setBold:YES];
+    byteCount += [self writeLine:description];
+    [linePrinter setBold:NO];
+    byteCount += [self writeLine:price];
+    
+    /* printed as text when the renderer can not draw it */
+    if (barcode.length > 0) {
+        NSUInteger imageBytes = 0;
+        if (barcodeType != HONEYWELL_BARCODE_UNSUPPORTED) {
+            imageBytes = [_barcodeRenderer writeValue:barcode type:barcodeType xOffset:0 toLinePrinter:linePrinter];
+        }
+        byteCount += imageBytes > 0 ? imageBytes : [self writeLine:barcode];
+    }
+    
+    if (_formFeedAfterEachLabel) {
+        [linePrinter formFeed];
+    } else {
+        byteCount += [self writeLine:@""];
+    }
+    
+    atomic_fetch_add(&queuedBytes, byteCount);
+}
+
+/* the last label of the queue is fed out to the tear bar, which flushes too */
+-(void)flushJobs
+{
+    if (unflushedJobs.count == 0 || linePrinter == nil) {
+        return;
+    }
+    
+    @try {
+        if ([self hasPendingJobs] || _formFeedAfterEachLabel) {
+            [linePrinter flush];
+        } else {
+            [linePrinter formFeed];
+        }
+        self.bytesWritten = [linePrinter getBytesWritten];
+    }
+    @catch (ITCLinePrinterException * exception) {
+        [self printerFailed:exception];
+        return;
+    }
+    
+    NSTimeInterval now = [NSDate timeIntervalSinceReferenceDate];
+    for (HoneywellPrintJob * job in unflushedJobs) {
+        job.writeTime = now;
+        job.printTime = now;
+        [job.group jobFinished:YES];
+    }
+    [unflushedJobs removeAllObjects];
+    atomic_store(&queuedBytes, 0);
+}
+
+/* what sat in the SDK buffer is lost, later labels reconnect first */
+-(void)printerFailed:(ITCLinePrinterException *)exception
+{
+    NSLog(@"Line printer %@ failed: %@", _printerHost, exception.reason);
+    
+    for (HoneywellPrintJob * job in unflushedJobs) {
+        [job.group jobFinished:NO];
+    }
+    [unflushedJobs removeAllObjects];
+    atomic_store(&queuedBytes, 0);
+    
+    [self disconnect];
+    [self scheduleDrain];
+}
+
+-(void)failAllJobs
+{
+    for (HoneywellPrintJob * job in unflushedJobs) {
+        [job.group jobFinished:NO];
+    }
+    [unflushedJobs removeAllObjects];
+    atomic_store(&queuedBytes, 0);
+    
+    HoneywellPrintJob * job;
+    while ((job = [self dequeuePendingJob]) != nil) {
+        [job.group jobFinished:NO];
+    }
+}
+
+@end
@@ -0,0 +1,34 @@
+//
+//  HoneywellMockPrinterBackend.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "HoneywellPrinterUtilities.h"
+
+/*
+
+ Backend that prints nothing and remembers every label instead, batched and
+ flushed like a line printer. It only needs Foundation and libdispatch, so
+ pools and queues can be exercised without a printer, also off iOS.
+
+ */
+
+@interface HoneywellMockPrinterBackend : NSObject<HoneywellPrinterBackend>
+
+// labels confirmed with one flush, defaults to 16
+@property (nonatomic) NSUInteger labelsPerFlush;
+
+// every label fails, as if the printer went away
+@property (nonatomic) BOOL failsLabels;
+
+// HoneywellPrintJob per printed label in print order, and the flushes it took
+@property (readonly) NSArray * printedJobs;
+@property (readonly) NSUInteger flushCount;
+
+-(instancetype)initWithPrinterID:(NSString *)printerID;
+
+@end
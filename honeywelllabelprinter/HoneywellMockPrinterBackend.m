@@ -0,0 +1,122 @@
+//
+//  HoneywellMockPrinterBackend.m
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import "HoneywellMockPrinterBackend.h"
+#import "HoneywellPrintJob.h"
+
+@interface HoneywellMockPrinterBackend()
+{
+    /* everything below is only touched on printQueue */
+    dispatch_queue_t printQueue;
+    NSMutableArray * unflushedJobs;
+    NSMutableArray * printed;
+    NSUInteger flushes;
+}
+@end
+
+@implementation HoneywellMockPrinterBackend
+
+@synthesize printerHost = _printerHost;
+// always 0, labels never wait for a socket
+@synthesize queuedByteCount = _queuedByteCount;
+
+-(instancetype)initWithPrinterID:(NSString *)printerID
+{
+    self = [super init];
+    if (self) {
+        _printerHost = [printerID copy];
+        _labelsPerFlush = 16;
+        printQueue = dispatch_queue_create("com.ritebozz.mock-printer", DISPATCH_QUEUE_SERIAL);
+        unflushedJobs = [[NSMutableArray alloc] init];
+        printed = [[NSMutableArray alloc] init];
+    }
+    return self;
+}
+
+-(NSArray *)printedJobs
+{
+    __block NSArray * jobs;
+    dispatch_sync(printQueue, ^{
+        jobs = [printed copy];
+    });
+    return jobs;
+}
+
+-(NSUInteger)flushCount
+{
+    __block NSUInteger count;
+    dispatch_sync(printQueue, ^{
+        count = flushes;
+    });
+    return count;
+}
+
+-(void)printBatch:(id<NSFastEnumeration>)records templateType:(LabelTemplateType)type priority:(HoneywellPrintPriority)priority completion:(HoneywellPrintCompletion)completion
+{
+    NSArray * jobs = [HoneywellPrintJob jobsWithRecords:records templateType:type priority:priority transform:nil];
+    if (jobs.count == 0) {
+        if (completion) {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                completion(YES);
+            });
+        }
+        return;
+    }
+    
+    HoneywellPrintJobGroup * group = [[HoneywellPrintJobGroup alloc] initWithJobCount:jobs.count completion:completion];
+    NSTimeInterval now = [NSDate timeIntervalSinceReferenceDate];
+    for (HoneywellPrintJob * job in jobs) {
+        job.group = group;
+        job.enqueueTime = now;
+    }
+    
+    /* no lanes, a mock printer never has a backlog for a label to overtake */
+    dispatch_async(printQueue, ^{
+        NSUInteger labelsPerFlush = MAX(_labelsPerFlush, 1);
+        for (HoneywellPrintJob * job in jobs) {
+            [unflushedJobs addObject:job];
+            if (unflushedJobs.count >= labelsPerFlush) {
+                [self flushJobs];
+            }
+        }
+        [self flushJobs];
+    });
+}
+
+-(void)flush
+{
+    dispatch_async(printQueue, ^{
+        [self flushJobs];
+    });
+}
+
+-(void)flushJobs
+{
+    if (unflushedJobs.count == 0) {
+        return;
+    }
+    
+    flushes++;
+    NSTimeInterval now = [NSDate timeIntervalSinceReferenceDate];
+    for (HoneywellPrintJob * job in unflushedJobs) {
+        if (!_failsLabels) {
+            job.writeTime = now;
+            job.printTime = now;
+            [printed addObject:job];
+        }
+        [job.group jobFinished:!_failsLabels];
+    }
+    [unflushedJobs removeAllObjects];
+}
+
+// every batch is flushed before its block returns, there is nothing to drop
+-(void)closeNetworkConnection
+{
+}
+
+@end
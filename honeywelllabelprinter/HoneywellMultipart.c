@@ -0,0 +1,223 @@
+//
+//  HoneywellMultipart.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+/* POSIX mmap under -std=c11 on Linux */
+#define _POSIX_C_SOURCE 200809L
+
+#include "HoneywellMultipart.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+typedef struct {
+    const uint8_t * bytes;
+    size_t length;
+    // header strings are allocated, file contents borrowed or mapped
+    void * allocated;
+    size_t mappedLength;
+} HoneywellSegment;
+
+struct HoneywellMultipart {
+    char * boundary;
+    HoneywellSegment * segments;
+    size_t segmentCount;
+    size_t segmentCapacity;
+    uint64_t partsLength;
+    // written after the parts, kept apart so parts can still be appended
+    HoneywellSegment closingBoundary;
+};
+
+static char * formatString(const char * format, const char * a, const char * b, const char * c)
+{
+    int length = snprintf(NULL, 0, format, a, b, c);
+    char * string = length < 0 ? NULL : malloc((size_t)length + 1);
+    if (string != NULL) {
+        snprintf(string, (size_t)length + 1, format, a, b, c);
+    }
+    return string;
+}
+
+HoneywellMultipart * HoneywellMultipartCreate(const char * boundary)
+{
+    HoneywellMultipart * body = calloc(1, sizeof(HoneywellMultipart));
+    if (body == NULL) {
+        return NULL;
+    }
+    
+    /* the delimiter the printer has always been sent, not the -- terminated one */
+    size_t length = strlen(boundary);
+    body->boundary = malloc(length + 1);
+    char * closing = formatString("\r\n--%s\r\n", boundary, "", "");
+    if (body->boundary == NULL || closing == NULL) {
+        free(closing);
+        HoneywellMultipartDestroy(body);
+        return NULL;
+    }
+    memcpy(body->boundary, boundary, length + 1);
+    body->closingBoundary.bytes = (const uint8_t *)closing;
+    body->closingBoundary.length = strlen(closing);
+    body->closingBoundary.allocated = closing;
+    return body;
+}
+
+static void releaseSegment(HoneywellSegment * segment)
+{
+    if (segment->mappedLength > 0) {
+        munmap((void *)segment->bytes, segment->mappedLength);
+    }
+    free(segment->allocated);
+}
+
+void HoneywellMultipartDestroy(HoneywellMultipart * body)
+{
+    if (body == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < body->segmentCount; i++) {
+        releaseSegment(&body->segments[i]);
+    }
+    releaseSegment(&body->closingBoundary);
+    free(body->segments);
+    free(body->boundary);
+    free(body);
+}
+
+#pragma mark - parts
+
+static int appendSegment(HoneywellMultipart * body, HoneywellSegment segment)
+{
+    if (body->segmentCount == body->segmentCapacity) {
+        size_t capacity = body->segmentCapacity ? body->segmentCapacity * 2 : 4;
+        HoneywellSegment * segments = realloc(body->segments, capacity * sizeof(HoneywellSegment));
+        if (segments == NULL) {
+            return -1;
+        }
+        body->segments = segments;
+        body->segmentCapacity = capacity;
+    }
+    body->segments[body->segmentCount++] = segment;
+    body->partsLength += segment.length;
+    return 0;
+}
+
+/* the part header and the contents as two segments, nothing is added on failure */
+static int appendFilePart(HoneywellMultipart * body, const char * name, const char * filename, HoneywellSegment contents)
+{
+    /* same layout the printer's upload form has always been sent */
+    char * header = formatString("\r\n--%s\r\n"
+                                 "Content-Disposition: form-data; name=\"%s\"; filename=\"%s\"\r\n"
+                                 "Content-Type: application/octet-stream\r\n\r\n", body->boundary, name, filename);
+    if (header == NULL) {
+        return -1;
+    }
+    HoneywellSegment headerSegment = { (const uint8_t *)header, strlen(header), header, 0 };
+    
+    if (appendSegment(body, headerSegment) != 0) {
+        free(header);
+        return -1;
+    }
+    if (appendSegment(body, contents) != 0) {
+        body->segmentCount--;
+        body->partsLength -= headerSegment.length;
+        free(header);
+        return -1;
+    }
+    return 0;
+}
+
+int HoneywellMultipartAppendFile(HoneywellMultipart * body, const char * name, const char * filename, const void * bytes, size_t length)
+{
+    HoneywellSegment contents = { bytes, length, NULL, 0 };
+    return appendFilePart(body, name, filename, contents);
+}
+
+int HoneywellMultipartAppendFileAtPath(HoneywellMultipart * body, const char * name, const char * filename, const char * path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        close(fd);
+        return -1;
+    }
+    
+    /* an empty file can not be mapped and needs no bytes */
+    HoneywellSegment contents = { NULL, (size_t)info.st_size, NULL, 0 };
+    if (contents.length > 0) {
+        void * mapped = mmap(NULL, contents.length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            close(fd);
+            return -1;
+        }
+        contents.bytes = mapped;
+        contents.mappedLength = contents.length;
+    }
+    close(fd);
+    
+    if (appendFilePart(body, name, filename, contents) != 0) {
+        releaseSegment(&contents);
+        return -1;
+    }
+    return 0;
+}
+
+uint64_t HoneywellMultipartContentLength(const HoneywellMultipart * body)
+{
+    return body->partsLength + body->closingBoundary.length;
+}
+
+#pragma mark - sending
+
+static const HoneywellSegment * segmentAt(const HoneywellMultipart * body, size_t index)
+{
+    if (index < body->segmentCount) {
+        return &body->segments[index];
+    }
+    return index == body->segmentCount ? &body->closingBoundary : NULL;
+}
+
+const uint8_t * HoneywellMultipartNextChunk(const HoneywellMultipart * body, const HoneywellMultipartCursor * cursor, size_t maxLength, size_t * length)
+{
+    /* skips finished and empty segments */
+    size_t index = cursor->segment;
+    size_t offset = cursor->offset;
+    const HoneywellSegment * segment;
+    while ((segment = segmentAt(body, index)) != NULL && offset >= segment->length) {
+        index++;
+        offset = 0;
+    }
+    
+    if (segment == NULL) {
+        *length = 0;
+        return NULL;
+    }
+    size_t remaining = segment->length - offset;
+    *length = remaining < maxLength ? remaining : maxLength;
+    return segment->bytes + offset;
+}
+
+void HoneywellMultipartAdvance(const HoneywellMultipart * body, HoneywellMultipartCursor * cursor, size_t written)
+{
+    const HoneywellSegment * segment;
+    while (written > 0 && (segment = segmentAt(body, cursor->segment)) != NULL) {
+        size_t remaining = segment->length - cursor->offset;
+        if (written < remaining) {
+            cursor->offset += written;
+            return;
+        }
+        written -= remaining;
+        cursor->segment++;
+        cursor->offset = 0;
+    }
+}
@@ -0,0 +1,55 @@
+//
+//  HoneywellMultipart.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#ifndef HoneywellMultipart_h
+#define HoneywellMultipart_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+
+ multipart/form-data body for the printer's /manage/upload.lp form, kept as
+ a list of segments instead of one buffer: the small part headers, the
+ file contents where they already are, in the caller's memory or mapped
+ from disk, and the closing boundary. Content-Length is the sum of the
+ segment lengths.
+
+ A sender walks the body with a cursor and gets each chunk as a pointer
+ into its segment, so nothing is copied on the way to the socket or the
+ stream. HoneywellMultipartBody wraps this for NSURLSession.
+
+ */
+
+typedef struct HoneywellMultipart HoneywellMultipart;
+
+typedef struct {
+    size_t segment;
+    size_t offset;
+} HoneywellMultipartCursor;
+
+// NULL if out of memory
+HoneywellMultipart * HoneywellMultipartCreate(const char * boundary);
+void HoneywellMultipartDestroy(HoneywellMultipart * body);
+
+// bytes are not copied and have to outlive the body, 0 or -1 if out of memory
+int HoneywellMultipartAppendFile(HoneywellMultipart * body, const char * name, const char * filename, const void * bytes, size_t length);
+
+// maps the file read only until the body is destroyed, -1 if it can not be read
+int HoneywellMultipartAppendFileAtPath(HoneywellMultipart * body, const char * name, const char * filename, const char * path);
+
+uint64_t HoneywellMultipartContentLength(const HoneywellMultipart * body);
+
+/* the body bytes at cursor, at most maxLength and never across a segment,
+   pointing into the segment itself. Returns NULL once everything is sent. */
+const uint8_t * HoneywellMultipartNextChunk(const HoneywellMultipart * body, const HoneywellMultipartCursor * cursor, size_t maxLength, size_t * length);
+
+// moves the cursor past bytes that were written, e.g. after a short write
+void HoneywellMultipartAdvance(const HoneywellMultipart * body, HoneywellMultipartCursor * cursor, size_t written);
+
+#endif /* HoneywellMultipart_h */
@@ -0,0 +1,41 @@
+//
+//  HoneywellMultipartBody.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/*
+
+ multipart/form-data request body that is streamed rather than assembled.
+ The segments live in the C core's HoneywellMultipart: file contents stay
+ in the caller's NSData or are mapped from disk, and a producer on the
+ printer I/O thread writes them in chunks into a bound stream pair whose
+ read end becomes the request's HTTPBodyStream. Content-Length is the sum
+ of the segment lengths, so the body never exists as one buffer. Append
+ every field before the body is applied to a request.
+
+ */
+
+@interface HoneywellMultipartBody : NSObject
+
+@property (nonatomic, readonly) NSString * boundary;
+@property (nonatomic, readonly) unsigned long long contentLength;
+
+-(instancetype)initWithBoundary:(NSString *)boundary;
+
+-(void)appendFileField:(NSString *)name filename:(NSString *)filename data:(NSData *)data;
+
+// the file is mapped, returns NO if it can not be read
+-(BOOL)appendFileField:(NSString *)name filename:(NSString *)filename contentsOfURL:(NSURL *)url;
+
+// sets Content-Type, Content-Length and a fresh body stream
+-(void)applyToRequest:(NSMutableURLRequest *)request;
+
+// each call starts a new producer, e.g. when a request has to be sent again
+-(NSInputStream *)openBodyStream;
+
+@end
@@ -0,0 +1,184 @@
+//
+//  HoneywellMultipartBody.m
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import "HoneywellMultipartBody.h"
+#import "HoneywellMultipart.h"
+#import "HoneywellPrinterIOThread.h"
+
+/* bound pair buffer, also the most written per stream event */
+static const NSUInteger kBodyChunkLength = 32 * 1024;
+
+@interface HoneywellMultipartBody ()
+{
+    // the NSData whose bytes the segments borrow
+    NSMutableArray * borrowedData;
+}
+
+// the segments, borrowed by the producer while it runs
+@property (nonatomic, readonly) HoneywellMultipart * multipart;
+
+@end
+
+#pragma mark - producer
+
+/* writes the body into the write end of a bound pair, keeps itself and the
+   body alive until everything is written or the reader goes away */
+@interface HoneywellMultipartBodyProducer : NSObject <NSStreamDelegate>
+{
+    HoneywellMultipartBody * body;
+    HoneywellMultipartCursor cursor;
+    NSOutputStream * output;
+    HoneywellMultipartBodyProducer * keepAlive;
+}
+
+-(instancetype)initWithBody:(HoneywellMultipartBody *)multipartBody output:(NSOutputStream *)outputStream;
+-(void)start;
+
+@end
+
+@implementation HoneywellMultipartBodyProducer
+
+-(instancetype)initWithBody:(HoneywellMultipartBody *)multipartBody output:(NSOutputStream *)outputStream
+{
+    self = [super init];
+    if (self) {
+        body = multipartBody;
+        output = outputStream;
+    }
+    return self;
+}
+
+-(void)start
+{
+    keepAlive = self;
+    [output setDelegate:self];
+    [output scheduleInRunLoop:[NSRunLoop currentRunLoop] forMode:NSDefaultRunLoopMode];
+    [output open];
+}
+
+-(void)writeNextChunk
+{
+    /* straight from the segment's bytes, a mapped file is paged in as it goes */
+    size_t length = 0;
+    const uint8_t * chunk = HoneywellMultipartNextChunk(body.multipart, &cursor, kBodyChunkLength, &length);
+    if (chunk == NULL) {
+        [self finish];
+        return;
+    }
+    
+    NSInteger written = [output write:chunk maxLength:length];
+    if (written < 0) {
+        NSLog(@"Upload body stream failed: %@", output.streamError);
+        [self finish];
+        return;
+    }
+    HoneywellMultipartAdvance(body.multipart, &cursor, (size_t)written);
+}
+
+-(void)finish
+{
+    [output setDelegate:nil];
+    [output removeFromRunLoop:[NSRunLoop currentRunLoop] forMode:NSDefaultRunLoopMode];
+    [output close];
+    output = nil;
+    body = nil;
+    keepAlive = nil;
+}
+
+- (void)stream:(NSStream *)theStream handleEvent:(NSStreamEvent)streamEvent
+{
+    switch (streamEvent) {
+        
+        case NSStreamEventHasSpaceAvailable:
+            [self writeNextChunk];
+            break;
+        
+        case NSStreamEventErrorOccurred:
+        case NSStreamEventEndEncountered:
+            /* the request was cancelled or the session closed the read end */
+            [self finish];
+            break;
+        
+        default:
+            break;
+    }
+}
+
+@end
+
+#pragma mark - body
+
+@implementation HoneywellMultipartBody
+
+-(instancetype)initWithBoundary:(NSString *)boundary
+{
+    self = [super init];
+    if (self) {
+        _boundary = [boundary copy];
+        _multipart = HoneywellMultipartCreate(_boundary.UTF8String);
+        borrowedData = [[NSMutableArray alloc] init];
+        if (_multipart == NULL) {
+            return nil;
+        }
+    }
+    return self;
+}
+
+-(void)dealloc
+{
+    HoneywellMultipartDestroy(_multipart);
+}
+
+-(void)appendFileField:(NSString *)name filename:(NSString *)filename data:(NSData *)data
+{
+    if (HoneywellMultipartAppendFile(_multipart, name.UTF8String, filename.UTF8String, data.bytes, data.length) != 0) {
+        NSLog(@"Upload field %@ could not be added", name);
+        return;
+    }
+    [borrowedData addObject:data];
+}
+
+-(BOOL)appendFileField:(NSString *)name filename:(NSString *)filename contentsOfURL:(NSURL *)url
+{
+    if (HoneywellMultipartAppendFileAtPath(_multipart, name.UTF8String, filename.UTF8String, url.fileSystemRepresentation) != 0) {
+        NSLog(@"Upload file %@ can not be read", url.path);
+        return NO;
+    }
+    return YES;
+}
+
+-(unsigned long long)contentLength
+{
+    return HoneywellMultipartContentLength(_multipart);
+}
+
+-(void)applyToRequest:(NSMutableURLRequest *)request
+{
+    NSString * contentType = [NSString stringWithFormat:@"multipart/form-data; boundary=%@", _boundary];
+    [request setValue:contentType forHTTPHeaderField:@"Content-Type"];
+    [request setValue:[NSString stringWithFormat:@"%llu", self.contentLength] forHTTPHeaderField:@"Content-Length"];
+    [request setHTTPBodyStream:[self openBodyStream]];
+}
+
+-(NSInputStream *)openBodyStream
+{
+    CFReadStreamRef readStream;
+    CFWriteStreamRef writeStream;
+    CFStreamCreateBoundPair(NULL, &readStream, &writeStream, kBodyChunkLength);
+    
+    NSInputStream * input = (__bridge_transfer NSInputStream *)readStream;
+    NSOutputStream * output = (__bridge_transfer NSOutputStream *)writeStream;
+    
+    HoneywellMultipartBodyProducer * producer = [[HoneywellMultipartBodyProducer alloc] initWithBody:self output:output];
+    [[HoneywellPrinterIOThread sharedIOThread] performBlock:^{
+        [producer start];
+    }];
+    return input;
+}
+
+@end
@@ -0,0 +1,880 @@
+//
+//  HoneywellPrintEngine.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+/* POSIX sockets and clocks under -std=c11 on Linux, SO_NOSIGPIPE on Apple */
+#define _POSIX_C_SOURCE 200809L
+#define _DARWIN_C_SOURCE
+
+#include "HoneywellPrintEngine.h"
+#include "HoneywellResponseParser.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+/* reconnect delay doubles per failed attempt up to the max */
+static const double kReconnectBaseDelay = 0.5;
+static const double kReconnectMaxDelay = 30.0;
+
+/* PRSTAT bits that stop the printer until someone attends to it:
+   printhead lifted, out of labels, out of ribbon */
+static const long kPrinterAttentionStatusMask = 1 | 4 | 8;
+static const double kStatusPollInterval = 1.0;
+
+/* labelsPerSecond is averaged over this many acknowledgements */
+enum { kThroughputWindow = 32 };
+
+typedef enum {
+    CONNECTION_CLOSED = 0,
+    CONNECTION_CONNECTING,
+    CONNECTION_OPEN
+} HoneywellConnectionState;
+
+typedef struct HoneywellEngineJob {
+    void * job;
+    uint64_t jobID;
+    int lane;
+    unsigned copies;
+    // write queue offset just past the label's last byte, for the current connection
+    uint64_t streamEndOffset;
+    int expectsAcknowledgement;
+    int written;
+    struct HoneywellEngineJob * next;
+} HoneywellEngineJob;
+
+typedef struct {
+    HoneywellEngineJob * head;
+    HoneywellEngineJob * tail;
+    size_t count;
+} HoneywellJobList;
+
+struct HoneywellPrintEngine {
+    HoneywellPrintEngineCallbacks callbacks;
+    HoneywellPrintEngineOptions options;
+    
+    HoneywellWriteQueue * writeQueue;
+    // set by the write queue above its high water mark, holds encoding
+    int writeQueueFull;
+    HoneywellResponseParser parser;
+    
+    char * host;
+    int port;
+    int fd;
+    HoneywellConnectionState state;
+    int reconnectEnabled;
+    unsigned reconnectAttempt;
+    // monotonic times the timers are due, 0 when not scheduled
+    double reconnectTime;
+    double statusPollTime;
+    uint64_t jitterState;
+    
+    /* jobs not yet encoded for the current connection, one lane per
+       priority, then jobs encoded but not yet confirmed, all in print order.
+       The first writtenJobCount unconfirmed jobs have left the socket and
+       wait for their ACK. */
+    HoneywellJobList lanes[HONEYWELL_PRINT_ENGINE_LANE_COUNT];
+    HoneywellJobList unconfirmed;
+    size_t writtenJobCount;
+    
+    /* last PRSTAT value, encoding is held while it needs attention */
+    long printerStatus;
+    int printerPaused;
+    
+    double ackTimes[kThroughputWindow];
+    uint64_t ackLabelTotals[kThroughputWindow];
+    size_t ackCount;
+    uint64_t confirmedLabelTotal;
+    double labelsPerSecond;
+};
+
+static void serviceConnection(HoneywellPrintEngine * engine);
+static void connectionDropped(HoneywellPrintEngine * engine);
+static void handleResponse(void * context, const HoneywellResponseEvent * event);
+
+static double monotonicTime(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static void logMessage(HoneywellPrintEngine * engine, const char * format, ...)
+{
+    if (engine->callbacks.log == NULL) {
+        return;
+    }
+    char message[256];
+    va_list arguments;
+    va_start(arguments, format);
+    vsnprintf(message, sizeof(message), format, arguments);
+    va_end(arguments);
+    engine->callbacks.log(engine->callbacks.context, message);
+}
+
+#pragma mark - job lists
+
+static void listAppend(HoneywellJobList * list, HoneywellEngineJob * job)
+{
+    job->next = NULL;
+    if (list->tail != NULL) {
+        list->tail->next = job;
+    } else {
+        list->head = job;
+    }
+    list->tail = job;
+    list->count++;
+}
+
+static void listPrepend(HoneywellJobList * list, HoneywellEngineJob * job)
+{
+    job->next = list->head;
+    list->head = job;
+    if (list->tail == NULL) {
+        list->tail = job;
+    }
+    list->count++;
+}
+
+static HoneywellEngineJob * listRemoveFirst(HoneywellJobList * list)
+{
+    HoneywellEngineJob * job = list->head;
+    if (job == NULL) {
+        return NULL;
+    }
+    list->head = job->next;
+    if (list->head == NULL) {
+        list->tail = NULL;
+    }
+    list->count--;
+    job->next = NULL;
+    return job;
+}
+
+/* moves all of from in front of to, keeping its order */
+static void listPrependList(HoneywellJobList * to, HoneywellJobList * from)
+{
+    if (from->head == NULL) {
+        return;
+    }
+    from->tail->next = to->head;
+    to->head = from->head;
+    if (to->tail == NULL) {
+        to->tail = from->tail;
+    }
+    to->count += from->count;
+    memset(from, 0, sizeof(*from));
+}
+
+static size_t pendingJobCount(const HoneywellPrintEngine * engine)
+{
+    size_t count = 0;
+    for (int lane = 0; lane < HONEYWELL_PRINT_ENGINE_LANE_COUNT; lane++) {
+        count += engine->lanes[lane].count;
+    }
+    return count;
+}
+
+static HoneywellEngineJob * dequeuePendingJob(HoneywellPrintEngine * engine)
+{
+    for (int lane = HONEYWELL_PRINT_ENGINE_LANE_COUNT - 1; lane >= 0; lane--) {
+        if (engine->lanes[lane].head != NULL) {
+            return listRemoveFirst(&engine->lanes[lane]);
+        }
+    }
+    return NULL;
+}
+
+static void finishJob(HoneywellPrintEngine * engine, HoneywellEngineJob * job, int printed)
+{
+    void * owned = job->job;
+    free(job);
+    engine->callbacks.labelFinished(engine->callbacks.context, owned, printed);
+}
+
+/* unconfirmed labels go back in front of their lanes, in print order. The
+   first of them may have printed with its ACK lost, it prints again. */
+static void requeueUnconfirmedJobs(HoneywellPrintEngine * engine)
+{
+    HoneywellJobList requeued[HONEYWELL_PRINT_ENGINE_LANE_COUNT];
+    memset(requeued, 0, sizeof(requeued));
+    
+    HoneywellEngineJob * job;
+    while ((job = listRemoveFirst(&engine->unconfirmed)) != NULL) {
+        job->written = 0;
+        listAppend(&requeued[job->lane], job);
+    }
+    for (int lane = 0; lane < HONEYWELL_PRINT_ENGINE_LANE_COUNT; lane++) {
+        listPrependList(&engine->lanes[lane], &requeued[lane]);
+    }
+    engine->writtenJobCount = 0;
+}
+
+static void failAllJobs(HoneywellPrintEngine * engine)
+{
+    HoneywellEngineJob * job;
+    while ((job = listRemoveFirst(&engine->unconfirmed)) != NULL) {
+        finishJob(engine, job, 0);
+    }
+    for (int lane = 0; lane < HONEYWELL_PRINT_ENGINE_LANE_COUNT; lane++) {
+        while ((job = listRemoveFirst(&engine->lanes[lane])) != NULL) {
+            finishJob(engine, job, 0);
+        }
+    }
+    engine->writtenJobCount = 0;
+}
+
+#pragma mark - lifecycle
+
+void HoneywellPrintEngineDefaultOptions(HoneywellPrintEngineOptions * options)
+{
+    options->maxQueuedJobs = 50000;
+    options->maxLabelsInFlight = 2;
+    options->acknowledgeLabels = 1;
+    options->writeQueueHighWaterMark = 256 * 1024;
+    options->writeQueueLowWaterMark = 64 * 1024;
+}
+
+HoneywellPrintEngine * HoneywellPrintEngineCreate(const HoneywellPrintEngineCallbacks * callbacks, const HoneywellPrintEngineOptions * options)
+{
+    HoneywellPrintEngine * engine = calloc(1, sizeof(HoneywellPrintEngine));
+    if (engine == NULL) {
+        return NULL;
+    }
+    engine->writeQueue = HoneywellWriteQueueCreate();
+    if (engine->writeQueue == NULL) {
+        free(engine);
+        return NULL;
+    }
+    
+    engine->callbacks = *callbacks;
+    HoneywellPrintEngineOptions defaultOptions;
+    if (options == NULL) {
+        HoneywellPrintEngineDefaultOptions(&defaultOptions);
+        options = &defaultOptions;
+    }
+    HoneywellPrintEngineSetOptions(engine, options);
+    HoneywellResponseParserInit(&engine->parser, handleResponse, engine);
+    engine->fd = -1;
+    
+    /* any seed will do, it only has to differ between clients */
+    engine->jitterState = ((uint64_t)time(NULL) << 20) ^ (uint64_t)(uintptr_t)engine ^ ((uint64_t)getpid() << 40);
+    if (engine->jitterState == 0) {
+        engine->jitterState = 1;
+    }
+    return engine;
+}
+
+void HoneywellPrintEngineDestroy(HoneywellPrintEngine * engine)
+{
+    if (engine == NULL) {
+        return;
+    }
+    HoneywellPrintEngineDisconnect(engine);
+    HoneywellWriteQueueDestroy(engine->writeQueue);
+    free(engine->host);
+    free(engine);
+}
+
+static void writeQueueWaterMark(void * context, int aboveHighWaterMark)
+{
+    HoneywellPrintEngine * engine = context;
+    engine->writeQueueFull = aboveHighWaterMark;
+}
+
+void HoneywellPrintEngineSetOptions(HoneywellPrintEngine * engine, const HoneywellPrintEngineOptions * options)
+{
+    engine->options = *options;
+    if (engine->options.maxLabelsInFlight == 0) {
+        engine->options.maxLabelsInFlight = 1;
+    }
+    if (engine->options.writeQueueHighWaterMark <= engine->options.writeQueueLowWaterMark) {
+        HoneywellPrintEngineOptions defaultOptions;
+        HoneywellPrintEngineDefaultOptions(&defaultOptions);
+        engine->options.writeQueueHighWaterMark = defaultOptions.writeQueueHighWaterMark;
+        engine->options.writeQueueLowWaterMark = defaultOptions.writeQueueLowWaterMark;
+    }
+    HoneywellWriteQueueSetWaterMarks(engine->writeQueue, engine->options.writeQueueHighWaterMark,
+                                     engine->options.writeQueueLowWaterMark, writeQueueWaterMark, engine);
+}
+
+#pragma mark - connection
+
+static void closeSocket(HoneywellPrintEngine * engine)
+{
+    if (engine->fd < 0) {
+        return;
+    }
+    
+    engine->callbacks.disconnected(engine->callbacks.context, engine->fd);
+    close(engine->fd);
+    engine->fd = -1;
+    engine->state = CONNECTION_CLOSED;
+    engine->statusPollTime = 0;
+    
+    /* bytes still queued are dropped, their jobs stay unconfirmed */
+    HoneywellWriteQueueRemoveAll(engine->writeQueue);
+}
+
+static void scheduleReconnect(HoneywellPrintEngine * engine)
+{
+    if (!engine->reconnectEnabled) {
+        return;
+    }
+    
+    /* xorshift64, jitter keeps a shop full of clients from reconnecting in lockstep */
+    uint64_t x = engine->jitterState;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    engine->jitterState = x;
+    
+    unsigned attempt = engine->reconnectAttempt < 16 ? engine->reconnectAttempt : 16;
+    double delay = kReconnectBaseDelay * (double)(1u << attempt);
+    if (delay > kReconnectMaxDelay) {
+        delay = kReconnectMaxDelay;
+    }
+    delay *= 0.5 + (x % 1001) / 2000.0;
+    engine->reconnectAttempt++;
+    
+    logMessage(engine, "Printer connection lost, reconnecting in %.1fs (attempt %u, %zu labels queued)",
+               delay, engine->reconnectAttempt, pendingJobCount(engine));
+    
+    engine->reconnectTime = monotonicTime() + delay;
+}
+
+static void connectionOpened(HoneywellPrintEngine * engine)
+{
+    engine->state = CONNECTION_OPEN;
+    engine->reconnectAttempt = 0;
+    logMessage(engine, "Connected to %s:%d", engine->host, engine->port);
+    
+    HoneywellByteBuffer commands = { 0 };
+    engine->callbacks.connected(engine->callbacks.context, &commands);
+    if (HoneywellWriteQueueEnqueueBuffer(engine->writeQueue, &commands) != 0) {
+        HoneywellByteBufferDestroy(&commands);
+        logMessage(engine, "Out of memory queueing connection commands");
+        connectionDropped(engine);
+        return;
+    }
+    
+    serviceConnection(engine);
+}
+
+static void openSocket(HoneywellPrintEngine * engine)
+{
+    /* nothing the printer knew about the last connection still holds */
+    HoneywellResponseParserReset(&engine->parser);
+    engine->printerStatus = 0;
+    engine->printerPaused = 0;
+    
+    char service[16];
+    snprintf(service, sizeof(service), "%d", engine->port);
+    
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    
+    struct addrinfo * addresses = NULL;
+    int error = getaddrinfo(engine->host, service, &hints, &addresses);
+    if (error != 0) {
+        logMessage(engine, "Can not resolve %s: %s", engine->host, gai_strerror(error));
+        scheduleReconnect(engine);
+        return;
+    }
+    
+    int fd = -1;
+    int inProgress = 0;
+    for (struct addrinfo * address = addresses; address != NULL; address = address->ai_next) {
+        
+        fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+#ifdef SO_NOSIGPIPE
+        int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+        
+        if (connect(fd, address->ai_addr, address->ai_addrlen) == 0) {
+            break;
+        }
+        if (errno == EINPROGRESS) {
+            inProgress = 1;
+            break;
+        }
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(addresses);
+    
+    if (fd < 0) {
+        logMessage(engine, "Can not connect to %s:%d: %s", engine->host, engine->port, strerror(errno));
+        scheduleReconnect(engine);
+        return;
+    }
+    
+    engine->fd = fd;
+    if (inProgress) {
+        engine->state = CONNECTION_CONNECTING;
+    } else {
+        connectionOpened(engine);
+    }
+}
+
+static void connectionDropped(HoneywellPrintEngine * engine)
+{
+    closeSocket(engine);
+    requeueUnconfirmedJobs(engine);
+    scheduleReconnect(engine);
+}
+
+void HoneywellPrintEngineConnect(HoneywellPrintEngine * engine, const char * host, int port)
+{
+    size_t length = strlen(host);
+    char * copy = malloc(length + 1);
+    if (copy == NULL) {
+        return;
+    }
+    memcpy(copy, host, length + 1);
+    
+    closeSocket(engine);
+    requeueUnconfirmedJobs(engine);
+    
+    free(engine->host);
+    engine->host = copy;
+    engine->port = port;
+    engine->reconnectEnabled = 1;
+    engine->reconnectAttempt = 0;
+    engine->reconnectTime = 0;
+    
+    openSocket(engine);
+}
+
+void HoneywellPrintEngineDisconnect(HoneywellPrintEngine * engine)
+{
+    engine->reconnectEnabled = 0;
+    engine->reconnectTime = 0;
+    
+    closeSocket(engine);
+    failAllJobs(engine);
+}
+
+int HoneywellPrintEngineIsConnected(const HoneywellPrintEngine * engine)
+{
+    return engine->state == CONNECTION_OPEN;
+}
+
+#pragma mark - jobs
+
+static int queueJob(HoneywellPrintEngine * engine, void * job, uint64_t jobID, int priority, unsigned copies, int inFront)
+{
+    if (pendingJobCount(engine) + engine->unconfirmed.count >= engine->options.maxQueuedJobs) {
+        return -1;
+    }
+    
+    HoneywellEngineJob * entry = calloc(1, sizeof(HoneywellEngineJob));
+    if (entry == NULL) {
+        return -1;
+    }
+    entry->job = job;
+    entry->jobID = jobID;
+    entry->copies = copies > 0 ? copies : 1;
+    
+    /* unknown priorities print as normal labels */
+    entry->lane = (priority >= 0 && priority < HONEYWELL_PRINT_ENGINE_LANE_COUNT) ? priority : 1;
+    
+    if (inFront) {
+        listPrepend(&engine->lanes[entry->lane], entry);
+    } else {
+        listAppend(&engine->lanes[entry->lane], entry);
+    }
+    return 0;
+}
+
+int HoneywellPrintEngineSubmit(HoneywellPrintEngine * engine, void * job, uint64_t jobID, int priority, unsigned copies)
+{
+    return queueJob(engine, job, jobID, priority, copies, 0);
+}
+
+int HoneywellPrintEngineResume(HoneywellPrintEngine * engine, void * job, uint64_t jobID, int priority, unsigned copies)
+{
+    return queueJob(engine, job, jobID, priority, copies, 1);
+}
+
+size_t HoneywellPrintEngineJobCount(const HoneywellPrintEngine * engine)
+{
+    return pendingJobCount(engine) + engine->unconfirmed.count;
+}
+
+void HoneywellPrintEngineService(HoneywellPrintEngine * engine)
+{
+    serviceConnection(engine);
+}
+
+#pragma mark - encoding
+
+/* statements run in order, so the echo comes back once the label's PF was
+   executed. PRSTAT rides along so the reply also reports the printer status. */
+static int appendAcknowledgement(HoneywellEngineJob * job, HoneywellByteBuffer * buffer)
+{
+    char statement[48];
+    int length = snprintf(statement, sizeof(statement), "PRINT \"ACK %llu \";PRSTAT\r\n", (unsigned long long)job->jobID);
+    return HoneywellByteBufferAppend(buffer, statement, (size_t)length);
+}
+
+/* only maxLabelsInFlight labels are encoded ahead of the printer, the rest
+   wait in their lanes, as do all of them while the write queue is above its
+   high water mark. Each label is picked from the highest lane at the time,
+   so an urgent label overtakes queued bulk labels at the next PF and the
+   bulk lane carries on after it. Returns -1 if out of memory. */
+static int encodePendingJobs(HoneywellPrintEngine * engine)
+{
+    if (engine->writeQueueFull || engine->unconfirmed.count >= engine->options.maxLabelsInFlight || pendingJobCount(engine) == 0) {
+        return 0;
+    }
+    
+    HoneywellByteBuffer chunk = { 0 };
+    uint64_t chunkOffset = HoneywellWriteQueueTotalBytesEnqueued(engine->writeQueue);
+    
+    while (engine->unconfirmed.count < engine->options.maxLabelsInFlight) {
+        
+        HoneywellEngineJob * job = dequeuePendingJob(engine);
+        if (job == NULL) {
+            break;
+        }
+        
+        size_t labelStart = chunk.length;
+        HoneywellEncodeResult result = engine->callbacks.encodeLabel(engine->callbacks.context, job->job, &chunk);
+        
+        if (result == HONEYWELL_ENCODE_FAILED) {
+            chunk.length = labelStart;
+            finishJob(engine, job, 0);
+            continue;
+        }
+        
+        /* a label waits, e.g. for its image, it and everything after it stay queued */
+        if (result == HONEYWELL_ENCODE_WAIT) {
+            listPrepend(&engine->lanes[job->lane], job);
+            break;
+        }
+        
+        job->expectsAcknowledgement = engine->options.acknowledgeLabels;
+        if (job->expectsAcknowledgement && appendAcknowledgement(job, &chunk) != 0) {
+            listPrepend(&engine->lanes[job->lane], job);
+            HoneywellByteBufferDestroy(&chunk);
+            return -1;
+        }
+        job->streamEndOffset = chunkOffset + chunk.length;
+        listAppend(&engine->unconfirmed, job);
+    }
+    
+    if (HoneywellWriteQueueEnqueueBuffer(engine->writeQueue, &chunk) != 0) {
+        HoneywellByteBufferDestroy(&chunk);
+        return -1;
+    }
+    return 0;
+}
+
+static void recordConfirmedLabels(HoneywellPrintEngine * engine, unsigned labels, double now)
+{
+    engine->confirmedLabelTotal += labels;
+    
+    size_t slot = engine->ackCount % kThroughputWindow;
+    engine->ackTimes[slot] = now;
+    engine->ackLabelTotals[slot] = engine->confirmedLabelTotal;
+    engine->ackCount++;
+    
+    if (engine->ackCount < 2) {
+        return;
+    }
+    
+    /* oldest entry still in the window */
+    size_t oldest = (engine->ackCount > kThroughputWindow) ? engine->ackCount % kThroughputWindow : 0;
+    double elapsed = now - engine->ackTimes[oldest];
+    if (elapsed > 0) {
+        engine->labelsPerSecond = (engine->confirmedLabelTotal - engine->ackLabelTotals[oldest]) / elapsed;
+    }
+}
+
+static void confirmFirstJob(HoneywellPrintEngine * engine, double now)
+{
+    HoneywellEngineJob * job = listRemoveFirst(&engine->unconfirmed);
+    if (job->written && engine->writtenJobCount > 0) {
+        engine->writtenJobCount--;
+    }
+    recordConfirmedLabels(engine, job->copies, now);
+    finishJob(engine, job, 1);
+}
+
+static void settleWrittenJobs(HoneywellPrintEngine * engine)
+{
+    uint64_t writtenOffset = HoneywellWriteQueueTotalBytesWritten(engine->writeQueue);
+    
+    HoneywellEngineJob * job = engine->unconfirmed.head;
+    for (size_t i = 0; job != NULL && i < engine->writtenJobCount; i++) {
+        job = job->next;
+    }
+    while (job != NULL && job->streamEndOffset <= writtenOffset) {
+        job->written = 1;
+        engine->writtenJobCount++;
+        engine->callbacks.labelWritten(engine->callbacks.context, job->job);
+        job = job->next;
+    }
+    
+    /* labels sent without an ACK request are confirmed once written */
+    double now = monotonicTime();
+    while (engine->writtenJobCount > 0 && !engine->unconfirmed.head->expectsAcknowledgement) {
+        confirmFirstJob(engine, now);
+    }
+}
+
+/* lanes, requeues and journal recovery all encode labels out of job ID order,
+   so an ACK confirms by position: its own label and the labels encoded before
+   it, whose reply got lost. An ACK for a label not in the list is ignored. */
+static void acknowledgeJobsThroughID(HoneywellPrintEngine * engine, uint64_t jobID)
+{
+    size_t position = 0;
+    HoneywellEngineJob * job = engine->unconfirmed.head;
+    while (job != NULL && job->jobID != jobID) {
+        job = job->next;
+        position++;
+    }
+    if (job == NULL) {
+        return;
+    }
+    
+    double now = monotonicTime();
+    for (size_t i = 0; i <= position; i++) {
+        confirmFirstJob(engine, now);
+    }
+}
+
+/* encode, write, then settle whatever the socket has taken. Labels sent
+   without an ACK request are confirmed right there, which makes room for
+   more, as does the write queue draining below its low water mark, so this
+   repeats until neither happens. */
+static void serviceConnection(HoneywellPrintEngine * engine)
+{
+    size_t unconfirmedCount;
+    int writeQueueWasFull;
+    do {
+        if (engine->state != CONNECTION_OPEN) {
+            return;
+        }
+        
+        if (!engine->printerPaused && encodePendingJobs(engine) != 0) {
+            logMessage(engine, "Out of memory encoding labels");
+            connectionDropped(engine);
+            return;
+        }
+        
+        writeQueueWasFull = engine->writeQueueFull;
+        if (HoneywellWriteQueueDrainToSocket(engine->writeQueue, engine->fd) < 0) {
+            logMessage(engine, "Printer write failed: %s", strerror(errno));
+            connectionDropped(engine);
+            return;
+        }
+        unconfirmedCount = engine->unconfirmed.count;
+        settleWrittenJobs(engine);
+    } while (engine->unconfirmed.count < unconfirmedCount || (writeQueueWasFull && !engine->writeQueueFull));
+}
+
+#pragma mark - printer responses
+
+/* while the printer needs attention no new labels are encoded, queued ones
+   stay in memory and the status is polled until it clears */
+static void updatePrinterStatus(HoneywellPrintEngine * engine, long status)
+{
+    engine->printerStatus = status;
+    int needsAttention = (status & kPrinterAttentionStatusMask) != 0;
+    
+    if (needsAttention && !engine->printerPaused) {
+        logMessage(engine, "Printer needs attention (PRSTAT %ld), holding labels", status);
+        engine->printerPaused = 1;
+        engine->statusPollTime = monotonicTime() + kStatusPollInterval;
+    }
+    else if (!needsAttention && engine->printerPaused) {
+        logMessage(engine, "Printer ready again");
+        engine->printerPaused = 0;
+        engine->statusPollTime = 0;
+        serviceConnection(engine);
+    }
+}
+
+static void pollPrinterStatus(HoneywellPrintEngine * engine)
+{
+    engine->statusPollTime = 0;
+    if (!engine->printerPaused || engine->state != CONNECTION_OPEN) {
+        return;
+    }
+    
+    static const char statusQuery[] = "PRINT PRSTAT\r\n";
+    if (HoneywellWriteQueueEnqueue(engine->writeQueue, statusQuery, sizeof(statusQuery) - 1) != 0
+        || HoneywellWriteQueueDrainToSocket(engine->writeQueue, engine->fd) < 0) {
+        connectionDropped(engine);
+        return;
+    }
+    engine->statusPollTime = monotonicTime() + kStatusPollInterval;
+}
+
+static void handleResponse(void * context, const HoneywellResponseEvent * event)
+{
+    HoneywellPrintEngine * engine = context;
+    
+    switch (event->type) {
+        
+        case HONEYWELL_RESPONSE_OK:
+            break;
+        
+        case HONEYWELL_RESPONSE_ERROR:
+            logMessage(engine, "Printer error %ld: %s", event->code, event->line);
+            break;
+        
+        case HONEYWELL_RESPONSE_STATUS:
+            updatePrinterStatus(engine, event->code);
+            break;
+        
+        case HONEYWELL_RESPONSE_ACK:
+            acknowledgeJobsThroughID(engine, (uint64_t)event->code);
+            updatePrinterStatus(engine, event->status);
+            break;
+        
+        case HONEYWELL_RESPONSE_TEXT:
+            if (engine->callbacks.textLine == NULL || !engine->callbacks.textLine(engine->callbacks.context, event->line, event->length)) {
+                logMessage(engine, "server said: %s", event->line);
+            }
+            break;
+    }
+}
+
+#pragma mark - event loop
+
+int HoneywellPrintEngineFileDescriptor(const HoneywellPrintEngine * engine)
+{
+    return engine->fd;
+}
+
+short HoneywellPrintEnginePollEvents(const HoneywellPrintEngine * engine)
+{
+    switch (engine->state) {
+        
+        case CONNECTION_CONNECTING:
+            return POLLOUT;
+        
+        case CONNECTION_OPEN:
+            return POLLIN | (HoneywellWriteQueueQueuedByteCount(engine->writeQueue) > 0 ? POLLOUT : 0);
+        
+        default:
+            return 0;
+    }
+}
+
+static void handleSocketEvents(HoneywellPrintEngine * engine, short revents)
+{
+    int fd = engine->fd;
+    
+    if (engine->state == CONNECTION_CONNECTING) {
+        if ((revents & (POLLOUT | POLLERR | POLLHUP)) == 0) {
+            return;
+        }
+        int error = 0;
+        socklen_t length = sizeof(error);
+        if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length) != 0) {
+            error = errno;
+        }
+        if (error != 0) {
+            logMessage(engine, "Can not connect to %s:%d: %s", engine->host, engine->port, strerror(error));
+            connectionDropped(engine);
+            return;
+        }
+        connectionOpened(engine);
+        return;
+    }
+    
+    if (revents & (POLLIN | POLLHUP | POLLERR)) {
+        
+        /* callbacks may drop the connection while lines are delivered */
+        if (HoneywellResponseParserReadFromSocket(&engine->parser, fd) != 0 && engine->fd == fd) {
+            logMessage(engine, "Printer closed the connection");
+            connectionDropped(engine);
+            return;
+        }
+    }
+    
+    /* acknowledgements free room for more labels in flight */
+    if ((revents & (POLLIN | POLLOUT)) && engine->fd == fd) {
+        serviceConnection(engine);
+    }
+}
+
+void HoneywellPrintEngineHandleEvents(HoneywellPrintEngine * engine, short revents)
+{
+    if (revents != 0 && engine->fd >= 0) {
+        handleSocketEvents(engine, revents);
+    }
+    
+    double now = monotonicTime();
+    if (engine->reconnectTime != 0 && now >= engine->reconnectTime) {
+        engine->reconnectTime = 0;
+        if (engine->reconnectEnabled && engine->fd < 0) {
+            openSocket(engine);
+        }
+    }
+    if (engine->statusPollTime != 0 && now >= engine->statusPollTime) {
+        pollPrinterStatus(engine);
+    }
+}
+
+double HoneywellPrintEngineTimeout(const HoneywellPrintEngine * engine)
+{
+    double due = 0;
+    if (engine->reconnectTime != 0) {
+        due = engine->reconnectTime;
+    }
+    if (engine->statusPollTime != 0 && (due == 0 || engine->statusPollTime < due)) {
+        due = engine->statusPollTime;
+    }
+    if (due == 0) {
+        return -1;
+    }
+    
+    double timeout = due - monotonicTime();
+    return timeout > 0 ? timeout : 0;
+}
+
+#pragma mark - state
+
+size_t HoneywellPrintEngineQueuedByteCount(HoneywellPrintEngine * engine)
+{
+    return HoneywellWriteQueueQueuedByteCount(engine->writeQueue);
+}
+
+double HoneywellPrintEngineLabelsPerSecond(const HoneywellPrintEngine * engine)
+{
+    return engine->labelsPerSecond;
+}
+
+long HoneywellPrintEnginePrinterStatus(const HoneywellPrintEngine * engine)
+{
+    return engine->printerStatus;
+}
+
+int HoneywellPrintEngineIsPaused(const HoneywellPrintEngine * engine)
+{
+    return engine->printerPaused;
+}
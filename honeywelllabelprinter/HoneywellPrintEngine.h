@@ -0,0 +1,183 @@
+//
+//  HoneywellPrintEngine.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#ifndef HoneywellPrintEngine_h
+#define HoneywellPrintEngine_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include "HoneywellByteBuffer.h"
+#include "HoneywellWriteQueue.h"
+
+/*
+
+ The job queue and Direct Protocol connection of one printer, in plain C
+ with POSIX sockets, so the app and the Linux print gateway daemon share it.
+
+ The engine owns no thread or run loop. Its owner watches
+ HoneywellPrintEngineFileDescriptor for HoneywellPrintEnginePollEvents,
+ calls HoneywellPrintEngineHandleEvents with what poll() reported, and calls
+ it again with 0 once HoneywellPrintEngineTimeout has passed. Apart from
+ HoneywellPrintEngineQueuedByteCount every function must be called from
+ the owner's thread, and the callbacks run there.
+
+ Jobs are opaque to the engine, it asks the owner to encode each label as
+ it is about to be sent, so the encoding always matches what the current
+ connection already stored on the printer.
+
+ Lanes: the highest non-empty priority lane is always encoded next and only
+ maxLabelsInFlight labels are encoded ahead of the printer's
+ acknowledgements, so an urgent label overtakes queued bulk labels at the
+ next PF.
+
+ Acknowledgements: each label is followed by PRINT "ACK n ";PRSTAT, which
+ the printer echoes once its PF was executed. An ACK confirms its label and
+ the labels sent before it, by position rather than by id.
+
+ Reconnects: labels stay queued until confirmed. When the connection drops
+ it is reopened with jittered exponential backoff and printing resumes at
+ the first unconfirmed label, so an outage loses no label and never
+ reprints one the printer acknowledged. A label prints at its PF, before
+ its ACK is sent: if the connection drops in between, nothing the printer
+ keeps tells the two apart and the label is printed again. Labels whose
+ ACK was lost are delivered at least once, all others exactly once.
+
+ Printer status: while PRSTAT reports the printhead lifted or labels or
+ ribbon out no new labels are encoded and the status is polled until it
+ clears.
+
+ */
+
+typedef struct HoneywellPrintEngine HoneywellPrintEngine;
+
+typedef enum {
+    HONEYWELL_ENCODE_OK = 0,
+    // hold the label and everything after it, e.g. until its image is on the printer
+    HONEYWELL_ENCODE_WAIT,
+    // the label can never be encoded, it finishes as not printed
+    HONEYWELL_ENCODE_FAILED
+} HoneywellEncodeResult;
+
+#define HONEYWELL_PRINT_ENGINE_LANE_COUNT 3
+
+typedef struct {
+    void * context;
+    
+    /* the connection is open, nothing an earlier one stored on the printer
+       can be assumed. commands are sent before any label. */
+    void (*connected)(void * context, HoneywellByteBuffer * commands);
+    
+    // the socket is about to be closed, stop watching fd
+    void (*disconnected)(void * context, int fd);
+    
+    /* appends the label for job to commands. Bytes appended before returning
+       HONEYWELL_ENCODE_WAIT are sent, those before HONEYWELL_ENCODE_FAILED
+       are dropped. */
+    HoneywellEncodeResult (*encodeLabel)(void * context, void * job, HoneywellByteBuffer * commands);
+    
+    // the label's last byte left the socket, may be called again after a reconnect
+    void (*labelWritten)(void * context, void * job);
+    
+    // the printer confirmed the label, or it was dropped, the engine forgets job
+    void (*labelFinished)(void * context, void * job, int printed);
+    
+    // a line the engine does not expect, returns 1 if the owner handled it
+    int (*textLine)(void * context, const char * line, size_t length);
+    
+    // one line of diagnostics, may be NULL
+    void (*log)(void * context, const char * message);
+} HoneywellPrintEngineCallbacks;
+
+typedef struct {
+    // labels queued or unconfirmed beyond this are rejected, defaults to 50000
+    size_t maxQueuedJobs;
+    
+    /* labels encoded ahead of the printer's acknowledgements, defaults to 2:
+       the one printing and the next, so the printer never idles waiting for
+       an ACK round trip. A new interactive label starts within two label
+       times, each extra label in flight adds one label time to that. */
+    size_t maxLabelsInFlight;
+    
+    /* request an ACK after every label, defaults to 1. With 0 a label is
+       confirmed as soon as the socket accepted its bytes. */
+    int acknowledgeLabels;
+    
+    /* no more labels are encoded while more than the high water mark of
+       bytes wait for the socket, until they drain below the low water mark.
+       Default to 256 KB and 64 KB, a high mark not above the low one
+       restores the defaults. */
+    size_t writeQueueHighWaterMark;
+    size_t writeQueueLowWaterMark;
+} HoneywellPrintEngineOptions;
+
+void HoneywellPrintEngineDefaultOptions(HoneywellPrintEngineOptions * options);
+
+// options may be NULL for the defaults, returns NULL if out of memory
+HoneywellPrintEngine * HoneywellPrintEngineCreate(const HoneywellPrintEngineCallbacks * callbacks, const HoneywellPrintEngineOptions * options);
+
+// closes the connection, jobs still queued finish as not printed
+void HoneywellPrintEngineDestroy(HoneywellPrintEngine * engine);
+
+void HoneywellPrintEngineSetOptions(HoneywellPrintEngine * engine, const HoneywellPrintEngineOptions * options);
+
+#pragma mark - connection
+
+/* connects to host and keeps reconnecting after drops until disconnected.
+   host is resolved synchronously, printers are normally given by address. */
+void HoneywellPrintEngineConnect(HoneywellPrintEngine * engine, const char * host, int port);
+
+// closes the connection and stops reconnecting, every queued job finishes as not printed
+void HoneywellPrintEngineDisconnect(HoneywellPrintEngine * engine);
+
+// 1 while a connection is open and ready for labels
+int HoneywellPrintEngineIsConnected(const HoneywellPrintEngine * engine);
+
+#pragma mark - jobs
+
+/* queues a label at the back of its lane. jobID must increase per engine
+   across runs, it names the label in the printer's ACK. Returns -1 and
+   leaves the job to the caller if the queue is full. */
+int HoneywellPrintEngineSubmit(HoneywellPrintEngine * engine, void * job, uint64_t jobID, int priority, unsigned copies);
+
+/* queues a label in front of its lane, for labels recovered from a journal.
+   Resume them last to first to keep their order. */
+int HoneywellPrintEngineResume(HoneywellPrintEngine * engine, void * job, uint64_t jobID, int priority, unsigned copies);
+
+// labels queued or unconfirmed
+size_t HoneywellPrintEngineJobCount(const HoneywellPrintEngine * engine);
+
+// encodes and writes what it can, e.g. after submitting or once an image the labels wait for is ready
+void HoneywellPrintEngineService(HoneywellPrintEngine * engine);
+
+#pragma mark - event loop
+
+// the socket to watch, -1 while there is none
+int HoneywellPrintEngineFileDescriptor(const HoneywellPrintEngine * engine);
+
+// POLLIN and POLLOUT as the socket should be watched for
+short HoneywellPrintEnginePollEvents(const HoneywellPrintEngine * engine);
+
+// handles poll() revents for the socket, 0 for none, and runs timers that are due
+void HoneywellPrintEngineHandleEvents(HoneywellPrintEngine * engine, short revents);
+
+// seconds until HoneywellPrintEngineHandleEvents has a timer to run, -1 for none
+double HoneywellPrintEngineTimeout(const HoneywellPrintEngine * engine);
+
+#pragma mark - state
+
+// bytes handed to the socket queue that have not been written yet, any thread
+size_t HoneywellPrintEngineQueuedByteCount(HoneywellPrintEngine * engine);
+
+// confirmed labels per second over the last few acknowledgements
+double HoneywellPrintEngineLabelsPerSecond(const HoneywellPrintEngine * engine);
+
+// last PRSTAT value, and whether labels are held until it clears
+long HoneywellPrintEnginePrinterStatus(const HoneywellPrintEngine * engine);
+int HoneywellPrintEngineIsPaused(const HoneywellPrintEngine * engine);
+
+#endif /* HoneywellPrintEngine_h */
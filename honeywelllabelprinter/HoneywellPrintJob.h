@@ -0,0 +1,60 @@
+//
+//  HoneywellPrintJob.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "HoneywellPrinterUtilities.h"
+
+/*
+
+ One label (with its copy count) waiting in a printer's job queue. Jobs keep
+ the record rather than encoded bytes, because the encoding depends on what
+ the current connection already stored on the printer. After a reconnect
+ unconfirmed jobs are simply encoded again.
+
+ */
+
+@class HoneywellPrintJobGroup;
+
+@interface HoneywellPrintJob : NSObject
+
+@property (nonatomic, readonly) NSDictionary * record;
+@property (nonatomic, readonly) LabelTemplateType templateType;
+@property (nonatomic, readonly) NSUInteger copies;
+@property (nonatomic) HoneywellPrintPriority priority;
+
+// assigned when the job enters the queue, increasing per printer
+@property (nonatomic) NSUInteger jobID;
+
+/* timestamps as NSDate timeIntervalSinceReferenceDate, 0 until reached.
+   After a reconnect writeTime is that of the last attempt. */
+@property (nonatomic) NSTimeInterval enqueueTime;
+@property (nonatomic) NSTimeInterval writeTime;
+@property (nonatomic) NSTimeInterval printTime;
+
+@property (nonatomic, strong) HoneywellPrintJobGroup * group;
+
++(instancetype)jobWithRecord:(NSDictionary *)record templateType:(LabelTemplateType)type copies:(NSUInteger)copies;
+
+/* one job per run of identical neighbouring records, printed as copies.
+   Records are copied, transform may be nil or return the record to queue. */
++(NSArray *)jobsWithRecords:(id<NSFastEnumeration>)records
+               templateType:(LabelTemplateType)type
+                   priority:(HoneywellPrintPriority)priority
+                  transform:(NSDictionary * (^)(NSDictionary * record))transform;
+
+@end
+
+/* the labels of one print call, reports once when all of them are finished */
+@interface HoneywellPrintJobGroup : NSObject
+
+-(instancetype)initWithJobCount:(NSUInteger)count completion:(HoneywellPrintCompletion)completion;
+
+// the completion runs on the main queue after the last job, with NO if any failed
+-(void)jobFinished:(BOOL)printed;
+
+@end
@@ -0,0 +1,99 @@
+//
+//  HoneywellPrintJob.m
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import "HoneywellPrintJob.h"
+
+@implementation HoneywellPrintJob
+
++(instancetype)jobWithRecord:(NSDictionary *)record templateType:(LabelTemplateType)type copies:(NSUInteger)copies
+{
+    HoneywellPrintJob * job = [[HoneywellPrintJob alloc] init];
+    job->_record = record;
+    job->_templateType = type;
+    job->_copies = copies;
+    return job;
+}
+
++(NSArray *)jobsWithRecords:(id<NSFastEnumeration>)records
+               templateType:(LabelTemplateType)type
+                   priority:(HoneywellPrintPriority)priority
+                  transform:(NSDictionary * (^)(NSDictionary * record))transform
+{
+    NSMutableArray * jobs = [[NSMutableArray alloc] init];
+    NSDictionary * pendingRecord = nil;
+    NSUInteger pendingCopies = 0;
+    
+    for (NSDictionary * record in records) {
+        
+        if (pendingRecord != nil && [record isEqualToDictionary:pendingRecord]) {
+            pendingCopies++;
+            continue;
+        }
+        
+        if (pendingRecord != nil) {
+            [jobs addObject:[HoneywellPrintJob jobWithRecord:(transform ? transform(pendingRecord) : pendingRecord) templateType:type copies:pendingCopies]];
+        }
+        pendingRecord = [record copy];
+        pendingCopies = 1;
+    }
+    
+    if (pendingRecord != nil) {
+        [jobs addObject:[HoneywellPrintJob jobWithRecord:(transform ? transform(pendingRecord) : pendingRecord) templateType:type copies:pendingCopies]];
+    }
+    
+    for (HoneywellPrintJob * job in jobs) {
+        job.priority = priority;
+    }
+    return jobs;
+}
+
+@end
+
+@interface HoneywellPrintJobGroup()
+{
+    NSUInteger remainingJobs;
+    BOOL failed;
+    HoneywellPrintCompletion completion;
+}
+@end
+
+@implementation HoneywellPrintJobGroup
+
+-(instancetype)initWithJobCount:(NSUInteger)count completion:(HoneywellPrintCompletion)aCompletion
+{
+    self = [super init];
+    if (self) {
+        remainingJobs = count;
+        completion = [aCompletion copy];
+    }
+    return self;
+}
+
+/* only called on the thread or queue of the printer owning the jobs, so no locking */
+-(void)jobFinished:(BOOL)printed
+{
+    if (remainingJobs == 0) {
+        return;
+    }
+    
+    if (!printed) {
+        failed = YES;
+    }
+    
+    remainingJobs--;
+    if (remainingJobs == 0 && completion) {
+        HoneywellPrintCompletion finishedCompletion = completion;
+        BOOL sent = !failed;
+        completion = nil;
+        dispatch_async(dispatch_get_main_queue(), ^{
+            finishedCompletion(sent);
+        });
+    }
+}
+
+@end
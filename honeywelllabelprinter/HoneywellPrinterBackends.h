@@ -0,0 +1,43 @@
+//
+//  HoneywellPrinterBackends.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "HoneywellPrinterUtilities.h"
+#import "HoneywellPrinterProfiles.h"
+
+/*
+
+ Picks the HoneywellPrinterBackend for a printer ID from printer_profiles.JSON,
+ so one queue or pool can drive a mixed fleet.
+
+ A printer's "Backend" setting, resolved by HoneywellPrinterProfiles, is one of
+
+    DirectProtocol   Direct Protocol over TCP, HoneywellPrinterUtilities (PC42t)
+    LinePrinter      printersdk's ITCLinePrinter over Bluetooth (PR2, PR3, PB)
+    Mock             HoneywellMockPrinterBackend, nothing is sent
+
+ Printers without the setting are line printers, the SDK reads the same
+ file. Unknown IDs get no backend.
+
+ */
+
+@interface HoneywellPrinterBackends : NSObject
+
+@property (nonatomic, readonly) HoneywellPrinterProfiles * profiles;
+
+// the shared profiles from the main bundle
++(instancetype)sharedBackends;
+
+-(instancetype)initWithProfiles:(HoneywellPrinterProfiles *)profiles;
+
+-(HoneywellBackendType)backendTypeForPrinterID:(NSString *)printerID;
+
+// host and port are only used by Direct Protocol printers, nil for unknown IDs
+-(id<HoneywellPrinterBackend>)backendForPrinterID:(NSString *)printerID host:(NSString *)host port:(int)port;
+
+@end
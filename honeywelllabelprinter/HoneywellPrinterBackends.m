@@ -0,0 +1,69 @@
+//
+//  HoneywellPrinterBackends.m
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import "HoneywellPrinterBackends.h"
+#import "HoneywellLinePrinterBackend.h"
+#import "HoneywellMockPrinterBackend.h"
+
+@implementation HoneywellPrinterBackends
+
++(instancetype)sharedBackends
+{
+    static HoneywellPrinterBackends * sharedBackends;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedBackends = [[HoneywellPrinterBackends alloc] initWithProfiles:[HoneywellPrinterProfiles sharedProfiles]];
+    });
+    return sharedBackends;
+}
+
+-(instancetype)initWithProfiles:(HoneywellPrinterProfiles *)profiles
+{
+    self = [super init];
+    if (self) {
+        _profiles = profiles;
+    }
+    return self;
+}
+
+-(HoneywellBackendType)backendTypeForPrinterID:(NSString *)printerID
+{
+    const HoneywellPrinterProfile * profile = [_profiles profileForPrinterID:printerID];
+    return profile ? (HoneywellBackendType)profile->backend : HONEYWELL_BACKEND_NONE;
+}
+
+#pragma mark backends
+
+-(id<HoneywellPrinterBackend>)backendForPrinterID:(NSString *)printerID host:(NSString *)host port:(int)port
+{
+    switch ([self backendTypeForPrinterID:printerID]) {
+        
+        case HONEYWELL_BACKEND_DIRECT_PROTOCOL: {
+            HoneywellPrinterUtilities * printer = [[HoneywellPrinterUtilities alloc] init];
+            [printer initNetworkCommunication:host port:port];
+            [printer openJournalAtPath:[HoneywellPrinterUtilities journalPathForHost:host port:port]];
+            return printer;
+        }
+        
+        case HONEYWELL_BACKEND_LINE_PRINTER: {
+            /* Fingerprint label printers name their label formats with LABEL_01 */
+            HoneywellLinePrinterBackend * printer = [[HoneywellLinePrinterBackend alloc] initWithProfilePath:_profiles.path printerID:printerID];
+            printer.formFeedAfterEachLabel = [_profiles profileForPrinterID:printerID]->labelSet[0] != '\0';
+            return printer;
+        }
+        
+        case HONEYWELL_BACKEND_MOCK:
+            return [[HoneywellMockPrinterBackend alloc] initWithPrinterID:printerID];
+        
+        default:
+            NSLog(@"No printer profile for %@", printerID);
+            return nil;
+    }
+}
+
+@end
@@ -0,0 +1,27 @@
+//
+//  HoneywellPrinterIOThread.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/*
+
+ Dedicated thread with its own run loop that owns the printer streams.
+ Blocks are queued to it from any thread and run in submission order, so
+ stream events and label encoding never compete with the UI run loop.
+
+ */
+
+@interface HoneywellPrinterIOThread : NSObject
+
++(instancetype)sharedIOThread;
+
+-(void)performBlock:(void (^)(void))block;
+-(void)performBlockAndWait:(void (^)(void))block;
+-(BOOL)isCurrentThread;
+
+@end
@@ -0,0 +1,77 @@
+//
+//  HoneywellPrinterIOThread.m
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import "HoneywellPrinterIOThread.h"
+
+@interface HoneywellPrinterIOThread()
+{
+    NSThread * thread;
+}
+@end
+
+@implementation HoneywellPrinterIOThread
+
++(instancetype)sharedIOThread
+{
+    static HoneywellPrinterIOThread * sharedIOThread = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedIOThread = [[HoneywellPrinterIOThread alloc] init];
+    });
+    return sharedIOThread;
+}
+
+-(instancetype)init
+{
+    self = [super init];
+    if (self) {
+        thread = [[NSThread alloc] initWithTarget:self selector:@selector(threadMain) object:nil];
+        thread.name = @"com.ritebozz.printer-io";
+        thread.qualityOfService = NSQualityOfServiceUserInitiated;
+        [thread start];
+    }
+    return self;
+}
+
+-(void)threadMain
+{
+    /* an input port keeps the run loop alive while no stream is scheduled */
+    [[NSRunLoop currentRunLoop] addPort:[NSPort port] forMode:NSDefaultRunLoopMode];
+    
+    while (YES) {
+        @autoreleasepool {
+            [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate distantFuture]];
+        }
+    }
+}
+
+-(void)runBlock:(void (^)(void))block
+{
+    block();
+}
+
+-(void)performBlock:(void (^)(void))block
+{
+    [self performSelector:@selector(runBlock:) onThread:thread withObject:[block copy] waitUntilDone:NO];
+}
+
+-(void)performBlockAndWait:(void (^)(void))block
+{
+    if ([self isCurrentThread]) {
+        block();
+        return;
+    }
+    [self performSelector:@selector(runBlock:) onThread:thread withObject:[block copy] waitUntilDone:YES];
+}
+
+-(BOOL)isCurrentThread
+{
+    return [NSThread currentThread] == thread;
+}
+
+@end
@@ -0,0 +1,26 @@
+//
+//  HoneywellPrinterPool+Backends.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import "HoneywellPrinterPool.h"
+
+/*
+
+ Adds real printers to a pool. Kept apart from the pool itself, which only
+ needs Foundation and libdispatch, so the queue can be tested with
+ HoneywellMockPrinterBackend where there is no printer or printersdk.
+
+ */
+
+@interface HoneywellPrinterPool (Backends)
+
+-(HoneywellPrinterUtilities *)addPrinterWithHost:(NSString *)host port:(int)port;
+
+// backend picked from printer_profiles.JSON, nil for an unknown printer ID
+-(id<HoneywellPrinterBackend>)addPrinterWithID:(NSString *)printerID host:(NSString *)host port:(int)port;
+
+@end
@@ -0,0 +1,33 @@
+//
+//  HoneywellPrinterPool+Backends.m
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import "HoneywellPrinterPool+Backends.h"
+#import "HoneywellPrinterBackends.h"
+
+@implementation HoneywellPrinterPool (Backends)
+
+-(HoneywellPrinterUtilities *)addPrinterWithHost:(NSString *)host port:(int)port
+{
+    HoneywellPrinterUtilities * printer = [[HoneywellPrinterUtilities alloc] init];
+    [printer initNetworkCommunication:host port:port];
+    [printer openJournalAtPath:[HoneywellPrinterUtilities journalPathForHost:host port:port]];
+    
+    [self addBackend:printer];
+    return printer;
+}
+
+-(id<HoneywellPrinterBackend>)addPrinterWithID:(NSString *)printerID host:(NSString *)host port:(int)port
+{
+    id<HoneywellPrinterBackend> printer = [[HoneywellPrinterBackends sharedBackends] backendForPrinterID:printerID host:host port:port];
+    if (printer != nil) {
+        [self addBackend:printer];
+    }
+    return printer;
+}
+
+@end
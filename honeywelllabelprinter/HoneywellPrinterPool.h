@@ -0,0 +1,52 @@
+//
+//  HoneywellPrinterPool.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "HoneywellPrinterUtilities.h"
+
+/*
+
+ Fans label batches out over several printer connections. A batch is cut
+ into chunks and each chunk goes to the eligible printer with the fewest
+ outstanding labels. Printers only get a new chunk once their backlog is
+ below a small window, so faster printers naturally take more of the batch.
+
+ Any HoneywellPrinterBackend can join, so Direct Protocol and Bluetooth line
+ printers share one queue. Affinity rules restrict a template type to a set
+ of printer hosts (printer IDs for Bluetooth printers), e.g. food labels only
+ on the back room printer. If none of those printers is in the pool the
+ labels go to any printer instead.
+
+ Labels a printer fails are rerouted to the other printers, and the failed
+ printer gets no new chunks for a while if others are available. A batch
+ only reports NO once its failed labels have no printer left to try.
+
+ */
+
+@interface HoneywellPrinterPool : NSObject
+
+@property (nonatomic, readonly) NSArray * printers;
+
+// labels per chunk handed to a single printer, defaults to 50
+@property (nonatomic) NSUInteger chunkSize;
+
+// real printers are added with HoneywellPrinterPool+Backends.h
+-(void)addBackend:(id<HoneywellPrinterBackend>)backend;
+-(void)removeAllPrinters;
+
+// sends what every printer is holding back to batch
+-(void)flushAllPrinters;
+
+// nil or an empty array allows every printer in the pool
+-(void)setAllowedPrinterHosts:(NSArray *)hosts forTemplateType:(LabelTemplateType)type;
+
+-(NSUInteger)outstandingLabelCountForPrinter:(id<HoneywellPrinterBackend>)printer;
+
+-(void)printBatch:(id<NSFastEnumeration>)records templateType:(LabelTemplateType)type completion:(HoneywellPrintCompletion)completion;
+
+@end
@@ -0,0 +1,351 @@
+//
+//  HoneywellPrinterPool.m
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import "HoneywellPrinterPool.h"
+
+/* chunks in flight per printer before it stops taking more work */
+static const NSUInteger kMaxChunksInFlightPerPrinter = 2;
+
+/* a printer that failed labels only gets new chunks again after this,
+   unless no other printer can take them */
+static const NSTimeInterval kFailedPrinterBenchTime = 30.0;
+
+@interface HoneywellPoolBatch : NSObject
+@property (nonatomic, copy) HoneywellPrintCompletion completion;
+@property (nonatomic) NSUInteger remainingChunks;
+@property (nonatomic) BOOL failed;
+@end
+
+@implementation HoneywellPoolBatch
+@end
+
+@interface HoneywellPoolChunk : NSObject
+@property (nonatomic, strong) NSArray * records;
+@property (nonatomic) LabelTemplateType templateType;
+@property (nonatomic, strong) HoneywellPoolBatch * batch;
+// printers these records already failed on, never tried again
+@property (nonatomic, strong) NSArray * failedPrinters;
+@end
+
+@implementation HoneywellPoolChunk
+@end
+
+@interface HoneywellPrinterPool()
+{
+    /* all state below is only touched on poolQueue */
+    dispatch_queue_t poolQueue;
+    NSMutableArray * printerList;
+    NSMapTable * outstandingLabels;
+    NSMapTable * benchedUntil;
+    NSMutableDictionary * affinityRules;
+    NSMutableArray * pendingChunks;
+}
+@end
+
+@implementation HoneywellPrinterPool
+
+-(instancetype)init
+{
+    self = [super init];
+    if (self) {
+        poolQueue = dispatch_queue_create("com.ritebozz.printer-pool", DISPATCH_QUEUE_SERIAL);
+        printerList = [[NSMutableArray alloc] init];
+        outstandingLabels = [NSMapTable strongToStrongObjectsMapTable];
+        benchedUntil = [NSMapTable strongToStrongObjectsMapTable];
+        affinityRules = [[NSMutableDictionary alloc] init];
+        pendingChunks = [[NSMutableArray alloc] init];
+        _chunkSize = 50;
+    }
+    return self;
+}
+
+-(NSArray *)printers
+{
+    __block NSArray * printers;
+    dispatch_sync(poolQueue, ^{
+        printers = [printerList copy];
+    });
+    return printers;
+}
+
+#pragma mark printer management
+
+-(void)addBackend:(id<HoneywellPrinterBackend>)backend
+{
+    dispatch_async(poolQueue, ^{
+        [printerList addObject:backend];
+        [outstandingLabels setObject:@0 forKey:backend];
+        [self dispatchPendingChunks];
+    });
+}
+
+-(void)removeAllPrinters
+{
+    dispatch_async(poolQueue, ^{
+        for (id<HoneywellPrinterBackend> printer in printerList) {
+            [printer closeNetworkConnection];
+        }
+        [printerList removeAllObjects];
+        [outstandingLabels removeAllObjects];
+        [benchedUntil removeAllObjects];
+        
+        /* with no printer left the waiting chunks fail */
+        [self dispatchPendingChunks];
+    });
+}
+
+-(void)flushAllPrinters
+{
+    dispatch_async(poolQueue, ^{
+        for (id<HoneywellPrinterBackend> printer in printerList) {
+            [printer flush];
+        }
+    });
+}
+
+-(void)setAllowedPrinterHosts:(NSArray *)hosts forTemplateType:(LabelTemplateType)type
+{
+    NSSet * allowedHosts = hosts.count > 0 ? [NSSet setWithArray:hosts] : nil;
+    
+    dispatch_async(poolQueue, ^{
+        if (allowedHosts) {
+            [affinityRules setObject:allowedHosts forKey:@(type)];
+        } else {
+            [affinityRules removeObjectForKey:@(type)];
+        }
+        [self dispatchPendingChunks];
+    });
+}
+
+-(NSUInteger)outstandingLabelCountForPrinter:(id<HoneywellPrinterBackend>)printer
+{
+    __block NSUInteger count = 0;
+    dispatch_sync(poolQueue, ^{
+        count = [[outstandingLabels objectForKey:printer] unsignedIntegerValue];
+    });
+    return count;
+}
+
+#pragma mark batch distribution
+
+-(void)printBatch:(id<NSFastEnumeration>)records templateType:(LabelTemplateType)type completion:(HoneywellPrintCompletion)completion
+{
+    NSMutableArray * chunks = [[NSMutableArray alloc] init];
+    NSMutableArray * chunkRecords = nil;
+    NSUInteger chunkSize = MAX(_chunkSize, 1);
+    
+    HoneywellPoolBatch * batch = [[HoneywellPoolBatch alloc] init];
+    batch.completion = completion;
+    
+    for (NSDictionary * record in records) {
+        if (chunkRecords == nil || chunkRecords.count == chunkSize) {
+            chunkRecords = [[NSMutableArray alloc] initWithCapacity:chunkSize];
+            
+            HoneywellPoolChunk * chunk = [[HoneywellPoolChunk alloc] init];
+            chunk.records = chunkRecords;
+            chunk.templateType = type;
+            chunk.batch = batch;
+            [chunks addObject:chunk];
+        }
+        [chunkRecords addObject:[record copy]];
+    }
+    
+    batch.remainingChunks = chunks.count;
+    if (chunks.count == 0) {
+        if (completion) {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                completion(YES);
+            });
+        }
+        return;
+    }
+    
+    dispatch_async(poolQueue, ^{
+        [pendingChunks addObjectsFromArray:chunks];
+        [self dispatchPendingChunks];
+    });
+}
+
+-(BOOL)printer:(id<HoneywellPrinterBackend>)printer acceptsTemplateType:(LabelTemplateType)type
+{
+    NSSet * allowedHosts = [affinityRules objectForKey:@(type)];
+    return allowedHosts == nil || [allowedHosts containsObject:printer.printerHost];
+}
+
+-(BOOL)isPrinterBenched:(id<HoneywellPrinterBackend>)printer
+{
+    NSDate * until = [benchedUntil objectForKey:printer];
+    return until != nil && until.timeIntervalSinceNow > 0;
+}
+
+/* printers that may take the chunk, an empty array if none ever will. When
+   no printer the affinity rule allows is in the pool, or all of them failed
+   the chunk, any printer is used rather than holding the labels forever. */
+-(NSArray *)candidatePrintersForChunk:(HoneywellPoolChunk *)chunk
+{
+    NSMutableArray * usable = [[NSMutableArray alloc] init];
+    NSMutableArray * allowed = [[NSMutableArray alloc] init];
+    
+    for (id<HoneywellPrinterBackend> printer in printerList) {
+        if ([chunk.failedPrinters containsObject:printer]) {
+            continue;
+        }
+        [usable addObject:printer];
+        if ([self printer:printer acceptsTemplateType:chunk.templateType]) {
+            [allowed addObject:printer];
+        }
+    }
+    
+    NSArray * candidates = allowed.count > 0 ? allowed : usable;
+    NSIndexSet * healthy = [candidates indexesOfObjectsPassingTest:^BOOL(id<HoneywellPrinterBackend> printer, NSUInteger index, BOOL * stop) {
+        return ![self isPrinterBenched:printer];
+    }];
+    return healthy.count > 0 ? [candidates objectsAtIndexes:healthy] : candidates;
+}
+
+/* least loaded candidate that still has room in its window, or nil */
+-(id<HoneywellPrinterBackend>)printerAmong:(NSArray *)candidates
+{
+    id<HoneywellPrinterBackend> bestPrinter = nil;
+    NSUInteger bestOutstanding = NSUIntegerMax;
+    NSUInteger window = kMaxChunksInFlightPerPrinter * MAX(_chunkSize, 1);
+    
+    for (id<HoneywellPrinterBackend> printer in candidates) {
+        
+        NSUInteger outstanding = [[outstandingLabels objectForKey:printer] unsignedIntegerValue];
+        if (outstanding >= window) {
+            continue;
+        }
+        
+        /* ties go to the printer with less data still queued on its socket */
+        if (outstanding < bestOutstanding ||
+            (outstanding == bestOutstanding && printer.queuedByteCount < bestPrinter.queuedByteCount)) {
+            bestPrinter = printer;
+            bestOutstanding = outstanding;
+        }
+    }
+    return bestPrinter;
+}
+
+-(void)dispatchPendingChunks
+{
+    NSUInteger index = 0;
+    
+    while (index < pendingChunks.count) {
+        
+        HoneywellPoolChunk * chunk = pendingChunks[index];
+        NSArray * candidates = [self candidatePrintersForChunk:chunk];
+        
+        if (candidates.count == 0) {
+            NSLog(@"No printer left for %lu labels", (unsigned long)chunk.records.count);
+            [pendingChunks removeObjectAtIndex:index];
+            [self finishChunk:chunk sent:NO];
+            continue;
+        }
+        
+        id<HoneywellPrinterBackend> printer = [self printerAmong:candidates];
+        if (printer == nil) {
+            index++;
+            continue;
+        }
+        
+        [pendingChunks removeObjectAtIndex:index];
+        [self sendChunk:chunk toPrinter:printer];
+    }
+}
+
+/* identical neighbours stay together as one print call, so they still print
+   as copies, and every call reports on its own. Only the labels of failed
+   calls are sent again, nothing that already printed. */
+-(void)sendChunk:(HoneywellPoolChunk *)chunk toPrinter:(id<HoneywellPrinterBackend>)printer
+{
+    NSUInteger outstanding = [[outstandingLabels objectForKey:printer] unsignedIntegerValue];
+    [outstandingLabels setObject:@(outstanding + chunk.records.count) forKey:printer];
+    
+    NSMutableArray * runs = [[NSMutableArray alloc] init];
+    for (NSDictionary * record in chunk.records) {
+        NSMutableArray * run = runs.lastObject;
+        if (run != nil && [record isEqualToDictionary:run.lastObject]) {
+            [run addObject:record];
+        } else {
+            [runs addObject:[NSMutableArray arrayWithObject:record]];
+        }
+    }
+    
+    NSMutableIndexSet * failedRuns = [[NSMutableIndexSet alloc] init];
+    __block NSUInteger remainingRuns = runs.count;
+    
+    [runs enumerateObjectsUsingBlock:^(NSArray * run, NSUInteger runIndex, BOOL * stop) {
+        [printer printBatch:run templateType:chunk.templateType priority:PRINT_PRIORITY_BULK completion:^(BOOL sent) {
+            dispatch_async(poolQueue, ^{
+                if (!sent) {
+                    [failedRuns addIndex:runIndex];
+                }
+                if (--remainingRuns > 0) {
+                    return;
+                }
+                
+                NSMutableArray * failedRecords = [[NSMutableArray alloc] init];
+                for (NSArray * failedRun in [runs objectsAtIndexes:failedRuns]) {
+                    [failedRecords addObjectsFromArray:failedRun];
+                }
+                [self chunk:chunk didFinishOnPrinter:printer failedRecords:failedRecords];
+            });
+        }];
+    }];
+}
+
+-(void)chunk:(HoneywellPoolChunk *)chunk didFinishOnPrinter:(id<HoneywellPrinterBackend>)printer failedRecords:(NSArray *)failedRecords
+{
+    NSNumber * outstanding = [outstandingLabels objectForKey:printer];
+    if (outstanding != nil) {
+        NSUInteger remaining = outstanding.unsignedIntegerValue - MIN(outstanding.unsignedIntegerValue, chunk.records.count);
+        [outstandingLabels setObject:@(remaining) forKey:printer];
+    }
+    
+    if (failedRecords.count == 0) {
+        [self finishChunk:chunk sent:YES];
+        [self dispatchPendingChunks];
+        return;
+    }
+    
+    /* the failed labels go back in front, for any printer but this one */
+    NSLog(@"%lu labels failed on %@, rerouting them", (unsigned long)failedRecords.count, printer.printerHost);
+    if (outstanding != nil) {
+        [benchedUntil setObject:[NSDate dateWithTimeIntervalSinceNow:kFailedPrinterBenchTime] forKey:printer];
+    }
+    
+    HoneywellPoolChunk * retry = [[HoneywellPoolChunk alloc] init];
+    retry.records = failedRecords;
+    retry.templateType = chunk.templateType;
+    retry.batch = chunk.batch;
+    retry.failedPrinters = [(chunk.failedPrinters ?: @[]) arrayByAddingObject:printer];
+    
+    [pendingChunks insertObject:retry atIndex:0];
+    [self dispatchPendingChunks];
+}
+
+/* a retried chunk stands in for the one that failed, it does not count again */
+-(void)finishChunk:(HoneywellPoolChunk *)chunk sent:(BOOL)sent
+{
+    HoneywellPoolBatch * batch = chunk.batch;
+    batch.remainingChunks--;
+    if (!sent) {
+        batch.failed = YES;
+    }
+    
+    if (batch.remainingChunks == 0 && batch.completion) {
+        HoneywellPrintCompletion completion = batch.completion;
+        BOOL batchSent = !batch.failed;
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completion(batchSent);
+        });
+    }
+}
+
+@end
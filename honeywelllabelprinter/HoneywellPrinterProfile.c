@@ -0,0 +1,289 @@
+//
+//  HoneywellPrinterProfile.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#include "HoneywellPrinterProfile.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define HONEYWELL_PROFILE_CACHE_MAGIC 0x50505748u    // "HWPP"
+#define HONEYWELL_PROFILE_CACHE_VERSION 1
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t profileSize;
+    uint32_t count;
+    uint32_t reserved;
+    uint64_t sourceHash;
+} HoneywellProfileCacheHeader;
+
+#pragma mark - JSON names
+
+static const char * const sequenceNames[HONEYWELL_SEQUENCE_COUNT] = {
+    [HONEYWELL_SEQUENCE_INITIALIZE] = "Initialize",
+    [HONEYWELL_SEQUENCE_NORMAL_FONT] = "NormalFont",
+    [HONEYWELL_SEQUENCE_NEW_LINE] = "NewLine",
+    [HONEYWELL_SEQUENCE_FORM_FEED] = "FormFeed",
+    [HONEYWELL_SEQUENCE_BOLD_ON] = "BoldOn",
+    [HONEYWELL_SEQUENCE_BOLD_OFF] = "BoldOff",
+    [HONEYWELL_SEQUENCE_COMPRESS_ON] = "CompressOn",
+    [HONEYWELL_SEQUENCE_COMPRESS_OFF] = "CompressOff",
+    [HONEYWELL_SEQUENCE_DOUBLE_HIGH_ON] = "DoubleHighOn",
+    [HONEYWELL_SEQUENCE_DOUBLE_HIGH_OFF] = "DoubleHighOff",
+    [HONEYWELL_SEQUENCE_DOUBLE_WIDE_ON] = "DoubleWideOn",
+    [HONEYWELL_SEQUENCE_DOUBLE_WIDE_OFF] = "DoubleWideOff",
+    [HONEYWELL_SEQUENCE_DOUBLE_WIDE_HIGH_PREFIX] = "DoubleWideHighPrefix",
+};
+
+/* spelled as in the SDK's profile file, BtconnectRetryDelay included */
+static const char * const settingNames[HONEYWELL_SETTING_COUNT] = {
+    [HONEYWELL_SETTING_PRINT_HEAD_WIDTH] = "PrintHeadWidth",
+    [HONEYWELL_SETTING_NORMAL_DOTS_HIGH] = "NormalDotsHigh",
+    [HONEYWELL_SETTING_COMPRESS_DOTS_HIGH] = "CompressDotsHigh",
+    [HONEYWELL_SETTING_DOUBLE_HIGH_DOTS_HIGH] = "DoubleHighDotsHigh",
+    [HONEYWELL_SETTING_DOUBLE_WIDE_DOTS_HIGH] = "DoubleWideDotsHigh",
+    [HONEYWELL_SETTING_DOUBLE_HIGH_MASK] = "DoubleHighMask",
+    [HONEYWELL_SETTING_DOUBLE_WIDE_MASK] = "DoubleWideMask",
+    [HONEYWELL_SETTING_NULLS_BEFORE_CLOSE] = "NullsBeforeClose",
+    [HONEYWELL_SETTING_PRE_CLOSE_DELAY] = "PreCloseDelay",
+    [HONEYWELL_SETTING_PRE_GRAPHICS_DELAY] = "PreGraphicsDelay",
+    [HONEYWELL_SETTING_START_OF_GRAPHICS_DELAY] = "StartOfGraphicsDelay",
+    [HONEYWELL_SETTING_END_OF_GRAPHICS_DELAY] = "EndOfGraphicsDelay",
+    [HONEYWELL_SETTING_POST_GRAPHICS_DELAY] = "PostGraphicsDelay",
+    [HONEYWELL_SETTING_POST_GRAPHICS_LINE_DELAY] = "PostGraphicsLineDelay",
+    [HONEYWELL_SETTING_BT_CONNECT_RETRIES] = "BtConnectRetries",
+    [HONEYWELL_SETTING_BT_CONNECT_RETRY_DELAY] = "BtconnectRetryDelay",
+    [HONEYWELL_SETTING_BT_WRITE_DATA_READY_TIMEOUT] = "BtWriteDataReadyTimeout",
+    [HONEYWELL_SETTING_BT_WRITE_INTERVAL_TIMEOUT] = "BtWriteIntervalTimeout",
+    [HONEYWELL_SETTING_BT_MAX_SEG_WRITE] = "BtMaxSegWrite",
+    [HONEYWELL_SETTING_BT_LINGER] = "BtLinger",
+    [HONEYWELL_SETTING_CODE39_NARROW_WIDTH] = "Code39NarrowWidth",
+    [HONEYWELL_SETTING_CODE39_WIDE_WIDTH] = "Code39WideWidth",
+    [HONEYWELL_SETTING_CODE128_NARROW_WIDTH] = "Code128NarrowWidth",
+};
+
+static const char * const flagNames[HONEYWELL_FLAG_COUNT] = {
+    [HONEYWELL_FLAG_BOLD_IS_FONT] = "BoldIsFont",
+    [HONEYWELL_FLAG_COMPRESS_IS_FONT] = "CompressIsFont",
+    [HONEYWELL_FLAG_DOUBLE_HIGH_IS_FONT] = "DoubleHighIsFont",
+    [HONEYWELL_FLAG_DOUBLE_WIDE_IS_FONT] = "DoubleWideIsFont",
+    [HONEYWELL_FLAG_USE_DOUBLE_HW_MASK] = "UseDoubleHWMask",
+    [HONEYWELL_FLAG_VALIDATE_ATTRIB_ON_FORM_FEED] = "ValidateAttribOnFormFeed",
+    [HONEYWELL_FLAG_VALIDATE_ATTRIB_ON_FONT] = "ValidateAttribOnFont",
+    [HONEYWELL_FLAG_VALIDATE_ATTRIB_ON_NEW_LINE] = "ValidateAttribOnNewLn",
+};
+
+static int indexOfName(const char * const * names, int count, const char * name)
+{
+    for (int i = 0; i < count; i++) {
+        if (strcmp(names[i], name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int HoneywellProfileSequenceNamed(const char * name)
+{
+    return indexOfName(sequenceNames, HONEYWELL_SEQUENCE_COUNT, name);
+}
+
+int HoneywellProfileSettingNamed(const char * name)
+{
+    return indexOfName(settingNames, HONEYWELL_SETTING_COUNT, name);
+}
+
+int HoneywellProfileFlagNamed(const char * name)
+{
+    return indexOfName(flagNames, HONEYWELL_FLAG_COUNT, name);
+}
+
+#pragma mark - byte sequences
+
+static const char * skipSpaces(const char * text)
+{
+    while (*text == ' ' || *text == '\t') {
+        text++;
+    }
+    return text;
+}
+
+int HoneywellParseByteSequence(const char * text, HoneywellByteSequence * sequence)
+{
+    memset(sequence, 0, sizeof(*sequence));
+    
+    text = skipSpaces(text);
+    if (*text++ != '[') {
+        return -1;
+    }
+    
+    text = skipSpaces(text);
+    if (*text == ']') {
+        return *skipSpaces(text + 1) == '\0' ? 0 : -1;
+    }
+    
+    for (;;) {
+        
+        if (sequence->length == HONEYWELL_PROFILE_SEQUENCE_CAPACITY) {
+            return -1;
+        }
+        
+        text = skipSpaces(text);
+        if (*text == '!') {
+            if (sequence->placeholderCount == HONEYWELL_PROFILE_PLACEHOLDER_CAPACITY) {
+                return -1;
+            }
+            sequence->placeholders[sequence->placeholderCount++] = sequence->length;
+            sequence->bytes[sequence->length++] = 0;
+            text++;
+        }
+        else {
+            char * end;
+            long value = strtol(text, &end, 0);
+            if (end == text || value < 0 || value > 255) {
+                return -1;
+            }
+            sequence->bytes[sequence->length++] = (uint8_t)value;
+            text = end;
+        }
+        
+        text = skipSpaces(text);
+        if (*text == ',') {
+            text++;
+            continue;
+        }
+        if (*text == ']' && *skipSpaces(text + 1) == '\0') {
+            return 0;
+        }
+        return -1;
+    }
+}
+
+size_t HoneywellByteSequenceWrite(const HoneywellByteSequence * sequence, const uint8_t * values, uint8_t * out)
+{
+    memcpy(out, sequence->bytes, sequence->length);
+    for (int i = 0; i < sequence->placeholderCount; i++) {
+        out[sequence->placeholders[i]] = values[i];
+    }
+    return sequence->length;
+}
+
+#pragma mark - profile set
+
+static int compareProfiles(const void * a, const void * b)
+{
+    return strcmp(((const HoneywellPrinterProfile *)a)->printerID, ((const HoneywellPrinterProfile *)b)->printerID);
+}
+
+static int compareKeyToProfile(const void * key, const void * profile)
+{
+    return strcmp((const char *)key, ((const HoneywellPrinterProfile *)profile)->printerID);
+}
+
+void HoneywellProfileSort(HoneywellPrinterProfile * profiles, uint32_t count)
+{
+    qsort(profiles, count, sizeof(HoneywellPrinterProfile), compareProfiles);
+}
+
+const HoneywellPrinterProfile * HoneywellProfileFind(const HoneywellPrinterProfile * profiles, uint32_t count, const char * printerID)
+{
+    if (profiles == NULL || printerID == NULL) {
+        return NULL;
+    }
+    return bsearch(printerID, profiles, count, sizeof(HoneywellPrinterProfile), compareKeyToProfile);
+}
+
+#pragma mark - binary cache
+
+uint64_t HoneywellProfileSourceHash(const void * bytes, size_t length)
+{
+    const uint8_t * p = bytes;
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= p[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+uint8_t * HoneywellProfileCacheEncode(const HoneywellPrinterProfile * profiles, uint32_t count, uint64_t sourceHash, size_t * length)
+{
+    size_t size = sizeof(HoneywellProfileCacheHeader) + (size_t)count * sizeof(HoneywellPrinterProfile);
+    uint8_t * cache = malloc(size);
+    if (cache == NULL) {
+        return NULL;
+    }
+    
+    HoneywellProfileCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = HONEYWELL_PROFILE_CACHE_MAGIC;
+    header.version = HONEYWELL_PROFILE_CACHE_VERSION;
+    header.profileSize = (uint16_t)sizeof(HoneywellPrinterProfile);
+    header.count = count;
+    header.sourceHash = sourceHash;
+    
+    memcpy(cache, &header, sizeof(header));
+    if (count > 0) {
+        memcpy(cache + sizeof(header), profiles, (size_t)count * sizeof(HoneywellPrinterProfile));
+    }
+    *length = size;
+    return cache;
+}
+
+/* strings end inside their fields and sequences inside their bytes, so a
+   damaged cache can not send a lookup or a write out of bounds */
+static int profileIsValid(const HoneywellPrinterProfile * profile)
+{
+    if (memchr(profile->printerID, 0, sizeof(profile->printerID)) == NULL ||
+        memchr(profile->displayName, 0, sizeof(profile->displayName)) == NULL ||
+        memchr(profile->labelSet, 0, sizeof(profile->labelSet)) == NULL) {
+        return 0;
+    }
+    
+    for (int i = 0; i < HONEYWELL_SEQUENCE_COUNT; i++) {
+        const HoneywellByteSequence * sequence = &profile->sequences[i];
+        if (sequence->length > HONEYWELL_PROFILE_SEQUENCE_CAPACITY ||
+            sequence->placeholderCount > HONEYWELL_PROFILE_PLACEHOLDER_CAPACITY) {
+            return 0;
+        }
+        for (int p = 0; p < sequence->placeholderCount; p++) {
+            if (sequence->placeholders[p] >= sequence->length) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+const HoneywellPrinterProfile * HoneywellProfileCacheProfiles(const uint8_t * cache, size_t length, uint64_t sourceHash, uint32_t * count)
+{
+    HoneywellProfileCacheHeader header;
+    if (cache == NULL || length < sizeof(header)) {
+        return NULL;
+    }
+    memcpy(&header, cache, sizeof(header));
+    
+    /* a different layout, byte order or source file means a rebuild */
+    if (header.magic != HONEYWELL_PROFILE_CACHE_MAGIC ||
+        header.version != HONEYWELL_PROFILE_CACHE_VERSION ||
+        header.profileSize != sizeof(HoneywellPrinterProfile) ||
+        header.sourceHash != sourceHash ||
+        length != sizeof(header) + (size_t)header.count * sizeof(HoneywellPrinterProfile)) {
+        return NULL;
+    }
+    
+    const HoneywellPrinterProfile * profiles = (const HoneywellPrinterProfile *)(cache + sizeof(header));
+    for (uint32_t i = 0; i < header.count; i++) {
+        if (!profileIsValid(&profiles[i]) || (i > 0 && compareProfiles(&profiles[i - 1], &profiles[i]) >= 0)) {
+            return NULL;
+        }
+    }
+    
+    *count = header.count;
+    return profiles;
+}
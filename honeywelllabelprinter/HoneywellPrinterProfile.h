@@ -0,0 +1,157 @@
+//
+//  HoneywellPrinterProfile.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#ifndef HoneywellPrinterProfile_h
+#define HoneywellPrinterProfile_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+
+ printer_profiles.JSON resolved once into one flat struct per printer, so
+ nothing has to follow INCLUDE_nn blocks or parse "[0x1b,0x77,!]" strings
+ while printing.
+
+ Command strings become byte sequences ready to write. A '!' is a value
+ filled in when the command is sent, e.g. the font for BoldOff. Its offset
+ is kept and the byte is 0 until then.
+
+ The profiles are kept sorted by printer ID and written to a binary cache
+ as they are in memory, together with a hash of the JSON they came from.
+ A cache of another JSON file, version or struct layout is ignored.
+
+ */
+
+// longest command string in a profile, Initialize has 9 bytes
+#define HONEYWELL_PROFILE_SEQUENCE_CAPACITY 24
+#define HONEYWELL_PROFILE_PLACEHOLDER_CAPACITY 4
+
+typedef enum {
+    HONEYWELL_BACKEND_NONE = 0,
+    HONEYWELL_BACKEND_DIRECT_PROTOCOL,
+    HONEYWELL_BACKEND_LINE_PRINTER,
+    HONEYWELL_BACKEND_MOCK
+} HoneywellBackendType;
+
+typedef enum {
+    HONEYWELL_SEQUENCE_INITIALIZE = 0,
+    HONEYWELL_SEQUENCE_NORMAL_FONT,
+    HONEYWELL_SEQUENCE_NEW_LINE,
+    HONEYWELL_SEQUENCE_FORM_FEED,
+    HONEYWELL_SEQUENCE_BOLD_ON,
+    HONEYWELL_SEQUENCE_BOLD_OFF,
+    HONEYWELL_SEQUENCE_COMPRESS_ON,
+    HONEYWELL_SEQUENCE_COMPRESS_OFF,
+    HONEYWELL_SEQUENCE_DOUBLE_HIGH_ON,
+    HONEYWELL_SEQUENCE_DOUBLE_HIGH_OFF,
+    HONEYWELL_SEQUENCE_DOUBLE_WIDE_ON,
+    HONEYWELL_SEQUENCE_DOUBLE_WIDE_OFF,
+    HONEYWELL_SEQUENCE_DOUBLE_WIDE_HIGH_PREFIX,
+    HONEYWELL_SEQUENCE_COUNT
+} HoneywellProfileSequence;
+
+typedef enum {
+    HONEYWELL_SETTING_PRINT_HEAD_WIDTH = 0,
+    HONEYWELL_SETTING_NORMAL_DOTS_HIGH,
+    HONEYWELL_SETTING_COMPRESS_DOTS_HIGH,
+    HONEYWELL_SETTING_DOUBLE_HIGH_DOTS_HIGH,
+    HONEYWELL_SETTING_DOUBLE_WIDE_DOTS_HIGH,
+    HONEYWELL_SETTING_DOUBLE_HIGH_MASK,
+    HONEYWELL_SETTING_DOUBLE_WIDE_MASK,
+    HONEYWELL_SETTING_NULLS_BEFORE_CLOSE,
+    HONEYWELL_SETTING_PRE_CLOSE_DELAY,
+    HONEYWELL_SETTING_PRE_GRAPHICS_DELAY,
+    HONEYWELL_SETTING_START_OF_GRAPHICS_DELAY,
+    HONEYWELL_SETTING_END_OF_GRAPHICS_DELAY,
+    HONEYWELL_SETTING_POST_GRAPHICS_DELAY,
+    HONEYWELL_SETTING_POST_GRAPHICS_LINE_DELAY,
+    HONEYWELL_SETTING_BT_CONNECT_RETRIES,
+    HONEYWELL_SETTING_BT_CONNECT_RETRY_DELAY,
+    HONEYWELL_SETTING_BT_WRITE_DATA_READY_TIMEOUT,
+    HONEYWELL_SETTING_BT_WRITE_INTERVAL_TIMEOUT,
+    HONEYWELL_SETTING_BT_MAX_SEG_WRITE,
+    HONEYWELL_SETTING_BT_LINGER,
+    HONEYWELL_SETTING_CODE39_NARROW_WIDTH,
+    HONEYWELL_SETTING_CODE39_WIDE_WIDTH,
+    HONEYWELL_SETTING_CODE128_NARROW_WIDTH,
+    HONEYWELL_SETTING_COUNT
+} HoneywellProfileSetting;
+
+typedef enum {
+    HONEYWELL_FLAG_BOLD_IS_FONT = 0,
+    HONEYWELL_FLAG_COMPRESS_IS_FONT,
+    HONEYWELL_FLAG_DOUBLE_HIGH_IS_FONT,
+    HONEYWELL_FLAG_DOUBLE_WIDE_IS_FONT,
+    HONEYWELL_FLAG_USE_DOUBLE_HW_MASK,
+    HONEYWELL_FLAG_VALIDATE_ATTRIB_ON_FORM_FEED,
+    HONEYWELL_FLAG_VALIDATE_ATTRIB_ON_FONT,
+    HONEYWELL_FLAG_VALIDATE_ATTRIB_ON_NEW_LINE,
+    HONEYWELL_FLAG_COUNT
+} HoneywellProfileFlag;
+
+typedef struct {
+    uint8_t length;
+    uint8_t placeholderCount;
+    uint8_t placeholders[HONEYWELL_PROFILE_PLACEHOLDER_CAPACITY];
+    uint8_t bytes[HONEYWELL_PROFILE_SEQUENCE_CAPACITY];
+} HoneywellByteSequence;
+
+typedef struct {
+    char printerID[32];
+    char displayName[48];
+    // LABEL_01, the printer's label formats, empty for roll paper
+    char labelSet[32];
+    uint32_t backend;
+    uint32_t flags;
+    int32_t settings[HONEYWELL_SETTING_COUNT];
+    HoneywellByteSequence sequences[HONEYWELL_SEQUENCE_COUNT];
+} HoneywellPrinterProfile;
+
+static inline int HoneywellProfileHasFlag(const HoneywellPrinterProfile * profile, HoneywellProfileFlag flag)
+{
+    return (profile->flags >> flag) & 1;
+}
+
+#pragma mark - JSON names
+
+// index of a JSON key, -1 if the profile does not keep it
+int HoneywellProfileSequenceNamed(const char * name);
+int HoneywellProfileSettingNamed(const char * name);
+int HoneywellProfileFlagNamed(const char * name);
+
+#pragma mark - byte sequences
+
+/* parses "[0x1b,0x77,!]", returns -1 for anything else or more bytes or
+   placeholders than fit. "[]" is an empty sequence. */
+int HoneywellParseByteSequence(const char * text, HoneywellByteSequence * sequence);
+
+/* copies the sequence to out with the placeholders set to values in order,
+   returns the number of bytes written */
+size_t HoneywellByteSequenceWrite(const HoneywellByteSequence * sequence, const uint8_t * values, uint8_t * out);
+
+#pragma mark - profile set
+
+// sorts by printer ID for HoneywellProfileFind
+void HoneywellProfileSort(HoneywellPrinterProfile * profiles, uint32_t count);
+
+const HoneywellPrinterProfile * HoneywellProfileFind(const HoneywellPrinterProfile * profiles, uint32_t count, const char * printerID);
+
+#pragma mark - binary cache
+
+// FNV-1a of the JSON file, ties a cache to the file it was built from
+uint64_t HoneywellProfileSourceHash(const void * bytes, size_t length);
+
+// malloc'ed cache of sorted profiles, NULL if out of memory
+uint8_t * HoneywellProfileCacheEncode(const HoneywellPrinterProfile * profiles, uint32_t count, uint64_t sourceHash, size_t * length);
+
+/* the profiles inside cache, without copying, or NULL if it is damaged or
+   not built from the JSON with sourceHash. cache must be 8 byte aligned. */
+const HoneywellPrinterProfile * HoneywellProfileCacheProfiles(const uint8_t * cache, size_t length, uint64_t sourceHash, uint32_t * count);
+
+#endif /* HoneywellPrinterProfile_h */
@@ -0,0 +1,40 @@
+//
+//  HoneywellPrinterProfiles.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#include "HoneywellPrinterProfile.h"
+
+/*
+
+ Loads printer_profiles.JSON into HoneywellPrinterProfile structs, see
+ HoneywellPrinterProfile.h. Each printer starts from DEFAULTS, then takes
+ its INCLUDE_01, INCLUDE_02, ... blocks in order and its own values last.
+ A block may include blocks itself, which it takes before its own values
+ the same way; a block that would include itself again is skipped. Blocks
+ that other printers or blocks include are not printers themselves.
+
+ With a cache path the resolved profiles are stored there and read back on
+ the next start instead of the JSON, as long as the JSON is unchanged.
+
+ */
+
+@interface HoneywellPrinterProfiles : NSObject
+
+@property (nonatomic, readonly) NSString * path;
+@property (nonatomic, readonly) NSUInteger count;
+
+// printer_profiles.JSON from the main bundle, cached in Library/Caches
++(instancetype)sharedProfiles;
+
+// cachePath may be nil to always read the JSON
+-(instancetype)initWithJSONPath:(NSString *)path cachePath:(NSString *)cachePath;
+
+// NULL for unknown IDs, valid as long as this object
+-(const HoneywellPrinterProfile *)profileForPrinterID:(NSString *)printerID;
+
+@end
@@ -0,0 +1,253 @@
+//
+//  HoneywellPrinterProfiles.m
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import "HoneywellPrinterProfiles.h"
+
+@interface HoneywellPrinterProfiles()
+{
+    /* the cache file or the profiles built from the JSON, never mutated */
+    NSData * profileData;
+    const HoneywellPrinterProfile * profiles;
+    uint32_t profileCount;
+}
+@end
+
+@implementation HoneywellPrinterProfiles
+
++(instancetype)sharedProfiles
+{
+    static HoneywellPrinterProfiles * sharedProfiles;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSString * path = [[NSBundle mainBundle] pathForResource:@"printer_profiles" ofType:@"JSON"];
+        NSString * caches = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES).firstObject;
+        NSString * cachePath = [caches stringByAppendingPathComponent:@"printer_profiles.cache"];
+        sharedProfiles = [[HoneywellPrinterProfiles alloc] initWithJSONPath:path cachePath:cachePath];
+    });
+    return sharedProfiles;
+}
+
+-(instancetype)initWithJSONPath:(NSString *)path cachePath:(NSString *)cachePath
+{
+    self = [super init];
+    if (self) {
+        _path = [path copy];
+        
+        NSData * json = path ? [NSData dataWithContentsOfFile:path] : nil;
+        if (json == nil) {
+            NSLog(@"Printer profiles could not be read from %@", path);
+            return self;
+        }
+        uint64_t sourceHash = HoneywellProfileSourceHash(json.bytes, json.length);
+        
+        /* a mapped file is page aligned, as the cache needs */
+        NSData * cache = cachePath ? [NSData dataWithContentsOfFile:cachePath options:NSDataReadingMappedIfSafe error:nil] : nil;
+        if (cache != nil) {
+            profiles = HoneywellProfileCacheProfiles(cache.bytes, cache.length, sourceHash, &profileCount);
+            if (profiles != NULL) {
+                profileData = cache;
+                return self;
+            }
+        }
+        
+        [self buildFromJSON:json];
+        
+        if (cachePath != nil) {
+            size_t length = 0;
+            uint8_t * encoded = HoneywellProfileCacheEncode(profiles, profileCount, sourceHash, &length);
+            if (encoded != NULL) {
+                NSData * data = [NSData dataWithBytesNoCopy:encoded length:length freeWhenDone:YES];
+                if (![data writeToFile:cachePath atomically:YES]) {
+                    NSLog(@"Printer profile cache could not be written to %@", cachePath);
+                }
+            }
+        }
+    }
+    return self;
+}
+
+-(NSUInteger)count
+{
+    return profileCount;
+}
+
+-(const HoneywellPrinterProfile *)profileForPrinterID:(NSString *)printerID
+{
+    return HoneywellProfileFind(profiles, profileCount, printerID.UTF8String);
+}
+
+#pragma mark JSON
+
+-(void)buildFromJSON:(NSData *)json
+{
+    NSDictionary * root = [NSJSONSerialization JSONObjectWithData:json options:0 error:nil];
+    NSDictionary * control = [root isKindOfClass:[NSDictionary class]] ? root[@"LINEPRINTERCONTROL"] : nil;
+    NSDictionary * defaults = [control isKindOfClass:[NSDictionary class]] ? control[@"DEFAULTS"] : nil;
+    NSDictionary * printers = [control isKindOfClass:[NSDictionary class]] ? control[@"PRINTERS"] : nil;
+    if (![printers isKindOfClass:[NSDictionary class]]) {
+        NSLog(@"Printer profiles in %@ have no PRINTERS", _path);
+        return;
+    }
+    if (![defaults isKindOfClass:[NSDictionary class]]) {
+        defaults = @{};
+    }
+    
+    /* settings blocks are the entries some printer includes */
+    NSMutableSet * blocks = [[NSMutableSet alloc] init];
+    for (NSString * printerID in printers) {
+        NSDictionary * printer = printers[printerID];
+        if ([printer isKindOfClass:[NSDictionary class]]) {
+            [blocks addObjectsFromArray:[self includesOfPrinter:printer]];
+        }
+    }
+    
+    NSMutableData * built = [[NSMutableData alloc] init];
+    
+    for (NSString * printerID in printers) {
+        
+        NSDictionary * printer = printers[printerID];
+        if ([blocks containsObject:printerID] || ![printer isKindOfClass:[NSDictionary class]]) {
+            continue;
+        }
+        
+        NSMutableDictionary * settings = [defaults mutableCopy];
+        NSMutableArray * path = [[NSMutableArray alloc] initWithObjects:printerID, nil];
+        [self applyIncludesOf:printer printerID:printerID printers:printers path:path toSettings:settings];
+        [settings addEntriesFromDictionary:printer];
+        
+        HoneywellPrinterProfile profile;
+        if ([self fillProfile:&profile printerID:printerID settings:settings]) {
+            [built appendBytes:&profile length:sizeof(profile)];
+        }
+    }
+    
+    profileCount = (uint32_t)(built.length / sizeof(HoneywellPrinterProfile));
+    HoneywellProfileSort(built.mutableBytes, profileCount);
+    profileData = built;
+    profiles = built.bytes;
+}
+
+// block names in INCLUDE_01, INCLUDE_02, ... order
+-(NSArray *)includesOfPrinter:(NSDictionary *)printer
+{
+    NSMutableArray * includes = [[NSMutableArray alloc] init];
+    NSArray * keys = [printer.allKeys sortedArrayUsingSelector:@selector(compare:)];
+    for (NSString * key in keys) {
+        if ([key hasPrefix:@"INCLUDE_"] && [printer[key] isKindOfClass:[NSString class]]) {
+            [includes addObject:printer[key]];
+        }
+    }
+    return includes;
+}
+
+/* applies the blocks entry includes in order, each after the blocks it
+   includes itself, so an entry's own keys always win over its includes.
+   path holds the entries being applied, a block that includes one of them
+   again is skipped instead of recursing forever. */
+-(void)applyIncludesOf:(NSDictionary *)entry printerID:(NSString *)printerID printers:(NSDictionary *)printers path:(NSMutableArray *)path toSettings:(NSMutableDictionary *)settings
+{
+    for (NSString * block in [self includesOfPrinter:entry]) {
+        
+        NSDictionary * included = printers[block];
+        if (![included isKindOfClass:[NSDictionary class]]) {
+            NSLog(@"Printer %@ includes unknown block %@", printerID, block);
+            continue;
+        }
+        if ([path containsObject:block]) {
+            NSLog(@"Printer %@ includes block %@ in a cycle: %@", printerID, block, [path componentsJoinedByString:@" > "]);
+            continue;
+        }
+        
+        [path addObject:block];
+        [self applyIncludesOf:included printerID:printerID printers:printers path:path toSettings:settings];
+        [path removeLastObject];
+        [settings addEntriesFromDictionary:included];
+    }
+}
+
+static BOOL HoneywellCopyProfileString(id value, char * field, size_t size)
+{
+    if (value == nil) {
+        field[0] = '\0';
+        return YES;
+    }
+    if (![value isKindOfClass:[NSString class]]) {
+        return NO;
+    }
+    return strlcpy(field, [value UTF8String], size) < size;
+}
+
+/* sequences may also be JSON arrays of byte values, e.g. "Initialize": [] */
+static BOOL HoneywellParseProfileSequence(id value, HoneywellByteSequence * sequence)
+{
+    if ([value isKindOfClass:[NSString class]]) {
+        return HoneywellParseByteSequence([value UTF8String], sequence) == 0;
+    }
+    if (![value isKindOfClass:[NSArray class]] || [value count] > HONEYWELL_PROFILE_SEQUENCE_CAPACITY) {
+        return NO;
+    }
+    
+    memset(sequence, 0, sizeof(*sequence));
+    for (id byte in value) {
+        if (![byte isKindOfClass:[NSNumber class]] || [byte integerValue] < 0 || [byte integerValue] > 255) {
+            return NO;
+        }
+        sequence->bytes[sequence->length++] = (uint8_t)[byte integerValue];
+    }
+    return YES;
+}
+
+-(BOOL)fillProfile:(HoneywellPrinterProfile *)profile printerID:(NSString *)printerID settings:(NSDictionary *)settings
+{
+    memset(profile, 0, sizeof(*profile));
+    
+    if (!HoneywellCopyProfileString(printerID, profile->printerID, sizeof(profile->printerID)) ||
+        !HoneywellCopyProfileString(settings[@"DisplayName"], profile->displayName, sizeof(profile->displayName)) ||
+        !HoneywellCopyProfileString(settings[@"LABEL_01"], profile->labelSet, sizeof(profile->labelSet))) {
+        NSLog(@"Printer %@ has a name that does not fit its profile", printerID);
+        return NO;
+    }
+    
+    /* printers without a Backend are line printers, the SDK reads this file */
+    NSString * backend = settings[@"Backend"];
+    if (backend == nil || [backend isEqual:@"LinePrinter"]) {
+        profile->backend = HONEYWELL_BACKEND_LINE_PRINTER;
+    } else if ([backend isEqual:@"DirectProtocol"]) {
+        profile->backend = HONEYWELL_BACKEND_DIRECT_PROTOCOL;
+    } else if ([backend isEqual:@"Mock"]) {
+        profile->backend = HONEYWELL_BACKEND_MOCK;
+    } else {
+        NSLog(@"Unknown backend %@ for printer %@", backend, printerID);
+        profile->backend = HONEYWELL_BACKEND_NONE;
+    }
+    
+    for (NSString * key in settings) {
+        
+        const char * name = key.UTF8String;
+        id value = settings[key];
+        int index;
+        
+        if ((index = HoneywellProfileSequenceNamed(name)) >= 0) {
+            if (!HoneywellParseProfileSequence(value, &profile->sequences[index])) {
+                NSLog(@"Printer %@ has an invalid %@: %@", printerID, key, value);
+                return NO;
+            }
+        } else if ((index = HoneywellProfileSettingNamed(name)) >= 0) {
+            if ([value isKindOfClass:[NSNumber class]]) {
+                profile->settings[index] = [value intValue];
+            }
+        } else if ((index = HoneywellProfileFlagNamed(name)) >= 0) {
+            if ([value isKindOfClass:[NSNumber class]] && [value boolValue]) {
+                profile->flags |= 1u << index;
+            }
+        }
+    }
+    return YES;
+}
+
+@end
@@ -0,0 +1,144 @@
+//
+//  HoneywellPrinterState.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#include "HoneywellPrinterState.h"
+#include <string.h>
+#include <strings.h>
+
+static const char * const kBarFontSwitchKey = "BF ON|OFF";
+
+static const char * const aliases[][2] = {
+    { "ALIGN", "AN" }, { "MAGNIFY", "MAG" }, { "FONT", "FT" }, { "BARFONT", "BF" }, { "DIRECTION", "DIR" }
+};
+
+static const char * const layoutStateCommands[] = {
+    "AN", "MAG", "DIR", "FT", "BF", "BARSET", "BARTYPE", "BARHEIGHT", "BARMAG", "BARRATIO"
+};
+
+static int copyKey(const char * name, char key[HONEYWELL_STATE_KEY_CAPACITY])
+{
+    size_t length = strlen(name);
+    if (length >= HONEYWELL_STATE_KEY_CAPACITY) {
+        return -1;
+    }
+    memcpy(key, name, length + 1);
+    return 0;
+}
+
+int HoneywellStateKeyForCommand(const char * command, const char * argument, size_t argumentLength, char key[HONEYWELL_STATE_KEY_CAPACITY])
+{
+    const char * name = command;
+    for (size_t i = 0; i < sizeof(aliases) / sizeof(aliases[0]); i++) {
+        if (strcmp(command, aliases[i][0]) == 0) {
+            name = aliases[i][1];
+            break;
+        }
+    }
+    
+    if (strncmp(name, "SYSVAR(", 7) == 0) {
+        return copyKey(name, key);
+    }
+    
+    if (strcmp(name, "BF") == 0) {
+        if ((argumentLength == 2 && strncasecmp(argument, "ON", 2) == 0) ||
+            (argumentLength == 3 && strncasecmp(argument, "OFF", 3) == 0)) {
+            return copyKey(kBarFontSwitchKey, key);
+        }
+    }
+    
+    for (size_t i = 0; i < sizeof(layoutStateCommands) / sizeof(layoutStateCommands[0]); i++) {
+        if (strcmp(name, layoutStateCommands[i]) == 0) {
+            return copyKey(name, key);
+        }
+    }
+    return -1;
+}
+
+static int isPersistent(const char * key)
+{
+    return strncmp(key, "SYSVAR(", 7) == 0;
+}
+
+static HoneywellStateEntry * findEntry(const HoneywellPrinterState * state, const char * key)
+{
+    for (int i = 0; i < state->count; i++) {
+        if (strcmp(state->entries[i].key, key) == 0) {
+            return (HoneywellStateEntry *)&state->entries[i];
+        }
+    }
+    return NULL;
+}
+
+static void removeEntry(HoneywellPrinterState * state, HoneywellStateEntry * entry)
+{
+    *entry = state->entries[--state->count];
+}
+
+int HoneywellPrinterStateHasValue(const HoneywellPrinterState * state, const char * key, const char * value, size_t length)
+{
+    const HoneywellStateEntry * entry = findEntry(state, key);
+    return entry != NULL && strlen(entry->value) == length && memcmp(entry->value, value, length) == 0;
+}
+
+static int hasSuffixIgnoringCase(const char * value, size_t length, const char * suffix)
+{
+    size_t suffixLength = strlen(suffix);
+    return length >= suffixLength && strncasecmp(value + length - suffixLength, suffix, suffixLength) == 0;
+}
+
+void HoneywellPrinterStateSetValue(HoneywellPrinterState * state, const char * key, const char * value, size_t length)
+{
+    /* BF "font",size,...,ON also flips bar font printing */
+    if (strcmp(key, "BF") == 0 && (hasSuffixIgnoringCase(value, length, "ON") || hasSuffixIgnoringCase(value, length, "OFF"))) {
+        HoneywellPrinterStateInvalidate(state, kBarFontSwitchKey);
+    }
+    
+    HoneywellStateEntry * entry = findEntry(state, key);
+    if (length >= HONEYWELL_STATE_VALUE_CAPACITY || strlen(key) >= HONEYWELL_STATE_KEY_CAPACITY) {
+        if (entry != NULL) {
+            removeEntry(state, entry);
+        }
+        return;
+    }
+    
+    if (entry == NULL) {
+        if (state->count == HONEYWELL_STATE_CAPACITY) {
+            return;
+        }
+        entry = &state->entries[state->count++];
+        strcpy(entry->key, key);
+    }
+    memcpy(entry->value, value, length);
+    entry->value[length] = '\0';
+}
+
+void HoneywellPrinterStateInvalidate(HoneywellPrinterState * state, const char * key)
+{
+    HoneywellStateEntry * entry = findEntry(state, key);
+    if (entry != NULL) {
+        removeEntry(state, entry);
+    }
+    
+    if (strcmp(key, "BF") == 0) {
+        HoneywellPrinterStateInvalidate(state, kBarFontSwitchKey);
+    }
+}
+
+void HoneywellPrinterStatePrintFeed(HoneywellPrinterState * state)
+{
+    for (int i = state->count; i-- > 0;) {
+        if (!isPersistent(state->entries[i].key)) {
+            removeEntry(state, &state->entries[i]);
+        }
+    }
+}
+
+void HoneywellPrinterStateReset(HoneywellPrinterState * state)
+{
+    state->count = 0;
+}
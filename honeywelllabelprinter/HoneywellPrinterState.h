@@ -0,0 +1,55 @@
+//
+//  HoneywellPrinterState.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#ifndef HoneywellPrinterState_h
+#define HoneywellPrinterState_h
+
+#include <stddef.h>
+
+/*
+
+ Per connection shadow of the printer's state setting statements, e.g.
+ SYSVAR(18), FT, BF, AN, MAG and the BARSET family. A statement is keyed by
+ its normalized command and compared by its argument text, so the encoder
+ can skip anything that would not change what the printer already has.
+
+ SYSVAR values persist until the connection is reset. Layout settings only
+ persist until the next print feed, the firmware resets them per label, so
+ after PF nothing is assumed about them.
+
+ A zeroed struct knows nothing about the printer. A value too long to keep
+ is treated as unknown, so it is always sent again.
+
+ */
+
+#define HONEYWELL_STATE_KEY_CAPACITY 16
+#define HONEYWELL_STATE_VALUE_CAPACITY 96
+#define HONEYWELL_STATE_CAPACITY 24
+
+typedef struct {
+    char key[HONEYWELL_STATE_KEY_CAPACITY];
+    char value[HONEYWELL_STATE_VALUE_CAPACITY];
+} HoneywellStateEntry;
+
+typedef struct {
+    HoneywellStateEntry entries[HONEYWELL_STATE_CAPACITY];
+    int count;
+} HoneywellPrinterState;
+
+/* writes the state key for a statement, command as HoneywellParseStatement
+   returns it. Returns -1 if the statement does not set state. */
+int HoneywellStateKeyForCommand(const char * command, const char * argument, size_t argumentLength, char key[HONEYWELL_STATE_KEY_CAPACITY]);
+
+int HoneywellPrinterStateHasValue(const HoneywellPrinterState * state, const char * key, const char * value, size_t length);
+void HoneywellPrinterStateSetValue(HoneywellPrinterState * state, const char * key, const char * value, size_t length);
+void HoneywellPrinterStateInvalidate(HoneywellPrinterState * state, const char * key);
+
+void HoneywellPrinterStatePrintFeed(HoneywellPrinterState * state);
+void HoneywellPrinterStateReset(HoneywellPrinterState * state);
+
+#endif /* HoneywellPrinterState_h */
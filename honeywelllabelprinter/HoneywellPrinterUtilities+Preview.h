@@ -0,0 +1,22 @@
+//
+//  HoneywellPrinterUtilities+Preview.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import <CoreGraphics/CoreGraphics.h>
+#import "HoneywellPrinterUtilities.h"
+
+/* label previews for the app, kept out of HoneywellPrinterUtilities.h so the
+   print core carries no CoreGraphics */
+@interface HoneywellPrinterUtilities (Preview)
+
+/* the label as it would print, 1 bit per pixel at 203 dpi, with a stand-in
+   font, see HoneywellRasterizer.h. Barcodes come from HoneywellBarcode.h.
+   Works without a printer connection, returns NULL for OTHER_LABEL. The
+   caller releases the image. */
+-(CGImageRef)copyPreviewImageForRecord:(NSDictionary *)record templateType:(LabelTemplateType)type CF_RETURNS_RETAINED;
+
+@end
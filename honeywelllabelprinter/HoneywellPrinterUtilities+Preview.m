@@ -0,0 +1,129 @@
+//
+//  HoneywellPrinterUtilities+Preview.m
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#import "HoneywellPrinterUtilities+Preview.h"
+#import "HoneywellImageLibrary.h"
+#import "HoneywellLabelEncoder.h"
+#import "HoneywellRasterizer.h"
+#import "HoneywellBarcode.h"
+
+/* implemented in HoneywellPrinterUtilities.m */
+@interface HoneywellPrinterUtilities ()
+
++(void)withRecord:(NSDictionary *)dictionary perform:(void (^)(const HoneywellRecord * record))block;
+
+@end
+
+/* the image most recently asked for by PM, decoded once per preview */
+typedef struct {
+    __unsafe_unretained HoneywellImageLibrary * library;
+    char name[64];
+    HoneywellMonoImage image;
+} HoneywellPreviewImages;
+
+static const HoneywellMonoImage * HoneywellPreviewImageNamed(void * context, const char * name)
+{
+    HoneywellPreviewImages * images = context;
+    if (images->image.bits != NULL && strcmp(images->name, name) == 0) {
+        return &images->image;
+    }
+    HoneywellMonoImageDestroy(&images->image);
+    
+    NSData * pcx = [images->library previewImageNamed:@(name)];
+    HoneywellGreyImage grey;
+    if (pcx == nil || HoneywellPCXDecode(pcx.bytes, pcx.length, &grey) != 0) {
+        return NULL;
+    }
+    
+    /* already black and white, any threshold keeps it as it is */
+    if (HoneywellMonoImageCreate(&images->image, grey.width, grey.height) == 0) {
+        HoneywellThreshold(&grey, 128, &images->image);
+        strlcpy(images->name, name, sizeof(images->name));
+    }
+    HoneywellGreyImageDestroy(&grey);
+    return images->image.bits != NULL ? &images->image : NULL;
+}
+
+static int HoneywellPreviewEncodeBarcode(void * context, const char * type, const char * data, uint8_t * widths, int capacity)
+{
+    return HoneywellBarcodeEncode(HoneywellBarcodeTypeNamed(type), data, widths, capacity);
+}
+
+/* compiled layouts for previews, rendering without printer state leaves them untouched */
+static const HoneywellLabelEncoder * HoneywellPreviewEncoder(void)
+{
+    static HoneywellLabelEncoder * encoder;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        encoder = HoneywellLabelEncoderCreate();
+    });
+    return encoder;
+}
+
+@implementation HoneywellPrinterUtilities (Preview)
+
+-(CGImageRef)copyPreviewImageForRecord:(NSDictionary *)record templateType:(LabelTemplateType)type
+{
+    const HoneywellLabelLayout * layout = HoneywellLabelLayoutForType((int)type);
+    const HoneywellLabelEncoder * encoder = HoneywellPreviewEncoder();
+    if (layout == NULL || encoder == NULL) {
+        return NULL;
+    }
+    
+    /* label sizes in dots the templates are laid out for */
+    uint32_t width = layout->width;
+    uint32_t height = layout->height;
+    
+    __block HoneywellByteBuffer commands = { 0 };
+    __block int rendered = -1;
+    /* the printer's default image stands behind the record, as its encoder
+       puts it behind the labels it prints */
+    NSString * defaultImageName = self.defaultImageName;
+    [HoneywellPrinterUtilities withRecord:record perform:^(const HoneywellRecord * values) {
+        HoneywellRecordField defaultImage = { HONEYWELL_IMAGE_RECORD_KEY, defaultImageName.UTF8String };
+        HoneywellRecord defaults = { &defaultImage, defaultImageName != nil ? 1 : 0, NULL };
+        HoneywellRecord withDefaults = *values;
+        withDefaults.defaults = &defaults;
+        rendered = HoneywellLabelTemplateRender(HoneywellLabelEncoderTemplate(encoder, (int)type), &withDefaults, 1, NULL, &commands);
+    }];
+    if (rendered != 0) {
+        HoneywellByteBufferDestroy(&commands);
+        return NULL;
+    }
+    
+    HoneywellMonoImage label;
+    if (HoneywellMonoImageCreate(&label, width, height) != 0) {
+        HoneywellByteBufferDestroy(&commands);
+        return NULL;
+    }
+    
+    /* images come from the library's preview cache, a busy I/O thread never holds up the caller */
+    HoneywellPreviewImages images = { self.imageLibrary };
+    HoneywellRasterizerOptions options = { HoneywellPreviewImageNamed, HoneywellPreviewEncodeBarcode, &images };
+    long consumed = HoneywellRasterizeLabel(commands.bytes, commands.length, &options, &label);
+    HoneywellMonoImageDestroy(&images.image);
+    
+    if (consumed < 0) {
+        NSLog(@"Preview found no PF in %lu bytes of label commands", (unsigned long)commands.length);
+        HoneywellByteBufferDestroy(&commands);
+        HoneywellMonoImageDestroy(&label);
+        return NULL;
+    }
+    HoneywellByteBufferDestroy(&commands);
+    
+    /* set bits are white, as in DeviceGray at 1 bit per pixel */
+    NSData * bits = [NSData dataWithBytesNoCopy:label.bits length:label.bytesPerLine * height freeWhenDone:YES];
+    CGDataProviderRef provider = CGDataProviderCreateWithCFData((__bridge CFDataRef)bits);
+    CGColorSpaceRef grey = CGColorSpaceCreateDeviceGray();
+    CGImageRef image = CGImageCreate(width, height, 1, 1, label.bytesPerLine, grey, (CGBitmapInfo)kCGImageAlphaNone, provider, NULL, false, kCGRenderingIntentDefault);
+    CGColorSpaceRelease(grey);
+    CGDataProviderRelease(provider);
+    return image;
+}
+
+@end
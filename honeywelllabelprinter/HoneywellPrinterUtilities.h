@@ -7,7 +7,6 @@
 //
 
 #import <Foundation/Foundation.h>
-#import <UIKit/UIKit.h>
 
 #pragma mark framework common constants/enums
 
@@ -19,15 +18,122 @@
 typedef NS_ENUM (NSInteger,LabelTemplateType) {
     STANDARD_PRICE_LABEL = 0,
     FOOD_INFO_LABEL,
-    OTHER_LABEL
+    OTHER_LABEL,
+    DEFAULT_SIZE_LABEL
 };
 
+/* lanes of the job queue, the highest non-empty lane is always encoded next.
+   A lane switch can only happen between labels, i.e. at a PF boundary. */
+typedef NS_ENUM (NSInteger,HoneywellPrintPriority) {
+    PRINT_PRIORITY_BULK = 0,
+    PRINT_PRIORITY_NORMAL,
+    PRINT_PRIORITY_INTERACTIVE
+};
+
+#define HONEYWELL_PRINT_PRIORITY_COUNT 3
+
+/* called on the main queue once every label of the call was confirmed by the
+   printer, or with NO if closeNetworkConnection dropped them first */
+typedef void (^HoneywellPrintCompletion)(BOOL sent);
+
+#pragma mark printer backends
+
+/* what a job queue needs from a printer connection, whatever the transport.
+   HoneywellPrinterUtilities speaks Direct Protocol over TCP, see
+   HoneywellPrinterBackends.h for the line printer and mock backends and for
+   picking one from printer_profiles.JSON. */
+@protocol HoneywellPrinterBackend <NSObject>
+
+// network host, or the profile's printer ID for Bluetooth printers
+@property (readonly, copy) NSString * printerHost;
+
+// bytes handed to the backend that have not reached the printer yet
+@property (nonatomic, readonly) NSUInteger queuedByteCount;
+
+-(void)printBatch:(id<NSFastEnumeration>)records templateType:(LabelTemplateType)type priority:(HoneywellPrintPriority)priority completion:(HoneywellPrintCompletion)completion;
+
+// sends whatever the backend is holding back to batch, returns immediately
+-(void)flush;
+
+-(void)closeNetworkConnection;
+
+@end
+
 #pragma mark class interface begin
 
-@interface HoneywellPrinterUtilities : NSObject<NSStreamDelegate>
+@class HoneywellPrintJob;
+@class HoneywellImageLibrary;
+
+/*
+ Wraps the C HoneywellPrintEngine, which keeps the job queue and speaks to
+ the printer, with HoneywellLabelEncoder producing the labels. All socket
+ work runs on HoneywellPrinterIOThread, the methods below only queue the
+ job and return immediately. Label previews are in
+ HoneywellPrinterUtilities+Preview.h.
+
+ Labels stay in the job queue until the printer confirmed them. If the
+ connection drops it is reopened with jittered exponential backoff and
+ printing resumes at the first unconfirmed label.
+ */
+@interface HoneywellPrinterUtilities : NSObject<HoneywellPrinterBackend>
+
+/* upload each template once per connection with LAYOUT INPUT and send only
+   the LAYOUT RUN record per label, defaults to YES */
+@property (nonatomic) BOOL useStoredLayouts;
+
+@property (readonly, copy) NSString * printerHost;
+
+@property (nonatomic, readonly) NSUInteger queuedByteCount;
+
+/* labels queued or unconfirmed beyond this are rejected, defaults to 50000 */
+@property (nonatomic) NSUInteger maxQueuedJobs;
+
+/* labels encoded ahead of the printer's acknowledgements, defaults to 2:
+   the one printing and the next, so the printer never idles waiting for an
+   ACK round trip. A new interactive label is encoded once the first of them
+   is confirmed and prints right after the second, so it starts within two
+   label times. Each extra label in flight adds one label time to that. */
+@property (nonatomic) NSUInteger maxLabelsInFlight;
+
+/* send PRINT "ACK n ";PRSTAT after every label and confirm it only once the
+   printer echoes it back, defaults to YES. With NO a label is confirmed as
+   soon as the socket accepted its bytes. */
+@property (nonatomic) BOOL acknowledgeLabels;
+
+/* images labels refer to by their record's "image" value, uploaded to the
+   printer on demand */
+@property (nonatomic, readonly) HoneywellImageLibrary * imageLibrary;
+
+/* image for records without an "image" value, defaults to the bundled
+   1bitleaf, nil for none. The label encoder fills it in, as it does for
+   honeywellprintd. */
+@property (nonatomic, copy) NSString * defaultImageName;
+
+/* called on the main queue for every confirmed label, the job carries its
+   enqueue, write and print timestamps */
+@property (copy) void (^labelPrintedHandler)(HoneywellPrintJob * job);
+
+/* confirmed labels per second over the last few acknowledgements */
+@property (readonly) double labelsPerSecond;
 
 -(void)initNetworkCommunication:(NSString *)host port:(int)port;
 -(void)closeNetworkConnection;
+
+/* journals every label from now on and queues the labels an earlier run left
+   unfinished at path, call before printing. One journal file per printer. */
+-(void)openJournalAtPath:(NSString *)path;
+
+// Application Support/Journals/<host>_<port>.journal, the directory is created
++(NSString *)journalPathForHost:(NSString *)host port:(int)port;
+
+/* single labels go into the interactive lane, batches into the bulk lane */
 -(void)printDataOnDefaultSizeLabel:(NSMutableDictionary *)dataToPrint;
 -(void)printDataOn50x30mmLabel:(NSMutableDictionary *)dataToPrint templateType:(LabelTemplateType)type;
+-(void)printDataOn50x30mmLabel:(NSMutableDictionary *)dataToPrint templateType:(LabelTemplateType)type completion:(HoneywellPrintCompletion)completion;
+
+/* records is any NSArray or NSEnumerator of label dictionaries, identical
+   neighbours are printed as one label with copies */
+-(void)printBatch:(id<NSFastEnumeration>)records templateType:(LabelTemplateType)type;
+-(void)printBatch:(id<NSFastEnumeration>)records templateType:(LabelTemplateType)type completion:(HoneywellPrintCompletion)completion;
+-(void)printBatch:(id<NSFastEnumeration>)records templateType:(LabelTemplateType)type priority:(HoneywellPrintPriority)priority completion:(HoneywellPrintCompletion)completion;
 @end
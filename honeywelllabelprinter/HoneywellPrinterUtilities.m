@@ -17,402 +17,550 @@
  */
 
 #import "HoneywellPrinterUtilities.h"
+#import "HoneywellPrinterIOThread.h"
+#import "HoneywellPrintJob.h"
+#import "HoneywellJobJournal.h"
+#import "HoneywellImageLibrary.h"
+#import "HoneywellPrintEngine.h"
+#import "HoneywellLabelEncoder.h"
+#import <poll.h>
 
 @interface HoneywellPrinterUtilities()
 {
-    NSInputStream *inputStream;
-    NSOutputStream *outputStream;
-    NSString * printerHost;
-    NSString * imageFileName;
+    /* the engine, the encoder and everything below are only touched on the
+       I/O thread, the engine's callbacks run there too */
+    HoneywellPrinterIOThread * ioThread;
+    HoneywellPrintEngine * engine;
+    HoneywellLabelEncoder * encoder;
+    
+    /* run loop sources standing in for the engine's poll() loop */
+    CFSocketRef engineSocket;
+    CFRunLoopSourceRef engineSocketSource;
+    NSTimer * engineTimer;
+    
+    NSUInteger lastJobID;
+    HoneywellJobJournal * journal;
 }
+
+@property (readwrite) double labelsPerSecond;
+
+-(void)handleEngineEvents:(short)revents;
+-(void)invalidateEngineSocket;
+-(void)engineConnected:(HoneywellByteBuffer *)commands;
+-(HoneywellEncodeResult)encodeJob:(HoneywellPrintJob *)job into:(HoneywellByteBuffer *)commands;
+-(void)jobWritten:(HoneywellPrintJob *)job;
+-(void)finishJob:(HoneywellPrintJob *)job printed:(BOOL)printed;
+
 @end
 
+#pragma mark engine callbacks
+
+static void HoneywellEngineConnected(void * context, HoneywellByteBuffer * commands);
+static void HoneywellEngineDisconnected(void * context, int fd);
+static HoneywellEncodeResult HoneywellEngineEncodeLabel(void * context, void * job, HoneywellByteBuffer * commands);
+static void HoneywellEngineLabelWritten(void * context, void * job);
+static void HoneywellEngineLabelFinished(void * context, void * job, int printed);
+static int HoneywellEngineTextLine(void * context, const char * line, size_t length);
+static void HoneywellEngineLog(void * context, const char * message);
+
 @implementation HoneywellPrinterUtilities
 
+@synthesize printerHost;
+
+-(instancetype)init
+{
+    self = [super init];
+    if (self) {
+        _useStoredLayouts = YES;
+        _maxQueuedJobs = 50000;
+        _maxLabelsInFlight = 2;
+        _acknowledgeLabels = YES;
+        _defaultImageName = @HONEYWELL_DEFAULT_IMAGE_NAME;
+        _imageLibrary = [[HoneywellImageLibrary alloc] init];
+        ioThread = [HoneywellPrinterIOThread sharedIOThread];
+        
+        /* the engine holds self unretained, dealloc destroys it first */
+        HoneywellPrintEngineCallbacks callbacks = {
+            (__bridge void *)self,
+            HoneywellEngineConnected,
+            HoneywellEngineDisconnected,
+            HoneywellEngineEncodeLabel,
+            HoneywellEngineLabelWritten,
+            HoneywellEngineLabelFinished,
+            HoneywellEngineTextLine,
+            HoneywellEngineLog
+        };
+        engine = HoneywellPrintEngineCreate(&callbacks, NULL);
+        encoder = HoneywellLabelEncoderCreate();
+        if (engine == NULL || encoder == NULL) {
+            return nil;
+        }
+        
+        /* labels held for an image carry on once it is uploaded */
+        __weak HoneywellPrinterUtilities * weakSelf = self;
+        _imageLibrary.imagesSettledHandler = ^{
+            [weakSelf serviceEngine];
+        };
+    }
+    return self;
+}
+
+-(void)dealloc
+{
+    /* unfinished labels report as not sent */
+    HoneywellPrintEngineDestroy(engine);
+    HoneywellLabelEncoderDestroy(encoder);
+    [engineTimer invalidate];
+}
 
 #pragma mark settings functions
 
 - (void)initNetworkCommunication:(NSString *)host port:(int)port {
     
-    imageFileName = @"1bitleaf";
-    printerHost = host;
-    
-    CFReadStreamRef readStream;
-    CFWriteStreamRef writeStream;
-    CFStreamCreatePairWithSocketToHost(NULL, (__bridge CFStringRef)host, port, &readStream, &writeStream);
-    inputStream = (__bridge NSInputStream *)readStream;
-    outputStream = (__bridge NSOutputStream *)writeStream;
+    printerHost = [host copy];
     
-    [inputStream setDelegate:self];
-    [outputStream setDelegate:self];
-    [inputStream scheduleInRunLoop:[NSRunLoop currentRunLoop] forMode:NSDefaultRunLoopMode];
-    [outputStream scheduleInRunLoop:[NSRunLoop currentRunLoop] forMode:NSDefaultRunLoopMode];
-    
-    [inputStream open];
-    [outputStream open];
+    [ioThread performBlock:^{
+        HoneywellPrintEngineConnect(engine, host.UTF8String, port);
+        [self updateEngineEvents];
+    }];
 }
 
--(void)sendSettingCommands
+/* the engine's options are only touched on the I/O thread */
+-(void)pushEngineOptions
 {
-    NSMutableString * responseString = [[NSMutableString alloc]init];
-    [responseString appendString:@"SYSVAR(18)=-1 \r\n"];
-    
-    NSData *data = [[NSData alloc] initWithData:[responseString dataUsingEncoding:NSASCIIStringEncoding]];
-    [outputStream write:[data bytes] maxLength:[data length]];
+    HoneywellPrintEngineOptions options;
+    HoneywellPrintEngineDefaultOptions(&options);
+    options.maxQueuedJobs = _maxQueuedJobs;
+    options.maxLabelsInFlight = _maxLabelsInFlight;
+    options.acknowledgeLabels = _acknowledgeLabels;
+    
+    [ioThread performBlock:^{
+        HoneywellPrintEngineSetOptions(engine, &options);
+        [self serviceEngine];
+    }];
 }
 
+-(void)setMaxQueuedJobs:(NSUInteger)maxQueuedJobs
+{
+    _maxQueuedJobs = maxQueuedJobs;
+    [self pushEngineOptions];
+}
 
-- (void)closeNetworkConnection {
-    
-    [inputStream close];
-    [outputStream close];
-    
-    [inputStream setDelegate:nil];
-    [outputStream setDelegate:nil];
-    
-    [inputStream removeFromRunLoop:[NSRunLoop currentRunLoop] forMode:NSDefaultRunLoopMode];
-    [outputStream removeFromRunLoop:[NSRunLoop currentRunLoop] forMode:NSDefaultRunLoopMode];
+-(void)setMaxLabelsInFlight:(NSUInteger)maxLabelsInFlight
+{
+    _maxLabelsInFlight = maxLabelsInFlight;
+    [self pushEngineOptions];
 }
 
-#pragma mark general functions
+-(void)setAcknowledgeLabels:(BOOL)acknowledgeLabels
+{
+    _acknowledgeLabels = acknowledgeLabels;
+    [self pushEngineOptions];
+}
 
--(void)printDataOnDefaultSizeLabel:(NSMutableDictionary *)dataToPrint
+-(void)setUseStoredLayouts:(BOOL)useStoredLayouts
 {
-    [self sendSettingCommands];
-    
-    NSMutableString * printerCommandString = [self generateStandardPriceTemplate35x25mm:dataToPrint];
-    
-    NSData *data = [[NSData alloc] initWithData:[printerCommandString dataUsingEncoding:NSASCIIStringEncoding]];
-    [outputStream write:[data bytes] maxLength:[data length]];
-    
+    _useStoredLayouts = useStoredLayouts;
+    [ioThread performBlock:^{
+        HoneywellLabelEncoderSetUseStoredLayouts(encoder, useStoredLayouts);
+    }];
 }
 
--(void)printDataOn50x30mmLabel:(NSMutableDictionary*)dataToPrint templateType:(LabelTemplateType)type
+-(void)setDefaultImageName:(NSString *)defaultImageName
 {
-    [self sendSettingCommands];
-    
-    NSMutableString * printerCommandString = [[NSMutableString alloc]init];
-    
-    switch (type) {
-        case STANDARD_PRICE_LABEL:
-            printerCommandString = [self generateStandardPriceTemplate50x30mm:dataToPrint];
-            break;
-            
-        case FOOD_INFO_LABEL:
-            printerCommandString = [self generateFoodLabelTemplate50x30mm:dataToPrint];
-            break;
-            
-        default:
-            NSLog(@"Unrecognized Label Type");
-            break;
+    NSString * imageName = [defaultImageName copy];
+    _defaultImageName = imageName;
+    [ioThread performBlock:^{
+        if (HoneywellLabelEncoderSetDefaultImage(encoder, imageName.UTF8String) != 0) {
+            NSLog(@"Out of memory setting the default image");
+        }
+    }];
+}
+
+-(void)reportCompletion:(HoneywellPrintCompletion)completion sent:(BOOL)sent
+{
+    if (completion) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completion(sent);
+        });
     }
+}
+
+-(NSUInteger)queuedByteCount
+{
+    return HoneywellPrintEngineQueuedByteCount(engine);
+}
+
+- (void)closeNetworkConnection {
     
-    NSData *data = [[NSData alloc] initWithData:[printerCommandString dataUsingEncoding:NSASCIIStringEncoding]];
-    [outputStream write:[data bytes] maxLength:[data length]];
+    [ioThread performBlock:^{
+        HoneywellPrintEngineDisconnect(engine);
+        [self updateEngineEvents];
+    }];
+}
+
+/* labels are written as soon as the in-flight window allows, so there is
+   nothing held back, this only pushes what the socket takes right now */
+-(void)flush
+{
+    [ioThread performBlock:^{
+        [self serviceEngine];
+    }];
 }
 
-#pragma mark command template generator
+#pragma mark engine events
 
--(NSMutableString*)generateStandardPriceTemplate50x30mm:(NSDictionary*)dataToPrint
+static void HoneywellEngineSocketCallBack(CFSocketRef socket, CFSocketCallBackType type, CFDataRef address, const void * data, void * info)
 {
-    /* based on 5.0cm x 3.0cm label print area */
-    /* width 400 height 241 */
-    
-    NSString * barcodeTypeCode = [[dataToPrint objectForKey:HONEYWELLPRT_KEY_BARCODETYPE_CODE] uppercaseString];
-    NSString * barCodeInput = [dataToPrint objectForKey:HONEYWELLPRT_KEY_BARCODE_INPUT];
-    NSString * itemDescription = [dataToPrint objectForKey:HONEYWELLPRT_KEY_ITEM_DESC];
-    NSString * itemPrice = [dataToPrint objectForKey:HONEYWELLPRT_KEY_ITEM_PRICE];
-    
-    NSLog(@"barcodetype: %@", barcodeTypeCode);
-    
-    NSMutableString * printerCommandString = [[NSMutableString alloc]init];
-    
-    // image
-    [printerCommandString appendString:@"PP 0,190: "];
-    [printerCommandString appendString:@"AN 1: "];
-    [printerCommandString appendString:@"MAG 1,4: "];
-    [printerCommandString appendString:[NSString stringWithFormat:@"PM \"%@\": ",[imageFileName uppercaseString]]];
-    [printerCommandString appendString:@"MAG 1,1: "];
-    
-    // barcode
-    [printerCommandString appendString:@"BF ON: "];
-    [printerCommandString appendString:@"BF \"Andale Mono\",1: "];
-    [printerCommandString appendString:@"PP 200,75: "];
-    [printerCommandString appendString:@"AN 2: "];
-    [printerCommandString appendString:[NSString stringWithFormat:@"BARSET \"%@\": ", barcodeTypeCode]];
-    [printerCommandString appendString:@"BARHEIGHT 70: "];
-    [printerCommandString appendString:@"BARMAG 3: "];
-    [printerCommandString appendString:[NSString stringWithFormat:@"PB \"%@\": ", barCodeInput]];
-    
-    // multiline text item description
-    /* PX box_height, box_width, box_border_thickness, info */
-    [printerCommandString appendString:@"FT \"Andale Mono\",6: "];
-    [printerCommandString appendString:@"PP 5,35: "];
-    [printerCommandString appendString:@"AN 1: "];
-    [printerCommandString appendString:[NSString stringWithFormat:@"PX 40,400,0,\"%@\": ", itemDescription]];
-    
-    // single line text price
-    [printerCommandString appendString:@"FT \"Swiss 721 Bold Condensed BT\",9: "];
-    [printerCommandString appendString:@"PP 260,0: "];
-    [printerCommandString appendString:[NSString stringWithFormat:@"PT \"%@\": ", itemPrice]];
-    
-    // print feed
-    [printerCommandString appendString:@"PF \r\n"];
-    return printerCommandString;
+    HoneywellPrinterUtilities * utilities = (__bridge HoneywellPrinterUtilities *)info;
+    [utilities handleEngineEvents:type == kCFSocketReadCallBack ? POLLIN : POLLOUT];
 }
 
--(NSMutableString*)generateFoodLabelTemplate50x30mm:(NSMutableDictionary*)dataToPrint
+-(void)handleEngineEvents:(short)revents
 {
-    /* based on 5.0cm x 3.0cm label print area */
-    /* width 400 height 241 */
-    
-    NSString * barcodeTypeCode = [[dataToPrint objectForKey:HONEYWELLPRT_KEY_BARCODETYPE_CODE] uppercaseString];
-    NSString * barCodeInput = [dataToPrint objectForKey:HONEYWELLPRT_KEY_BARCODE_INPUT];
-    NSString * itemDescription = [dataToPrint objectForKey:HONEYWELLPRT_KEY_ITEM_DESC];
-    
-    NSMutableString * printerCommandString = [[NSMutableString alloc]init];
-    
-    // multiline text item description
-    /* PX box_height, box_width, box_border_thickness, info */
-    [printerCommandString appendString:@"FT \"Swiss 721 Bold BT\",8: "];
-    [printerCommandString appendString:@"PP 200,200: "];
-    [printerCommandString appendString:@"AN 2: "];
-    [printerCommandString appendString:[NSString stringWithFormat:@"PX 30,400,0,\"%@\": ", itemDescription]];
-    
-    // divider line below item description
-    /* PL line_width, line_thickness */
-    [printerCommandString appendString:@"PP 0,170: "];
-    [printerCommandString appendString:@"AN 1: "];
-    [printerCommandString appendString:@"PL 400,2: "];
-    
-    // barcode
-    [printerCommandString appendString:@"BF ON: "];
-    [printerCommandString appendString:@"BF \"Andale Mono\",1: "];
-    [printerCommandString appendString:@"PP 17,35: "];
-    [printerCommandString appendString:@"AN 1: "];
-    [printerCommandString appendString:[NSString stringWithFormat:@"BARSET \"%@\": ", barcodeTypeCode]];
-    [printerCommandString appendString:@"BARHEIGHT 50: "];
-    [printerCommandString appendString:[NSString stringWithFormat:@"PB \"%@\": ", barCodeInput]];
-
-    // multiline text company detail
-    [printerCommandString appendString:@"FT \"Andale Mono\",6: "];
-    [printerCommandString appendString:@"PP 200,0: "];
-    [printerCommandString appendString:@"AN 2: "];
-    [printerCommandString appendString:[NSString stringWithFormat:@"PX 25,400,0,\"%@\": ", @"Ritebos Sdn Bhd, Genius Income"]];
-    
-    // divider line top company details
-    [printerCommandString appendString:@"PP 0,25: "];
-    [printerCommandString appendString:@"AN 1: "];
-    [printerCommandString appendString:@"PL 400,2: "];
-    
-    // print feed
-    [printerCommandString appendString:@"PF \r\n"];
-    return printerCommandString;
+    HoneywellPrintEngineHandleEvents(engine, revents);
+    [self updateEngineEvents];
 }
 
--(NSMutableString*)generateStandardPriceTemplate35x25mm:(NSMutableDictionary*)dataToPrint
+-(void)engineTimerFired:(NSTimer *)timer
 {
-    /* based on 3.5cm x 2.5cm label print area */
-    /* width 280 height 201 */
-    
-    NSMutableString * printerCommandString = [[NSMutableString alloc]init];
-    
-    NSString * barcodeTypeCode = [[dataToPrint objectForKey:@"barcode"] uppercaseString];
-    NSString * input = [dataToPrint objectForKey:@"input"];
-    
-    NSLog(@"barcodetype: %@", barcodeTypeCode);
-    
-    // image
-    [printerCommandString appendString:@"PP 0,150: "];
-    [printerCommandString appendString:@"AN 1: "];
-    [printerCommandString appendString:@"MAG 1,4: "];
-    [printerCommandString appendString:[NSString stringWithFormat:@"PM \"%@\": ",[imageFileName uppercaseString]]];
-    [printerCommandString appendString:@"MAG 1,1: "];
-    
-    // barcode
-    [printerCommandString appendString:@"BF ON: "];
-    [printerCommandString appendString:@"BF \"Andale Mono\",1: "];
-    [printerCommandString appendString:@"PP 140,50: "];
-    [printerCommandString appendString:@"AN 2: "];
-    [printerCommandString appendString:[NSString stringWithFormat:@"BARSET \"%@\": ", barcodeTypeCode]];
-    [printerCommandString appendString:@"BARHEIGHT 70: "];
-    [printerCommandString appendString:[NSString stringWithFormat:@"PB \"%@\": ", input]];
-    
-    // multiline text item description
-    /* PX box_height, box_width, box_border_thickness, info */
-    [printerCommandString appendString:@"FT \"Andale Mono\",6: "];
-    [printerCommandString appendString:@"PP 5,15: "];
-    [printerCommandString appendString:@"AN 1: "];
-    [printerCommandString appendString:[NSString stringWithFormat:@"PX 40,170,0,\"%@\": ", @"A&W Rootbeer Orange-Berry Flavour 250ml"]];
-    
-    // single line text price
-    [printerCommandString appendString:@"FT \"Swiss 721 Bold Condensed BT\",9: "];
-    [printerCommandString appendString:@"PP 160,20: "];
-    [printerCommandString appendString:[NSString stringWithFormat:@"PT \"%@\": ", @"RM28000.50"]];
-    
-    // print feed
-    [printerCommandString appendString:@"PF \r\n"];
-    return printerCommandString;
+    [self handleEngineEvents:0];
 }
 
-#pragma mark upload image
+-(void)serviceEngine
+{
+    HoneywellPrintEngineService(engine);
+    [self updateEngineEvents];
+}
 
--(void)uploadImage
+/* the I/O thread's run loop watches the engine's socket and timer, called
+   after every engine call since any of them may change what it waits for */
+-(void)updateEngineEvents
 {
-    NSString * filepath = [[NSBundle mainBundle] pathForResource:imageFileName ofType:nil];
-    NSLog(@"filepath:%@",filepath);
+    int fd = HoneywellPrintEngineFileDescriptor(engine);
     
-    NSData *imageData = [[NSData alloc]initWithContentsOfFile:filepath];
-    
-    NSString * urlString = [NSString stringWithFormat:@"http://%@/manage/upload.lp?type=image",printerHost];
-    NSMutableURLRequest *request = [[NSMutableURLRequest alloc] initWithURL:[NSURL URLWithString:urlString]];
-    
-    [request setCachePolicy:NSURLRequestReloadIgnoringLocalCacheData];
-    [request setHTTPShouldHandleCookies:NO];
-    [request setTimeoutInterval:120];
-    [request setHTTPMethod:@"POST"];
-    
-    NSString *boundary = @"------WebKitFormBoundary";
-    
-    // set Content-Type in HTTP header
-    NSString *contentType = [NSString stringWithFormat:@"multipart/form-data; boundary=%@", boundary];
-    [request addValue:contentType forHTTPHeaderField:@"Content-Type"];
+    if (fd >= 0 && engineSocket == NULL) {
+        CFSocketContext context = { 0, (__bridge void *)self, NULL, NULL, NULL };
+        engineSocket = CFSocketCreateWithNative(NULL, fd, kCFSocketReadCallBack | kCFSocketWriteCallBack, HoneywellEngineSocketCallBack, &context);
+        
+        /* the engine closes the socket */
+        CFSocketSetSocketFlags(engineSocket, CFSocketGetSocketFlags(engineSocket) & ~kCFSocketCloseOnInvalidate);
+        engineSocketSource = CFSocketCreateRunLoopSource(NULL, engineSocket, 0);
+        CFRunLoopAddSource(CFRunLoopGetCurrent(), engineSocketSource, kCFRunLoopDefaultMode);
+    }
     
-    // post body
-    NSMutableData *body = [NSMutableData data];
+    if (engineSocket != NULL) {
+        if (HoneywellPrintEnginePollEvents(engine) & POLLOUT) {
+            CFSocketEnableCallBacks(engineSocket, kCFSocketWriteCallBack);
+        } else {
+            CFSocketDisableCallBacks(engineSocket, kCFSocketWriteCallBack);
+        }
+    }
     
-    // add image data
-    if (imageData) {
-        [body appendData:[[NSString stringWithFormat:@"\r\n--%@\r\n", boundary] dataUsingEncoding:NSUTF8StringEncoding]];
-        [body appendData:[[NSString stringWithFormat:@"Content-Disposition: form-data; name=\"%@\"; filename=\"%@\"\r\n", @"file", imageFileName] dataUsingEncoding:NSUTF8StringEncoding]];
-        [body appendData:[@"Content-Type: application/octet-stream\r\n\r\n" dataUsingEncoding:NSUTF8StringEncoding]];
-        [body appendData:[NSData dataWithData:imageData]];
-        [body appendData:[[NSString stringWithFormat:@"\r\n--%@\r\n", boundary] dataUsingEncoding:NSUTF8StringEncoding]];
+    [engineTimer invalidate];
+    engineTimer = nil;
+    double timeout = HoneywellPrintEngineTimeout(engine);
+    if (timeout >= 0) {
+        engineTimer = [NSTimer scheduledTimerWithTimeInterval:timeout target:self selector:@selector(engineTimerFired:) userInfo:nil repeats:NO];
     }
     
-    NSString * bodyString = [[NSString alloc]initWithData:body encoding:NSASCIIStringEncoding];
-    NSLog(@"bodyString:\n%@",bodyString);
+    self.labelsPerSecond = HoneywellPrintEngineLabelsPerSecond(engine);
+}
+
+-(void)invalidateEngineSocket
+{
+    if (engineSocket == NULL) {
+        return;
+    }
+    CFRunLoopSourceInvalidate(engineSocketSource);
+    CFRelease(engineSocketSource);
+    CFSocketInvalidate(engineSocket);
+    CFRelease(engineSocket);
+    engineSocketSource = NULL;
+    engineSocket = NULL;
+}
+
+static void HoneywellEngineConnected(void * context, HoneywellByteBuffer * commands)
+{
+    HoneywellPrinterUtilities * utilities = (__bridge HoneywellPrinterUtilities *)context;
+    [utilities engineConnected:commands];
+}
+
+static void HoneywellEngineDisconnected(void * context, int fd)
+{
+    HoneywellPrinterUtilities * utilities = (__bridge HoneywellPrinterUtilities *)context;
+    [utilities invalidateEngineSocket];
+    [utilities.imageLibrary disconnect];
+}
+
+static HoneywellEncodeResult HoneywellEngineEncodeLabel(void * context, void * job, HoneywellByteBuffer * commands)
+{
+    HoneywellPrinterUtilities * utilities = (__bridge HoneywellPrinterUtilities *)context;
+    return [utilities encodeJob:(__bridge HoneywellPrintJob *)job into:commands];
+}
+
+static void HoneywellEngineLabelWritten(void * context, void * job)
+{
+    HoneywellPrinterUtilities * utilities = (__bridge HoneywellPrinterUtilities *)context;
+    [utilities jobWritten:(__bridge HoneywellPrintJob *)job];
+}
+
+static void HoneywellEngineLabelFinished(void * context, void * job, int printed)
+{
+    HoneywellPrinterUtilities * utilities = (__bridge HoneywellPrinterUtilities *)context;
     
-    // setting the body of the post to the request
-    [request setHTTPBody:body];
+    /* the engine's reference, taken when the job was submitted */
+    [utilities finishJob:(__bridge_transfer HoneywellPrintJob *)job printed:printed != 0];
+}
+
+static int HoneywellEngineTextLine(void * context, const char * line, size_t length)
+{
+    HoneywellPrinterUtilities * utilities = (__bridge HoneywellPrinterUtilities *)context;
+    return [utilities.imageLibrary handleTextLine:line length:length];
+}
+
+static void HoneywellEngineLog(void * context, const char * message)
+{
+    NSLog(@"%s", message);
+}
+
+#pragma mark job queue
+
+-(void)submitJobs:(NSArray *)jobs completion:(HoneywellPrintCompletion)completion
+{
+    if (jobs.count == 0) {
+        [self reportCompletion:completion sent:YES];
+        return;
+    }
     
-    // set the content-length
-    NSString *postLength = [NSString stringWithFormat:@"%lu", (unsigned long)[body length]];
-    [request setValue:postLength forHTTPHeaderField:@"Content-Length"];
+    HoneywellPrintJobGroup * group = [[HoneywellPrintJobGroup alloc] initWithJobCount:jobs.count completion:completion];
+    NSTimeInterval now = [NSDate timeIntervalSinceReferenceDate];
+    for (HoneywellPrintJob * job in jobs) {
+        job.group = group;
+        job.enqueueTime = now;
+    }
     
-    NSURLSession *session = [NSURLSession sharedSession];
-    NSURLSessionDataTask *task = [session dataTaskWithRequest:request completionHandler: ^(NSData *data, NSURLResponse *response, NSError *error) {
+    [ioThread performBlock:^{
+        
+        if (HoneywellPrintEngineJobCount(engine) + jobs.count > _maxQueuedJobs) {
+            NSLog(@"Print queue full, %lu labels rejected", (unsigned long)jobs.count);
+            for (HoneywellPrintJob * job in jobs) {
+                [job.group jobFinished:NO];
+            }
+            return;
+        }
         
-        if(data.length > 0)
-        {
-            //success
-            NSString * responseString = [[NSString alloc]initWithData:data encoding:NSASCIIStringEncoding];
-            NSLog(@"responseString: \n%@",responseString);
-            
-            NSString * redirectUri = [self getRedirectURIFromHTMLString:responseString];
-            [self onUploadImageComplete:redirectUri];
+        for (HoneywellPrintJob * job in jobs) {
+            job.jobID = ++lastJobID;
+            [journal appendEnqueuedJob:job];
+            [self queueJob:job inFront:NO];
         }
+        
+        [self serviceEngine];
     }];
+}
+
+/* the engine keeps a reference to the job until labelFinished */
+-(void)queueJob:(HoneywellPrintJob *)job inFront:(BOOL)inFront
+{
+    void * reference = (void *)CFBridgingRetain(job);
+    int queued = inFront
+        ? HoneywellPrintEngineResume(engine, reference, job.jobID, (int)job.priority, (unsigned)job.copies)
+        : HoneywellPrintEngineSubmit(engine, reference, job.jobID, (int)job.priority, (unsigned)job.copies);
     
-    [task resume];
-    
+    if (queued != 0) {
+        [self finishJob:(__bridge_transfer HoneywellPrintJob *)reference printed:NO];
+    }
 }
 
-- (void)onUploadImageComplete:(NSString*)redirectURI
+-(void)jobWritten:(HoneywellPrintJob *)job
 {
-    NSString * urlString = [NSString stringWithFormat:@"http://%@/manage/%@",printerHost,redirectURI];
-    NSMutableURLRequest *request = [[NSMutableURLRequest alloc] initWithURL:[NSURL URLWithString:urlString]];
+    job.writeTime = [NSDate timeIntervalSinceReferenceDate];
+    [journal appendEntry:HONEYWELL_JOURNAL_SENT forJobID:job.jobID];
+}
+
+-(void)finishJob:(HoneywellPrintJob *)job printed:(BOOL)printed
+{
+    [journal appendEntry:printed ? HONEYWELL_JOURNAL_ACKNOWLEDGED : HONEYWELL_JOURNAL_FAILED forJobID:job.jobID];
+    [job.group jobFinished:printed];
     
-    [request setCachePolicy:NSURLRequestReloadIgnoringLocalCacheData];
-    [request setHTTPShouldHandleCookies:NO];
-    [request setTimeoutInterval:120];
-    [request setHTTPMethod:@"GET"];
+    if (!printed) {
+        return;
+    }
+    
+    NSTimeInterval now = [NSDate timeIntervalSinceReferenceDate];
+    if (job.writeTime == 0) {
+        job.writeTime = now;
+    }
+    job.printTime = now;
     
-    NSURLSession *session = [NSURLSession sharedSession];
-    NSURLSessionDataTask *task = [session dataTaskWithRequest:request completionHandler: ^(NSData *data, NSURLResponse *response, NSError *error) {
-        if(data.length > 0)
-        {
-            //success
-            NSString * responseString = [[NSString alloc]initWithData:data encoding:NSASCIIStringEncoding];
-            NSLog(@"responseString: \n%@",responseString);
+    void (^handler)(HoneywellPrintJob *) = self.labelPrintedHandler;
+    if (handler) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            handler(job);
+        });
+    }
+}
+
+#pragma mark job journal
+
+-(void)openJournalAtPath:(NSString *)path
+{
+    [ioThread performBlock:^{
+        
+        [journal close];
+        journal = [HoneywellJobJournal journalAtPath:path];
+        if (journal == nil) {
+            return;
+        }
+        
+        lastJobID = MAX(lastJobID, journal.lastJobID);
+        
+        NSArray * recoveredJobs = journal.unfinishedJobs;
+        if (recoveredJobs.count == 0) {
+            return;
+        }
+        
+        NSLog(@"Resuming %lu labels from the job journal", (unsigned long)recoveredJobs.count);
+        
+        HoneywellPrintJobGroup * group = [[HoneywellPrintJobGroup alloc] initWithJobCount:recoveredJobs.count completion:nil];
+        NSTimeInterval now = [NSDate timeIntervalSinceReferenceDate];
+        for (HoneywellPrintJob * job in [recoveredJobs reverseObjectEnumerator]) {
+            job.group = group;
+            job.enqueueTime = now;
+            [self queueJob:job inFront:YES];
         }
+        
+        [self serviceEngine];
     }];
-    
-    [task resume];
 }
 
--(NSString *)getRedirectURIFromHTMLString:(NSString*)htmlString
++(NSString *)journalPathForHost:(NSString *)host port:(int)port
 {
-    NSRange rangePrefix = [htmlString rangeOfString:@"url="];
-    if (rangePrefix.location == NSNotFound) {
-        NSLog(@"Search string was not found");
-        return @"";
-    }
-    
-    NSRange rangeSuffix = [htmlString rangeOfString:@"</head>"];
-    if(rangeSuffix.location == NSNotFound){
-        NSLog(@"Search string was not found");
-        return @"";
+    NSURL * supportDirectory = [[NSFileManager defaultManager] URLForDirectory:NSApplicationSupportDirectory
+                                                                       inDomain:NSUserDomainMask
+                                                              appropriateForURL:nil
+                                                                         create:YES
+                                                                          error:nil];
+    NSString * directory = [supportDirectory.path stringByAppendingPathComponent:@"Journals"];
+    [[NSFileManager defaultManager] createDirectoryAtPath:directory withIntermediateDirectories:YES attributes:nil error:nil];
+    
+    /* a host name or address is all the file name needs, anything else becomes _ */
+    NSMutableCharacterSet * allowed = [NSMutableCharacterSet alphanumericCharacterSet];
+    [allowed addCharactersInString:@".-"];
+    NSMutableString * name = [NSMutableString stringWithString:host ?: @""];
+    for (NSUInteger i = 0; i < name.length; i++) {
+        if (![allowed characterIsMember:[name characterAtIndex:i]]) {
+            [name replaceCharactersInRange:NSMakeRange(i, 1) withString:@"_"];
+        }
     }
     
-    NSRange uriStringRange = NSMakeRange(rangePrefix.location + rangePrefix.length,
-                                         rangeSuffix.location - (rangePrefix.location + rangePrefix.length) - 5);
-    
-    NSString *redirectUri = [htmlString substringWithRange:uriStringRange];
-    NSLog(@"redirectUri: %@", redirectUri);
+    return [directory stringByAppendingPathComponent:[NSString stringWithFormat:@"%@_%d.journal", name, port]];
+}
+
+#pragma mark general functions
+
+-(void)printDataOnDefaultSizeLabel:(NSMutableDictionary *)dataToPrint
+{
+    [self printBatch:@[dataToPrint] templateType:DEFAULT_SIZE_LABEL priority:PRINT_PRIORITY_INTERACTIVE completion:nil];
+}
+
+-(void)printDataOn50x30mmLabel:(NSMutableDictionary*)dataToPrint templateType:(LabelTemplateType)type
+{
+    [self printDataOn50x30mmLabel:dataToPrint templateType:type completion:nil];
+}
+
+-(void)printDataOn50x30mmLabel:(NSMutableDictionary*)dataToPrint templateType:(LabelTemplateType)type completion:(HoneywellPrintCompletion)completion
+{
+    [self printBatch:@[dataToPrint] templateType:type priority:PRINT_PRIORITY_INTERACTIVE completion:completion];
+}
+
+-(void)printBatch:(id<NSFastEnumeration>)records templateType:(LabelTemplateType)type
+{
+    [self printBatch:records templateType:type completion:nil];
+}
+
+-(void)printBatch:(id<NSFastEnumeration>)records templateType:(LabelTemplateType)type completion:(HoneywellPrintCompletion)completion
+{
+    [self printBatch:records templateType:type priority:PRINT_PRIORITY_BULK completion:completion];
+}
+
+-(void)printBatch:(id<NSFastEnumeration>)records templateType:(LabelTemplateType)type priority:(HoneywellPrintPriority)priority completion:(HoneywellPrintCompletion)completion
+{
+    /* records are snapshotted here, the caller is free to mutate them afterwards.
+       consecutive identical records collapse into a single label with PF n */
+    NSArray * jobs = [HoneywellPrintJob jobsWithRecords:records templateType:type priority:priority transform:nil];
     
-    return redirectUri;
+    [self submitJobs:jobs completion:completion];
+}
+
+#pragma mark label encoding
+
+/* the record as C strings, valid for the duration of block */
++(void)withRecord:(NSDictionary *)dictionary perform:(void (^)(const HoneywellRecord * record))block
+{
+    @autoreleasepool {
+        NSUInteger count = dictionary.count;
+        HoneywellRecordField * fields = calloc(count > 0 ? count : 1, sizeof(HoneywellRecordField));
+        if (fields == NULL) {
+            return;
+        }
+        
+        __block NSUInteger index = 0;
+        [dictionary enumerateKeysAndObjectsUsingBlock:^(id key, id value, BOOL * stop) {
+            fields[index].key = [key description].UTF8String;
+            fields[index].value = [value description].UTF8String;
+            index++;
+        }];
+        
+        HoneywellRecord record = { fields, index, NULL };
+        block(&record);
+        free(fields);
+    }
 }
 
-#pragma mark stream delegates
+-(void)engineConnected:(HoneywellByteBuffer *)commands
+{
+    /* stored layouts and printer state do not survive a new connection */
+    HoneywellLabelEncoderReset(encoder);
+    
+    NSMutableData * libraryCommands = [[NSMutableData alloc] init];
+    [_imageLibrary connectToPrinter:printerHost commands:libraryCommands];
+    HoneywellByteBufferAppend(commands, libraryCommands.bytes, libraryCommands.length);
+}
 
-- (void)stream:(NSStream *)theStream handleEvent:(NSStreamEvent)streamEvent {
+-(HoneywellEncodeResult)encodeJob:(HoneywellPrintJob *)job into:(HoneywellByteBuffer *)commands
+{
+    const HoneywellLabelTemplate * labelTemplate = HoneywellLabelEncoderTemplate(encoder, (int)job.templateType);
+    if (labelTemplate == NULL) {
+        NSLog(@"Unrecognized Label Type");
+        return HONEYWELL_ENCODE_FAILED;
+    }
     
-    switch (streamEvent) {
-            
-        case NSStreamEventOpenCompleted:
-            
-            if(theStream == inputStream){
-                NSLog(@"Input stream opened");
-            } else {
-                NSLog(@"Output stream opened");
-                [self uploadImage];
+    __block HoneywellEncodeResult result = HONEYWELL_ENCODE_FAILED;
+    [HoneywellPrinterUtilities withRecord:job.record perform:^(const HoneywellRecord * record) {
+        
+        /* a label waits for its image, the record's own or the encoder's
+           default, it and everything after it stay queued */
+        HoneywellRecord values = HoneywellLabelEncoderRecordWithDefaults(encoder, record);
+        const char * imageName = HoneywellRecordValue(&values, HONEYWELL_IMAGE_RECORD_KEY);
+        if (imageName != NULL && HoneywellLabelTemplateHasSlot(labelTemplate, HONEYWELL_IMAGE_RECORD_KEY)) {
+            NSMutableData * imageCommands = [[NSMutableData alloc] init];
+            HoneywellImageState state = [_imageLibrary prepareImageNamed:@(imageName) commands:imageCommands];
+            if (HoneywellByteBufferAppend(commands, imageCommands.bytes, imageCommands.length) != 0) {
+                return;
             }
-            break;
-            
-        case NSStreamEventHasBytesAvailable:
-            
-            if (theStream == inputStream) {
-                
-                uint8_t buffer[1024];
-                long len;
-                
-                while ([inputStream hasBytesAvailable]) {
-                    len = [inputStream read:buffer maxLength:sizeof(buffer)];
-                    if (len > 0) {
-                        
-                        NSString *output = [[NSString alloc] initWithBytes:buffer length:len encoding:NSASCIIStringEncoding];
-                        
-                        if (nil != output) {
-                            NSLog(@"server said: %@", output);
-                        }
-                    }
-                }
+            if (state == HONEYWELL_IMAGE_PENDING) {
+                result = HONEYWELL_ENCODE_WAIT;
+                return;
             }
-            break;
-            
-        case NSStreamEventErrorOccurred:
-            NSLog(@"Can not connect to the host!");
-            break;
-            
-        case NSStreamEventEndEncountered:
-            NSLog(@"Stream event end occured");
-            break;
-            
-        default:
-            break;
-    }
-    
+        }
+        
+        if (HoneywellLabelEncoderAppendLabel(encoder, (int)job.templateType, record, (unsigned)job.copies, commands) == 0) {
+            result = HONEYWELL_ENCODE_OK;
+        }
+    }];
+    return result;
 }
 
 @end
@@ -0,0 +1,587 @@
+//
+//  HoneywellRasterizer.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#include "HoneywellRasterizer.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PRINTER_DPI 203
+#define MAX_ARGUMENTS 8
+#define MAX_TEXT_LENGTH 512
+#define MAX_BARCODE_WIDTHS 1024
+
+/* 5x7 font, one byte per column, bit 0 is the top row and bit 7 a descender */
+static const uint8_t font5x7[95][5] = {
+    { 0x00, 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x5f, 0x00, 0x00 }, { 0x00, 0x07, 0x00, 0x07, 0x00 },
+    { 0x14, 0x7f, 0x14, 0x7f, 0x14 }, { 0x24, 0x2a, 0x7f, 0x2a, 0x12 }, { 0x23, 0x13, 0x08, 0x64, 0x62 },
+    { 0x36, 0x49, 0x56, 0x20, 0x50 }, { 0x00, 0x08, 0x07, 0x03, 0x00 }, { 0x00, 0x1c, 0x22, 0x41, 0x00 },
+    { 0x00, 0x41, 0x22, 0x1c, 0x00 }, { 0x2a, 0x1c, 0x7f, 0x1c, 0x2a }, { 0x08, 0x08, 0x3e, 0x08, 0x08 },
+    { 0x00, 0x80, 0x70, 0x30, 0x00 }, { 0x08, 0x08, 0x08, 0x08, 0x08 }, { 0x00, 0x00, 0x60, 0x60, 0x00 },
+    { 0x20, 0x10, 0x08, 0x04, 0x02 }, { 0x3e, 0x51, 0x49, 0x45, 0x3e }, { 0x00, 0x42, 0x7f, 0x40, 0x00 },
+    { 0x72, 0x49, 0x49, 0x49, 0x46 }, { 0x21, 0x41, 0x49, 0x4d, 0x33 }, { 0x18, 0x14, 0x12, 0x7f, 0x10 },
+    { 0x27, 0x45, 0x45, 0x45, 0x39 }, { 0x3c, 0x4a, 0x49, 0x49, 0x31 }, { 0x41, 0x21, 0x11, 0x09, 0x07 },
+    { 0x36, 0x49, 0x49, 0x49, 0x36 }, { 0x46, 0x49, 0x49, 0x29, 0x1e }, { 0x00, 0x00, 0x14, 0x00, 0x00 },
+    { 0x00, 0x40, 0x34, 0x00, 0x00 }, { 0x00, 0x08, 0x14, 0x22, 0x41 }, { 0x14, 0x14, 0x14, 0x14, 0x14 },
+    { 0x00, 0x41, 0x22, 0x14, 0x08 }, { 0x02, 0x01, 0x59, 0x09, 0x06 }, { 0x3e, 0x41, 0x5d, 0x59, 0x4e },
+    { 0x7c, 0x12, 0x11, 0x12, 0x7c }, { 0x7f, 0x49, 0x49, 0x49, 0x36 }, { 0x3e, 0x41, 0x41, 0x41, 0x22 },
+    { 0x7f, 0x41, 0x41, 0x41, 0x3e }, { 0x7f, 0x49, 0x49, 0x49, 0x41 }, { 0x7f, 0x09, 0x09, 0x09, 0x01 },
+    { 0x3e, 0x41, 0x41, 0x51, 0x73 }, { 0x7f, 0x08, 0x08, 0x08, 0x7f }, { 0x00, 0x41, 0x7f, 0x41, 0x00 },
+    { 0x20, 0x40, 0x41, 0x3f, 0x01 }, { 0x7f, 0x08, 0x14, 0x22, 0x41 }, { 0x7f, 0x40, 0x40, 0x40, 0x40 },
+    { 0x7f, 0x02, 0x1c, 0x02, 0x7f }, { 0x7f, 0x04, 0x08, 0x10, 0x7f }, { 0x3e, 0x41, 0x41, 0x41, 0x3e },
+    { 0x7f, 0x09, 0x09, 0x09, 0x06 }, { 0x3e, 0x41, 0x51, 0x21, 0x5e }, { 0x7f, 0x09, 0x19, 0x29, 0x46 },
+    { 0x26, 0x49, 0x49, 0x49, 0x32 }, { 0x03, 0x01, 0x7f, 0x01, 0x03 }, { 0x3f, 0x40, 0x40, 0x40, 0x3f },
+    { 0x1f, 0x20, 0x40, 0x20, 0x1f }, { 0x3f, 0x40, 0x38, 0x40, 0x3f }, { 0x63, 0x14, 0x08, 0x14, 0x63 },
+    { 0x03, 0x04, 0x78, 0x04, 0x03 }, { 0x61, 0x59, 0x49, 0x4d, 0x43 }, { 0x00, 0x7f, 0x41, 0x41, 0x41 },
+    { 0x02, 0x04, 0x08, 0x10, 0x20 }, { 0x00, 0x41, 0x41, 0x41, 0x7f }, { 0x04, 0x02, 0x01, 0x02, 0x04 },
+    { 0x40, 0x40, 0x40, 0x40, 0x40 }, { 0x00, 0x03, 0x07, 0x08, 0x00 }, { 0x20, 0x54, 0x54, 0x78, 0x40 },
+    { 0x7f, 0x28, 0x44, 0x44, 0x38 }, { 0x38, 0x44, 0x44, 0x44, 0x28 }, { 0x38, 0x44, 0x44, 0x28, 0x7f },
+    { 0x38, 0x54, 0x54, 0x54, 0x18 }, { 0x00, 0x08, 0x7e, 0x09, 0x02 }, { 0x18, 0xa4, 0xa4, 0x9c, 0x78 },
+    { 0x7f, 0x08, 0x04, 0x04, 0x78 }, { 0x00, 0x44, 0x7d, 0x40, 0x00 }, { 0x20, 0x40, 0x40, 0x3d, 0x00 },
+    { 0x7f, 0x10, 0x28, 0x44, 0x00 }, { 0x00, 0x41, 0x7f, 0x40, 0x00 }, { 0x7c, 0x04, 0x78, 0x04, 0x78 },
+    { 0x7c, 0x08, 0x04, 0x04, 0x78 }, { 0x38, 0x44, 0x44, 0x44, 0x38 }, { 0xfc, 0x18, 0x24, 0x24, 0x18 },
+    { 0x18, 0x24, 0x24, 0x18, 0xfc }, { 0x7c, 0x08, 0x04, 0x04, 0x08 }, { 0x48, 0x54, 0x54, 0x54, 0x24 },
+    { 0x04, 0x04, 0x3f, 0x44, 0x24 }, { 0x3c, 0x40, 0x40, 0x20, 0x7c }, { 0x1c, 0x20, 0x40, 0x20, 0x1c },
+    { 0x3c, 0x40, 0x30, 0x40, 0x3c }, { 0x44, 0x28, 0x10, 0x28, 0x44 }, { 0x4c, 0x90, 0x90, 0x90, 0x7c },
+    { 0x44, 0x64, 0x54, 0x4c, 0x44 }, { 0x00, 0x08, 0x36, 0x41, 0x00 }, { 0x00, 0x00, 0x77, 0x00, 0x00 },
+    { 0x00, 0x41, 0x36, 0x08, 0x00 }, { 0x02, 0x01, 0x02, 0x04, 0x02 },
+};
+
+/* glyph cell is 6x8 font pixels, 7 rows above the baseline */
+#define GLYPH_ADVANCE 6
+#define GLYPH_ASCENT 7
+#define GLYPH_LINE 9
+
+typedef struct {
+    int x;
+    int y;
+    int anchor;
+    int magH;
+    int magV;
+    int fontSize;
+    int barHeight;
+    int barMag;
+    char barType[16];
+} RasterState;
+
+typedef struct {
+    int isText;
+    long number;
+    const char * text;
+    size_t length;
+} Argument;
+
+#pragma mark - drawing
+
+/* clears bits x0 up to x1 in a packed row, whole bytes in the middle */
+static void blackenSpan(uint8_t * row, int x0, int x1)
+{
+    int first = x0 >> 3;
+    int last = (x1 - 1) >> 3;
+    uint8_t firstMask = (uint8_t)(0xff >> (x0 & 7));
+    uint8_t lastMask = (uint8_t)(0xff << (7 - ((x1 - 1) & 7)));
+    
+    if (first == last) {
+        row[first] &= (uint8_t)~(firstMask & lastMask);
+        return;
+    }
+    row[first] &= (uint8_t)~firstMask;
+    memset(row + first + 1, 0, (size_t)(last - first - 1));
+    row[last] &= (uint8_t)~lastMask;
+}
+
+/* x, y is the lower left corner in label coordinates */
+static void fillRect(HoneywellMonoImage * label, int x, int y, int width, int height)
+{
+    int x0 = x < 0 ? 0 : x;
+    int x1 = x + width > (int)label->width ? (int)label->width : x + width;
+    int top = (int)label->height - (y + height);
+    int bottom = (int)label->height - y;
+    if (top < 0) {
+        top = 0;
+    }
+    if (bottom > (int)label->height) {
+        bottom = (int)label->height;
+    }
+    if (x0 >= x1 || top >= bottom) {
+        return;
+    }
+    
+    for (int row = top; row < bottom; row++) {
+        blackenSpan(label->bits + (size_t)row * label->bytesPerLine, x0, x1);
+    }
+}
+
+/* draws the black pixels of a packed source row, a byte at a time when it
+   lies fully inside the label */
+static void blitRow(uint8_t * row, int rowWidth, int x, const uint8_t * source, int width)
+{
+    if (x < 0 || x + width > rowWidth) {
+        for (int i = 0; i < width; i++) {
+            int dx = x + i;
+            if (dx >= 0 && dx < rowWidth && !(source[i >> 3] & (0x80 >> (i & 7)))) {
+                row[dx >> 3] &= (uint8_t)~(0x80 >> (dx & 7));
+            }
+        }
+        return;
+    }
+    
+    int shift = x & 7;
+    uint8_t * out = row + (x >> 3);
+    int bytes = (width + 7) >> 3;
+    
+    for (int i = 0; i < bytes; i++) {
+        uint8_t black = (uint8_t)~source[i];
+        if (i == bytes - 1 && (width & 7)) {
+            black &= (uint8_t)(0xff << (8 - (width & 7)));
+        }
+        out[i] &= (uint8_t)~(black >> shift);
+        uint8_t spill = (uint8_t)(black << (8 - shift));
+        if (shift && spill) {
+            out[i + 1] &= (uint8_t)~spill;
+        }
+    }
+}
+
+static void drawImage(HoneywellMonoImage * label, const HoneywellMonoImage * image, int x, int y, int magH, int magV)
+{
+    int width = (int)image->width * magH;
+    int height = (int)image->height * magV;
+    
+    /* widened rows are built once and then blitted magV times */
+    uint8_t * wide = NULL;
+    if (magH > 1) {
+        wide = malloc(((size_t)width + 7) / 8);
+        if (wide == NULL) {
+            return;
+        }
+    }
+    
+    int top = (int)label->height - (y + height);
+    
+    for (uint32_t sy = 0; sy < image->height; sy++) {
+        
+        const uint8_t * source = image->bits + (size_t)sy * image->bytesPerLine;
+        if (wide != NULL) {
+            memset(wide, 0xff, ((size_t)width + 7) / 8);
+            for (uint32_t sx = 0; sx < image->width; sx++) {
+                if (!(source[sx >> 3] & (0x80 >> (sx & 7)))) {
+                    blackenSpan(wide, (int)sx * magH, (int)(sx + 1) * magH);
+                }
+            }
+            source = wide;
+        }
+        
+        for (int r = 0; r < magV; r++) {
+            int row = top + (int)sy * magV + r;
+            if (row >= 0 && row < (int)label->height) {
+                blitRow(label->bits + (size_t)row * label->bytesPerLine, (int)label->width, x, source, width);
+            }
+        }
+    }
+    
+    free(wide);
+}
+
+#pragma mark - text
+
+static int fontScale(int fontSize)
+{
+    int dots = fontSize * PRINTER_DPI / 72;
+    int scale = (dots + 4) / 8;
+    return scale < 1 ? 1 : scale;
+}
+
+static int textWidth(size_t length, int scaleH)
+{
+    return length == 0 ? 0 : (int)length * GLYPH_ADVANCE * scaleH - scaleH;
+}
+
+/* x is the left edge, y the baseline */
+static void drawText(HoneywellMonoImage * label, const char * text, size_t length, int x, int y, int scaleH, int scaleV)
+{
+    for (size_t i = 0; i < length; i++, x += GLYPH_ADVANCE * scaleH) {
+        
+        unsigned char c = (unsigned char)text[i];
+        if (c < 32 || c > 126) {
+            c = '?';
+        }
+        const uint8_t * glyph = font5x7[c - 32];
+        
+        /* one rectangle per vertical run of set pixels */
+        for (int column = 0; column < 5; column++) {
+            uint8_t bits = glyph[column];
+            int rowIndex = 0;
+            while (bits) {
+                while (!(bits & 1)) {
+                    bits >>= 1;
+                    rowIndex++;
+                }
+                int run = 0;
+                while (bits & 1) {
+                    bits >>= 1;
+                    run++;
+                }
+                int runBottom = y + (GLYPH_ASCENT - rowIndex - run) * scaleV;
+                fillRect(label, x + column * scaleH, runBottom, scaleH, run * scaleV);
+                rowIndex += run;
+            }
+        }
+    }
+}
+
+#pragma mark - statements
+
+static void anchorBox(const RasterState * state, int width, int height, int * x, int * y)
+{
+    int anchor = state->anchor;
+    *x = state->x;
+    *y = state->y;
+    
+    if (anchor == 2 || anchor == 5 || anchor == 8) {
+        *x -= width / 2;
+    }
+    else if (anchor == 3 || anchor == 6 || anchor == 9) {
+        *x -= width;
+    }
+    if (anchor >= 4 && anchor <= 6) {
+        *y -= height / 2;
+    }
+    else if (anchor >= 7) {
+        *y -= height;
+    }
+}
+
+/* arguments are separated by commas, quoted parts joined by ; are one text */
+static int parseArguments(const char * p, const char * end, Argument * arguments, char * text, size_t textCapacity)
+{
+    int count = 0;
+    size_t textLength = 0;
+    
+    while (p < end && count < MAX_ARGUMENTS) {
+        
+        while (p < end && (*p == ' ' || *p == '\t')) {
+            p++;
+        }
+        if (p >= end) {
+            break;
+        }
+        
+        Argument * argument = &arguments[count++];
+        memset(argument, 0, sizeof(*argument));
+        
+        if (*p == '"') {
+            argument->isText = 1;
+            argument->text = text + textLength;
+            while (p < end && *p == '"') {
+                p++;
+                while (p < end && *p != '"') {
+                    if (textLength + 1 < textCapacity) {
+                        text[textLength++] = *p;
+                    }
+                    p++;
+                }
+                p++;
+                while (p < end && (*p == ' ' || *p == ';')) {
+                    p++;
+                }
+            }
+            argument->length = (size_t)(text + textLength - argument->text);
+            text[textLength++ < textCapacity ? textLength - 1 : textCapacity - 1] = '\0';
+        }
+        else {
+            argument->number = strtol(p, NULL, 10);
+        }
+        
+        while (p < end && *p != ',') {
+            p++;
+        }
+        p++;
+    }
+    return count;
+}
+
+static int isCommand(const char * command, const char * shortName, const char * longName)
+{
+    return strcmp(command, shortName) == 0 || (longName != NULL && strcmp(command, longName) == 0);
+}
+
+static void drawBox(HoneywellMonoImage * label, const RasterState * state, const Argument * arguments, int count)
+{
+    int height = (int)arguments[0].number;
+    int width = (int)arguments[1].number;
+    int border = (int)arguments[2].number;
+    int x;
+    int y;
+    anchorBox(state, width, height, &x, &y);
+    
+    if (border > 0) {
+        fillRect(label, x, y + height - border, width, border);
+        fillRect(label, x, y, width, border);
+        fillRect(label, x, y, border, height);
+        fillRect(label, x + width - border, y, border, height);
+    }
+    
+    if (count < 4 || !arguments[3].isText) {
+        return;
+    }
+    
+    /* greedy word wrap into the inside of the box, top line first */
+    int scale = fontScale(state->fontSize);
+    int scaleH = scale * state->magH;
+    int scaleV = scale * state->magV;
+    int innerWidth = width - 2 * border;
+    size_t perLine = (size_t)((innerWidth + scaleH) / (GLYPH_ADVANCE * scaleH));
+    if (perLine == 0) {
+        return;
+    }
+    
+    const char * text = arguments[3].text;
+    size_t remaining = arguments[3].length;
+    int baseline = y + height - border - GLYPH_ASCENT * scaleV;
+    
+    while (remaining > 0 && baseline - scaleV >= y + border) {
+        
+        while (remaining > 0 && *text == ' ') {
+            text++;
+            remaining--;
+        }
+        size_t lineLength = remaining < perLine ? remaining : perLine;
+        if (lineLength < remaining) {
+            size_t space = lineLength;
+            while (space > 0 && text[space] != ' ') {
+                space--;
+            }
+            if (space > 0) {
+                lineLength = space;
+            }
+        }
+        
+        drawText(label, text, lineLength, x + border, baseline, scaleH, scaleV);
+        text += lineLength;
+        remaining -= lineLength;
+        baseline -= GLYPH_LINE * scaleV;
+    }
+}
+
+static void drawBarcode(HoneywellMonoImage * label, const RasterState * state, const Argument * data, const HoneywellRasterizerOptions * options)
+{
+    uint8_t widths[MAX_BARCODE_WIDTHS];
+    int count = -1;
+    
+    if (options != NULL && options->encodeBarcode != NULL) {
+        count = options->encodeBarcode(options->context, state->barType, data->text, widths, MAX_BARCODE_WIDTHS);
+    }
+    
+    /* stand-in pattern of about Code 128 width, 11 modules per character */
+    if (count < 0) {
+        count = 0;
+        for (size_t i = 0; i < data->length && count + 6 <= MAX_BARCODE_WIDTHS; i++) {
+            unsigned char c = (unsigned char)data->text[i];
+            for (int bit = 0; bit < 6; bit++) {
+                widths[count++] = (uint8_t)(1 + ((c >> bit) & 1));
+            }
+        }
+    }
+    
+    int modules = 0;
+    for (int i = 0; i < count; i++) {
+        modules += widths[i];
+    }
+    
+    int x;
+    int y;
+    anchorBox(state, modules * state->barMag, state->barHeight, &x, &y);
+    
+    for (int i = 0; i < count; i++) {
+        int barWidth = widths[i] * state->barMag;
+        if ((i & 1) == 0) {
+            fillRect(label, x, y, barWidth, state->barHeight);
+        }
+        x += barWidth;
+    }
+}
+
+/* returns 1 once the statement was PF */
+static int executeStatement(HoneywellMonoImage * label, RasterState * state, const char * p, const char * end, const HoneywellRasterizerOptions * options)
+{
+    while (p < end && (*p == ' ' || *p == '\t')) {
+        p++;
+    }
+    
+    char command[16];
+    size_t commandLength = 0;
+    while (p < end && *p != ' ' && *p != '"' && *p != ',') {
+        if (commandLength + 1 < sizeof(command)) {
+            command[commandLength++] = (char)toupper((unsigned char)*p);
+        }
+        p++;
+    }
+    command[commandLength] = '\0';
+    if (commandLength == 0) {
+        return 0;
+    }
+    
+    Argument arguments[MAX_ARGUMENTS];
+    char text[MAX_TEXT_LENGTH];
+    int count = parseArguments(p, end, arguments, text, sizeof(text));
+    
+    if (isCommand(command, "PF", "PRINTFEED")) {
+        return 1;
+    }
+    else if (isCommand(command, "PP", "PRPOS") && count >= 2) {
+        state->x = (int)arguments[0].number;
+        state->y = (int)arguments[1].number;
+    }
+    else if (isCommand(command, "AN", "ALIGN") && count >= 1) {
+        state->anchor = (int)arguments[0].number;
+    }
+    else if (isCommand(command, "MAG", "MAGNIFY") && count >= 2) {
+        state->magH = arguments[0].number > 0 ? (int)arguments[0].number : 1;
+        state->magV = arguments[1].number > 0 ? (int)arguments[1].number : 1;
+    }
+    else if (isCommand(command, "FT", "FONT") && count >= 2 && !arguments[1].isText) {
+        state->fontSize = arguments[1].number > 0 ? (int)arguments[1].number : state->fontSize;
+    }
+    else if (isCommand(command, "PT", "PRTXT") && count >= 1 && arguments[0].isText) {
+        int scale = fontScale(state->fontSize);
+        int scaleH = scale * state->magH;
+        int scaleV = scale * state->magV;
+        int x;
+        int y;
+        anchorBox(state, textWidth(arguments[0].length, scaleH), GLYPH_ASCENT * scaleV, &x, &y);
+        drawText(label, arguments[0].text, arguments[0].length, x, y, scaleH, scaleV);
+    }
+    else if (isCommand(command, "PX", "PRBOX") && count >= 3) {
+        drawBox(label, state, arguments, count);
+    }
+    else if (isCommand(command, "PL", "PRLINE") && count >= 2) {
+        int x;
+        int y;
+        anchorBox(state, (int)arguments[0].number, (int)arguments[1].number, &x, &y);
+        fillRect(label, x, y, (int)arguments[0].number, (int)arguments[1].number);
+    }
+    else if (isCommand(command, "BARSET", NULL) && count >= 1) {
+        if (arguments[0].isText) {
+            strncpy(state->barType, arguments[0].text, sizeof(state->barType) - 1);
+        }
+        /* BARSET type, ratio large, ratio small, enlargement, height */
+        if (count >= 4 && arguments[3].number > 0) {
+            state->barMag = (int)arguments[3].number;
+        }
+        if (count >= 5 && arguments[4].number > 0) {
+            state->barHeight = (int)arguments[4].number;
+        }
+    }
+    else if (isCommand(command, "BT", "BARTYPE") && count >= 1 && arguments[0].isText) {
+        strncpy(state->barType, arguments[0].text, sizeof(state->barType) - 1);
+    }
+    else if (isCommand(command, "BH", "BARHEIGHT") && count >= 1) {
+        state->barHeight = (int)arguments[0].number;
+    }
+    else if (isCommand(command, "BM", "BARMAG") && count >= 1) {
+        state->barMag = arguments[0].number > 0 ? (int)arguments[0].number : 1;
+    }
+    else if (isCommand(command, "PB", "PRBAR") && count >= 1 && arguments[0].isText) {
+        drawBarcode(label, state, &arguments[0], options);
+    }
+    else if (isCommand(command, "PM", "PRIMAGE") && count >= 1 && arguments[0].isText) {
+        const HoneywellMonoImage * image = NULL;
+        if (options != NULL && options->imageNamed != NULL) {
+            image = options->imageNamed(options->context, arguments[0].text);
+        }
+        if (image != NULL) {
+            int x;
+            int y;
+            anchorBox(state, (int)image->width * state->magH, (int)image->height * state->magV, &x, &y);
+            drawImage(label, image, x, y, state->magH, state->magV);
+        }
+    }
+    return 0;
+}
+
+#pragma mark - labels
+
+long HoneywellRasterizeLabel(const char * commands, size_t length, const HoneywellRasterizerOptions * options, HoneywellMonoImage * label)
+{
+    /* printer defaults at the start of a label */
+    RasterState state = { 0 };
+    state.anchor = 1;
+    state.magH = 1;
+    state.magV = 1;
+    state.fontSize = 12;
+    state.barHeight = 100;
+    state.barMag = 2;
+    strcpy(state.barType, "EAN13");
+    
+    memset(label->bits, 0xff, label->bytesPerLine * label->height);
+    
+    const char * p = commands;
+    const char * end = commands + length;
+    
+    while (p < end) {
+        
+        const char * start = p;
+        int quoted = 0;
+        while (p < end) {
+            if (*p == '"') {
+                quoted = !quoted;
+            }
+            else if (!quoted && (*p == ':' || *p == '\r' || *p == '\n')) {
+                break;
+            }
+            p++;
+        }
+        const char * stop = p;
+        if (p < end) {
+            p++;
+        }
+        
+        if (executeStatement(label, &state, start, stop, options)) {
+            /* the line end after PF belongs to this label */
+            while (p < end && (*p == '\r' || *p == '\n')) {
+                p++;
+            }
+            return (long)(p - commands);
+        }
+    }
+    return -1;
+}
+
+size_t HoneywellMonoImageDifference(const HoneywellMonoImage * a, const HoneywellMonoImage * b)
+{
+    if (a->width != b->width || a->height != b->height) {
+        return SIZE_MAX;
+    }
+    
+    size_t fullBytes = a->width / 8;
+    uint8_t lastMask = (uint8_t)(0xff << (8 - (a->width & 7)));
+    size_t differences = 0;
+    
+    for (uint32_t y = 0; y < a->height; y++) {
+        const uint8_t * rowA = a->bits + (size_t)y * a->bytesPerLine;
+        const uint8_t * rowB = b->bits + (size_t)y * b->bytesPerLine;
+        
+        /* eight bytes at a time, then the rest */
+        size_t i = 0;
+        for (; i + 8 <= fullBytes; i += 8) {
+            uint64_t wordA;
+            uint64_t wordB;
+            memcpy(&wordA, rowA + i, 8);
+            memcpy(&wordB, rowB + i, 8);
+            differences += (size_t)__builtin_popcountll(wordA ^ wordB);
+        }
+        for (; i < fullBytes; i++) {
+            differences += (size_t)__builtin_popcount(rowA[i] ^ rowB[i]);
+        }
+        if (a->width & 7) {
+            differences += (size_t)__builtin_popcount((rowA[fullBytes] ^ rowB[fullBytes]) & lastMask);
+        }
+    }
+    return differences;
+}
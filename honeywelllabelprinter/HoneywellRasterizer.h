@@ -0,0 +1,55 @@
+//
+//  HoneywellRasterizer.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#ifndef HoneywellRasterizer_h
+#define HoneywellRasterizer_h
+
+#include "HoneywellBitmap.h"
+
+/*
+
+ Renders a Direct Protocol label into a mono image at printer resolution,
+ for previews and for comparing a template's output against a known good
+ image without printing it.
+
+ Covers what the label templates use: PP, AN, MAG, FT, PT, PX, PL, PM and
+ PB with BARSET / BARHEIGHT / BARMAG, in their long forms too. Other
+ statements are skipped, DIR is assumed to be 1. As on the printer the
+ origin is the lower left corner and y grows up the label.
+
+ Text uses a built-in 5x7 font scaled to the FT point size, so previews show
+ where text goes and how it wraps, not the printer's typeface. A barcode is
+ drawn through the encoder callback when one is set, otherwise as a stripe
+ pattern of roughly the right size.
+
+ Rows stay packed as in the mono image, fills and image blits work a byte
+ or more at a time rather than on single pixels.
+
+ */
+
+typedef struct {
+    // returns the image a PM statement names, NULL skips it
+    const HoneywellMonoImage * (*imageNamed)(void * context, const char * name);
+
+    /* writes the bar and space widths of a barcode in modules, starting with
+       a bar, returns their count or -1 if data can not be encoded */
+    int (*encodeBarcode)(void * context, const char * type, const char * data, uint8_t * widths, int capacity);
+
+    void * context;
+} HoneywellRasterizerOptions;
+
+/* renders statements up to and including the first PF into label, which is
+   cleared to white first and sets the label size. Returns the number of
+   bytes consumed, so a stream of labels can be rendered one by one, or -1
+   when no PF was found. options may be NULL. */
+long HoneywellRasterizeLabel(const char * commands, size_t length, const HoneywellRasterizerOptions * options, HoneywellMonoImage * label);
+
+// number of pixels that differ, SIZE_MAX if the sizes do not match
+size_t HoneywellMonoImageDifference(const HoneywellMonoImage * a, const HoneywellMonoImage * b);
+
+#endif /* HoneywellRasterizer_h */
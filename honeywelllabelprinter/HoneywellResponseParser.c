@@ -0,0 +1,242 @@
+//
+//  HoneywellResponseParser.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+/* POSIX sockets under -std=c11 on Linux */
+#define _POSIX_C_SOURCE 200809L
+
+#include "HoneywellResponseParser.h"
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+
+#define RING_MASK (HONEYWELL_RESPONSE_RING_SIZE - 1)
+
+void HoneywellResponseParserInit(HoneywellResponseParser * parser, HoneywellResponseHandler handler, void * context)
+{
+    memset(parser, 0, sizeof(*parser));
+    parser->handler = handler;
+    parser->context = context;
+}
+
+void HoneywellResponseParserReset(HoneywellResponseParser * parser)
+{
+    parser->lineStart = 0;
+    parser->scanIndex = 0;
+    parser->writeIndex = 0;
+}
+
+#pragma mark - line handling
+
+static int hasPrefixIgnoringCase(const char * text, size_t length, const char * prefix)
+{
+    size_t prefixLength = strlen(prefix);
+    return length >= prefixLength && strncasecmp(text, prefix, prefixLength) == 0;
+}
+
+/* parses an optionally signed integer, returns 0 if anything else follows
+   or it does not fit a long */
+static int parseInteger(const char * text, size_t length, long * value)
+{
+    size_t i = 0;
+    int negative = 0;
+    
+    if (i < length && (text[i] == '-' || text[i] == '+')) {
+        negative = (text[i] == '-');
+        i++;
+    }
+    if (i == length) {
+        return 0;
+    }
+    
+    long result = 0;
+    for (; i < length; i++) {
+        if (text[i] < '0' || text[i] > '9') {
+            return 0;
+        }
+        int digit = text[i] - '0';
+        if (result > (LONG_MAX - digit) / 10) {
+            return 0;
+        }
+        result = result * 10 + digit;
+    }
+    
+    *value = negative ? -result : result;
+    return 1;
+}
+
+static HoneywellResponseEvent classifyLine(const char * text, size_t length)
+{
+    HoneywellResponseEvent event = { HONEYWELL_RESPONSE_TEXT, 0, 0, text, length };
+    
+    /* classification ignores surrounding blanks, the event keeps the raw line */
+    const char * trimmed = text;
+    size_t trimmedLength = length;
+    while (trimmedLength > 0 && (*trimmed == ' ' || *trimmed == '\t')) {
+        trimmed++;
+        trimmedLength--;
+    }
+    while (trimmedLength > 0 && (trimmed[trimmedLength - 1] == ' ' || trimmed[trimmedLength - 1] == '\t')) {
+        trimmedLength--;
+    }
+    
+    if (trimmedLength == 2 && strncasecmp(trimmed, "ok", 2) == 0) {
+        event.type = HONEYWELL_RESPONSE_OK;
+        return event;
+    }
+    
+    if (hasPrefixIgnoringCase(trimmed, trimmedLength, "error")) {
+        event.type = HONEYWELL_RESPONSE_ERROR;
+        
+        size_t i = 5;
+        while (i < trimmedLength && trimmed[i] == ' ') {
+            i++;
+        }
+        /* an error number too long for a long is reported as LONG_MAX */
+        long code = 0;
+        while (i < trimmedLength && trimmed[i] >= '0' && trimmed[i] <= '9') {
+            int digit = trimmed[i] - '0';
+            code = (code > (LONG_MAX - digit) / 10) ? LONG_MAX : code * 10 + digit;
+            i++;
+        }
+        event.code = code;
+        return event;
+    }
+    
+    if (hasPrefixIgnoringCase(trimmed, trimmedLength, "ack ")) {
+        
+        /* ACK <job id> <status> */
+        size_t i = 4;
+        while (i < trimmedLength && trimmed[i] == ' ') {
+            i++;
+        }
+        size_t idStart = i;
+        while (i < trimmedLength && trimmed[i] != ' ') {
+            i++;
+        }
+        
+        long jobID;
+        if (parseInteger(trimmed + idStart, i - idStart, &jobID)) {
+            
+            while (i < trimmedLength && trimmed[i] == ' ') {
+                i++;
+            }
+            /* status stays 0 if it is missing or not a number */
+            long status = 0;
+            parseInteger(trimmed + i, trimmedLength - i, &status);
+            
+            event.type = HONEYWELL_RESPONSE_ACK;
+            event.code = jobID;
+            event.status = status;
+            return event;
+        }
+    }
+    
+    long value;
+    if (parseInteger(trimmed, trimmedLength, &value)) {
+        event.type = HONEYWELL_RESPONSE_STATUS;
+        event.code = value;
+    }
+    return event;
+}
+
+static void emitLine(HoneywellResponseParser * parser, size_t from, size_t to)
+{
+    if (to == from) {
+        return;
+    }
+    
+    size_t length = to - from;
+    if (length > HONEYWELL_RESPONSE_LINE_CAPACITY - 1) {
+        length = HONEYWELL_RESPONSE_LINE_CAPACITY - 1;
+    }
+    for (size_t i = 0; i < length; i++) {
+        parser->line[i] = (char)parser->ring[(from + i) & RING_MASK];
+    }
+    parser->line[length] = '\0';
+    
+    HoneywellResponseEvent event = classifyLine(parser->line, length);
+    parser->handler(parser->context, &event);
+}
+
+static void scanLines(HoneywellResponseParser * parser)
+{
+    while (parser->scanIndex < parser->writeIndex) {
+        
+        uint8_t c = parser->ring[parser->scanIndex & RING_MASK];
+        parser->scanIndex++;
+        
+        /* CR, LF and CRLF all end a line, the empty line between CR and LF is skipped */
+        if (c == '\r' || c == '\n') {
+            emitLine(parser, parser->lineStart, parser->scanIndex - 1);
+            parser->lineStart = parser->scanIndex;
+        }
+    }
+}
+
+/* the ring is full without a line end, deliver what there is */
+static void flushOverlongLine(HoneywellResponseParser * parser)
+{
+    emitLine(parser, parser->lineStart, parser->writeIndex);
+    parser->lineStart = parser->writeIndex;
+    parser->scanIndex = parser->writeIndex;
+}
+
+/* contiguous free space at the write index */
+static size_t writableSpace(HoneywellResponseParser * parser)
+{
+    if (parser->writeIndex - parser->lineStart == HONEYWELL_RESPONSE_RING_SIZE) {
+        flushOverlongLine(parser);
+    }
+    
+    size_t start = parser->writeIndex & RING_MASK;
+    size_t space = HONEYWELL_RESPONSE_RING_SIZE - (parser->writeIndex - parser->lineStart);
+    size_t contiguous = HONEYWELL_RESPONSE_RING_SIZE - start;
+    return space < contiguous ? space : contiguous;
+}
+
+int HoneywellResponseParserReadFromSocket(HoneywellResponseParser * parser, int fd)
+{
+    while (1) {
+        
+        size_t space = writableSpace(parser);
+        ssize_t length = recv(fd, parser->ring + (parser->writeIndex & RING_MASK), space, 0);
+        
+        if (length > 0) {
+            parser->writeIndex += length;
+            scanLines(parser);
+            continue;
+        }
+        if (length < 0 && errno == EINTR) {
+            continue;
+        }
+        if (length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return 0;
+        }
+        return -1;
+    }
+}
+
+void HoneywellResponseParserAppend(HoneywellResponseParser * parser, const uint8_t * bytes, size_t length)
+{
+    while (length > 0) {
+        
+        size_t contiguous = writableSpace(parser);
+        if (contiguous > length) {
+            contiguous = length;
+        }
+        
+        memcpy(parser->ring + (parser->writeIndex & RING_MASK), bytes, contiguous);
+        bytes += contiguous;
+        length -= contiguous;
+        parser->writeIndex += contiguous;
+        
+        scanLines(parser);
+    }
+}
@@ -0,0 +1,86 @@
+//
+//  HoneywellResponseParser.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#ifndef HoneywellResponseParser_h
+#define HoneywellResponseParser_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+
+ Incremental parser for what the printer sends back on the Direct Protocol
+ socket. The socket is read straight into a fixed ring buffer and complete
+ lines are classified in place, so nothing is allocated per read or per
+ line. Replies look like
+
+    Ok
+    Error 1019
+    Error 1031: Next label not found
+    0              (reply to PRINT PRSTAT and other numeric queries)
+    ACK 17 0       (label acknowledgement, job id and PRSTAT)
+
+ Anything else is delivered as a text line, so are a status or job id too
+ large for a long. Lines longer than the line capacity are delivered
+ truncated, a line longer than the ring as one truncated line per ring.
+
+ */
+
+/* ring size must be a power of two, indexes run freely and are masked */
+#define HONEYWELL_RESPONSE_RING_SIZE 4096
+#define HONEYWELL_RESPONSE_LINE_CAPACITY 256
+
+typedef enum {
+    HONEYWELL_RESPONSE_OK = 0,
+    HONEYWELL_RESPONSE_ERROR,
+    HONEYWELL_RESPONSE_STATUS,
+    HONEYWELL_RESPONSE_TEXT,
+    HONEYWELL_RESPONSE_ACK
+} HoneywellResponseType;
+
+typedef struct {
+    HoneywellResponseType type;
+    // error number, status value or acknowledged job id, 0 for Ok and text lines
+    long code;
+    // printer status reported with an acknowledgement
+    long status;
+    // the line without its terminator, only valid during the callback
+    const char * line;
+    size_t length;
+} HoneywellResponseEvent;
+
+typedef void (*HoneywellResponseHandler)(void * context, const HoneywellResponseEvent * event);
+
+typedef struct {
+    uint8_t ring[HONEYWELL_RESPONSE_RING_SIZE];
+    char line[HONEYWELL_RESPONSE_LINE_CAPACITY];
+
+    /* lineStart <= scanIndex <= writeIndex, lineStart is the first byte of
+       the line not yet terminated */
+    size_t lineStart;
+    size_t scanIndex;
+    size_t writeIndex;
+
+    HoneywellResponseHandler handler;
+    void * context;
+} HoneywellResponseParser;
+
+void HoneywellResponseParserInit(HoneywellResponseParser * parser, HoneywellResponseHandler handler, void * context);
+
+/* reads everything the non-blocking socket has available and reports each
+   complete line. Returns 0, or -1 once the peer closed the connection or
+   the read failed. */
+int HoneywellResponseParserReadFromSocket(HoneywellResponseParser * parser, int fd);
+
+// for bytes that did not come from a socket
+void HoneywellResponseParserAppend(HoneywellResponseParser * parser, const uint8_t * bytes, size_t length);
+
+// drops a partial line, e.g. after a reconnect
+void HoneywellResponseParserReset(HoneywellResponseParser * parser);
+
+#endif /* HoneywellResponseParser_h */
@@ -0,0 +1,106 @@
+//
+//  HoneywellSymbology.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#include "HoneywellSymbology.h"
+#include <stdlib.h>
+#include <strings.h>
+
+#define EAN_UPC(symbology, displayName, barset, length, check) \
+    [symbology] = { displayName, barset, HONEYWELL_CHARSET_DIGITS, length, length, check, HONEYWELL_DEFAULT_BAR_HEIGHT, HONEYWELL_DEFAULT_BAR_MAG }
+
+#define GS1_128(symbology, displayName) \
+    [symbology] = { displayName, displayName, HONEYWELL_CHARSET_ASCII, 1, 48, HONEYWELL_CHECK_NONE, 70, 2 }
+
+#define UPCD(symbology, displayName) \
+    [symbology] = { displayName, displayName, HONEYWELL_CHARSET_DIGITS, 1, 255, HONEYWELL_CHECK_NONE, 70, 2 }
+
+const HoneywellSymbologyInfo HoneywellSymbologies[HONEYWELL_SYMBOLOGY_COUNT] = {
+    EAN_UPC(HONEYWELL_SYMBOLOGY_EAN8, "EAN8", "EAN8", 8, HONEYWELL_CHECK_MOD10),
+    EAN_UPC(HONEYWELL_SYMBOLOGY_EAN8_CC, "EAN8_CC", "EAN8_CC", 8, HONEYWELL_CHECK_MOD10),
+    EAN_UPC(HONEYWELL_SYMBOLOGY_EAN13, "EAN13", "EAN13", 13, HONEYWELL_CHECK_MOD10),
+    EAN_UPC(HONEYWELL_SYMBOLOGY_EAN13_CC, "EAN13_CC", "EAN13_CC", 13, HONEYWELL_CHECK_MOD10),
+    GS1_128(HONEYWELL_SYMBOLOGY_EAN128, "EAN128"),
+    GS1_128(HONEYWELL_SYMBOLOGY_EAN128A, "EAN128A"),
+    GS1_128(HONEYWELL_SYMBOLOGY_EAN128B, "EAN128B"),
+    GS1_128(HONEYWELL_SYMBOLOGY_EAN128C, "EAN128C"),
+    GS1_128(HONEYWELL_SYMBOLOGY_EAN128_CCAB, "EAN128_CCAB"),
+    GS1_128(HONEYWELL_SYMBOLOGY_EAN128_CCC, "EAN128_CCC"),
+    EAN_UPC(HONEYWELL_SYMBOLOGY_UPCA, "UPCA", "UPCA", 12, HONEYWELL_CHECK_MOD10),
+    EAN_UPC(HONEYWELL_SYMBOLOGY_UPCA_CC, "UPCA_CC", "UPCA_CC", 12, HONEYWELL_CHECK_MOD10),
+    UPCD(HONEYWELL_SYMBOLOGY_UPCD1, "UPCD1"),
+    UPCD(HONEYWELL_SYMBOLOGY_UPCD2, "UPCD2"),
+    UPCD(HONEYWELL_SYMBOLOGY_UPCD3, "UPCD3"),
+    UPCD(HONEYWELL_SYMBOLOGY_UPCD4, "UPCD4"),
+    UPCD(HONEYWELL_SYMBOLOGY_UPCD5, "UPCD5"),
+    /* UPC-E takes 6 to 8 digits, see HoneywellBarcodeValidator.h */
+    [HONEYWELL_SYMBOLOGY_UPCE] = { "UPCE", "UPCE", HONEYWELL_CHARSET_DIGITS, 6, 8, HONEYWELL_CHECK_UPCE, HONEYWELL_DEFAULT_BAR_HEIGHT, HONEYWELL_DEFAULT_BAR_MAG },
+    [HONEYWELL_SYMBOLOGY_UPCE_CC] = { "UPCE-CC", "UPCE_CC", HONEYWELL_CHARSET_DIGITS, 6, 8, HONEYWELL_CHECK_UPCE, HONEYWELL_DEFAULT_BAR_HEIGHT, HONEYWELL_DEFAULT_BAR_MAG },
+    /* 14 digit shipping container code, wider so a smaller module */
+    [HONEYWELL_SYMBOLOGY_UPCSCC] = { "UPCSCC", "UPCSCC", HONEYWELL_CHARSET_DIGITS, 14, 14, HONEYWELL_CHECK_MOD10, 100, 2 },
+};
+
+/* every name and BARSET name in strcasecmp order, '-' and '_' sort before letters */
+static const struct {
+    const char * name;
+    HoneywellSymbology symbology;
+} kNameIndex[] = {
+    { "EAN128", HONEYWELL_SYMBOLOGY_EAN128 },
+    { "EAN128_CCAB", HONEYWELL_SYMBOLOGY_EAN128_CCAB },
+    { "EAN128_CCC", HONEYWELL_SYMBOLOGY_EAN128_CCC },
+    { "EAN128A", HONEYWELL_SYMBOLOGY_EAN128A },
+    { "EAN128B", HONEYWELL_SYMBOLOGY_EAN128B },
+    { "EAN128C", HONEYWELL_SYMBOLOGY_EAN128C },
+    { "EAN13", HONEYWELL_SYMBOLOGY_EAN13 },
+    { "EAN13_CC", HONEYWELL_SYMBOLOGY_EAN13_CC },
+    { "EAN8", HONEYWELL_SYMBOLOGY_EAN8 },
+    { "EAN8_CC", HONEYWELL_SYMBOLOGY_EAN8_CC },
+    { "UPCA", HONEYWELL_SYMBOLOGY_UPCA },
+    { "UPCA_CC", HONEYWELL_SYMBOLOGY_UPCA_CC },
+    { "UPCD1", HONEYWELL_SYMBOLOGY_UPCD1 },
+    { "UPCD2", HONEYWELL_SYMBOLOGY_UPCD2 },
+    { "UPCD3", HONEYWELL_SYMBOLOGY_UPCD3 },
+    { "UPCD4", HONEYWELL_SYMBOLOGY_UPCD4 },
+    { "UPCD5", HONEYWELL_SYMBOLOGY_UPCD5 },
+    { "UPCE", HONEYWELL_SYMBOLOGY_UPCE },
+    { "UPCE-CC", HONEYWELL_SYMBOLOGY_UPCE_CC },
+    { "UPCE_CC", HONEYWELL_SYMBOLOGY_UPCE_CC },
+    { "UPCSCC", HONEYWELL_SYMBOLOGY_UPCSCC },
+};
+
+int HoneywellSymbologyNamed(const char * name)
+{
+    size_t low = 0;
+    size_t high = sizeof(kNameIndex) / sizeof(kNameIndex[0]);
+    
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        int order = strcasecmp(name, kNameIndex[middle].name);
+        if (order == 0) {
+            return kNameIndex[middle].symbology;
+        }
+        if (order < 0) {
+            high = middle;
+        } else {
+            low = middle + 1;
+        }
+    }
+    return -1;
+}
+
+int HoneywellSymbologyForValue(const char * value)
+{
+    if (value == NULL) {
+        return -1;
+    }
+    if (value[0] >= '0' && value[0] <= '9') {
+        char * end;
+        long number = strtol(value, &end, 10);
+        return (*end == '\0' && number < HONEYWELL_SYMBOLOGY_COUNT) ? (int)number : -1;
+    }
+    return HoneywellSymbologyNamed(value);
+}
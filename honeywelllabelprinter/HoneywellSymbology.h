@@ -0,0 +1,97 @@
+//
+//  HoneywellSymbology.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#ifndef HoneywellSymbology_h
+#define HoneywellSymbology_h
+
+#include <stdint.h>
+
+/*
+
+ The barcode symbologies the app offers, in picker order, with everything
+ the label screen, the templates and the validator need to know about them.
+ The table is built at compile time and indexed by HoneywellSymbology, so a
+ label only needs the enum, not a name to compare or uppercase.
+
+ name is what the picker shows, barsetName what Direct Protocol's BARSET
+ expects; they only differ for UPCE-CC. Lengths include the check digit,
+ mod 10 values may leave it out. barHeight and barMag are what the label
+ templates print with, sized for a 30 mm label at 203 dpi, see
+ HoneywellLabelTemplate.h.
+
+ */
+
+typedef enum {
+    HONEYWELL_SYMBOLOGY_EAN8 = 0,
+    HONEYWELL_SYMBOLOGY_EAN8_CC,
+    HONEYWELL_SYMBOLOGY_EAN13,
+    HONEYWELL_SYMBOLOGY_EAN13_CC,
+    HONEYWELL_SYMBOLOGY_EAN128,
+    HONEYWELL_SYMBOLOGY_EAN128A,
+    HONEYWELL_SYMBOLOGY_EAN128B,
+    HONEYWELL_SYMBOLOGY_EAN128C,
+    HONEYWELL_SYMBOLOGY_EAN128_CCAB,
+    HONEYWELL_SYMBOLOGY_EAN128_CCC,
+    HONEYWELL_SYMBOLOGY_UPCA,
+    HONEYWELL_SYMBOLOGY_UPCA_CC,
+    HONEYWELL_SYMBOLOGY_UPCD1,
+    HONEYWELL_SYMBOLOGY_UPCD2,
+    HONEYWELL_SYMBOLOGY_UPCD3,
+    HONEYWELL_SYMBOLOGY_UPCD4,
+    HONEYWELL_SYMBOLOGY_UPCD5,
+    HONEYWELL_SYMBOLOGY_UPCE,
+    HONEYWELL_SYMBOLOGY_UPCE_CC,
+    HONEYWELL_SYMBOLOGY_UPCSCC,
+    HONEYWELL_SYMBOLOGY_COUNT
+} HoneywellSymbology;
+
+typedef enum {
+    HONEYWELL_CHARSET_DIGITS = 0,
+    HONEYWELL_CHARSET_ASCII,
+} HoneywellCharset;
+
+typedef enum {
+    HONEYWELL_CHECK_NONE = 0,
+    // last digit is a mod 10 check digit
+    HONEYWELL_CHECK_MOD10,
+    // UPC-E body with number system and check digit
+    HONEYWELL_CHECK_UPCE,
+} HoneywellCheckDigit;
+
+typedef struct {
+    const char * name;
+    const char * barsetName;
+    HoneywellCharset charset;
+    uint8_t minLength;
+    uint8_t maxLength;
+    HoneywellCheckDigit checkDigit;
+    uint16_t barHeight;
+    uint8_t barMag;
+} HoneywellSymbologyInfo;
+
+/* for barcode types outside the table, e.g. CODE128 from an old record */
+#define HONEYWELL_DEFAULT_BAR_HEIGHT 70
+#define HONEYWELL_DEFAULT_BAR_MAG 3
+
+extern const HoneywellSymbologyInfo HoneywellSymbologies[HONEYWELL_SYMBOLOGY_COUNT];
+
+static inline const HoneywellSymbologyInfo * HoneywellSymbologyInfoFor(HoneywellSymbology symbology)
+{
+    return &HoneywellSymbologies[symbology];
+}
+
+/* matches name or BARSET name ignoring case, -1 if unknown. A binary search
+   over a sorted name index, cheap enough to run per label. */
+int HoneywellSymbologyNamed(const char * name);
+
+/* what a record's barcode type field holds: a HoneywellSymbology number
+   such as "2", or a name from records saved before the picker stored
+   numbers. -1 if it is neither. */
+int HoneywellSymbologyForValue(const char * value);
+
+#endif /* HoneywellSymbology_h */
@@ -0,0 +1,261 @@
+//
+//  HoneywellWriteQueue.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+/* POSIX threads and sockets under -std=c11 on Linux */
+#define _POSIX_C_SOURCE 200809L
+
+#include "HoneywellWriteQueue.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+
+/* platforms without MSG_NOSIGNAL set SO_NOSIGPIPE on the socket instead */
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+/* a single write call never asks for more than this */
+#define MAX_WRITE_LENGTH (64 * 1024)
+
+typedef struct HoneywellQueuedData {
+    uint8_t * bytes;
+    size_t length;
+    struct HoneywellQueuedData * next;
+} HoneywellQueuedData;
+
+struct HoneywellWriteQueue {
+    pthread_mutex_t lock;
+    
+    HoneywellQueuedData * head;
+    HoneywellQueuedData * tail;
+    size_t headOffset;
+    size_t queuedBytes;
+    uint64_t enqueuedTotal;
+    uint64_t writtenTotal;
+    
+    size_t highWaterMark;
+    size_t lowWaterMark;
+    int aboveHighWaterMark;
+    HoneywellWaterMarkHandler waterMarkHandler;
+    void * waterMarkContext;
+};
+
+HoneywellWriteQueue * HoneywellWriteQueueCreate(void)
+{
+    HoneywellWriteQueue * queue = calloc(1, sizeof(HoneywellWriteQueue));
+    if (queue == NULL) {
+        return NULL;
+    }
+    pthread_mutex_init(&queue->lock, NULL);
+    queue->highWaterMark = 256 * 1024;
+    queue->lowWaterMark = 64 * 1024;
+    return queue;
+}
+
+void HoneywellWriteQueueDestroy(HoneywellWriteQueue * queue)
+{
+    if (queue == NULL) {
+        return;
+    }
+    /* the owner is going away, it is not told about the queue emptying */
+    queue->waterMarkHandler = NULL;
+    HoneywellWriteQueueRemoveAll(queue);
+    pthread_mutex_destroy(&queue->lock);
+    free(queue);
+}
+
+void HoneywellWriteQueueSetWaterMarks(HoneywellWriteQueue * queue, size_t highWaterMark, size_t lowWaterMark, HoneywellWaterMarkHandler handler, void * context)
+{
+    pthread_mutex_lock(&queue->lock);
+    queue->highWaterMark = highWaterMark;
+    queue->lowWaterMark = lowWaterMark;
+    queue->waterMarkHandler = handler;
+    queue->waterMarkContext = context;
+    pthread_mutex_unlock(&queue->lock);
+}
+
+static int enqueueBytes(HoneywellWriteQueue * queue, uint8_t * bytes, size_t length)
+{
+    HoneywellQueuedData * data = malloc(sizeof(HoneywellQueuedData));
+    if (data == NULL) {
+        return -1;
+    }
+    data->bytes = bytes;
+    data->length = length;
+    data->next = NULL;
+    
+    int crossedHighWaterMark = 0;
+    
+    pthread_mutex_lock(&queue->lock);
+    if (queue->tail != NULL) {
+        queue->tail->next = data;
+    } else {
+        queue->head = data;
+    }
+    queue->tail = data;
+    queue->queuedBytes += length;
+    queue->enqueuedTotal += length;
+    
+    if (!queue->aboveHighWaterMark && queue->queuedBytes > queue->highWaterMark) {
+        queue->aboveHighWaterMark = 1;
+        crossedHighWaterMark = 1;
+    }
+    HoneywellWaterMarkHandler handler = queue->waterMarkHandler;
+    void * context = queue->waterMarkContext;
+    pthread_mutex_unlock(&queue->lock);
+    
+    if (crossedHighWaterMark && handler != NULL) {
+        handler(context, 1);
+    }
+    return 0;
+}
+
+int HoneywellWriteQueueEnqueueBuffer(HoneywellWriteQueue * queue, HoneywellByteBuffer * buffer)
+{
+    if (buffer->length == 0) {
+        return 0;
+    }
+    if (enqueueBytes(queue, buffer->bytes, buffer->length) != 0) {
+        return -1;
+    }
+    buffer->bytes = NULL;
+    buffer->length = 0;
+    buffer->capacity = 0;
+    return 0;
+}
+
+int HoneywellWriteQueueEnqueue(HoneywellWriteQueue * queue, const void * bytes, size_t length)
+{
+    if (length == 0) {
+        return 0;
+    }
+    uint8_t * copy = malloc(length);
+    if (copy == NULL) {
+        return -1;
+    }
+    memcpy(copy, bytes, length);
+    if (enqueueBytes(queue, copy, length) != 0) {
+        free(copy);
+        return -1;
+    }
+    return 0;
+}
+
+long HoneywellWriteQueueDrainToSocket(HoneywellWriteQueue * queue, int fd)
+{
+    long totalWritten = 0;
+    int failed = 0;
+    int crossedLowWaterMark = 0;
+    
+    pthread_mutex_lock(&queue->lock);
+    
+    while (queue->head != NULL) {
+        
+        HoneywellQueuedData * head = queue->head;
+        size_t remaining = head->length - queue->headOffset;
+        
+        ssize_t written = send(fd, head->bytes + queue->headOffset, remaining < MAX_WRITE_LENGTH ? remaining : MAX_WRITE_LENGTH, MSG_NOSIGNAL);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            failed = (written < 0 && errno != EAGAIN && errno != EWOULDBLOCK);
+            break;
+        }
+        
+        totalWritten += written;
+        queue->queuedBytes -= written;
+        queue->writtenTotal += written;
+        queue->headOffset += written;
+        
+        if (queue->headOffset == head->length) {
+            queue->head = head->next;
+            if (queue->head == NULL) {
+                queue->tail = NULL;
+            }
+            queue->headOffset = 0;
+            free(head->bytes);
+            free(head);
+        }
+    }
+    
+    if (queue->aboveHighWaterMark && queue->queuedBytes < queue->lowWaterMark) {
+        queue->aboveHighWaterMark = 0;
+        crossedLowWaterMark = 1;
+    }
+    
+    HoneywellWaterMarkHandler handler = queue->waterMarkHandler;
+    void * context = queue->waterMarkContext;
+    int error = errno;
+    pthread_mutex_unlock(&queue->lock);
+    
+    if (crossedLowWaterMark && handler != NULL) {
+        handler(context, 0);
+    }
+    if (failed) {
+        errno = error;
+        return -1;
+    }
+    return totalWritten;
+}
+
+size_t HoneywellWriteQueueQueuedByteCount(HoneywellWriteQueue * queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    size_t count = queue->queuedBytes;
+    pthread_mutex_unlock(&queue->lock);
+    return count;
+}
+
+uint64_t HoneywellWriteQueueTotalBytesEnqueued(HoneywellWriteQueue * queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    uint64_t total = queue->enqueuedTotal;
+    pthread_mutex_unlock(&queue->lock);
+    return total;
+}
+
+uint64_t HoneywellWriteQueueTotalBytesWritten(HoneywellWriteQueue * queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    uint64_t total = queue->writtenTotal;
+    pthread_mutex_unlock(&queue->lock);
+    return total;
+}
+
+void HoneywellWriteQueueRemoveAll(HoneywellWriteQueue * queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    HoneywellQueuedData * data = queue->head;
+    queue->head = NULL;
+    queue->tail = NULL;
+    queue->headOffset = 0;
+    queue->enqueuedTotal -= queue->queuedBytes;
+    queue->queuedBytes = 0;
+    
+    /* an empty queue is below any low water mark, a producer paused by the
+       high water mark would otherwise wait for a drain that never comes */
+    int crossedLowWaterMark = queue->aboveHighWaterMark;
+    queue->aboveHighWaterMark = 0;
+    HoneywellWaterMarkHandler handler = queue->waterMarkHandler;
+    void * context = queue->waterMarkContext;
+    pthread_mutex_unlock(&queue->lock);
+    
+    while (data != NULL) {
+        HoneywellQueuedData * next = data->next;
+        free(data->bytes);
+        free(data);
+        data = next;
+    }
+    
+    if (crossedLowWaterMark && handler != NULL) {
+        handler(context, 0);
+    }
+}
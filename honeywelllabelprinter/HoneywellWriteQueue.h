@@ -0,0 +1,63 @@
+//
+//  HoneywellWriteQueue.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#ifndef HoneywellWriteQueue_h
+#define HoneywellWriteQueue_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include "HoneywellByteBuffer.h"
+
+/*
+
+ Outbound byte queue between the label encoder and the printer socket.
+ Data is written only as far as the non-blocking socket accepts it and a
+ short write resumes from where it stopped, so nothing is dropped when the
+ printer's receive buffer fills up.
+
+ The producer sets a water mark handler to pace itself. It is called with
+ 1 once the queued bytes exceed the high water mark and with 0 once they
+ drain below the low water mark again or HoneywellWriteQueueRemoveAll
+ empties the queue. The handler runs on the thread that enqueued, drained or
+ removed, without the queue's lock held.
+
+ */
+
+typedef struct HoneywellWriteQueue HoneywellWriteQueue;
+
+typedef void (*HoneywellWaterMarkHandler)(void * context, int aboveHighWaterMark);
+
+// water marks default to 256 KB and 64 KB, NULL if out of memory
+HoneywellWriteQueue * HoneywellWriteQueueCreate(void);
+
+// drops the queued bytes without calling the water mark handler
+void HoneywellWriteQueueDestroy(HoneywellWriteQueue * queue);
+
+void HoneywellWriteQueueSetWaterMarks(HoneywellWriteQueue * queue, size_t highWaterMark, size_t lowWaterMark, HoneywellWaterMarkHandler handler, void * context);
+
+/* takes the buffer's bytes and leaves it empty, 0 or -1 if out of memory,
+   in which case the buffer is left as it was */
+int HoneywellWriteQueueEnqueueBuffer(HoneywellWriteQueue * queue, HoneywellByteBuffer * buffer);
+int HoneywellWriteQueueEnqueue(HoneywellWriteQueue * queue, const void * bytes, size_t length);
+
+/* writes as much as the socket accepts without blocking. Returns the bytes
+   written, or -1 with errno set if the socket failed. */
+long HoneywellWriteQueueDrainToSocket(HoneywellWriteQueue * queue, int fd);
+
+size_t HoneywellWriteQueueQueuedByteCount(HoneywellWriteQueue * queue);
+
+/* running stream offsets, a producer can note the enqueued total before
+   queueing data and later compare against the written total to see how far
+   the socket has got. HoneywellWriteQueueRemoveAll rewinds the enqueued total. */
+uint64_t HoneywellWriteQueueTotalBytesEnqueued(HoneywellWriteQueue * queue);
+uint64_t HoneywellWriteQueueTotalBytesWritten(HoneywellWriteQueue * queue);
+
+// drops everything not yet written
+void HoneywellWriteQueueRemoveAll(HoneywellWriteQueue * queue);
+
+#endif /* HoneywellWriteQueue_h */
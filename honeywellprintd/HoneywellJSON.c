@@ -0,0 +1,523 @@
+//
+//  HoneywellJSON.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#include "HoneywellJSON.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* nesting deeper than any request needs is rejected rather than recursed into */
+#define MAX_DEPTH 32
+
+typedef struct {
+    const char * text;
+    size_t length;
+    size_t position;
+} HoneywellJSONParser;
+
+static int parseValue(HoneywellJSONParser * parser, HoneywellJSONValue * value, int depth);
+
+static void freeContents(HoneywellJSONValue * value)
+{
+    free(value->text);
+    for (size_t i = 0; i < value->count; i++) {
+        freeContents(&value->items[i]);
+        if (value->keys != NULL) {
+            free(value->keys[i]);
+        }
+    }
+    free(value->items);
+    free(value->keys);
+    memset(value, 0, sizeof(*value));
+}
+
+void HoneywellJSONFree(HoneywellJSONValue * value)
+{
+    if (value == NULL) {
+        return;
+    }
+    freeContents(value);
+    free(value);
+}
+
+#pragma mark - parsing
+
+static void skipWhitespace(HoneywellJSONParser * parser)
+{
+    while (parser->position < parser->length) {
+        char c = parser->text[parser->position];
+        if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+            break;
+        }
+        parser->position++;
+    }
+}
+
+static int consume(HoneywellJSONParser * parser, char expected)
+{
+    skipWhitespace(parser);
+    if (parser->position < parser->length && parser->text[parser->position] == expected) {
+        parser->position++;
+        return 1;
+    }
+    return 0;
+}
+
+static char * copyText(const char * text, size_t length)
+{
+    char * copy = malloc(length + 1);
+    if (copy != NULL) {
+        memcpy(copy, text, length);
+        copy[length] = '\0';
+    }
+    return copy;
+}
+
+static int hexValue(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+static int parseHex4(HoneywellJSONParser * parser, unsigned * codeUnit)
+{
+    if (parser->length - parser->position < 4) {
+        return -1;
+    }
+    unsigned result = 0;
+    for (int i = 0; i < 4; i++) {
+        int digit = hexValue(parser->text[parser->position + i]);
+        if (digit < 0) {
+            return -1;
+        }
+        result = result * 16 + (unsigned)digit;
+    }
+    parser->position += 4;
+    *codeUnit = result;
+    return 0;
+}
+
+static size_t encodeUTF8(unsigned codePoint, char * output)
+{
+    if (codePoint < 0x80) {
+        output[0] = (char)codePoint;
+        return 1;
+    }
+    if (codePoint < 0x800) {
+        output[0] = (char)(0xC0 | (codePoint >> 6));
+        output[1] = (char)(0x80 | (codePoint & 0x3F));
+        return 2;
+    }
+    if (codePoint < 0x10000) {
+        output[0] = (char)(0xE0 | (codePoint >> 12));
+        output[1] = (char)(0x80 | ((codePoint >> 6) & 0x3F));
+        output[2] = (char)(0x80 | (codePoint & 0x3F));
+        return 3;
+    }
+    output[0] = (char)(0xF0 | (codePoint >> 18));
+    output[1] = (char)(0x80 | ((codePoint >> 12) & 0x3F));
+    output[2] = (char)(0x80 | ((codePoint >> 6) & 0x3F));
+    output[3] = (char)(0x80 | (codePoint & 0x3F));
+    return 4;
+}
+
+/* decoded text is never longer than the quoted source */
+static char * parseString(HoneywellJSONParser * parser, size_t * length)
+{
+    if (!consume(parser, '"')) {
+        return NULL;
+    }
+    
+    size_t start = parser->position;
+    size_t end = start;
+    while (end < parser->length && parser->text[end] != '"') {
+        end += (parser->text[end] == '\\') ? 2 : 1;
+    }
+    if (end >= parser->length) {
+        return NULL;
+    }
+    
+    char * decoded = malloc(end - start + 1);
+    if (decoded == NULL) {
+        return NULL;
+    }
+    
+    size_t out = 0;
+    while (parser->position < end) {
+        
+        char c = parser->text[parser->position++];
+        if ((unsigned char)c < 0x20) {
+            free(decoded);
+            return NULL;
+        }
+        if (c != '\\') {
+            decoded[out++] = c;
+            continue;
+        }
+        
+        char escape = parser->text[parser->position++];
+        switch (escape) {
+            case '"': decoded[out++] = '"'; break;
+            case '\\': decoded[out++] = '\\'; break;
+            case '/': decoded[out++] = '/'; break;
+            case 'b': decoded[out++] = '\b'; break;
+            case 'f': decoded[out++] = '\f'; break;
+            case 'n': decoded[out++] = '\n'; break;
+            case 'r': decoded[out++] = '\r'; break;
+            case 't': decoded[out++] = '\t'; break;
+            
+            case 'u': {
+                unsigned codePoint;
+                if (parseHex4(parser, &codePoint) != 0) {
+                    free(decoded);
+                    return NULL;
+                }
+                
+                /* a surrogate pair is one code point, a lone surrogate prints as '?' */
+                if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+                    unsigned low;
+                    if (parser->position + 6 <= end
+                        && parser->text[parser->position] == '\\' && parser->text[parser->position + 1] == 'u') {
+                        parser->position += 2;
+                        if (parseHex4(parser, &low) != 0) {
+                            free(decoded);
+                            return NULL;
+                        }
+                        codePoint = (low >= 0xDC00 && low <= 0xDFFF) ? 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00) : '?';
+                    } else {
+                        codePoint = '?';
+                    }
+                } else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) {
+                    codePoint = '?';
+                }
+                out += encodeUTF8(codePoint, decoded + out);
+                break;
+            }
+            
+            default:
+                free(decoded);
+                return NULL;
+        }
+    }
+    
+    parser->position = end + 1;
+    decoded[out] = '\0';
+    *length = out;
+    return decoded;
+}
+
+static int parseNumber(HoneywellJSONParser * parser, HoneywellJSONValue * value)
+{
+    const char * text = parser->text;
+    size_t start = parser->position;
+    size_t i = start;
+    
+    if (i < parser->length && text[i] == '-') {
+        i++;
+    }
+    size_t digits = i;
+    while (i < parser->length && text[i] >= '0' && text[i] <= '9') {
+        i++;
+    }
+    if (i == digits) {
+        return -1;
+    }
+    if (i < parser->length && text[i] == '.') {
+        i++;
+        size_t fraction = i;
+        while (i < parser->length && text[i] >= '0' && text[i] <= '9') {
+            i++;
+        }
+        if (i == fraction) {
+            return -1;
+        }
+    }
+    if (i < parser->length && (text[i] == 'e' || text[i] == 'E')) {
+        i++;
+        if (i < parser->length && (text[i] == '+' || text[i] == '-')) {
+            i++;
+        }
+        size_t exponent = i;
+        while (i < parser->length && text[i] >= '0' && text[i] <= '9') {
+            i++;
+        }
+        if (i == exponent) {
+            return -1;
+        }
+    }
+    
+    value->type = HONEYWELL_JSON_NUMBER;
+    value->text = copyText(text + start, i - start);
+    value->length = i - start;
+    parser->position = i;
+    return value->text != NULL ? 0 : -1;
+}
+
+static int parseLiteral(HoneywellJSONParser * parser, const char * literal)
+{
+    size_t length = strlen(literal);
+    if (parser->length - parser->position < length || memcmp(parser->text + parser->position, literal, length) != 0) {
+        return -1;
+    }
+    parser->position += length;
+    return 0;
+}
+
+/* items and keys grow by doubling, keys is NULL for arrays */
+static HoneywellJSONValue * appendItem(HoneywellJSONValue * value, size_t * capacity, char * key)
+{
+    if (value->count == *capacity) {
+        size_t newCapacity = *capacity > 0 ? *capacity * 2 : 4;
+        
+        HoneywellJSONValue * items = realloc(value->items, newCapacity * sizeof(HoneywellJSONValue));
+        if (items == NULL) {
+            return NULL;
+        }
+        value->items = items;
+        
+        if (value->type == HONEYWELL_JSON_OBJECT) {
+            char ** keys = realloc(value->keys, newCapacity * sizeof(char *));
+            if (keys == NULL) {
+                return NULL;
+            }
+            value->keys = keys;
+        }
+        *capacity = newCapacity;
+    }
+    
+    HoneywellJSONValue * item = &value->items[value->count];
+    memset(item, 0, sizeof(*item));
+    if (value->keys != NULL) {
+        value->keys[value->count] = key;
+    }
+    value->count++;
+    return item;
+}
+
+static int parseContainer(HoneywellJSONParser * parser, HoneywellJSONValue * value, int depth, int isObject)
+{
+    value->type = isObject ? HONEYWELL_JSON_OBJECT : HONEYWELL_JSON_ARRAY;
+    parser->position++;
+    
+    if (consume(parser, isObject ? '}' : ']')) {
+        return 0;
+    }
+
+    size_t capacity = 0;
+    do {
+        char * key = NULL;
+        if (isObject) {
+            size_t keyLength;
+            skipWhitespace(parser);
+            key = parseString(parser, &keyLength);
+            if (key == NULL || !consume(parser, ':')) {
+                free(key);
+                return -1;
+            }
+        }
+        
+        HoneywellJSONValue * item = appendItem(value, &capacity, key);
+        if (item == NULL) {
+            free(key);
+            return -1;
+        }
+        if (parseValue(parser, item, depth + 1) != 0) {
+            return -1;
+        }
+    } while (consume(parser, ','));
+
+    return consume(parser, isObject ? '}' : ']') ? 0 : -1;
+}
+
+static int parseValue(HoneywellJSONParser * parser, HoneywellJSONValue * value, int depth)
+{
+    if (depth > MAX_DEPTH) {
+        return -1;
+    }
+
+    skipWhitespace(parser);
+    if (parser->position >= parser->length) {
+        return -1;
+    }
+
+    char c = parser->text[parser->position];
+    switch (c) {
+
+        case '{':
+            return parseContainer(parser, value, depth, 1);
+        
+        case '[':
+            return parseContainer(parser, value, depth, 0);
+        
+        case '"':
+            value->type = HONEYWELL_JSON_STRING;
+            value->text = parseString(parser, &value->length);
+            return value->text != NULL ? 0 : -1;
+        
+        case 't':
+        case 'f':
+            value->type = HONEYWELL_JSON_BOOL;
+            if (parseLiteral(parser, c == 't' ? "true" : "false") != 0) {
+                return -1;
+            }
+            value->text = copyText(c == 't' ? "true" : "false", c == 't' ? 4 : 5);
+            value->length = c == 't' ? 4 : 5;
+            return value->text != NULL ? 0 : -1;
+        
+        case 'n':
+            value->type = HONEYWELL_JSON_NULL;
+            return parseLiteral(parser, "null");
+        
+        default:
+            return parseNumber(parser, value);
+    }
+}
+
+HoneywellJSONValue * HoneywellJSONParse(const char * text, size_t length)
+{
+    HoneywellJSONValue * value = calloc(1, sizeof(HoneywellJSONValue));
+    if (value == NULL) {
+        return NULL;
+    }
+
+    HoneywellJSONParser parser = { text, length, 0 };
+    if (parseValue(&parser, value, 0) != 0) {
+        HoneywellJSONFree(value);
+        return NULL;
+    }
+
+    /* nothing but whitespace may follow */
+    skipWhitespace(&parser);
+    if (parser.position != length) {
+        HoneywellJSONFree(value);
+        return NULL;
+    }
+    return value;
+}
+
+#pragma mark - access
+
+const HoneywellJSONValue * HoneywellJSONObjectValue(const HoneywellJSONValue * value, const char * key)
+{
+    if (value == NULL || value->type != HONEYWELL_JSON_OBJECT) {
+        return NULL;
+    }
+
+    /* the last of duplicate keys wins, as in most JSON readers */
+    const HoneywellJSONValue * found = NULL;
+    for (size_t i = 0; i < value->count; i++) {
+        if (strcmp(value->keys[i], key) == 0) {
+            found = &value->items[i];
+        }
+    }
+    return found;
+}
+
+const char * HoneywellJSONScalarText(const HoneywellJSONValue * value)
+{
+    if (value == NULL) {
+        return NULL;
+    }
+
+    switch (value->type) {
+        
+        /* as NSNumber describes a boolean */
+        case HONEYWELL_JSON_BOOL:
+            return value->text[0] == 't' ? "1" : "0";
+        
+        case HONEYWELL_JSON_NUMBER:
+        case HONEYWELL_JSON_STRING:
+            return value->text;
+        
+        default:
+            return NULL;
+    }
+}
+
+#pragma mark - writing
+
+int HoneywellJSONAppendString(HoneywellByteBuffer * buffer, const char * string)
+{
+    if (HoneywellByteBufferAppend(buffer, "\"", 1) != 0) {
+        return -1;
+    }
+
+    for (const char * c = string; *c != '\0'; c++) {
+        
+        char escaped[8];
+        const char * bytes = escaped;
+        size_t length = 2;
+        
+        switch (*c) {
+            case '"': bytes = "\\\""; break;
+            case '\\': bytes = "\\\\"; break;
+            case '\n': bytes = "\\n"; break;
+            case '\r': bytes = "\\r"; break;
+            case '\t': bytes = "\\t"; break;
+            
+            default:
+                if ((unsigned char)*c < 0x20) {
+                    length = (size_t)snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned char)*c);
+                } else {
+                    bytes = c;
+                    length = 1;
+                }
+                break;
+        }
+        
+        if (HoneywellByteBufferAppend(buffer, bytes, length) != 0) {
+            return -1;
+        }
+    }
+
+    return HoneywellByteBufferAppend(buffer, "\"", 1);
+}
+
+int HoneywellJSONAppendValue(HoneywellByteBuffer * buffer, const HoneywellJSONValue * value)
+{
+    if (value == NULL || value->type == HONEYWELL_JSON_NULL) {
+        return HoneywellByteBufferAppendString(buffer, "null");
+    }
+
+    switch (value->type) {
+        
+        case HONEYWELL_JSON_BOOL:
+        case HONEYWELL_JSON_NUMBER:
+            return HoneywellByteBufferAppend(buffer, value->text, value->length);
+        
+        case HONEYWELL_JSON_STRING:
+            return HoneywellJSONAppendString(buffer, value->text);
+        
+        default: {
+            int isObject = (value->type == HONEYWELL_JSON_OBJECT);
+            if (HoneywellByteBufferAppend(buffer, isObject ? "{" : "[", 1) != 0) {
+                return -1;
+            }
+            for (size_t i = 0; i < value->count; i++) {
+                if (i > 0 && HoneywellByteBufferAppend(buffer, ",", 1) != 0) {
+                    return -1;
+                }
+                if (isObject && (HoneywellJSONAppendString(buffer, value->keys[i]) != 0 || HoneywellByteBufferAppend(buffer, ":", 1) != 0)) {
+                    return -1;
+                }
+                if (HoneywellJSONAppendValue(buffer, &value->items[i]) != 0) {
+                    return -1;
+                }
+            }
+            return HoneywellByteBufferAppend(buffer, isObject ? "}" : "]", 1);
+        }
+    }
+}
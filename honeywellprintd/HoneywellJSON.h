@@ -0,0 +1,58 @@
+//
+//  HoneywellJSON.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#ifndef HoneywellJSON_h
+#define HoneywellJSON_h
+
+#include <stddef.h>
+#include "HoneywellByteBuffer.h"
+
+/*
+
+ Just enough JSON for the print gateway's one request per line protocol.
+ A document is parsed into a tree of values in one go. Strings are decoded
+ to UTF-8, numbers keep their literal text so record values print exactly
+ as the client wrote them.
+
+ */
+
+typedef enum {
+    HONEYWELL_JSON_NULL = 0,
+    HONEYWELL_JSON_BOOL,
+    HONEYWELL_JSON_NUMBER,
+    HONEYWELL_JSON_STRING,
+    HONEYWELL_JSON_ARRAY,
+    HONEYWELL_JSON_OBJECT
+} HoneywellJSONType;
+
+typedef struct HoneywellJSONValue {
+    HoneywellJSONType type;
+    // "true" or "false", the number's literal or the decoded string, NUL terminated
+    char * text;
+    size_t length;
+    // array items or object values, objects keep their keys in source order
+    struct HoneywellJSONValue * items;
+    char ** keys;
+    size_t count;
+} HoneywellJSONValue;
+
+// NULL if text is not a single valid JSON value or memory runs out
+HoneywellJSONValue * HoneywellJSONParse(const char * text, size_t length);
+void HoneywellJSONFree(HoneywellJSONValue * value);
+
+// the value for key in an object, NULL if value is not an object or has no such key
+const HoneywellJSONValue * HoneywellJSONObjectValue(const HoneywellJSONValue * value, const char * key);
+
+// the value's text as a record would print it, NULL for null, arrays and objects
+const char * HoneywellJSONScalarText(const HoneywellJSONValue * value);
+
+// serializes value, or null if value is NULL
+int HoneywellJSONAppendValue(HoneywellByteBuffer * buffer, const HoneywellJSONValue * value);
+int HoneywellJSONAppendString(HoneywellByteBuffer * buffer, const char * string);
+
+#endif /* HoneywellJSON_h */
@@ -0,0 +1,704 @@
+//
+//  honeywellprintd.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+/*
+
+ Print gateway daemon for Linux and macOS, built on the same C print core as
+ the app. Clients connect over TCP and send one JSON request per line,
+
+    {"id":7,"printer":"192.168.1.10","port":9100,"template":0,"priority":2,"records":[{...},{...}]}
+
+ and get one line back once the printer confirmed every label, or dropped
+ them,
+
+    {"id":7,"sent":true}
+
+ template is a LabelTemplateType value, port defaults to 9100. priority is
+ a HoneywellPrintPriority value, 0 for bulk, 1 normal and 2 interactive,
+ defaulting to 0, an interactive label overtakes queued bulk labels.
+
+ One HoneywellPrintEngine per printer carries every client's labels, all in
+ a single poll() loop. Records without an image show the encoder's default
+ image as in the app, the image must already be stored on the printer.
+
+    honeywellprintd [-p port] [-a]
+
+ -p is the port to listen on, defaults to 9101, 0 picks a free one. -a also
+ accepts clients from the network, by default only loopback clients are.
+ The listening port is printed on stdout once the daemon is ready.
+
+ */
+
+/* POSIX sockets and signals under -std=c11 on Linux, SO_NOSIGPIPE on Apple */
+#define _POSIX_C_SOURCE 200809L
+#define _DARWIN_C_SOURCE
+
+#include "HoneywellJSON.h"
+#include "HoneywellLabelEncoder.h"
+#include "HoneywellPrintEngine.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+#define DEFAULT_LISTEN_PORT 9101
+#define DEFAULT_PRINTER_PORT 9100
+
+/* a client whose unfinished request line grows past this is disconnected */
+#define MAX_REQUEST_LENGTH (16 * 1024 * 1024)
+
+#define MAX_CLIENTS 256
+#define MAX_PRINTERS 64
+
+typedef struct {
+    int fd;
+    // identifies the client to requests still printing after it left
+    unsigned long serial;
+    HoneywellByteBuffer inbound;
+    HoneywellByteBuffer outbound;
+} HoneywellClient;
+
+/* one client request, answered once its last label finished */
+typedef struct {
+    unsigned long clientSerial;
+    HoneywellByteBuffer replyID;
+    size_t remainingJobs;
+    int failed;
+} HoneywellRequest;
+
+/* one label with copies, record strings are owned by the job */
+typedef struct {
+    HoneywellRequest * request;
+    int type;
+    unsigned copies;
+    HoneywellRecordField * fields;
+    size_t fieldCount;
+} HoneywellJob;
+
+typedef struct {
+    char * host;
+    int port;
+    HoneywellPrintEngine * engine;
+    HoneywellLabelEncoder * encoder;
+    uint64_t lastJobID;
+} HoneywellPrinter;
+
+static HoneywellClient clients[MAX_CLIENTS];
+static size_t clientCount;
+static unsigned long lastClientSerial;
+
+static HoneywellPrinter printers[MAX_PRINTERS];
+static size_t printerCount;
+
+static volatile sig_atomic_t stopRequested;
+
+static void handleStopSignal(int signal)
+{
+    (void)signal;
+    stopRequested = 1;
+}
+
+static char * copyString(const char * string)
+{
+    size_t length = strlen(string);
+    char * copy = malloc(length + 1);
+    if (copy != NULL) {
+        memcpy(copy, string, length + 1);
+    }
+    return copy;
+}
+
+static int setNonBlocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+#pragma mark - clients
+
+static HoneywellClient * clientWithSerial(unsigned long serial)
+{
+    for (size_t i = 0; i < clientCount; i++) {
+        if (clients[i].serial == serial) {
+            return &clients[i];
+        }
+    }
+    return NULL;
+}
+
+static void disconnectClient(size_t index)
+{
+    HoneywellClient * client = &clients[index];
+    close(client->fd);
+    HoneywellByteBufferDestroy(&client->inbound);
+    HoneywellByteBufferDestroy(&client->outbound);
+    
+    /* requests of a client that left still print, their replies are dropped */
+    clients[index] = clients[--clientCount];
+}
+
+/* writes until the socket is full, poll() picks up the rest */
+static int flushClient(HoneywellClient * client)
+{
+    size_t offset = 0;
+    while (offset < client->outbound.length) {
+        
+        ssize_t written = send(client->fd, client->outbound.bytes + offset, client->outbound.length - offset, MSG_NOSIGNAL);
+        if (written > 0) {
+            offset += written;
+            continue;
+        }
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        fprintf(stderr, "Gateway response write failed: %s\n", strerror(errno));
+        return -1;
+    }
+    
+    memmove(client->outbound.bytes, client->outbound.bytes + offset, client->outbound.length - offset);
+    client->outbound.length -= offset;
+    return 0;
+}
+
+/* reply is a JSON object without its braces */
+static void sendReply(unsigned long clientSerial, const HoneywellByteBuffer * replyID, const char * reply)
+{
+    HoneywellClient * client = clientWithSerial(clientSerial);
+    if (client == NULL) {
+        return;
+    }
+    
+    HoneywellByteBuffer * outbound = &client->outbound;
+    if (replyID != NULL) {
+        HoneywellByteBufferAppendString(outbound, "{\"id\":");
+        HoneywellByteBufferAppend(outbound, replyID->bytes, replyID->length);
+        HoneywellByteBufferAppendString(outbound, ",");
+    } else {
+        HoneywellByteBufferAppendString(outbound, "{");
+    }
+    HoneywellByteBufferAppendString(outbound, reply);
+    HoneywellByteBufferAppendString(outbound, "}\n");
+}
+
+#pragma mark - printers
+
+static void engineConnected(void * context, HoneywellByteBuffer * commands)
+{
+    (void)commands;
+    HoneywellPrinter * printer = context;
+    
+    /* stored layouts and printer state do not survive a new connection */
+    HoneywellLabelEncoderReset(printer->encoder);
+}
+
+static void engineDisconnected(void * context, int fd)
+{
+    (void)context;
+    (void)fd;
+}
+
+static HoneywellEncodeResult engineEncodeLabel(void * context, void * job, HoneywellByteBuffer * commands)
+{
+    HoneywellPrinter * printer = context;
+    HoneywellJob * label = job;
+    
+    HoneywellRecord record = { label->fields, label->fieldCount, NULL };
+    if (HoneywellLabelEncoderAppendLabel(printer->encoder, label->type, &record, label->copies, commands) != 0) {
+        fprintf(stderr, "Unrecognized Label Type %d\n", label->type);
+        return HONEYWELL_ENCODE_FAILED;
+    }
+    return HONEYWELL_ENCODE_OK;
+}
+
+static void engineLabelWritten(void * context, void * job)
+{
+    (void)context;
+    (void)job;
+}
+
+static void freeJob(HoneywellJob * job)
+{
+    for (size_t i = 0; i < job->fieldCount; i++) {
+        free((char *)job->fields[i].key);
+        free((char *)job->fields[i].value);
+    }
+    free(job->fields);
+    free(job);
+}
+
+static void finishRequestJob(HoneywellRequest * request, int printed)
+{
+    if (!printed) {
+        request->failed = 1;
+    }
+    if (--request->remainingJobs > 0) {
+        return;
+    }
+    
+    sendReply(request->clientSerial, &request->replyID, request->failed ? "\"sent\":false" : "\"sent\":true");
+    HoneywellByteBufferDestroy(&request->replyID);
+    free(request);
+}
+
+static void engineLabelFinished(void * context, void * job, int printed)
+{
+    (void)context;
+    HoneywellJob * label = job;
+    HoneywellRequest * request = label->request;
+    freeJob(label);
+    finishRequestJob(request, printed);
+}
+
+static void engineLog(void * context, const char * message)
+{
+    HoneywellPrinter * printer = context;
+    fprintf(stderr, "%s:%d: %s\n", printer->host, printer->port, message);
+}
+
+/* the shared connection for a printer, opened on first use */
+static HoneywellPrinter * printerForHost(const char * host, int port)
+{
+    for (size_t i = 0; i < printerCount; i++) {
+        if (printers[i].port == port && strcmp(printers[i].host, host) == 0) {
+            return &printers[i];
+        }
+    }
+    if (printerCount == MAX_PRINTERS) {
+        return NULL;
+    }
+    
+    HoneywellPrinter * printer = &printers[printerCount];
+    memset(printer, 0, sizeof(*printer));
+    printer->host = copyString(host);
+    printer->port = port;
+    printer->encoder = HoneywellLabelEncoderCreate();
+    
+    HoneywellPrintEngineCallbacks callbacks = {
+        printer,
+        engineConnected,
+        engineDisconnected,
+        engineEncodeLabel,
+        engineLabelWritten,
+        engineLabelFinished,
+        NULL,
+        engineLog
+    };
+    printer->engine = HoneywellPrintEngineCreate(&callbacks, NULL);
+    
+    if (printer->host == NULL || printer->encoder == NULL || printer->engine == NULL) {
+        HoneywellPrintEngineDestroy(printer->engine);
+        HoneywellLabelEncoderDestroy(printer->encoder);
+        free(printer->host);
+        return NULL;
+    }
+    
+    printerCount++;
+    HoneywellPrintEngineConnect(printer->engine, host, port);
+    return printer;
+}
+
+#pragma mark - requests
+
+/* NULL for a record that is not an object */
+static HoneywellJob * jobWithRecord(const HoneywellJSONValue * record, int type)
+{
+    if (record->type != HONEYWELL_JSON_OBJECT) {
+        return NULL;
+    }
+    
+    HoneywellJob * job = calloc(1, sizeof(HoneywellJob));
+    if (job == NULL) {
+        return NULL;
+    }
+    job->type = type;
+    job->copies = 1;
+    job->fields = calloc(record->count > 0 ? record->count : 1, sizeof(HoneywellRecordField));
+    if (job->fields == NULL) {
+        free(job);
+        return NULL;
+    }
+    
+    /* null, arrays and objects have nothing to print */
+    for (size_t i = 0; i < record->count; i++) {
+        const char * text = HoneywellJSONScalarText(&record->items[i]);
+        if (text == NULL) {
+            continue;
+        }
+        HoneywellRecordField * field = &job->fields[job->fieldCount++];
+        field->key = copyString(record->keys[i]);
+        field->value = copyString(text);
+        if (field->key == NULL || field->value == NULL) {
+            freeJob(job);
+            return NULL;
+        }
+    }
+    return job;
+}
+
+static int jobsHaveSameRecord(const HoneywellJob * a, const HoneywellJob * b)
+{
+    if (a->fieldCount != b->fieldCount) {
+        return 0;
+    }
+    for (size_t i = 0; i < a->fieldCount; i++) {
+        if (strcmp(a->fields[i].key, b->fields[i].key) != 0 || strcmp(a->fields[i].value, b->fields[i].value) != 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void handleRequest(HoneywellClient * client, const char * line, size_t length)
+{
+    HoneywellJSONValue * request = HoneywellJSONParse(line, length);
+    if (request == NULL || request->type != HONEYWELL_JSON_OBJECT) {
+        sendReply(client->serial, NULL, "\"error\":\"invalid JSON\"");
+        HoneywellJSONFree(request);
+        return;
+    }
+    
+    HoneywellByteBuffer replyID = { 0 };
+    HoneywellJSONAppendValue(&replyID, HoneywellJSONObjectValue(request, "id"));
+    
+    const HoneywellJSONValue * host = HoneywellJSONObjectValue(request, "printer");
+    const HoneywellJSONValue * records = HoneywellJSONObjectValue(request, "records");
+    
+    if (host == NULL || host->type != HONEYWELL_JSON_STRING || records == NULL || records->type != HONEYWELL_JSON_ARRAY) {
+        sendReply(client->serial, &replyID, "\"error\":\"printer and records are required\"");
+        HoneywellByteBufferDestroy(&replyID);
+        HoneywellJSONFree(request);
+        return;
+    }
+    for (size_t i = 0; i < records->count; i++) {
+        if (records->items[i].type != HONEYWELL_JSON_OBJECT) {
+            sendReply(client->serial, &replyID, "\"error\":\"records must be objects\"");
+            HoneywellByteBufferDestroy(&replyID);
+            HoneywellJSONFree(request);
+            return;
+        }
+    }
+    
+    const HoneywellJSONValue * portValue = HoneywellJSONObjectValue(request, "port");
+    int port = (portValue != NULL && portValue->type == HONEYWELL_JSON_NUMBER) ? atoi(portValue->text) : 0;
+    if (port <= 0) {
+        port = DEFAULT_PRINTER_PORT;
+    }
+    const HoneywellJSONValue * typeValue = HoneywellJSONObjectValue(request, "template");
+    int type = (typeValue != NULL && typeValue->type == HONEYWELL_JSON_NUMBER) ? atoi(typeValue->text) : HONEYWELL_LABEL_STANDARD_PRICE;
+    
+    const HoneywellJSONValue * priorityValue = HoneywellJSONObjectValue(request, "priority");
+    int priority = 0;
+    if (priorityValue != NULL) {
+        priority = (priorityValue->type == HONEYWELL_JSON_NUMBER) ? atoi(priorityValue->text) : -1;
+        if (priority < 0 || priority >= HONEYWELL_PRINT_ENGINE_LANE_COUNT || strchr(priorityValue->text, '.') != NULL) {
+            sendReply(client->serial, &replyID, "\"error\":\"priority must be 0, 1 or 2\"");
+            HoneywellByteBufferDestroy(&replyID);
+            HoneywellJSONFree(request);
+            return;
+        }
+    }
+    
+    HoneywellPrinter * printer = printerForHost(host->text, port);
+    HoneywellRequest * pending = calloc(1, sizeof(HoneywellRequest));
+    
+    if (printer == NULL || pending == NULL) {
+        sendReply(client->serial, &replyID, "\"sent\":false");
+        HoneywellByteBufferDestroy(&replyID);
+        HoneywellJSONFree(request);
+        free(pending);
+        return;
+    }
+    pending->clientSerial = client->serial;
+    pending->replyID = replyID;
+    
+    /* the request stays open until its last job was queued */
+    pending->remainingJobs = 1;
+    
+    /* consecutive identical records collapse into a single label with PF n */
+    HoneywellJob * job = NULL;
+    for (size_t i = 0; i <= records->count; i++) {
+        
+        HoneywellJob * next = NULL;
+        if (i < records->count) {
+            next = jobWithRecord(&records->items[i], type);
+            if (next == NULL) {
+                pending->failed = 1;
+                continue;
+            }
+            if (job != NULL && jobsHaveSameRecord(job, next)) {
+                job->copies++;
+                freeJob(next);
+                continue;
+            }
+        }
+        
+        if (job != NULL) {
+            job->request = pending;
+            pending->remainingJobs++;
+            if (HoneywellPrintEngineSubmit(printer->engine, job, ++printer->lastJobID, priority, job->copies) != 0) {
+                fprintf(stderr, "Print queue full, label rejected\n");
+                freeJob(job);
+                finishRequestJob(pending, 0);
+            }
+        }
+        job = next;
+    }
+    
+    finishRequestJob(pending, 1);
+    HoneywellPrintEngineService(printer->engine);
+    HoneywellJSONFree(request);
+}
+
+static void processRequests(HoneywellClient * client)
+{
+    size_t consumed = 0;
+    while (consumed < client->inbound.length) {
+        
+        const uint8_t * start = client->inbound.bytes + consumed;
+        const uint8_t * lineEnd = memchr(start, '\n', client->inbound.length - consumed);
+        if (lineEnd == NULL) {
+            break;
+        }
+        
+        size_t lineLength = lineEnd - start;
+        if (lineLength > 0) {
+            handleRequest(client, (const char *)start, lineLength);
+        }
+        consumed += lineLength + 1;
+    }
+    
+    memmove(client->inbound.bytes, client->inbound.bytes + consumed, client->inbound.length - consumed);
+    client->inbound.length -= consumed;
+}
+
+/* returns -1 once the client is gone, complete requests are still printed */
+static int readFromClient(HoneywellClient * client)
+{
+    uint8_t buffer[16 * 1024];
+    
+    while (1) {
+        
+        ssize_t length = recv(client->fd, buffer, sizeof(buffer), 0);
+        
+        if (length > 0) {
+            if (HoneywellByteBufferAppend(&client->inbound, buffer, length) != 0) {
+                return -1;
+            }
+            continue;
+        }
+        if (length < 0 && errno == EINTR) {
+            continue;
+        }
+        if (length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        
+        processRequests(client);
+        return -1;
+    }
+    
+    processRequests(client);
+    
+    if (client->inbound.length > MAX_REQUEST_LENGTH) {
+        fprintf(stderr, "Gateway client sent an oversized request, disconnecting\n");
+        return -1;
+    }
+    return 0;
+}
+
+static void acceptClients(int listenFd)
+{
+    while (1) {
+        
+        int fd = accept(listenFd, NULL, NULL);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                fprintf(stderr, "Gateway accept failed: %s\n", strerror(errno));
+            }
+            return;
+        }
+        
+        if (clientCount == MAX_CLIENTS || !setNonBlocking(fd)) {
+            close(fd);
+            continue;
+        }
+
+#ifdef SO_NOSIGPIPE
+        int noSigPipe = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+        
+        HoneywellClient * client = &clients[clientCount++];
+        memset(client, 0, sizeof(*client));
+        client->fd = fd;
+        client->serial = ++lastClientSerial;
+    }
+}
+
+#pragma mark - main loop
+
+static int listenOnPort(int port, int loopbackOnly)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        fprintf(stderr, "Gateway socket failed: %s\n", strerror(errno));
+        return -1;
+    }
+    
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons((uint16_t)port);
+    address.sin_addr.s_addr = htonl(loopbackOnly ? INADDR_LOOPBACK : INADDR_ANY);
+    
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(fd, 16) != 0 || !setNonBlocking(fd)) {
+        fprintf(stderr, "Gateway can not listen on port %d: %s\n", port, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void runLoop(int listenFd)
+{
+    struct pollfd fds[1 + MAX_CLIENTS + MAX_PRINTERS];
+    
+    while (!stopRequested) {
+        
+        size_t count = 0;
+        fds[count++] = (struct pollfd){ listenFd, POLLIN, 0 };
+        
+        for (size_t i = 0; i < clientCount; i++) {
+            short events = POLLIN | (clients[i].outbound.length > 0 ? POLLOUT : 0);
+            fds[count++] = (struct pollfd){ clients[i].fd, events, 0 };
+        }
+        
+        /* printers without a socket still get their timers run */
+        double timeout = -1;
+        for (size_t i = 0; i < printerCount; i++) {
+            HoneywellPrintEngine * engine = printers[i].engine;
+            fds[count++] = (struct pollfd){ HoneywellPrintEngineFileDescriptor(engine), HoneywellPrintEnginePollEvents(engine), 0 };
+            
+            double engineTimeout = HoneywellPrintEngineTimeout(engine);
+            if (engineTimeout >= 0 && (timeout < 0 || engineTimeout < timeout)) {
+                timeout = engineTimeout;
+            }
+        }
+        
+        int ready = poll(fds, count, timeout < 0 ? -1 : (int)(timeout * 1000) + 1);
+        if (ready < 0 && errno != EINTR) {
+            fprintf(stderr, "poll failed: %s\n", strerror(errno));
+            return;
+        }
+        
+        /* engines first, their replies go out with the clients' pass below */
+        size_t clientsPolled = clientCount;
+        for (size_t i = 0; i < printerCount; i++) {
+            short revents = ready > 0 ? fds[1 + clientsPolled + i].revents : 0;
+            HoneywellPrintEngineHandleEvents(printers[i].engine, revents);
+        }
+        
+        if (ready > 0 && (fds[0].revents & POLLIN)) {
+            acceptClients(listenFd);
+        }
+        
+        /* clients are matched by fd, the list is compacted as they leave */
+        for (size_t polled = 0; polled < clientsPolled; polled++) {
+            struct pollfd * entry = &fds[1 + polled];
+            for (size_t i = 0; i < clientCount; i++) {
+                if (clients[i].fd != entry->fd) {
+                    continue;
+                }
+                if ((entry->revents & (POLLIN | POLLHUP | POLLERR)) && readFromClient(&clients[i]) != 0) {
+                    flushClient(&clients[i]);
+                    disconnectClient(i);
+                }
+                break;
+            }
+        }
+        
+        for (size_t i = 0; i < clientCount; i++) {
+            if (clients[i].outbound.length > 0 && flushClient(&clients[i]) != 0) {
+                disconnectClient(i--);
+            }
+        }
+    }
+}
+
+static void usage(const char * name)
+{
+    fprintf(stderr, "usage: %s [-p port] [-a]\n", name);
+}
+
+int main(int argc, char * argv[])
+{
+    int listenPort = DEFAULT_LISTEN_PORT;
+    int loopbackOnly = 1;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            listenPort = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-a") == 0) {
+            loopbackOnly = 0;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = SIG_IGN;
+    sigaction(SIGPIPE, &action, NULL);
+    action.sa_handler = handleStopSignal;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    
+    int listenFd = listenOnPort(listenPort, loopbackOnly);
+    if (listenFd < 0) {
+        return 1;
+    }
+    
+    struct sockaddr_in bound;
+    socklen_t boundLength = sizeof(bound);
+    getsockname(listenFd, (struct sockaddr *)&bound, &boundLength);
+    printf("%u\n", ntohs(bound.sin_port));
+    fflush(stdout);
+    
+    runLoop(listenFd);
+    
+    /* labels still queued are dropped, their clients get sent:false */
+    for (size_t i = 0; i < printerCount; i++) {
+        HoneywellPrintEngineDestroy(printers[i].engine);
+        HoneywellLabelEncoderDestroy(printers[i].encoder);
+        free(printers[i].host);
+    }
+    while (clientCount > 0) {
+        flushClient(&clients[0]);
+        disconnectClient(0);
+    }
+    close(listenFd);
+    return 0;
+}
@@ -0,0 +1,138 @@
+//
+//  HoneywellBarcodeBenchmark.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+/*
+
+ Reports how many barcode values per second one core encodes into widths
+ and renders into a label image, and how long validating an import of
+ EAN13 values takes with each kernel set. Not part of ctest, timings
+ depend on the machine.
+
+    HoneywellBarcodeBenchmark [values]
+
+ */
+
+/* POSIX clocks under -std=c11 on Linux */
+#define _POSIX_C_SOURCE 199309L
+
+#include "HoneywellBarcode.h"
+#include "HoneywellBarcodeValidator.h"
+#include "HoneywellDither.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+    const char * name;
+    HoneywellBarcodeType type;
+    // printf format for the value numbered i
+    const char * format;
+} BarcodeCase;
+
+static const BarcodeCase barcodeCases[] = {
+    { "EAN13", HONEYWELL_BARCODE_EAN13, "%012ld" },
+    { "UPCE", HONEYWELL_BARCODE_UPCE, "%06ld" },
+    { "CODE128", HONEYWELL_BARCODE_CODE128, "NL-%07ld" },
+    { "EAN128", HONEYWELL_BARCODE_EAN128, "(01)0950110%07ld" },
+};
+
+static const HoneywellKernelSet kernelSets[] = {
+    HONEYWELL_KERNEL_SCALAR,
+    HONEYWELL_KERNEL_SSE2,
+    HONEYWELL_KERNEL_AVX2,
+    HONEYWELL_KERNEL_NEON
+};
+
+static double monotonicTime(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+int main(int argc, char * argv[])
+{
+    long values = (argc > 1) ? strtol(argv[1], NULL, 10) : 200000;
+    if (values <= 0) {
+        fprintf(stderr, "usage: %s [values]\n", argv[0]);
+        return 2;
+    }
+    
+    printf("%-8s %12s %12s\n", "type", "encode/s", "render/s");
+    
+    for (size_t i = 0; i < sizeof(barcodeCases) / sizeof(barcodeCases[0]); i++) {
+        const BarcodeCase * test = &barcodeCases[i];
+        uint8_t widths[512];
+        char data[32];
+        
+        double start = monotonicTime();
+        for (long n = 0; n < values; n++) {
+            snprintf(data, sizeof(data), test->format, n % 1000000);
+            HoneywellBarcodeEncode(test->type, data, widths, (int)sizeof(widths));
+        }
+        double encodeRate = values / (monotonicTime() - start);
+        
+        /* 2 dot modules, 80 dots high as on a 50 mm label */
+        snprintf(data, sizeof(data), test->format, 123456L);
+        int count = HoneywellBarcodeEncode(test->type, data, widths, (int)sizeof(widths));
+        long renders = values / 10 + 1;
+        start = monotonicTime();
+        for (long n = 0; n < renders; n++) {
+            HoneywellMonoImage image;
+            if (HoneywellBarcodeRender(test->type, widths, count, 2, 80, &image) == 0) {
+                HoneywellMonoImageDestroy(&image);
+            }
+        }
+        double renderRate = renders / (monotonicTime() - start);
+        
+        printf("%-8s %12.0f %12.0f\n", test->name, encodeRate, renderRate);
+    }
+    
+    /* an import of EAN13 values, one in 16 left without its check digit */
+    char * rows = malloc((size_t)values * 16);
+    const char ** rowValues = malloc((size_t)values * sizeof(*rowValues));
+    size_t * lengths = malloc((size_t)values * sizeof(*lengths));
+    uint8_t * results = malloc((size_t)values);
+    if (rows == NULL || rowValues == NULL || lengths == NULL || results == NULL) {
+        return 1;
+    }
+    for (long n = 0; n < values; n++) {
+        char * row = rows + n * 16;
+        snprintf(row, 16, "590%09ld", n % 1000000000);
+        lengths[n] = 12;
+        if (n % 16 != 0) {
+            char completed[16];
+            HoneywellBarcodeValidate(HONEYWELL_SYMBOLOGY_EAN13, row, 12, completed);
+            memcpy(row, completed, 14);
+            lengths[n] = 13;
+        }
+        rowValues[n] = row;
+    }
+    
+    printf("\n%-8s %12s %12s\n", "kernels", "valid", "validate");
+    for (size_t k = 0; k < sizeof(kernelSets) / sizeof(kernelSets[0]); k++) {
+        if (HoneywellUseKernelSet(kernelSets[k]) != 0) {
+            continue;
+        }
+        size_t valid = 0;
+        double start = monotonicTime();
+        for (int run = 0; run < 10; run++) {
+            valid = HoneywellBarcodeValidateBatch(HONEYWELL_SYMBOLOGY_EAN13, rowValues, lengths, (size_t)values, results);
+        }
+        double milliseconds = (monotonicTime() - start) * 1000 / 10;
+        printf("%-8s %12zu %9.3f ms\n", HoneywellKernelSetName(kernelSets[k]), valid, milliseconds);
+    }
+    
+    HoneywellUseKernelSet(HoneywellBestKernelSet());
+    free(results);
+    free(lengths);
+    free(rowValues);
+    free(rows);
+    return 0;
+}
@@ -0,0 +1,515 @@
+//
+//  HoneywellBarcodeTests.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+/*
+
+ Checks HoneywellBarcode against the symbology tables rather than against
+ itself: EAN and UPC modules are rebuilt here from the L, G and R digit
+ codes, and Code 128 widths are decoded back into symbol values and
+ compared with the values the data has to produce.
+
+ */
+
+#include "HoneywellBarcode.h"
+#include "HoneywellTest.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_WIDTHS 1024
+
+#pragma mark - EAN / UPC reference
+
+// L codes, R is L inverted, G is R reversed
+static const char * const lCodes[10] = {
+    "0001101", "0011001", "0010011", "0111101", "0100011",
+    "0110001", "0101111", "0111011", "0110111", "0001011"
+};
+
+static const char * const ean13Parities[10] = {
+    "LLLLLL", "LLGLGG", "LLGGLG", "LLGGGL", "LGLLGG",
+    "LGGLLG", "LGGGLL", "LGLGLG", "LGLGGL", "LGGLGL"
+};
+
+// number system 0 by check digit, E is even (G), O is odd (L)
+static const char * const upceParities[10] = {
+    "EEEOOO", "EEOEOO", "EEOOEO", "EEOOOE", "EOEEOO",
+    "EOOEEO", "EOOOEE", "EOEOEO", "EOEOOE", "EOOEOE"
+};
+
+static char * appendDigitCode(char * out, int digit, char set)
+{
+    for (int i = 0; i < 7; i++) {
+        char l = lCodes[digit][set == 'G' ? 6 - i : i];
+        *out++ = (set == 'L') ? l : (l == '0' ? '1' : '0');
+    }
+    return out;
+}
+
+static char * appendString(char * out, const char * string)
+{
+    size_t length = strlen(string);
+    memcpy(out, string, length);
+    return out + length;
+}
+
+/* 1 for a dark module, 0 for a light one */
+static void referenceEAN13(const char * digits, char * modules)
+{
+    const char * parity = ean13Parities[digits[0] - '0'];
+    char * out = appendString(modules, "101");
+    for (int i = 0; i < 6; i++) {
+        out = appendDigitCode(out, digits[1 + i] - '0', parity[i]);
+    }
+    out = appendString(out, "01010");
+    for (int i = 0; i < 6; i++) {
+        out = appendDigitCode(out, digits[7 + i] - '0', 'R');
+    }
+    out = appendString(out, "101");
+    *out = '\0';
+}
+
+static void referenceEAN8(const char * digits, char * modules)
+{
+    char * out = appendString(modules, "101");
+    for (int i = 0; i < 4; i++) {
+        out = appendDigitCode(out, digits[i] - '0', 'L');
+    }
+    out = appendString(out, "01010");
+    for (int i = 0; i < 4; i++) {
+        out = appendDigitCode(out, digits[4 + i] - '0', 'R');
+    }
+    out = appendString(out, "101");
+    *out = '\0';
+}
+
+/* digits are number system, six body digits and check digit */
+static void referenceUPCE(const char * digits, char * modules)
+{
+    const char * parity = upceParities[digits[7] - '0'];
+    char * out = appendString(modules, "101");
+    for (int i = 0; i < 6; i++) {
+        int even = parity[i] == 'E';
+        if (digits[0] == '1') {
+            even = !even;
+        }
+        out = appendDigitCode(out, digits[1 + i] - '0', even ? 'G' : 'L');
+    }
+    out = appendString(out, "010101");
+    *out = '\0';
+}
+
+/* the UPC-A a UPC-E body stands for, its check digit is the UPC-E one */
+static int upceCheckDigit(const char * digits)
+{
+    const char * b = digits + 1;
+    char upca[12];
+    switch (b[5]) {
+        case '0': case '1': case '2':
+            snprintf(upca, sizeof(upca), "%c%c%c%c0000%c%c%c", digits[0], b[0], b[1], b[5], b[2], b[3], b[4]);
+            break;
+        case '3':
+            snprintf(upca, sizeof(upca), "%c%c%c%c00000%c%c", digits[0], b[0], b[1], b[2], b[3], b[4]);
+            break;
+        case '4':
+            snprintf(upca, sizeof(upca), "%c%c%c%c%c00000%c", digits[0], b[0], b[1], b[2], b[3], b[4]);
+            break;
+        default:
+            snprintf(upca, sizeof(upca), "%c%c%c%c%c%c0000%c", digits[0], b[0], b[1], b[2], b[3], b[4], b[5]);
+            break;
+    }
+    int sum = 0;
+    for (int i = 0; i < 11; i++) {
+        sum += (upca[i] - '0') * ((i & 1) ? 1 : 3);
+    }
+    return (10 - sum % 10) % 10;
+}
+
+static int checkDigit(const char * digits, int count)
+{
+    int sum = 0;
+    for (int i = 0; i < count; i++) {
+        sum += (digits[count - 1 - i] - '0') * ((i & 1) ? 1 : 3);
+    }
+    return (10 - sum % 10) % 10;
+}
+
+/* widths expanded to 1 and 0 modules, starting with a bar */
+static void modulesFromWidths(const uint8_t * widths, int count, char * modules)
+{
+    for (int i = 0; i < count; i++) {
+        for (int k = 0; k < widths[i]; k++) {
+            *modules++ = (i & 1) ? '0' : '1';
+        }
+    }
+    *modules = '\0';
+}
+
+static void checkModules(const char * type, const char * data, const char * expected)
+{
+    uint8_t widths[MAX_WIDTHS];
+    char modules[MAX_WIDTHS * 4];
+    int count = HoneywellBarcodeEncode(HoneywellBarcodeTypeNamed(type), data, widths, MAX_WIDTHS);
+    HONEYWELL_CHECK(count > 0);
+    if (count <= 0) {
+        return;
+    }
+    modulesFromWidths(widths, count, modules);
+    if (strcmp(modules, expected) != 0) {
+        fprintf(stderr, "%s %s\n  got      %s\n  expected %s\n", type, data, modules, expected);
+    }
+    HONEYWELL_CHECK(strcmp(modules, expected) == 0);
+}
+
+static void testEANAndUPC(void)
+{
+    /* room for two ints in full, so gcc can see snprintf never cuts the digits */
+    char digits[2 * 11 + 1];
+    char modules[128];
+    
+    /* every first digit, so every parity pattern */
+    for (int first = 0; first <= 9; first++) {
+        snprintf(digits, sizeof(digits), "%d%011d", first, 123456789 + first * 7919);
+        digits[12] = (char)('0' + checkDigit(digits, 12));
+        digits[13] = '\0';
+        referenceEAN13(digits, modules);
+        checkModules("EAN13", digits, modules);
+        
+        // the check digit left out is added
+        digits[12] = '\0';
+        checkModules("EAN13", digits, modules);
+    }
+    referenceEAN13("5901234123457", modules);
+    checkModules("EAN13", "590123412345", modules);
+    
+    /* UPC-A is EAN13 with a leading 0 */
+    referenceEAN13("0036000291452", modules);
+    checkModules("UPCA", "036000291452", modules);
+    checkModules("UPCA", "03600029145", modules);
+    
+    referenceEAN8("96385074", modules);
+    checkModules("EAN8", "96385074", modules);
+    checkModules("EAN8", "9638507", modules);
+    
+    /* every check digit in both number systems */
+    for (int system = 0; system <= 1; system++) {
+        for (int body = 0; body < 1000000; body += 7919) {
+            snprintf(digits, sizeof(digits), "%d%06d", system, body);
+            digits[7] = (char)('0' + upceCheckDigit(digits));
+            digits[8] = '\0';
+            referenceUPCE(digits, modules);
+            checkModules("UPCE", digits, modules);
+            if (system == 0) {
+                // a bare body is number system 0
+                char bare[7];
+                memcpy(bare, digits + 1, 6);
+                bare[6] = '\0';
+                checkModules("UPCE", bare, modules);
+            }
+        }
+    }
+    HONEYWELL_CHECK(upceCheckDigit("0654321") == 7);
+    referenceUPCE("06543217", modules);
+    checkModules("UPCE", "654321", modules);
+    
+    /* composites print their linear part */
+    referenceUPCE("01234565", modules);
+    checkModules("UPCE_CC", "01234565", modules);
+    referenceEAN13("5901234123457", modules);
+    checkModules("EAN13_CCAB", "5901234123457", modules);
+}
+
+static void testRejected(void)
+{
+    uint8_t widths[MAX_WIDTHS];
+    
+    HONEYWELL_CHECK(HoneywellBarcodeEncode(HONEYWELL_BARCODE_EAN13, "5901234123458", widths, MAX_WIDTHS) == -1);
+    HONEYWELL_CHECK(HoneywellBarcodeEncode(HONEYWELL_BARCODE_EAN13, "59012341234", widths, MAX_WIDTHS) == -1);
+    HONEYWELL_CHECK(HoneywellBarcodeEncode(HONEYWELL_BARCODE_EAN13, "59012341234A", widths, MAX_WIDTHS) == -1);
+    HONEYWELL_CHECK(HoneywellBarcodeEncode(HONEYWELL_BARCODE_EAN8, "96385075", widths, MAX_WIDTHS) == -1);
+    HONEYWELL_CHECK(HoneywellBarcodeEncode(HONEYWELL_BARCODE_UPCE, "06543218", widths, MAX_WIDTHS) == -1);
+    HONEYWELL_CHECK(HoneywellBarcodeEncode(HONEYWELL_BARCODE_UPCE, "2654321", widths, MAX_WIDTHS) == -1);
+    HONEYWELL_CHECK(HoneywellBarcodeEncode(HONEYWELL_BARCODE_UNSUPPORTED, "123", widths, MAX_WIDTHS) == -1);
+    HONEYWELL_CHECK(HoneywellBarcodeEncode(HONEYWELL_BARCODE_CODE128, "", widths, MAX_WIDTHS) == -1);
+    HONEYWELL_CHECK(HoneywellBarcodeEncode(HONEYWELL_BARCODE_CODE128, "caf\xc3\xa9", widths, MAX_WIDTHS) == -1);
+    
+    // too little room is refused, not overrun
+    HONEYWELL_CHECK(HoneywellBarcodeEncode(HONEYWELL_BARCODE_EAN13, "5901234123457", widths, 58) == -1);
+    HONEYWELL_CHECK(HoneywellBarcodeEncode(HONEYWELL_BARCODE_CODE128, "Wikipedia", widths, 72) == -1);
+}
+
+static void testTypes(void)
+{
+    /* picker names, BARSET names and names outside the symbology table */
+    HONEYWELL_CHECK(HoneywellBarcodeTypeNamed("EAN13") == HONEYWELL_BARCODE_EAN13);
+    HONEYWELL_CHECK(HoneywellBarcodeTypeNamed("upce-cc") == HONEYWELL_BARCODE_UPCE);
+    HONEYWELL_CHECK(HoneywellBarcodeTypeNamed("EAN128_CCC") == HONEYWELL_BARCODE_EAN128);
+    HONEYWELL_CHECK(HoneywellBarcodeTypeNamed("EAN13_CCAB") == HONEYWELL_BARCODE_EAN13);
+    HONEYWELL_CHECK(HoneywellBarcodeTypeNamed("code128b") == HONEYWELL_BARCODE_CODE128B);
+    HONEYWELL_CHECK(HoneywellBarcodeTypeNamed("CODE128_CC") == HONEYWELL_BARCODE_CODE128);
+    
+    HONEYWELL_CHECK(HoneywellBarcodeTypeNamed("UPCD1") == HONEYWELL_BARCODE_UNSUPPORTED);
+    HONEYWELL_CHECK(HoneywellBarcodeTypeNamed("UPCSCC") == HONEYWELL_BARCODE_UNSUPPORTED);
+    HONEYWELL_CHECK(HoneywellBarcodeTypeNamed("EAN13_XX") == HONEYWELL_BARCODE_UNSUPPORTED);
+    HONEYWELL_CHECK(HoneywellBarcodeTypeNamed("CODE128D") == HONEYWELL_BARCODE_UNSUPPORTED);
+    HONEYWELL_CHECK(HoneywellBarcodeTypeNamed("") == HONEYWELL_BARCODE_UNSUPPORTED);
+    
+    /* a symbology and its BARSET name give the same encoder */
+    for (int symbology = 0; symbology < HONEYWELL_SYMBOLOGY_COUNT; symbology++) {
+        const char * barsetName = HoneywellSymbologyInfoFor((HoneywellSymbology)symbology)->barsetName;
+        HONEYWELL_CHECK(HoneywellBarcodeTypeForSymbology((HoneywellSymbology)symbology) == HoneywellBarcodeTypeNamed(barsetName));
+    }
+    HONEYWELL_CHECK(HoneywellBarcodeTypeForSymbology(HONEYWELL_SYMBOLOGY_COUNT) == HONEYWELL_BARCODE_UNSUPPORTED);
+}
+
+#pragma mark - Code 128
+
+/* a few patterns from the symbology table, bar first */
+typedef struct {
+    int value;
+    const char * widths;
+} KnownPattern;
+
+static const KnownPattern knownPatterns[] = {
+    { 0, "212222" }, { 1, "222122" }, { 2, "222221" }, { 12, "112232" }, { 34, "131123" },
+    { 56, "331121" }, { 78, "241112" }, { 85, "124211" }, { 90, "214121" }, { 99, "113141" },
+    { 100, "114131" }, { 101, "311141" }, { 102, "411131" }, { 103, "211412" }, { 104, "211214" },
+    { 105, "211232" }
+};
+
+#define CODE128_PATTERN_COUNT 106
+
+static char code128Table[CODE128_PATTERN_COUNT][7];
+
+static const uint8_t * symbolAt(const uint8_t * widths, int symbol)
+{
+    return widths + symbol * 6;
+}
+
+static void patternString(const uint8_t * widths, char * pattern)
+{
+    for (int i = 0; i < 6; i++) {
+        pattern[i] = (char)('0' + widths[i]);
+    }
+    pattern[6] = '\0';
+}
+
+/* set C digit pairs give values 0 to 99 as the first data symbol, the
+   rest come from the switches, FNC1 and the three start symbols */
+static void harvestCode128Table(void)
+{
+    uint8_t widths[MAX_WIDTHS];
+    // any int fits, see testEANAndUPC
+    char data[11 + 1];
+    
+    for (int value = 0; value < 100; value++) {
+        snprintf(data, sizeof(data), "%02d", value);
+        HONEYWELL_CHECK(HoneywellBarcodeEncode(HONEYWELL_BARCODE_CODE128C, data, widths, MAX_WIDTHS) == 6 * 3 + 7);
+        patternString(symbolAt(widths, 1), code128Table[value]);
+    }
+    
+    HONEYWELL_CHECK(HoneywellBarcodeEncode(HONEYWELL_BARCODE_CODE128C, "a", widths, MAX_WIDTHS) > 0);
+    patternString(symbolAt(widths, 1), code128Table[100]);
+    HONEYWELL_CHECK(HoneywellBarcodeEncode(HONEYWELL_BARCODE_CODE128C, "\t", widths, MAX_WIDTHS) > 0);
+    patternString(symbolAt(widths, 1), code128Table[101]);
+    HONEYWELL_CHECK(HoneywellBarcodeEncode(HONEYWELL_BARCODE_EAN128C, "01", widths, MAX_WIDTHS) > 0);
+    patternString(symbolAt(widths, 1), code128Table[102]);
+    
+    for (int set = 0; set < 3; set++) {
+        HoneywellBarcodeType type = (HoneywellBarcodeType)(HONEYWELL_BARCODE_CODE128A + set);
+        HONEYWELL_CHECK(HoneywellBarcodeEncode(type, "00", widths, MAX_WIDTHS) > 0);
+        patternString(symbolAt(widths, 0), code128Table[103 + set]);
+    }
+}
+
+/* every symbol is 11 modules of three bars and three spaces, bars take an
+   even number of modules, and no two values share a pattern */
+static void testCode128Table(void)
+{
+    harvestCode128Table();
+    
+    for (int value = 0; value < CODE128_PATTERN_COUNT; value++) {
+        const char * pattern = code128Table[value];
+        int modules = 0;
+        int barModules = 0;
+        for (int i = 0; i < 6; i++) {
+            int width = pattern[i] - '0';
+            HONEYWELL_CHECK(width >= 1 && width <= 4);
+            modules += width;
+            barModules += (i & 1) ? 0 : width;
+        }
+        HONEYWELL_CHECK(modules == 11);
+        HONEYWELL_CHECK((barModules & 1) == 0);
+        for (int other = 0; other < value; other++) {
+            HONEYWELL_CHECK(strcmp(code128Table[other], pattern) != 0);
+        }
+    }
+    
+    for (size_t i = 0; i < sizeof(knownPatterns) / sizeof(knownPatterns[0]); i++) {
+        HONEYWELL_CHECK(strcmp(code128Table[knownPatterns[i].value], knownPatterns[i].widths) == 0);
+    }
+}
+
+/* decodes the symbol values up to the stop symbol, -1 if a pattern is unknown */
+static int decodeCode128(const uint8_t * widths, int count, int * values)
+{
+    static const uint8_t stop[7] = { 2, 3, 3, 1, 1, 1, 2 };
+    if (count < 7 + 6 * 2 || (count - 7) % 6 != 0 || memcmp(widths + count - 7, stop, 7) != 0) {
+        return -1;
+    }
+    
+    int symbols = (count - 7) / 6;
+    for (int s = 0; s < symbols; s++) {
+        char pattern[7];
+        patternString(symbolAt(widths, s), pattern);
+        values[s] = -1;
+        for (int value = 0; value < CODE128_PATTERN_COUNT; value++) {
+            if (strcmp(code128Table[value], pattern) == 0) {
+                values[s] = value;
+                break;
+            }
+        }
+        if (values[s] < 0) {
+            return -1;
+        }
+    }
+    return symbols;
+}
+
+/* expected values from the start symbol up to the data's last one */
+typedef struct {
+    const char * type;
+    const char * data;
+    int values[32];
+    int count;
+} Code128Case;
+
+static const Code128Case code128Cases[] = {
+    /* a digit run that fits set C whole */
+    { "CODE128", "1234567890", { 105, 12, 34, 56, 78, 90 }, 6 },
+    { "CODE128", "Wikipedia", { 104, 55, 73, 75, 73, 80, 69, 68, 73, 65 }, 10 },
+    /* six digits pay for switching into set C and back */
+    { "CODE128", "ABC123456def", { 104, 33, 34, 35, 99, 12, 34, 56, 100, 68, 69, 70 }, 12 },
+    /* an odd run leaves its first digit in set B */
+    { "CODE128", "X12345", { 104, 56, 17, 99, 23, 45 }, 6 },
+    /* control characters need set A, lower case goes back to B */
+    { "CODE128", "ab\tc", { 104, 65, 66, 101, 73, 100, 67 }, 7 },
+    { "CODE128A", "HELLO\tX", { 103, 40, 37, 44, 44, 47, 73, 56 }, 8 },
+    { "CODE128B", "00", { 104, 16, 16 }, 3 },
+    /* GS1-128 starts with FNC1, bracketed identifiers lose their brackets */
+    { "EAN128", "(01)09501101530003", { 105, 102, 1, 9, 50, 11, 1, 53, 0, 3 }, 10 },
+    { "EAN128C", "0109501101530003", { 105, 102, 1, 9, 50, 11, 1, 53, 0, 3 }, 10 },
+};
+
+static void testCode128Values(void)
+{
+    for (size_t i = 0; i < sizeof(code128Cases) / sizeof(code128Cases[0]); i++) {
+        const Code128Case * test = &code128Cases[i];
+        uint8_t widths[MAX_WIDTHS];
+        int values[MAX_WIDTHS / 6];
+        
+        int count = HoneywellBarcodeEncode(HoneywellBarcodeTypeNamed(test->type), test->data, widths, MAX_WIDTHS);
+        int symbols = count > 0 ? decodeCode128(widths, count, values) : -1;
+        
+        /* the data symbols, then the weighted mod 103 check symbol */
+        int sum = test->values[0];
+        for (int k = 1; k < test->count; k++) {
+            sum += test->values[k] * k;
+        }
+        int matches = symbols == test->count + 1 && values[test->count] == sum % 103;
+        for (int k = 0; matches && k < test->count; k++) {
+            matches = values[k] == test->values[k];
+        }
+        if (!matches) {
+            fprintf(stderr, "%s \"%s\": decoded %d symbols:", test->type, test->data, symbols);
+            for (int k = 0; k < symbols; k++) {
+                fprintf(stderr, " %d", values[k]);
+            }
+            fprintf(stderr, "\n");
+        }
+        HONEYWELL_CHECK(matches);
+    }
+}
+
+#pragma mark - rendering
+
+static int pixelIsBlack(const HoneywellMonoImage * image, uint32_t x, uint32_t y)
+{
+    return (image->bits[y * image->bytesPerLine + (x >> 3)] & (0x80 >> (x & 7))) == 0;
+}
+
+/* every row shows the modules, each moduleWidth dots, between white quiet zones */
+static void checkRender(HoneywellBarcodeType type, const char * data, uint32_t moduleWidth)
+{
+    uint8_t widths[MAX_WIDTHS];
+    char modules[MAX_WIDTHS * 4];
+    int count = HoneywellBarcodeEncode(type, data, widths, MAX_WIDTHS);
+    HONEYWELL_CHECK(count > 0);
+    if (count <= 0) {
+        return;
+    }
+    modulesFromWidths(widths, count, modules);
+    
+    int left = 0;
+    int right = 0;
+    HoneywellBarcodeQuietZone(type, &left, &right);
+    HONEYWELL_CHECK(left > 0 && right > 0);
+    
+    HoneywellMonoImage image;
+    HONEYWELL_CHECK(HoneywellBarcodeRender(type, widths, count, moduleWidth, 7, &image) == 0);
+    if (image.bits == NULL) {
+        return;
+    }
+    uint32_t moduleCount = (uint32_t)(left + (int)strlen(modules) + right);
+    HONEYWELL_CHECK(image.width == moduleCount * moduleWidth && image.height == 7);
+    
+    size_t wrong = 0;
+    for (uint32_t y = 0; y < image.height; y++) {
+        for (uint32_t x = 0; x < image.width; x++) {
+            uint32_t module = x / moduleWidth;
+            int black = module >= (uint32_t)left && module < moduleCount - (uint32_t)right && modules[module - left] == '1';
+            wrong += black != pixelIsBlack(&image, x, y);
+        }
+    }
+    HONEYWELL_CHECK(wrong == 0);
+    HoneywellMonoImageDestroy(&image);
+}
+
+static void testRender(void)
+{
+    int left;
+    int right;
+    HoneywellBarcodeQuietZone(HONEYWELL_BARCODE_EAN13, &left, &right);
+    HONEYWELL_CHECK(left == 11 && right == 7);
+    HoneywellBarcodeQuietZone(HONEYWELL_BARCODE_CODE128, &left, &right);
+    HONEYWELL_CHECK(left == 10 && right == 10);
+    
+    /* module widths that put bar edges on and off byte boundaries */
+    for (uint32_t moduleWidth = 1; moduleWidth <= 4; moduleWidth++) {
+        checkRender(HONEYWELL_BARCODE_EAN13, "5901234123457", moduleWidth);
+        checkRender(HONEYWELL_BARCODE_UPCE, "654321", moduleWidth);
+        checkRender(HONEYWELL_BARCODE_CODE128, "ABC123456def", moduleWidth);
+    }
+    
+    uint8_t widths[MAX_WIDTHS];
+    HoneywellMonoImage image;
+    int count = HoneywellBarcodeEncode(HONEYWELL_BARCODE_EAN8, "96385074", widths, MAX_WIDTHS);
+    HONEYWELL_CHECK(HoneywellBarcodeRender(HONEYWELL_BARCODE_EAN8, widths, count, 0, 10, &image) == -1);
+    HONEYWELL_CHECK(HoneywellBarcodeRender(HONEYWELL_BARCODE_EAN8, widths, 0, 2, 10, &image) == -1);
+}
+
+int main(void)
+{
+    testEANAndUPC();
+    testRejected();
+    testTypes();
+    testCode128Table();
+    testCode128Values();
+    testRender();
+    
+    return HONEYWELL_TEST_RESULT;
+}
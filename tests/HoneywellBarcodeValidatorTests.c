@@ -0,0 +1,256 @@
+//
+//  HoneywellBarcodeValidatorTests.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+/*
+
+ Checks HoneywellBarcodeValidator on known good and bad values per
+ symbology, and that the batch call gives the same result as the single
+ value call for every row of a large random import with every kernel set
+ the CPU supports.
+
+ */
+
+#include "HoneywellBarcodeValidator.h"
+#include "HoneywellDither.h"
+#include "HoneywellTest.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    HoneywellSymbology symbology;
+    const char * value;
+    HoneywellBarcodeValidity validity;
+    // what a valid value is sent as
+    const char * completed;
+} ValidatorCase;
+
+static const ValidatorCase validatorCases[] = {
+    { HONEYWELL_SYMBOLOGY_EAN13, "5901234123457", HONEYWELL_BARCODE_VALID, "5901234123457" },
+    { HONEYWELL_SYMBOLOGY_EAN13, "590123412345", HONEYWELL_BARCODE_VALID, "5901234123457" },
+    { HONEYWELL_SYMBOLOGY_EAN13, "5901234123458", HONEYWELL_BARCODE_BAD_CHECK_DIGIT, NULL },
+    { HONEYWELL_SYMBOLOGY_EAN13, "59012341234", HONEYWELL_BARCODE_BAD_LENGTH, NULL },
+    { HONEYWELL_SYMBOLOGY_EAN13, "59012341234570", HONEYWELL_BARCODE_BAD_LENGTH, NULL },
+    { HONEYWELL_SYMBOLOGY_EAN13, "", HONEYWELL_BARCODE_BAD_LENGTH, NULL },
+    { HONEYWELL_SYMBOLOGY_EAN13, "59012341234x", HONEYWELL_BARCODE_BAD_CHARACTER, NULL },
+    { HONEYWELL_SYMBOLOGY_EAN13_CC, "590123412345", HONEYWELL_BARCODE_VALID, "5901234123457" },
+    { HONEYWELL_SYMBOLOGY_EAN8, "9638507", HONEYWELL_BARCODE_VALID, "96385074" },
+    { HONEYWELL_SYMBOLOGY_EAN8, "96385075", HONEYWELL_BARCODE_BAD_CHECK_DIGIT, NULL },
+    { HONEYWELL_SYMBOLOGY_UPCA, "036000291452", HONEYWELL_BARCODE_VALID, "036000291452" },
+    { HONEYWELL_SYMBOLOGY_UPCA, "03600029145", HONEYWELL_BARCODE_VALID, "036000291452" },
+    { HONEYWELL_SYMBOLOGY_UPCA, "036000291453", HONEYWELL_BARCODE_BAD_CHECK_DIGIT, NULL },
+    { HONEYWELL_SYMBOLOGY_UPCSCC, "10012345678902", HONEYWELL_BARCODE_VALID, "10012345678902" },
+    { HONEYWELL_SYMBOLOGY_UPCSCC, "1001234567890", HONEYWELL_BARCODE_VALID, "10012345678902" },
+    /* UPC-E is checked through the UPC-A it stands for */
+    { HONEYWELL_SYMBOLOGY_UPCE, "654321", HONEYWELL_BARCODE_VALID, "06543217" },
+    { HONEYWELL_SYMBOLOGY_UPCE, "0654321", HONEYWELL_BARCODE_VALID, "06543217" },
+    { HONEYWELL_SYMBOLOGY_UPCE, "06543217", HONEYWELL_BARCODE_VALID, "06543217" },
+    { HONEYWELL_SYMBOLOGY_UPCE, "06543218", HONEYWELL_BARCODE_BAD_CHECK_DIGIT, NULL },
+    { HONEYWELL_SYMBOLOGY_UPCE, "2654321", HONEYWELL_BARCODE_BAD_CHARACTER, NULL },
+    { HONEYWELL_SYMBOLOGY_UPCE, "65432", HONEYWELL_BARCODE_BAD_LENGTH, NULL },
+    { HONEYWELL_SYMBOLOGY_UPCE_CC, "01234565", HONEYWELL_BARCODE_VALID, "01234565" },
+    { HONEYWELL_SYMBOLOGY_EAN128, "(01)09501101530003", HONEYWELL_BARCODE_VALID, "(01)09501101530003" },
+    { HONEYWELL_SYMBOLOGY_EAN128, "", HONEYWELL_BARCODE_BAD_LENGTH, NULL },
+    { HONEYWELL_SYMBOLOGY_EAN128, "caf\xc3\xa9", HONEYWELL_BARCODE_BAD_CHARACTER, NULL },
+    { HONEYWELL_SYMBOLOGY_EAN128, "0123456789012345678901234567890123456789012345678", HONEYWELL_BARCODE_BAD_LENGTH, NULL },
+    /* only the characters are checked */
+    { HONEYWELL_SYMBOLOGY_UPCD1, "123", HONEYWELL_BARCODE_VALID, "123" },
+    { HONEYWELL_SYMBOLOGY_UPCD1, "12a", HONEYWELL_BARCODE_BAD_CHARACTER, NULL },
+    { HONEYWELL_SYMBOLOGY_COUNT, "5901234123457", HONEYWELL_BARCODE_UNKNOWN_TYPE, NULL },
+};
+
+static const HoneywellKernelSet kernelSets[] = {
+    HONEYWELL_KERNEL_SCALAR,
+    HONEYWELL_KERNEL_SSE2,
+    HONEYWELL_KERNEL_AVX2,
+    HONEYWELL_KERNEL_NEON
+};
+
+static void testKnownValues(void)
+{
+    for (size_t i = 0; i < sizeof(validatorCases) / sizeof(validatorCases[0]); i++) {
+        const ValidatorCase * test = &validatorCases[i];
+        size_t length = strlen(test->value);
+        char completed[64] = "";
+        
+        HoneywellBarcodeValidity validity = HoneywellBarcodeValidate(test->symbology, test->value, length, completed);
+        if (validity != test->validity) {
+            fprintf(stderr, "\"%s\": %s, expected %s\n", test->value, HoneywellBarcodeValidityDescription(validity),
+                    HoneywellBarcodeValidityDescription(test->validity));
+        }
+        HONEYWELL_CHECK(validity == test->validity);
+        if (test->completed != NULL) {
+            HONEYWELL_CHECK(strcmp(completed, test->completed) == 0);
+        }
+        
+        /* a single row batch agrees, with whichever kernel set is current */
+        uint8_t result = 0xff;
+        const char * values[] = { test->value };
+        size_t valid = HoneywellBarcodeValidateBatch(test->symbology, values, &length, 1, &result);
+        HONEYWELL_CHECK(result == test->validity);
+        HONEYWELL_CHECK(valid == (test->validity == HONEYWELL_BARCODE_VALID));
+    }
+}
+
+static void testSymbologyNames(void)
+{
+    HONEYWELL_CHECK(HoneywellSymbologyNamed("EAN13") == HONEYWELL_SYMBOLOGY_EAN13);
+    HONEYWELL_CHECK(HoneywellSymbologyNamed("upce-cc") == HONEYWELL_SYMBOLOGY_UPCE_CC);
+    HONEYWELL_CHECK(HoneywellSymbologyNamed("UPCE_CC") == HONEYWELL_SYMBOLOGY_UPCE_CC);
+    HONEYWELL_CHECK(HoneywellSymbologyNamed("CODE39") == -1);
+    HONEYWELL_CHECK(HoneywellSymbologyNamed("") == -1);
+    HONEYWELL_CHECK(HoneywellSymbologyNamed("EAN") == -1);
+    HONEYWELL_CHECK(HoneywellSymbologyNamed("ZZZ") == -1);
+    
+    /* the name index is searched by halves, a name out of order would go missing */
+    for (int symbology = 0; symbology < HONEYWELL_SYMBOLOGY_COUNT; symbology++) {
+        const HoneywellSymbologyInfo * info = HoneywellSymbologyInfoFor((HoneywellSymbology)symbology);
+        char lowercase[16];
+        size_t length = strlen(info->name);
+        HONEYWELL_CHECK(length < sizeof(lowercase));
+        for (size_t i = 0; i <= length && i < sizeof(lowercase); i++) {
+            lowercase[i] = (info->name[i] >= 'A' && info->name[i] <= 'Z') ? (char)(info->name[i] + 'a' - 'A') : info->name[i];
+        }
+        HONEYWELL_CHECK(HoneywellSymbologyNamed(info->name) == symbology);
+        HONEYWELL_CHECK(HoneywellSymbologyNamed(info->barsetName) == symbology);
+        HONEYWELL_CHECK(HoneywellSymbologyNamed(lowercase) == symbology);
+    }
+    
+    /* record fields hold the enum as digits, older records the name */
+    HONEYWELL_CHECK(HoneywellSymbologyForValue("2") == HONEYWELL_SYMBOLOGY_EAN13);
+    HONEYWELL_CHECK(HoneywellSymbologyForValue("0") == HONEYWELL_SYMBOLOGY_EAN8);
+    HONEYWELL_CHECK(HoneywellSymbologyForValue("19") == HONEYWELL_SYMBOLOGY_UPCSCC);
+    HONEYWELL_CHECK(HoneywellSymbologyForValue("upca") == HONEYWELL_SYMBOLOGY_UPCA);
+    HONEYWELL_CHECK(HoneywellSymbologyForValue("20") == -1);
+    HONEYWELL_CHECK(HoneywellSymbologyForValue("99999999999999999999999") == -1);
+    HONEYWELL_CHECK(HoneywellSymbologyForValue("2x") == -1);
+    HONEYWELL_CHECK(HoneywellSymbologyForValue("-1") == -1);
+    HONEYWELL_CHECK(HoneywellSymbologyForValue(NULL) == -1);
+    
+    for (int validity = HONEYWELL_BARCODE_VALID; validity <= HONEYWELL_BARCODE_BAD_CHECK_DIGIT; validity++) {
+        HONEYWELL_CHECK(strcmp(HoneywellBarcodeValidityDescription((HoneywellBarcodeValidity)validity), "unknown") != 0);
+    }
+}
+
+#pragma mark - batch against single values
+
+#define ROW_COUNT 100000
+#define ROW_SIZE 32
+
+static uint32_t randomState = 2463534242u;
+
+static uint32_t nextRandom(void)
+{
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+}
+
+/* mostly good values as an import would have, then every way to be wrong:
+   lengths around the valid ones, characters next to the digits, high bytes
+   and check digits off by one */
+static size_t makeRow(HoneywellSymbology symbology, char * row)
+{
+    const HoneywellSymbologyInfo * info = HoneywellSymbologyInfoFor(symbology);
+    uint32_t kind = nextRandom() % 16;
+    size_t length = info->maxLength - (nextRandom() % 2);
+    if (kind == 0) {
+        length = nextRandom() % (info->maxLength + 2);
+    }
+    if (length >= ROW_SIZE) {
+        length = ROW_SIZE - 1;
+    }
+    
+    for (size_t i = 0; i < length; i++) {
+        row[i] = (char)('0' + nextRandom() % 10);
+    }
+    if (info->checkDigit == HONEYWELL_CHECK_UPCE && length > 6 && kind != 1) {
+        row[0] = (char)('0' + nextRandom() % 2);
+    }
+    
+    /* give the row its right check digit, then maybe break it */
+    if (kind >= 4 && length == info->maxLength && info->checkDigit != HONEYWELL_CHECK_NONE) {
+        char completed[ROW_SIZE + 3];
+        if (HoneywellBarcodeValidate(symbology, row, length - 1, completed) == HONEYWELL_BARCODE_VALID) {
+            memcpy(row, completed, length);
+        }
+        if (kind == 4) {
+            row[length - 1] = (char)('0' + (row[length - 1] - '0' + 1) % 10);
+        }
+    }
+    
+    if (length > 0 && (kind == 2 || kind == 3)) {
+        static const char notDigits[] = { '/', ':', ' ', 'A', '\x80', '\xff' };
+        row[nextRandom() % length] = notDigits[nextRandom() % sizeof(notDigits)];
+    }
+    row[length] = '\0';
+    return length;
+}
+
+static void testBatchMatchesSingle(void)
+{
+    static const HoneywellSymbology symbologies[] = {
+        HONEYWELL_SYMBOLOGY_EAN8, HONEYWELL_SYMBOLOGY_EAN13, HONEYWELL_SYMBOLOGY_UPCA,
+        HONEYWELL_SYMBOLOGY_UPCSCC, HONEYWELL_SYMBOLOGY_UPCE, HONEYWELL_SYMBOLOGY_EAN128
+    };
+    
+    char * rows = malloc((size_t)ROW_COUNT * ROW_SIZE);
+    const char ** values = malloc(ROW_COUNT * sizeof(*values));
+    size_t * lengths = malloc(ROW_COUNT * sizeof(*lengths));
+    uint8_t * expected = malloc(ROW_COUNT);
+    uint8_t * results = malloc(ROW_COUNT);
+    HONEYWELL_CHECK(rows != NULL && values != NULL && lengths != NULL && expected != NULL && results != NULL);
+    
+    for (size_t s = 0; s < sizeof(symbologies) / sizeof(symbologies[0]) && results != NULL; s++) {
+        const HoneywellSymbologyInfo * info = HoneywellSymbologyInfoFor(symbologies[s]);
+        
+        size_t expectedValid = 0;
+        for (size_t i = 0; i < ROW_COUNT; i++) {
+            values[i] = rows + i * ROW_SIZE;
+            lengths[i] = makeRow(symbologies[s], rows + i * ROW_SIZE);
+            expected[i] = (uint8_t)HoneywellBarcodeValidate(symbologies[s], values[i], lengths[i], NULL);
+            expectedValid += expected[i] == HONEYWELL_BARCODE_VALID;
+        }
+        // the rows exercise both outcomes
+        HONEYWELL_CHECK(expectedValid > ROW_COUNT / 4 && expectedValid < ROW_COUNT);
+        
+        for (size_t k = 0; k < sizeof(kernelSets) / sizeof(kernelSets[0]); k++) {
+            if (HoneywellUseKernelSet(kernelSets[k]) != 0) {
+                continue;
+            }
+            memset(results, 0xff, ROW_COUNT);
+            size_t valid = HoneywellBarcodeValidateBatch(symbologies[s], values, lengths, ROW_COUNT, results);
+            
+            size_t mismatches = 0;
+            for (size_t i = 0; i < ROW_COUNT; i++) {
+                if (results[i] != expected[i] && mismatches++ < 5) {
+                    fprintf(stderr, "%s %s \"%s\": batch %u, single %u\n", info->name, HoneywellKernelSetName(kernelSets[k]),
+                            values[i], results[i], expected[i]);
+                }
+            }
+            HONEYWELL_CHECK(mismatches == 0);
+            HONEYWELL_CHECK(valid == expectedValid);
+        }
+    }
+    
+    HoneywellUseKernelSet(HoneywellBestKernelSet());
+    free(results);
+    free(expected);
+    free(lengths);
+    free(values);
+    free(rows);
+}
+
+int main(void)
+{
+    testKnownValues();
+    testSymbologyNames();
+    testBatchMatchesSingle();
+    
+    return HONEYWELL_TEST_RESULT;
+}
@@ -0,0 +1,169 @@
+//
+//  HoneywellBitmapTests.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+/*
+
+ Checks the logo preparation in HoneywellBitmap on the bundled assets: the
+ 1-bit PCX decodes back to exactly the thresholded image, and the upload
+ shrinks as much as the colour originals allow.
+
+    HoneywellBitmapTests <directory with 1bitleaf and puzzle>
+
+ */
+
+#include "HoneywellBitmap.h"
+#include "HoneywellTest.h"
+#include "HoneywellTestFiles.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    const char * name;
+    // the smallest original size / 1-bit PCX size accepted
+    double minimumRatio;
+} BundledImage;
+
+/* 1bitleaf is 3 planes of 8-bit colour, puzzle is already paletted */
+static const BundledImage bundledImages[] = {
+    { "1bitleaf", 20.0 },
+    { "puzzle", 5.0 }
+};
+
+static unsigned readLE16(const uint8_t * bytes)
+{
+    return bytes[0] | (bytes[1] << 8);
+}
+
+static int monoPixelIsWhite(const HoneywellMonoImage * mono, uint32_t x, uint32_t y)
+{
+    return (mono->bits[y * mono->bytesPerLine + (x >> 3)] & (0x80 >> (x & 7))) != 0;
+}
+
+/* every pixel of the decoded 1-bit PCX is what the threshold made of the original */
+static void checkRoundTrip(const HoneywellGreyImage * grey, uint8_t threshold, const uint8_t * pcx, size_t length)
+{
+    HoneywellGreyImage decoded;
+    HONEYWELL_CHECK(HoneywellPCXDecode(pcx, length, &decoded) == 0);
+    if (decoded.pixels == NULL) {
+        return;
+    }
+    HONEYWELL_CHECK(decoded.width == grey->width && decoded.height == grey->height);
+    
+    size_t differences = 0;
+    for (uint32_t y = 0; y < grey->height && y < decoded.height; y++) {
+        for (uint32_t x = 0; x < grey->width && x < decoded.width; x++) {
+            int white = grey->pixels[y * grey->stride + x] >= threshold;
+            int decodedWhite = decoded.pixels[y * decoded.stride + x] != 0;
+            differences += (white != decodedWhite);
+        }
+    }
+    HONEYWELL_CHECK(differences == 0);
+    HoneywellGreyImageDestroy(&decoded);
+}
+
+static void testBundledImage(const char * directory, const BundledImage * bundled)
+{
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s", directory, bundled->name);
+    size_t length = 0;
+    uint8_t * original = HoneywellTestReadFile(path, &length);
+    HONEYWELL_CHECK(original != NULL);
+    if (original == NULL) {
+        return;
+    }
+    
+    HoneywellGreyImage grey;
+    HONEYWELL_CHECK(HoneywellPCXDecode(original, length, &grey) == 0);
+    free(original);
+    if (grey.pixels == NULL) {
+        return;
+    }
+    
+    uint8_t threshold = HoneywellOtsuThreshold(&grey);
+    HoneywellMonoImage mono;
+    HONEYWELL_CHECK(HoneywellMonoImageCreate(&mono, grey.width, grey.height) == 0);
+    HoneywellThreshold(&grey, threshold, &mono);
+    
+    size_t pcxLength = 0;
+    uint8_t * pcx = HoneywellPCXEncodeMono(&mono, 203, &pcxLength);
+    HONEYWELL_CHECK(pcx != NULL);
+    if (pcx != NULL) {
+        double ratio = (double)length / (double)pcxLength;
+        printf("%s: %ux%u, %zu -> %zu bytes (%.1fx), threshold %u\n", bundled->name, grey.width, grey.height, length, pcxLength, ratio, threshold);
+        HONEYWELL_CHECK(ratio >= bundled->minimumRatio);
+        
+        /* one plane of one bit, at the print head's resolution */
+        HONEYWELL_CHECK(pcx[0] == 0x0a && pcx[2] == 1 && pcx[3] == 1 && pcx[65] == 1);
+        HONEYWELL_CHECK(readLE16(pcx + 12) == 203);
+        checkRoundTrip(&grey, threshold, pcx, pcxLength);
+    }
+    
+    free(pcx);
+    HoneywellMonoImageDestroy(&mono);
+    HoneywellGreyImageDestroy(&grey);
+}
+
+/* an odd width pads scan lines, the padding must not show up as pixels */
+static void testOddWidthRoundTrip(void)
+{
+    HoneywellGreyImage grey;
+    HONEYWELL_CHECK(HoneywellGreyImageCreate(&grey, 13, 5) == 0);
+    if (grey.pixels == NULL) {
+        return;
+    }
+    for (uint32_t y = 0; y < grey.height; y++) {
+        for (uint32_t x = 0; x < grey.width; x++) {
+            grey.pixels[y * grey.stride + x] = ((x + y) % 3 == 0) ? 0 : 255;
+        }
+    }
+    
+    HoneywellMonoImage mono;
+    HONEYWELL_CHECK(HoneywellMonoImageCreate(&mono, grey.width, grey.height) == 0);
+    HONEYWELL_CHECK(mono.bytesPerLine % 2 == 0);
+    HoneywellThreshold(&grey, 128, &mono);
+    HONEYWELL_CHECK(!monoPixelIsWhite(&mono, 0, 0));
+    HONEYWELL_CHECK(monoPixelIsWhite(&mono, 1, 0));
+    
+    size_t length = 0;
+    uint8_t * pcx = HoneywellPCXEncodeMono(&mono, 203, &length);
+    HONEYWELL_CHECK(pcx != NULL);
+    if (pcx != NULL) {
+        checkRoundTrip(&grey, 128, pcx, length);
+    }
+    free(pcx);
+    
+    /* BMP for the line printer SDK: 4 byte aligned rows, bottom up */
+    uint8_t * bmp = HoneywellBMPEncodeMono(&mono, 203, &length);
+    HONEYWELL_CHECK(bmp != NULL);
+    if (bmp != NULL) {
+        HONEYWELL_CHECK(bmp[0] == 'B' && bmp[1] == 'M');
+        HONEYWELL_CHECK(readLE16(bmp + 28) == 1);
+        HONEYWELL_CHECK(length == 62 + 4 * mono.height);
+        // the bottom row comes first
+        HONEYWELL_CHECK(bmp[62] == mono.bits[(mono.height - 1) * mono.bytesPerLine]);
+    }
+    free(bmp);
+    
+    HoneywellMonoImageDestroy(&mono);
+    HoneywellGreyImageDestroy(&grey);
+}
+
+int main(int argc, char * argv[])
+{
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <directory with 1bitleaf and puzzle>\n", argv[0]);
+        return 2;
+    }
+    
+    for (size_t i = 0; i < sizeof(bundledImages) / sizeof(bundledImages[0]); i++) {
+        testBundledImage(argv[1], &bundledImages[i]);
+    }
+    testOddWidthRoundTrip();
+    
+    return HONEYWELL_TEST_RESULT;
+}
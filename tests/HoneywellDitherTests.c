@@ -0,0 +1,262 @@
+//
+//  HoneywellDitherTests.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+/*
+
+ Checks that every kernel set the CPU supports gives the same output as
+ the scalar one, bit for bit, on the bundled logos at each print head
+ width and on a large odd-sized image, and that the dithers keep the
+ image's brightness.
+
+    HoneywellDitherTests <directory with 1bitleaf and puzzle>
+
+ */
+
+#include "HoneywellDither.h"
+#include "HoneywellTest.h"
+#include "HoneywellTestFiles.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const HoneywellKernelSet kernelSets[] = {
+    HONEYWELL_KERNEL_SCALAR,
+    HONEYWELL_KERNEL_SSE2,
+    HONEYWELL_KERNEL_AVX2,
+    HONEYWELL_KERNEL_NEON
+};
+
+#define KERNEL_SET_COUNT (sizeof(kernelSets) / sizeof(kernelSets[0]))
+
+// PrintHeadWidth values in printer_profiles.JSON
+static const uint32_t printHeadWidths[] = { 384, 576, 832 };
+
+/* everything one kernel set made of an image */
+typedef struct {
+    HoneywellGreyImage scaled;
+    HoneywellMonoImage ordered;
+    HoneywellMonoImage diffused;
+} KernelOutput;
+
+static void destroyOutput(KernelOutput * output)
+{
+    HoneywellGreyImageDestroy(&output->scaled);
+    HoneywellMonoImageDestroy(&output->ordered);
+    HoneywellMonoImageDestroy(&output->diffused);
+}
+
+static int runKernels(const HoneywellGreyImage * grey, uint32_t width, KernelOutput * output)
+{
+    memset(output, 0, sizeof(*output));
+    if (HoneywellScaleToWidth(grey, width, &output->scaled) != 0
+        || HoneywellMonoImageCreate(&output->ordered, output->scaled.width, output->scaled.height) != 0
+        || HoneywellMonoImageCreate(&output->diffused, output->scaled.width, output->scaled.height) != 0) {
+        destroyOutput(output);
+        return -1;
+    }
+    HoneywellOrderedDither(&output->scaled, &output->ordered);
+    return HoneywellErrorDiffusionDither(&output->scaled, &output->diffused);
+}
+
+static int greyImagesEqual(const HoneywellGreyImage * a, const HoneywellGreyImage * b)
+{
+    if (a->width != b->width || a->height != b->height) {
+        return 0;
+    }
+    for (uint32_t y = 0; y < a->height; y++) {
+        if (memcmp(a->pixels + y * a->stride, b->pixels + y * b->stride, a->width) != 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int monoImagesEqual(const HoneywellMonoImage * a, const HoneywellMonoImage * b)
+{
+    return a->width == b->width && a->height == b->height && a->bytesPerLine == b->bytesPerLine
+        && memcmp(a->bits, b->bits, a->bytesPerLine * a->height) == 0;
+}
+
+/* runs every supported set on grey scaled to width and compares with scalar */
+static void checkKernelSetsAgree(const char * name, const HoneywellGreyImage * grey, uint32_t width)
+{
+    HONEYWELL_CHECK(HoneywellUseKernelSet(HONEYWELL_KERNEL_SCALAR) == 0);
+    KernelOutput reference;
+    HONEYWELL_CHECK(runKernels(grey, width, &reference) == 0);
+    HONEYWELL_CHECK(reference.scaled.width == width);
+    
+    for (size_t i = 1; i < KERNEL_SET_COUNT; i++) {
+        if (HoneywellUseKernelSet(kernelSets[i]) != 0) {
+            continue;
+        }
+        KernelOutput output;
+        HONEYWELL_CHECK(runKernels(grey, width, &output) == 0);
+        
+        int scaledEqual = greyImagesEqual(&reference.scaled, &output.scaled);
+        int orderedEqual = monoImagesEqual(&reference.ordered, &output.ordered);
+        int diffusedEqual = monoImagesEqual(&reference.diffused, &output.diffused);
+        if (!scaledEqual || !orderedEqual || !diffusedEqual) {
+            fprintf(stderr, "%s at %u: %s differs from scalar (scale %d, ordered %d, diffusion %d)\n",
+                    name, width, HoneywellKernelSetName(kernelSets[i]), !scaledEqual, !orderedEqual, !diffusedEqual);
+        }
+        HONEYWELL_CHECK(scaledEqual && orderedEqual && diffusedEqual);
+        destroyOutput(&output);
+    }
+    destroyOutput(&reference);
+}
+
+static void testBundledImages(const char * directory)
+{
+    static const char * const names[] = { "1bitleaf", "puzzle" };
+    
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        char path[1024];
+        snprintf(path, sizeof(path), "%s/%s", directory, names[i]);
+        size_t length = 0;
+        uint8_t * pcx = HoneywellTestReadFile(path, &length);
+        HONEYWELL_CHECK(pcx != NULL);
+        if (pcx == NULL) {
+            continue;
+        }
+        
+        /* the decoder converts colour planes with the current set */
+        HoneywellGreyImage reference;
+        HONEYWELL_CHECK(HoneywellUseKernelSet(HONEYWELL_KERNEL_SCALAR) == 0);
+        HONEYWELL_CHECK(HoneywellPCXDecode(pcx, length, &reference) == 0);
+        for (size_t set = 1; set < KERNEL_SET_COUNT && reference.pixels != NULL; set++) {
+            HoneywellGreyImage grey;
+            if (HoneywellUseKernelSet(kernelSets[set]) != 0) {
+                continue;
+            }
+            HONEYWELL_CHECK(HoneywellPCXDecode(pcx, length, &grey) == 0);
+            HONEYWELL_CHECK(greyImagesEqual(&reference, &grey));
+            HoneywellGreyImageDestroy(&grey);
+        }
+        free(pcx);
+        
+        for (size_t w = 0; w < sizeof(printHeadWidths) / sizeof(printHeadWidths[0]) && reference.pixels != NULL; w++) {
+            checkKernelSetsAgree(names[i], &reference, printHeadWidths[w]);
+        }
+        HoneywellGreyImageDestroy(&reference);
+    }
+}
+
+/* a photo far wider than the print head, odd sizes so every kernel hits its row tail */
+static void testLargeImage(void)
+{
+    HoneywellGreyImage grey;
+    HONEYWELL_CHECK(HoneywellGreyImageCreate(&grey, 1501, 1003) == 0);
+    if (grey.pixels == NULL) {
+        return;
+    }
+    for (uint32_t y = 0; y < grey.height; y++) {
+        for (uint32_t x = 0; x < grey.width; x++) {
+            grey.pixels[y * grey.stride + x] = (uint8_t)(((y * grey.width + x) * 2654435761u) >> 13);
+        }
+    }
+    
+    checkKernelSetsAgree("noise", &grey, 384);
+    checkKernelSetsAgree("noise", &grey, 1501);
+    HoneywellGreyImageDestroy(&grey);
+}
+
+/* colour to grey on its own, rows long enough for a full vector plus a tail */
+static void testGreyFromPlanes(void)
+{
+    enum { WIDTH = 1037 };
+    static uint8_t r[WIDTH], g[WIDTH], b[WIDTH], reference[WIDTH], grey[WIDTH];
+    uint32_t seed = 12345;
+    for (size_t x = 0; x < WIDTH; x++) {
+        seed = seed * 1103515245u + 12345u;
+        r[x] = (uint8_t)(seed >> 24);
+        g[x] = (uint8_t)(seed >> 16);
+        b[x] = (uint8_t)(seed >> 8);
+    }
+    r[0] = g[0] = b[0] = 255;
+    r[1] = g[1] = b[1] = 0;
+    
+    HONEYWELL_CHECK(HoneywellUseKernelSet(HONEYWELL_KERNEL_SCALAR) == 0);
+    HoneywellGreyFromPlanes(r, g, b, WIDTH, reference);
+    HONEYWELL_CHECK(reference[0] == 255 && reference[1] == 0);
+    
+    for (size_t i = 1; i < KERNEL_SET_COUNT; i++) {
+        if (HoneywellUseKernelSet(kernelSets[i]) != 0) {
+            continue;
+        }
+        for (uint32_t width = WIDTH - 40; width <= WIDTH; width++) {
+            memset(grey, 0xa5, sizeof(grey));
+            HoneywellGreyFromPlanes(r, g, b, width, grey);
+            HONEYWELL_CHECK(memcmp(grey, reference, width) == 0);
+            // nothing written past the row
+            HONEYWELL_CHECK(width == WIDTH || grey[width] == 0xa5);
+        }
+    }
+}
+
+static double blackFraction(const HoneywellMonoImage * mono)
+{
+    size_t black = 0;
+    for (uint32_t y = 0; y < mono->height; y++) {
+        for (uint32_t x = 0; x < mono->width; x++) {
+            black += (mono->bits[y * mono->bytesPerLine + (x >> 3)] & (0x80 >> (x & 7))) == 0;
+        }
+    }
+    return (double)black / ((double)mono->width * mono->height);
+}
+
+/* a flat grey dithers to about as much black as it is dark */
+static void testDitherKeepsBrightness(void)
+{
+    static const uint8_t levels[] = { 0, 64, 128, 192, 255 };
+    
+    for (size_t i = 0; i < sizeof(levels) / sizeof(levels[0]); i++) {
+        HoneywellGreyImage grey;
+        HoneywellMonoImage mono;
+        HONEYWELL_CHECK(HoneywellGreyImageCreate(&grey, 64, 64) == 0);
+        HONEYWELL_CHECK(HoneywellMonoImageCreate(&mono, 64, 64) == 0);
+        if (grey.pixels == NULL || mono.bits == NULL) {
+            return;
+        }
+        for (uint32_t y = 0; y < grey.height; y++) {
+            memset(grey.pixels + y * grey.stride, levels[i], grey.width);
+        }
+        double expected = 1.0 - levels[i] / 255.0;
+        
+        HoneywellOrderedDither(&grey, &mono);
+        double ordered = blackFraction(&mono);
+        HONEYWELL_CHECK(ordered > expected - 0.02 && ordered < expected + 0.02);
+        
+        HONEYWELL_CHECK(HoneywellErrorDiffusionDither(&grey, &mono) == 0);
+        double diffused = blackFraction(&mono);
+        HONEYWELL_CHECK(diffused > expected - 0.02 && diffused < expected + 0.02);
+        
+        HoneywellMonoImageDestroy(&mono);
+        HoneywellGreyImageDestroy(&grey);
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <directory with 1bitleaf and puzzle>\n", argv[0]);
+        return 2;
+    }
+    
+    for (size_t i = 0; i < KERNEL_SET_COUNT; i++) {
+        if (HoneywellUseKernelSet(kernelSets[i]) == 0) {
+            printf("kernel set %s\n", HoneywellKernelSetName(kernelSets[i]));
+        }
+    }
+    
+    testGreyFromPlanes();
+    testBundledImages(argv[1]);
+    testLargeImage();
+    testDitherKeepsBrightness();
+    
+    HoneywellUseKernelSet(HoneywellBestKernelSet());
+    return HONEYWELL_TEST_RESULT;
+}
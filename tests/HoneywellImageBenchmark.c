@@ -0,0 +1,131 @@
+//
+//  HoneywellImageBenchmark.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+/*
+
+ Times preparing the bundled logos for upload: decoding the colour PCX,
+ picking a threshold and writing the 1-bit PCX, and reports the bytes
+ saved. Then times each dither stage with every kernel set the CPU has at
+ the print head widths. Not part of ctest, timings depend on the machine.
+
+    HoneywellImageBenchmark <directory with 1bitleaf and puzzle> [iterations]
+
+ */
+
+/* POSIX clocks under -std=c11 on Linux */
+#define _POSIX_C_SOURCE 199309L
+
+#include "HoneywellDither.h"
+#include "HoneywellTestFiles.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static const char * const bundledImages[] = { "1bitleaf", "puzzle" };
+
+static const HoneywellKernelSet kernelSets[] = {
+    HONEYWELL_KERNEL_SCALAR,
+    HONEYWELL_KERNEL_SSE2,
+    HONEYWELL_KERNEL_AVX2,
+    HONEYWELL_KERNEL_NEON
+};
+
+// PrintHeadWidth values in printer_profiles.JSON
+static const uint32_t printHeadWidths[] = { 384, 576, 832 };
+
+static double monotonicTime(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/* what uploadImage does per image, returns the 1-bit PCX size or 0 on failure */
+static size_t prepareImage(const uint8_t * pcx, size_t length)
+{
+    HoneywellGreyImage grey;
+    if (HoneywellPCXDecode(pcx, length, &grey) != 0) {
+        return 0;
+    }
+    
+    size_t preparedLength = 0;
+    HoneywellMonoImage mono;
+    if (HoneywellMonoImageCreate(&mono, grey.width, grey.height) == 0) {
+        HoneywellThreshold(&grey, HoneywellOtsuThreshold(&grey), &mono);
+        free(HoneywellPCXEncodeMono(&mono, 203, &preparedLength));
+        HoneywellMonoImageDestroy(&mono);
+    }
+    HoneywellGreyImageDestroy(&grey);
+    return preparedLength;
+}
+
+int main(int argc, char * argv[])
+{
+    long iterations = (argc > 2) ? strtol(argv[2], NULL, 10) : 200;
+    if (argc < 2 || iterations <= 0) {
+        fprintf(stderr, "usage: %s <directory with 1bitleaf and puzzle> [iterations]\n", argv[0]);
+        return 2;
+    }
+    
+    printf("%-10s %9s %9s %7s %10s\n", "image", "original", "1-bit", "ratio", "prepare");
+    
+    for (size_t i = 0; i < sizeof(bundledImages) / sizeof(bundledImages[0]); i++) {
+        
+        char path[1024];
+        snprintf(path, sizeof(path), "%s/%s", argv[1], bundledImages[i]);
+        size_t length = 0;
+        uint8_t * pcx = HoneywellTestReadFile(path, &length);
+        if (pcx == NULL) {
+            fprintf(stderr, "Can not read %s\n", path);
+            return 1;
+        }
+        
+        size_t preparedLength = 0;
+        double start = monotonicTime();
+        for (long n = 0; n < iterations; n++) {
+            preparedLength = prepareImage(pcx, length);
+        }
+        double milliseconds = (monotonicTime() - start) * 1000 / iterations;
+        
+        printf("%-10s %9zu %9zu %6.1fx %7.3f ms\n", bundledImages[i], length, preparedLength,
+               preparedLength > 0 ? (double)length / (double)preparedLength : 0.0, milliseconds);
+        free(pcx);
+    }
+    
+    printf("\n%-10s %-7s %9s %9s %9s %9s %9s  (ms)\n", "image", "kernels", "size", "decode", "scale", "ordered", "diffusion");
+    
+    for (size_t i = 0; i < sizeof(bundledImages) / sizeof(bundledImages[0]); i++) {
+        
+        char path[1024];
+        snprintf(path, sizeof(path), "%s/%s", argv[1], bundledImages[i]);
+        size_t length = 0;
+        uint8_t * pcx = HoneywellTestReadFile(path, &length);
+        if (pcx == NULL) {
+            fprintf(stderr, "Can not read %s\n", path);
+            return 1;
+        }
+        
+        for (size_t w = 0; w < sizeof(printHeadWidths) / sizeof(printHeadWidths[0]); w++) {
+            for (size_t set = 0; set < sizeof(kernelSets) / sizeof(kernelSets[0]); set++) {
+                HoneywellKernelTimings timings;
+                if (HoneywellUseKernelSet(kernelSets[set]) != 0
+                    || HoneywellBenchmarkKernels(pcx, length, printHeadWidths[w], (unsigned)iterations, &timings) != 0) {
+                    continue;
+                }
+                char size[32];
+                snprintf(size, sizeof(size), "%ux%u", timings.width, timings.height);
+                printf("%-10s %-7s %9s %9.3f %9.3f %9.3f %9.3f\n", bundledImages[i], HoneywellKernelSetName(kernelSets[set]),
+                       size, timings.decode, timings.scale, timings.ordered, timings.diffusion);
+            }
+        }
+        free(pcx);
+    }
+    
+    HoneywellUseKernelSet(HoneywellBestKernelSet());
+    return 0;
+}
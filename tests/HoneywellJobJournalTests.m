@@ -0,0 +1,179 @@
+//
+//  HoneywellJobJournalTests.m
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+/*
+
+ Writes ENQUEUED, SENT, ACKNOWLEDGED and FAILED records to a
+ HoneywellJobJournal, reopens it and checks which labels come back, then
+ cuts the file in the middle of its last record, as a kill during a write
+ would, and checks the replay stops cleanly before it. The highest job id
+ has to survive every reopen, also once no label is left unfinished.
+
+ */
+
+#import <Foundation/Foundation.h>
+#import "HoneywellJobJournal.h"
+#import "HoneywellPrintJob.h"
+#include "HoneywellTest.h"
+#include <unistd.h>
+
+static HoneywellPrintJob * makeJob(NSUInteger jobID)
+{
+    NSDictionary * record = @{ @"Name" : [NSString stringWithFormat:@"Item %lu", (unsigned long)jobID],
+                               @"PLU" : @(jobID) };
+    HoneywellPrintJob * job = [HoneywellPrintJob jobWithRecord:record templateType:FOOD_INFO_LABEL copies:jobID];
+    job.jobID = jobID;
+    job.priority = jobID % HONEYWELL_PRINT_PRIORITY_COUNT;
+    return job;
+}
+
+static NSString * temporaryJournalPath(void)
+{
+    NSString * name = [NSString stringWithFormat:@"HoneywellJobJournalTests-%d.journal", getpid()];
+    NSString * path = [NSTemporaryDirectory() stringByAppendingPathComponent:name];
+    [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+    return path;
+}
+
+/* the unfinished jobs must be exactly these, in this order, with their data */
+static void checkUnfinishedJobs(HoneywellJobJournal * journal, NSArray * jobIDs)
+{
+    NSArray * jobs = journal.unfinishedJobs;
+    HONEYWELL_CHECK(jobs.count == jobIDs.count);
+    for (NSUInteger i = 0; i < jobs.count && i < jobIDs.count; i++) {
+        HoneywellPrintJob * job = jobs[i];
+        HoneywellPrintJob * expected = makeJob([jobIDs[i] unsignedIntegerValue]);
+        HONEYWELL_CHECK(job.jobID == expected.jobID);
+        HONEYWELL_CHECK([job.record isEqualToDictionary:expected.record]);
+        HONEYWELL_CHECK(job.templateType == expected.templateType);
+        HONEYWELL_CHECK(job.copies == expected.copies);
+        HONEYWELL_CHECK(job.priority == expected.priority);
+    }
+}
+
+/* the mapping keeps the file at its capacity, the records end at the last
+   byte that is not zero. Cutting back from there lands inside the last record. */
+static void truncateInsideLastRecord(NSString * path, off_t bytesIntoRecord)
+{
+    NSData * data = [NSData dataWithContentsOfFile:path];
+    const uint8_t * bytes = data.bytes;
+    off_t end = (off_t)data.length;
+    while (end > 0 && bytes[end - 1] == 0) {
+        end--;
+    }
+    HONEYWELL_CHECK(end > bytesIntoRecord);
+    HONEYWELL_CHECK(truncate(path.fileSystemRepresentation, end - bytesIntoRecord) == 0);
+}
+
+#pragma mark - replay
+
+static void testReplayKeepsUnfinishedJobs(NSString * path)
+{
+    HoneywellJobJournal * journal = [HoneywellJobJournal journalAtPath:path];
+    HONEYWELL_CHECK(journal != nil && journal.unfinishedJobs.count == 0 && journal.lastJobID == 0);
+    
+    for (NSUInteger jobID = 1; jobID <= 5; jobID++) {
+        [journal appendEnqueuedJob:makeJob(jobID)];
+    }
+    for (NSUInteger jobID = 1; jobID <= 3; jobID++) {
+        [journal appendEntry:HONEYWELL_JOURNAL_SENT forJobID:jobID];
+    }
+    [journal appendEntry:HONEYWELL_JOURNAL_ACKNOWLEDGED forJobID:1];
+    [journal appendEntry:HONEYWELL_JOURNAL_FAILED forJobID:2];
+    [journal commit];
+    [journal close];
+    
+    /* 3 was sent but never acknowledged, it may not have come out */
+    journal = [HoneywellJobJournal journalAtPath:path];
+    HONEYWELL_CHECK(journal != nil);
+    checkUnfinishedJobs(journal, @[@3, @4, @5]);
+    HONEYWELL_CHECK(journal.lastJobID == 5);
+    [journal close];
+    
+    /* replaying the compacted file gives the same */
+    journal = [HoneywellJobJournal journalAtPath:path];
+    checkUnfinishedJobs(journal, @[@3, @4, @5]);
+    HONEYWELL_CHECK(journal.lastJobID == 5);
+    [journal close];
+}
+
+#pragma mark - torn records
+
+static void testTornAcknowledgementIsIgnored(NSString * path)
+{
+    HoneywellJobJournal * journal = [HoneywellJobJournal journalAtPath:path];
+    [journal appendEnqueuedJob:makeJob(6)];
+    [journal appendEntry:HONEYWELL_JOURNAL_ACKNOWLEDGED forJobID:3];
+    [journal commit];
+    [journal close];
+    
+    /* the job id of the acknowledgement is cut, so 3 stays unfinished */
+    truncateInsideLastRecord(path, 1);
+    
+    journal = [HoneywellJobJournal journalAtPath:path];
+    HONEYWELL_CHECK(journal != nil);
+    checkUnfinishedJobs(journal, @[@3, @4, @5, @6]);
+    HONEYWELL_CHECK(journal.lastJobID == 6);
+    [journal close];
+}
+
+static void testTornEnqueueIsDropped(NSString * path)
+{
+    HoneywellJobJournal * journal = [HoneywellJobJournal journalAtPath:path];
+    [journal appendEntry:HONEYWELL_JOURNAL_ACKNOWLEDGED forJobID:4];
+    [journal appendEnqueuedJob:makeJob(7)];
+    [journal commit];
+    [journal close];
+    
+    /* half of the label data is gone, the label with it, the records before still count */
+    truncateInsideLastRecord(path, 10);
+    
+    journal = [HoneywellJobJournal journalAtPath:path];
+    HONEYWELL_CHECK(journal != nil);
+    checkUnfinishedJobs(journal, @[@3, @5, @6]);
+    HONEYWELL_CHECK(journal.lastJobID == 6);
+    [journal close];
+}
+
+#pragma mark - job ids
+
+static void testLastJobIDOutlivesFinishedJobs(NSString * path)
+{
+    HoneywellJobJournal * journal = [HoneywellJobJournal journalAtPath:path];
+    [journal appendEnqueuedJob:makeJob(8)];
+    for (NSNumber * jobID in @[@3, @5, @6, @8]) {
+        [journal appendEntry:HONEYWELL_JOURNAL_ACKNOWLEDGED forJobID:jobID.unsignedIntegerValue];
+    }
+    [journal commit];
+    [journal close];
+    
+    /* no record is left to carry job 8, the id must not start over */
+    journal = [HoneywellJobJournal journalAtPath:path];
+    HONEYWELL_CHECK(journal != nil && journal.unfinishedJobs.count == 0);
+    HONEYWELL_CHECK(journal.lastJobID == 8);
+    [journal close];
+    
+    journal = [HoneywellJobJournal journalAtPath:path];
+    HONEYWELL_CHECK(journal.lastJobID == 8);
+    [journal close];
+}
+
+int main(void)
+{
+    @autoreleasepool {
+        NSString * path = temporaryJournalPath();
+        
+        testReplayKeepsUnfinishedJobs(path);
+        testTornAcknowledgementIsIgnored(path);
+        testTornEnqueueIsDropped(path);
+        testLastJobIDOutlivesFinishedJobs(path);
+        
+        [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+    }
+    return HONEYWELL_TEST_RESULT;
+}
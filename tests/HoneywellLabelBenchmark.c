@@ -0,0 +1,129 @@
+//
+//  HoneywellLabelBenchmark.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+/*
+
+ Reports, per label layout, the bytes a label costs before and after
+ HoneywellOptimizeCommands and as a LAYOUT RUN record, and how many labels
+ per second one core encodes and rasterizes, the latter without PM images.
+ Not part of ctest, timings depend on the machine.
+
+    HoneywellLabelBenchmark [iterations]
+
+ */
+
+/* POSIX clocks under -std=c11 on Linux */
+#define _POSIX_C_SOURCE 199309L
+
+#include "HoneywellBarcode.h"
+#include "HoneywellLabelEncoder.h"
+#include "HoneywellRasterizer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const HoneywellRecordField fields[] = {
+    { "image", "1bitleaf" },
+    { "barcodeTypeCode", "2" },
+    { "barcodeInput", "9556001234567" },
+    { "itemDescription", "A&W Rootbeer Orange-Berry Flavour 250ml" },
+    { "itemPrice", "RM28.50" },
+    { "barcode", "2" },
+    { "input", "5901234123457" }
+};
+
+static double monotonicTime(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static int encodeBarcode(void * context, const char * type, const char * data, uint8_t * widths, int capacity)
+{
+    (void)context;
+    return HoneywellBarcodeEncode(HoneywellBarcodeTypeNamed(type), data, widths, capacity);
+}
+
+static size_t renderedLength(const HoneywellLabelTemplate * labelTemplate, const HoneywellRecord * record)
+{
+    HoneywellByteBuffer commands = { 0 };
+    HoneywellLabelTemplateRender(labelTemplate, record, 1, NULL, &commands);
+    size_t length = commands.length;
+    HoneywellByteBufferDestroy(&commands);
+    return length;
+}
+
+int main(int argc, char * argv[])
+{
+    long iterations = (argc > 1) ? strtol(argv[1], NULL, 10) : 2000;
+    if (iterations <= 0) {
+        fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+        return 2;
+    }
+    
+    HoneywellLabelEncoder * encoder = HoneywellLabelEncoderCreate();
+    if (encoder == NULL) {
+        return 1;
+    }
+    HoneywellRecord record = { fields, sizeof(fields) / sizeof(fields[0]), NULL };
+    
+    printf("%-12s %8s %10s %6s %7s %12s %12s\n", "layout", "source", "optimized", "saved", "record", "encode/s", "rasterize/s");
+    
+    for (int type = 0; type < HONEYWELL_LABEL_TYPE_COUNT; type++) {
+        
+        const HoneywellLabelLayout * layout = HoneywellLabelLayoutForType(type);
+        if (layout == NULL) {
+            continue;
+        }
+        const HoneywellLabelTemplate * labelTemplate = HoneywellLabelEncoderTemplate(encoder, type);
+        HoneywellLabelTemplate * unoptimized = HoneywellLabelTemplateCreate(layout->source, strlen(layout->source), NULL);
+        if (unoptimized == NULL) {
+            continue;
+        }
+        
+        size_t sourceLength = renderedLength(unoptimized, &record);
+        size_t optimizedLength = renderedLength(labelTemplate, &record);
+        
+        HoneywellByteBuffer commands = { 0 };
+        HoneywellLabelTemplateRenderRecord(labelTemplate, &record, 1, NULL, &commands);
+        size_t recordLength = commands.length;
+        
+        /* labels as a bulk batch sends them, state carried from label to label */
+        HoneywellLabelEncoderReset(encoder);
+        double start = monotonicTime();
+        for (long i = 0; i < iterations; i++) {
+            commands.length = 0;
+            HoneywellLabelEncoderAppendLabel(encoder, type, &record, 1, &commands);
+        }
+        double encodeRate = iterations / (monotonicTime() - start);
+        
+        commands.length = 0;
+        HoneywellLabelTemplateRender(labelTemplate, &record, 1, NULL, &commands);
+        HoneywellMonoImage label;
+        HoneywellMonoImageCreate(&label, layout->width, layout->height);
+        HoneywellRasterizerOptions options = { NULL, encodeBarcode, NULL };
+        
+        start = monotonicTime();
+        for (long i = 0; i < iterations; i++) {
+            HoneywellRasterizeLabel((const char *)commands.bytes, commands.length, &options, &label);
+        }
+        double rasterizeRate = iterations / (monotonicTime() - start);
+        
+        printf("%-12s %8zu %10zu %5.1f%% %7zu %12.0f %12.0f\n", layout->layoutName, sourceLength, optimizedLength,
+               100.0 * (double)(sourceLength - optimizedLength) / (double)sourceLength, recordLength, encodeRate, rasterizeRate);
+        
+        HoneywellMonoImageDestroy(&label);
+        HoneywellByteBufferDestroy(&commands);
+        HoneywellLabelTemplateDestroy(unoptimized);
+    }
+    
+    HoneywellLabelEncoderDestroy(encoder);
+    return 0;
+}
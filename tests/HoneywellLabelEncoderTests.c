@@ -0,0 +1,157 @@
+//
+//  HoneywellLabelEncoderTests.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+/*
+
+ Checks that a label the encoder fails to append leaves nothing behind.
+ The print engine drops the bytes of a failed label from its chunk, so the
+ encoder must not keep a layout as stored or a setting as sent that only
+ the dropped bytes carried.
+
+ The byte buffer is built into this test with a realloc that can be told
+ to fail, so every allocation a label makes is failed once in turn. After
+ each failure the label is appended again and has to come out exactly as
+ on a fresh connection, LAYOUT INPUT and settings included.
+
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+/* reallocations that succeed before the next one fails, -1 never fails */
+static int reallocationsLeft = -1;
+
+static void * failingRealloc(void * bytes, size_t size)
+{
+    if (reallocationsLeft == 0) {
+        return NULL;
+    }
+    if (reallocationsLeft > 0) {
+        reallocationsLeft--;
+    }
+    return realloc(bytes, size);
+}
+
+#define realloc failingRealloc
+#include "HoneywellByteBuffer.c"
+#undef realloc
+
+#include "HoneywellLabelEncoder.h"
+#include "HoneywellTest.h"
+
+static const char kEarlierLabels[] = "PP 0,0: PT \"earlier label in the chunk\": PF \r\n";
+
+/* sized so the layout definition, the LAYOUT RUN record and the inline
+   label each grow the buffer past another doubling, retune with the layouts */
+static char longDescription[1400];
+
+static HoneywellRecord priceRecord(HoneywellRecordField fields[4], const char * description)
+{
+    fields[0] = (HoneywellRecordField){ "barcodeTypeCode", "2" };
+    fields[1] = (HoneywellRecordField){ "barcodeInput", "9556001234567" };
+    fields[2] = (HoneywellRecordField){ "itemDescription", description };
+    fields[3] = (HoneywellRecordField){ "itemPrice", "RM28.50" };
+    HoneywellRecord record = { fields, 4, NULL };
+    return record;
+}
+
+/* what a fresh connection sends for the record, then for it once more */
+static void appendReference(int useStoredLayouts, const HoneywellRecord * record, HoneywellByteBuffer * first, HoneywellByteBuffer * second)
+{
+    HoneywellLabelEncoder * encoder = HoneywellLabelEncoderCreate();
+    HONEYWELL_CHECK(encoder != NULL);
+    if (encoder == NULL) {
+        return;
+    }
+    HoneywellLabelEncoderSetUseStoredLayouts(encoder, useStoredLayouts);
+    HONEYWELL_CHECK(HoneywellLabelEncoderAppendLabel(encoder, HONEYWELL_LABEL_STANDARD_PRICE, record, 1, first) == 0);
+    HONEYWELL_CHECK(HoneywellLabelEncoderAppendLabel(encoder, HONEYWELL_LABEL_STANDARD_PRICE, record, 1, second) == 0);
+    HoneywellLabelEncoderDestroy(encoder);
+}
+
+static int bytesEqual(const HoneywellByteBuffer * buffer, size_t start, const HoneywellByteBuffer * expected)
+{
+    return buffer->length - start == expected->length && memcmp(buffer->bytes + start, expected->bytes, expected->length) == 0;
+}
+
+/* returns how many of the label's allocations were failed */
+static int checkFailuresLeaveNothing(int useStoredLayouts, const HoneywellRecord * record)
+{
+    HoneywellByteBuffer first = { 0 };
+    HoneywellByteBuffer second = { 0 };
+    appendReference(useStoredLayouts, record, &first, &second);
+    
+    HoneywellLabelEncoder * encoder = HoneywellLabelEncoderCreate();
+    HONEYWELL_CHECK(encoder != NULL);
+    if (encoder == NULL) {
+        return 0;
+    }
+    HoneywellLabelEncoderSetUseStoredLayouts(encoder, useStoredLayouts);
+    
+    int failures = 0;
+    for (int failAt = 0; failAt < 64; failAt++) {
+        
+        HoneywellLabelEncoderReset(encoder);
+        HoneywellByteBuffer chunk = { 0 };
+        HONEYWELL_CHECK(HoneywellByteBufferAppendString(&chunk, kEarlierLabels) == 0);
+        size_t labelStart = chunk.length;
+        
+        reallocationsLeft = failAt;
+        int result = HoneywellLabelEncoderAppendLabel(encoder, HONEYWELL_LABEL_STANDARD_PRICE, record, 1, &chunk);
+        reallocationsLeft = -1;
+        
+        if (result == 0) {
+            /* nothing left to fail, the label went through untouched */
+            HONEYWELL_CHECK(bytesEqual(&chunk, labelStart, &first));
+            HoneywellByteBufferDestroy(&chunk);
+            break;
+        }
+        
+        failures++;
+        HONEYWELL_CHECK(chunk.length == labelStart);
+        HONEYWELL_CHECK(memcmp(chunk.bytes, kEarlierLabels, labelStart) == 0);
+        
+        /* as the engine does, the failed label's bytes are gone, so the next
+           label has to bring the layout and settings itself */
+        HONEYWELL_CHECK(HoneywellLabelEncoderAppendLabel(encoder, HONEYWELL_LABEL_STANDARD_PRICE, record, 1, &chunk) == 0);
+        HONEYWELL_CHECK(bytesEqual(&chunk, labelStart, &first));
+        
+        size_t secondStart = chunk.length;
+        HONEYWELL_CHECK(HoneywellLabelEncoderAppendLabel(encoder, HONEYWELL_LABEL_STANDARD_PRICE, record, 1, &chunk) == 0);
+        HONEYWELL_CHECK(bytesEqual(&chunk, secondStart, &second));
+        
+        HoneywellByteBufferDestroy(&chunk);
+    }
+    
+    HoneywellLabelEncoderDestroy(encoder);
+    HoneywellByteBufferDestroy(&first);
+    HoneywellByteBufferDestroy(&second);
+    return failures;
+}
+
+int main(void)
+{
+    memset(longDescription, 'x', sizeof(longDescription) - 1);
+    HoneywellRecordField fields[4];
+    
+    /* the long description makes the LAYOUT RUN record grow the buffer after
+       the layout definition went in, a '|' sends the label inline instead */
+    HoneywellRecord stored = priceRecord(fields, longDescription);
+    HONEYWELL_CHECK(checkFailuresLeaveNothing(1, &stored) >= 2);
+    
+    longDescription[700] = '|';
+    HoneywellRecord separator = priceRecord(fields, longDescription);
+    HONEYWELL_CHECK(checkFailuresLeaveNothing(1, &separator) >= 3);
+    
+    HONEYWELL_CHECK(checkFailuresLeaveNothing(0, &separator) >= 1);
+    
+    HoneywellRecord shortRecord = priceRecord(fields, "A&W Rootbeer 250ml");
+    HONEYWELL_CHECK(checkFailuresLeaveNothing(1, &shortRecord) >= 1);
+    
+    return HONEYWELL_TEST_RESULT;
+}
@@ -0,0 +1,361 @@
+//
+//  HoneywellLabelGoldenTests.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+/*
+
+ Golden tests for the label layouts. Each sample record is rendered through
+ its compiled layout and compared with references under tests/golden:
+
+ - <name>.dp, the Direct Protocol of the inline label, byte for byte
+ - <name>.pbm, the label as HoneywellRasterizeLabel draws it, pixel for pixel
+
+ The layout source is also rendered without HoneywellOptimizeCommands and
+ must draw the same label, so an optimizer change that alters a printed
+ label fails here. connection.dp holds what the encoder sends for all the
+ samples on a fresh connection, stored layouts included.
+
+    HoneywellLabelGoldenTests <golden directory> <path to 1bitleaf>
+
+ With HONEYWELL_UPDATE_GOLDEN=1 in the environment the references are
+ rewritten instead, review the diff before committing them. A failed
+ comparison writes what was rendered to the working directory.
+
+ */
+
+#include "HoneywellBarcode.h"
+#include "HoneywellCommandOptimizer.h"
+#include "HoneywellLabelEncoder.h"
+#include "HoneywellRasterizer.h"
+#include "HoneywellTest.h"
+#include "HoneywellTestFiles.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    // file name of the references, without extension
+    const char * name;
+    int type;
+    HoneywellRecordField fields[5];
+} GoldenLabel;
+
+static const GoldenLabel goldenLabels[] = {
+    { "price50", HONEYWELL_LABEL_STANDARD_PRICE, {
+        { "image", "1bitleaf" },
+        { "barcodeTypeCode", "2" },
+        { "barcodeInput", "9556001234567" },
+        { "itemDescription", "A&W Rootbeer Orange-Berry Flavour 250ml" },
+        { "itemPrice", "RM28.50" } } },
+    { "food50", HONEYWELL_LABEL_FOOD_INFO, {
+        { "itemDescription", "Nasi Lemak Ayam Goreng Berempah dengan Sambal" },
+        { "barcodeTypeCode", "CODE128" },
+        { "barcodeInput", "NL-0042" } } },
+    { "price35", HONEYWELL_LABEL_DEFAULT_SIZE, {
+        { "image", "1bitleaf" },
+        { "barcode", "2" },
+        { "input", "5901234123457" } } }
+};
+
+#define GOLDEN_LABEL_COUNT (sizeof(goldenLabels) / sizeof(goldenLabels[0]))
+
+static const char * goldenDirectory;
+static int updateGolden;
+static HoneywellMonoImage logo;
+
+static HoneywellRecord recordForLabel(const GoldenLabel * label)
+{
+    size_t count = 0;
+    while (count < sizeof(label->fields) / sizeof(label->fields[0]) && label->fields[count].key != NULL) {
+        count++;
+    }
+    HoneywellRecord record = { label->fields, count, NULL };
+    return record;
+}
+
+#pragma mark - files
+
+static void goldenPath(char * path, size_t capacity, const char * name, const char * extension)
+{
+    snprintf(path, capacity, "%s/%s.%s", goldenDirectory, name, extension);
+}
+
+/* binary PBM, where a set bit is black, the other way round from a mono image */
+static int writePBM(const char * path, const HoneywellMonoImage * image)
+{
+    FILE * file = fopen(path, "wb");
+    if (file == NULL) {
+        return -1;
+    }
+    fprintf(file, "P4\n%u %u\n", image->width, image->height);
+    
+    size_t rowLength = (image->width + 7) / 8;
+    uint8_t * row = malloc(rowLength);
+    for (uint32_t y = 0; row != NULL && y < image->height; y++) {
+        const uint8_t * bits = image->bits + y * image->bytesPerLine;
+        for (size_t i = 0; i < rowLength; i++) {
+            row[i] = (uint8_t)~bits[i];
+        }
+        fwrite(row, 1, rowLength, file);
+    }
+    free(row);
+    return (fclose(file) == 0) ? 0 : -1;
+}
+
+static int readPBM(const char * path, HoneywellMonoImage * image)
+{
+    size_t length = 0;
+    uint8_t * bytes = HoneywellTestReadFile(path, &length);
+    if (bytes == NULL) {
+        return -1;
+    }
+    
+    unsigned width = 0;
+    unsigned height = 0;
+    int headerLength = 0;
+    char header[32] = { 0 };
+    memcpy(header, bytes, length < sizeof(header) - 1 ? length : sizeof(header) - 1);
+    if (sscanf(header, "P4 %u %u%n", &width, &height, &headerLength) != 2
+        || HoneywellMonoImageCreate(image, width, height) != 0) {
+        free(bytes);
+        return -1;
+    }
+    
+    /* one whitespace byte ends the header */
+    size_t rowLength = (width + 7) / 8;
+    size_t offset = (size_t)headerLength + 1;
+    if (offset + rowLength * height > length) {
+        HoneywellMonoImageDestroy(image);
+        free(bytes);
+        return -1;
+    }
+    for (uint32_t y = 0; y < height; y++) {
+        uint8_t * bits = image->bits + y * image->bytesPerLine;
+        for (size_t i = 0; i < rowLength; i++) {
+            bits[i] = (uint8_t)~bytes[offset + y * rowLength + i];
+        }
+    }
+    free(bytes);
+    return 0;
+}
+
+#pragma mark - rendering
+
+static const HoneywellMonoImage * imageNamed(void * context, const char * name)
+{
+    (void)context;
+    return (strcmp(name, "1BITLEAF") == 0 && logo.bits != NULL) ? &logo : NULL;
+}
+
+static int encodeBarcode(void * context, const char * type, const char * data, uint8_t * widths, int capacity)
+{
+    (void)context;
+    return HoneywellBarcodeEncode(HoneywellBarcodeTypeNamed(type), data, widths, capacity);
+}
+
+/* the bundled logo is already black and white, any threshold keeps it as it is */
+static int loadLogo(const char * path)
+{
+    size_t length = 0;
+    uint8_t * pcx = HoneywellTestReadFile(path, &length);
+    HoneywellGreyImage grey;
+    if (pcx == NULL || HoneywellPCXDecode(pcx, length, &grey) != 0) {
+        free(pcx);
+        return -1;
+    }
+    free(pcx);
+    
+    int result = HoneywellMonoImageCreate(&logo, grey.width, grey.height);
+    if (result == 0) {
+        HoneywellThreshold(&grey, 128, &logo);
+    }
+    HoneywellGreyImageDestroy(&grey);
+    return result;
+}
+
+static int rasterize(const HoneywellByteBuffer * commands, const HoneywellLabelLayout * layout, HoneywellMonoImage * label)
+{
+    if (HoneywellMonoImageCreate(label, layout->width, layout->height) != 0) {
+        return -1;
+    }
+    HoneywellRasterizerOptions options = { imageNamed, encodeBarcode, NULL };
+    if (HoneywellRasterizeLabel((const char *)commands->bytes, commands->length, &options, label) < 0) {
+        HoneywellMonoImageDestroy(label);
+        return -1;
+    }
+    return 0;
+}
+
+#pragma mark - comparisons
+
+static void checkCommandsMatchGolden(const char * name, const HoneywellByteBuffer * commands)
+{
+    char path[1024];
+    goldenPath(path, sizeof(path), name, "dp");
+    if (updateGolden) {
+        HONEYWELL_CHECK(HoneywellTestWriteFile(path, commands->bytes, commands->length) == 0);
+        return;
+    }
+    
+    size_t length = 0;
+    uint8_t * golden = HoneywellTestReadFile(path, &length);
+    HONEYWELL_CHECK(golden != NULL);
+    
+    int matches = golden != NULL && length == commands->length && memcmp(golden, commands->bytes, length) == 0;
+    if (!matches) {
+        fprintf(stderr, "%s.dp differs from the golden commands\n", name);
+        snprintf(path, sizeof(path), "%s.dp", name);
+        HoneywellTestWriteFile(path, commands->bytes, commands->length);
+    }
+    HONEYWELL_CHECK(matches);
+    free(golden);
+}
+
+static void checkImageMatchesGolden(const char * name, const HoneywellMonoImage * label)
+{
+    char path[1024];
+    goldenPath(path, sizeof(path), name, "pbm");
+    if (updateGolden) {
+        HONEYWELL_CHECK(writePBM(path, label) == 0);
+        return;
+    }
+    
+    HoneywellMonoImage golden;
+    HONEYWELL_CHECK(readPBM(path, &golden) == 0);
+    if (golden.bits == NULL) {
+        return;
+    }
+    
+    size_t difference = HoneywellMonoImageDifference(&golden, label);
+    if (difference != 0) {
+        fprintf(stderr, "%s.pbm differs from the golden label in %zu pixels\n", name, difference);
+        snprintf(path, sizeof(path), "%s.pbm", name);
+        writePBM(path, label);
+    }
+    HONEYWELL_CHECK(difference == 0);
+    HoneywellMonoImageDestroy(&golden);
+}
+
+#pragma mark - tests
+
+static void testLabelMatchesGolden(const HoneywellLabelEncoder * encoder, const GoldenLabel * golden)
+{
+    const HoneywellLabelLayout * layout = HoneywellLabelLayoutForType(golden->type);
+    HONEYWELL_CHECK(layout != NULL);
+    if (layout == NULL) {
+        return;
+    }
+    HoneywellRecord record = recordForLabel(golden);
+    
+    HoneywellByteBuffer commands = { 0 };
+    HONEYWELL_CHECK(HoneywellLabelTemplateRender(HoneywellLabelEncoderTemplate(encoder, golden->type), &record, 1, NULL, &commands) == 0);
+    checkCommandsMatchGolden(golden->name, &commands);
+    
+    HoneywellMonoImage label = { 0 };
+    HONEYWELL_CHECK(rasterize(&commands, layout, &label) == 0);
+    if (label.bits != NULL) {
+        checkImageMatchesGolden(golden->name, &label);
+    }
+    
+    /* the optimizer may only drop statements that change nothing on the label */
+    HoneywellLabelTemplate * unoptimized = HoneywellLabelTemplateCreate(layout->source, strlen(layout->source), NULL);
+    HONEYWELL_CHECK(unoptimized != NULL);
+    HoneywellByteBuffer unoptimizedCommands = { 0 };
+    HONEYWELL_CHECK(HoneywellLabelTemplateRender(unoptimized, &record, 1, NULL, &unoptimizedCommands) == 0);
+    HONEYWELL_CHECK(unoptimizedCommands.length >= commands.length);
+    
+    HoneywellMonoImage unoptimizedLabel = { 0 };
+    HONEYWELL_CHECK(rasterize(&unoptimizedCommands, layout, &unoptimizedLabel) == 0);
+    if (label.bits != NULL && unoptimizedLabel.bits != NULL) {
+        HONEYWELL_CHECK(HoneywellMonoImageDifference(&label, &unoptimizedLabel) == 0);
+    }
+    
+    HoneywellMonoImageDestroy(&unoptimizedLabel);
+    HoneywellMonoImageDestroy(&label);
+    HoneywellByteBufferDestroy(&unoptimizedCommands);
+    HoneywellLabelTemplateDestroy(unoptimized);
+    HoneywellByteBufferDestroy(&commands);
+}
+
+/* layouts are stored once, labels after that are LAYOUT RUN records */
+static void testConnectionMatchesGolden(HoneywellLabelEncoder * encoder)
+{
+    HoneywellLabelEncoderReset(encoder);
+    
+    HoneywellByteBuffer commands = { 0 };
+    for (int pass = 0; pass < 2; pass++) {
+        for (size_t i = 0; i < GOLDEN_LABEL_COUNT; i++) {
+            HoneywellRecord record = recordForLabel(&goldenLabels[i]);
+            HONEYWELL_CHECK(HoneywellLabelEncoderAppendLabel(encoder, goldenLabels[i].type, &record, 1 + pass, &commands) == 0);
+        }
+    }
+    checkCommandsMatchGolden("connection", &commands);
+    HoneywellByteBufferDestroy(&commands);
+}
+
+typedef struct {
+    const char * source;
+    const char * optimized;
+} OptimizerCase;
+
+static const OptimizerCase optimizerCases[] = {
+    // a repeated AN with the same value
+    { "AN 1: PT \"A\": AN 1: PT \"B\": PF \r\n", "AN 1: PT \"A\": PT \"B\": PF \r\n" },
+    // MAG 1,1 that nothing prints with before PF resets it
+    { "MAG 1,4: PM \"X\": MAG 1,1: PF \r\n", "MAG 1,4: PM \"X\": PF \r\n" },
+    // a PP move straight into another
+    { "PP 1,2: PP 3,4: PT \"A\": PF \r\n", "PP 3,4: PT \"A\": PF \r\n" },
+    // a font overridden before use
+    { "FT \"A\",6: FT \"B\",8: PT \"x\": PF \r\n", "FT \"B\",8: PT \"x\": PF \r\n" },
+    // PF resets the state, the same AN on the next label is not a repeat
+    { "AN 1: PF \r\nAN 1: PT \"y\": PF \r\n", "PF \r\nAN 1: PT \"y\": PF \r\n" },
+    // nothing moves across a statement the pass does not know
+    { "PP 2,2: FOO 1: PP 3,3: PT \"x\": PF \r\n", "PP 2,2: FOO 1: PP 3,3: PT \"x\": PF \r\n" }
+};
+
+static void testOptimizerCases(void)
+{
+    for (size_t i = 0; i < sizeof(optimizerCases) / sizeof(optimizerCases[0]); i++) {
+        const OptimizerCase * optimizerCase = &optimizerCases[i];
+        HoneywellByteBuffer optimized = { 0 };
+        HONEYWELL_CHECK(HoneywellOptimizeCommands(optimizerCase->source, strlen(optimizerCase->source), &optimized) == 0);
+        
+        int matches = optimized.length == strlen(optimizerCase->optimized)
+            && memcmp(optimized.bytes, optimizerCase->optimized, optimized.length) == 0;
+        if (!matches) {
+            fprintf(stderr, "optimized %s into %.*s\n", optimizerCase->source, (int)optimized.length, (const char *)optimized.bytes);
+        }
+        HONEYWELL_CHECK(matches);
+        HoneywellByteBufferDestroy(&optimized);
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <golden directory> <path to 1bitleaf>\n", argv[0]);
+        return 2;
+    }
+    goldenDirectory = argv[1];
+    const char * update = getenv("HONEYWELL_UPDATE_GOLDEN");
+    updateGolden = update != NULL && strcmp(update, "1") == 0;
+    
+    HONEYWELL_CHECK(loadLogo(argv[2]) == 0);
+    HoneywellLabelEncoder * encoder = HoneywellLabelEncoderCreate();
+    HONEYWELL_CHECK(encoder != NULL);
+    
+    testOptimizerCases();
+    if (encoder != NULL) {
+        for (size_t i = 0; i < GOLDEN_LABEL_COUNT; i++) {
+            testLabelMatchesGolden(encoder, &goldenLabels[i]);
+        }
+        testConnectionMatchesGolden(encoder);
+    }
+    
+    HoneywellLabelEncoderDestroy(encoder);
+    HoneywellMonoImageDestroy(&logo);
+    return HONEYWELL_TEST_RESULT;
+}
@@ -0,0 +1,540 @@
+//
+//  HoneywellManageStandIn.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+/* POSIX sockets and threads under -std=c11 on Linux */
+#define _POSIX_C_SOURCE 200809L
+
+#include "HoneywellManageStandIn.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+#define HEAD_CAPACITY 8192
+// larger bodies are refused, the printer's flash is far smaller
+#define MAX_BODY_LENGTH (64 * 1024 * 1024)
+// a client silent this long has given up
+#define READ_TIMEOUT_MS 10000
+
+typedef struct {
+    char name[128];
+    uint8_t * bytes;
+    size_t length;
+    // set once upload_done.lp was asked for it
+    int stored;
+} HoneywellManageFile;
+
+struct HoneywellManageStandIn {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    int stopRequested;
+    
+    int listenFd;
+    int port;
+    
+    HoneywellManageRequest * requests;
+    size_t requestCount;
+    size_t requestCapacity;
+    
+    HoneywellManageFile * files;
+    size_t fileCount;
+    size_t fileCapacity;
+};
+
+/* the body as it arrived, the head's leftovers first */
+typedef struct {
+    uint8_t * bytes;
+    size_t length;
+} HoneywellRequestBody;
+
+static const uint8_t * findBytes(const uint8_t * haystack, size_t length, const void * needle, size_t needleLength)
+{
+    if (needleLength == 0 || length < needleLength) {
+        return NULL;
+    }
+    for (size_t i = 0; i + needleLength <= length; i++) {
+        if (haystack[i] == *(const uint8_t *)needle && memcmp(haystack + i, needle, needleLength) == 0) {
+            return haystack + i;
+        }
+    }
+    return NULL;
+}
+
+static int isStopRequested(HoneywellManageStandIn * standIn)
+{
+    pthread_mutex_lock(&standIn->lock);
+    int stop = standIn->stopRequested;
+    pthread_mutex_unlock(&standIn->lock);
+    return stop;
+}
+
+/* waits for data in short slices so Stop is not held up, returns what
+   recv returned or -1 on timeout */
+static ssize_t receive(HoneywellManageStandIn * standIn, int fd, void * buffer, size_t capacity)
+{
+    for (int waited = 0; waited < READ_TIMEOUT_MS && !isStopRequested(standIn); waited += 20) {
+        struct pollfd pfd = { fd, POLLIN, 0 };
+        if (poll(&pfd, 1, 20) <= 0) {
+            continue;
+        }
+        ssize_t length = recv(fd, buffer, capacity, 0);
+        if (length < 0 && errno == EINTR) {
+            continue;
+        }
+        return length;
+    }
+    return -1;
+}
+
+static void sendAll(int fd, const char * text, size_t length)
+{
+    size_t offset = 0;
+    while (offset < length) {
+        ssize_t written = send(fd, text + offset, length - offset, MSG_NOSIGNAL);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return;
+        }
+        offset += written;
+    }
+}
+
+static void answer(int fd, int status, const char * page)
+{
+    const char * reason = status == 200 ? "OK" : status == 400 ? "Bad Request" : status == 411 ? "Length Required" : "Not Found";
+    char head[256];
+    int length = snprintf(head, sizeof(head), "HTTP/1.1 %d %s\r\nContent-Type: text/html\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n",
+                          status, reason, strlen(page));
+    sendAll(fd, head, (size_t)length);
+    sendAll(fd, page, strlen(page));
+}
+
+#pragma mark - request head
+
+/* value of header name in head, copied into value, 0 if it is missing */
+static int headerValue(const char * head, const char * name, char * value, size_t capacity)
+{
+    size_t nameLength = strlen(name);
+    for (const char * line = strstr(head, "\r\n"); line != NULL; line = strstr(line, "\r\n")) {
+        line += 2;
+        if (strncasecmp(line, name, nameLength) == 0 && line[nameLength] == ':') {
+            const char * start = line + nameLength + 1;
+            while (*start == ' ') {
+                start++;
+            }
+            const char * end = strstr(start, "\r\n");
+            size_t length = end != NULL ? (size_t)(end - start) : strlen(start);
+            if (length >= capacity) {
+                length = capacity - 1;
+            }
+            memcpy(value, start, length);
+            value[length] = '\0';
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* reads up to the blank line, the bytes after it are the start of the body */
+static int readHead(HoneywellManageStandIn * standIn, int fd, char * head, size_t * headLength, size_t * received)
+{
+    *received = 0;
+    while (*received < HEAD_CAPACITY - 1) {
+        ssize_t length = receive(standIn, fd, head + *received, HEAD_CAPACITY - 1 - *received);
+        if (length <= 0) {
+            return -1;
+        }
+        *received += (size_t)length;
+        head[*received] = '\0';
+        
+        char * end = strstr(head, "\r\n\r\n");
+        if (end != NULL) {
+            *headLength = (size_t)(end - head) + 4;
+            end[2] = '\0';
+            return 0;
+        }
+    }
+    return -1;
+}
+
+#pragma mark - multipart
+
+static int keepFile(HoneywellManageStandIn * standIn, const char * name, const uint8_t * bytes, size_t length)
+{
+    HoneywellManageFile file;
+    memset(&file, 0, sizeof(file));
+    snprintf(file.name, sizeof(file.name), "%s", name);
+    file.bytes = malloc(length > 0 ? length : 1);
+    if (file.bytes == NULL) {
+        return -1;
+    }
+    memcpy(file.bytes, bytes, length);
+    file.length = length;
+    
+    pthread_mutex_lock(&standIn->lock);
+    if (standIn->fileCount == standIn->fileCapacity) {
+        size_t capacity = standIn->fileCapacity > 0 ? standIn->fileCapacity * 2 : 8;
+        HoneywellManageFile * files = realloc(standIn->files, capacity * sizeof(HoneywellManageFile));
+        if (files == NULL) {
+            pthread_mutex_unlock(&standIn->lock);
+            free(file.bytes);
+            return -1;
+        }
+        standIn->files = files;
+        standIn->fileCapacity = capacity;
+    }
+    standIn->files[standIn->fileCount++] = file;
+    pthread_mutex_unlock(&standIn->lock);
+    return 0;
+}
+
+/* keeps every file part, the first one's name goes to filename. Accepts the
+   closing delimiter with or without its trailing --, the app has always
+   sent it without. Returns -1 for a malformed body. */
+static int parseMultipart(HoneywellManageStandIn * standIn, const HoneywellRequestBody * body, const char * boundary, char * filename, size_t capacity)
+{
+    char delimiter[128];
+    int delimiterLength = snprintf(delimiter, sizeof(delimiter), "\r\n--%s", boundary);
+    if (delimiterLength <= 4 || (size_t)delimiterLength >= sizeof(delimiter)) {
+        return -1;
+    }
+    
+    /* the first delimiter may come without its CRLF */
+    const uint8_t * end = body->bytes + body->length;
+    const uint8_t * p;
+    if (body->length >= (size_t)delimiterLength - 2 && memcmp(body->bytes, delimiter + 2, (size_t)delimiterLength - 2) == 0) {
+        p = body->bytes + delimiterLength - 2;
+    }
+    else if ((p = findBytes(body->bytes, body->length, delimiter, (size_t)delimiterLength)) != NULL) {
+        p += delimiterLength;
+    }
+    else {
+        return -1;
+    }
+    
+    int parts = 0;
+    filename[0] = '\0';
+    while (1) {
+        if (end - p >= 2 && memcmp(p, "--", 2) == 0) {
+            break;
+        }
+        if (end - p < 2 || memcmp(p, "\r\n", 2) != 0) {
+            return -1;
+        }
+        p += 2;
+        if (p == end && parts > 0) {
+            break;
+        }
+        
+        const uint8_t * headersEnd = findBytes(p, (size_t)(end - p), "\r\n\r\n", 4);
+        if (headersEnd == NULL) {
+            return -1;
+        }
+        char headers[1024];
+        size_t headersLength = (size_t)(headersEnd - p);
+        if (headersLength >= sizeof(headers)) {
+            return -1;
+        }
+        memcpy(headers, p, headersLength);
+        headers[headersLength] = '\0';
+        
+        const uint8_t * contents = headersEnd + 4;
+        const uint8_t * next = findBytes(contents, (size_t)(end - contents), delimiter, (size_t)delimiterLength);
+        if (next == NULL) {
+            return -1;
+        }
+        
+        char * name = strstr(headers, "filename=\"");
+        if (name != NULL) {
+            name += 10;
+            char * quote = strchr(name, '"');
+            if (quote == NULL) {
+                return -1;
+            }
+            *quote = '\0';
+            if (keepFile(standIn, name, contents, (size_t)(next - contents)) != 0) {
+                return -1;
+            }
+            if (filename[0] == '\0') {
+                snprintf(filename, capacity, "%s", name);
+            }
+        }
+        parts++;
+        p = next + delimiterLength;
+    }
+    return filename[0] != '\0' ? 0 : -1;
+}
+
+#pragma mark - requests
+
+static void recordRequest(HoneywellManageStandIn * standIn, const HoneywellManageRequest * request)
+{
+    pthread_mutex_lock(&standIn->lock);
+    if (standIn->requestCount == standIn->requestCapacity) {
+        size_t capacity = standIn->requestCapacity > 0 ? standIn->requestCapacity * 2 : 16;
+        HoneywellManageRequest * requests = realloc(standIn->requests, capacity * sizeof(HoneywellManageRequest));
+        if (requests == NULL) {
+            pthread_mutex_unlock(&standIn->lock);
+            return;
+        }
+        standIn->requests = requests;
+        standIn->requestCapacity = capacity;
+    }
+    standIn->requests[standIn->requestCount++] = *request;
+    pthread_mutex_unlock(&standIn->lock);
+}
+
+/* reads exactly Content-Length bytes, fewer if the client stopped sending */
+static int readBody(HoneywellManageStandIn * standIn, int fd, const char * leftover, size_t leftoverLength, HoneywellManageRequest * request, HoneywellRequestBody * body)
+{
+    size_t expected = (size_t)request->contentLength;
+    body->bytes = malloc(expected > 0 ? expected : 1);
+    body->length = 0;
+    if (body->bytes == NULL) {
+        return -1;
+    }
+    
+    size_t initial = leftoverLength < expected ? leftoverLength : expected;
+    memcpy(body->bytes, leftover, initial);
+    body->length = initial;
+    request->largestRead = initial;
+    
+    while (body->length < expected) {
+        ssize_t length = receive(standIn, fd, body->bytes + body->length, expected - body->length);
+        if (length <= 0) {
+            break;
+        }
+        body->length += (size_t)length;
+        if ((size_t)length > request->largestRead) {
+            request->largestRead = (size_t)length;
+        }
+    }
+    request->bodyLength = body->length;
+    return body->length == expected ? 0 : -1;
+}
+
+static int handleUpload(HoneywellManageStandIn * standIn, int fd, const char * head, const char * leftover, size_t leftoverLength, HoneywellManageRequest * request)
+{
+    char value[256];
+    if (!headerValue(head, "Content-Length", value, sizeof(value))) {
+        answer(fd, 411, "<html><body>Length Required</body></html>");
+        return 411;
+    }
+    char * valueEnd;
+    request->contentLength = strtoll(value, &valueEnd, 10);
+    if (valueEnd == value || *valueEnd != '\0' || request->contentLength < 0 || request->contentLength > MAX_BODY_LENGTH) {
+        answer(fd, 400, "<html><body>Bad Request</body></html>");
+        return 400;
+    }
+    
+    char boundary[128] = "";
+    const char * boundaryStart = headerValue(head, "Content-Type", value, sizeof(value)) ? strstr(value, "boundary=") : NULL;
+    if (boundaryStart != NULL) {
+        snprintf(boundary, sizeof(boundary), "%s", boundaryStart + 9);
+    }
+    
+    HoneywellRequestBody body = { NULL, 0 };
+    char filename[128];
+    int status = 400;
+    if (readBody(standIn, fd, leftover, leftoverLength, request, &body) == 0 && boundary[0] != '\0'
+        && parseMultipart(standIn, &body, boundary, filename, sizeof(filename)) == 0) {
+        
+        /* what the printer answers, the app takes the URI between url= and the head's end */
+        char page[512];
+        snprintf(page, sizeof(page), "<html><head>\n<meta http-equiv=\"refresh\" content=\"0;url=upload_done.lp?file=%s\" />\n</head>"
+                 "<body>Uploading</body></html>", filename);
+        answer(fd, 200, page);
+        status = 200;
+    }
+    else {
+        answer(fd, 400, "<html><body>Bad Request</body></html>");
+    }
+    free(body.bytes);
+    return status;
+}
+
+static int handleUploadDone(HoneywellManageStandIn * standIn, int fd, const char * name)
+{
+    int found = 0;
+    pthread_mutex_lock(&standIn->lock);
+    for (size_t i = standIn->fileCount; i > 0 && !found; i--) {
+        if (strcmp(standIn->files[i - 1].name, name) == 0) {
+            standIn->files[i - 1].stored = 1;
+            found = 1;
+        }
+    }
+    pthread_mutex_unlock(&standIn->lock);
+    
+    if (!found) {
+        answer(fd, 404, "<html><body>Not Found</body></html>");
+        return 404;
+    }
+    answer(fd, 200, "<html><body>File stored</body></html>");
+    return 200;
+}
+
+static void serveConnection(HoneywellManageStandIn * standIn, int fd)
+{
+    char head[HEAD_CAPACITY];
+    size_t headLength = 0;
+    size_t received = 0;
+    if (readHead(standIn, fd, head, &headLength, &received) != 0) {
+        return;
+    }
+    
+    HoneywellManageRequest request;
+    memset(&request, 0, sizeof(request));
+    request.contentLength = -1;
+    char format[32];
+    snprintf(format, sizeof(format), "%%%zus %%%zus", sizeof(request.method) - 1, sizeof(request.path) - 1);
+    if (sscanf(head, format, request.method, request.path) != 2) {
+        return;
+    }
+    
+    static const char doneTarget[] = "/manage/upload_done.lp?file=";
+    if (strcmp(request.method, "POST") == 0 && strcmp(request.path, "/manage/upload.lp?type=image") == 0) {
+        request.status = handleUpload(standIn, fd, head, head + headLength, received - headLength, &request);
+    }
+    else if (strcmp(request.method, "GET") == 0 && strncmp(request.path, doneTarget, sizeof(doneTarget) - 1) == 0) {
+        request.status = handleUploadDone(standIn, fd, request.path + sizeof(doneTarget) - 1);
+    }
+    else {
+        answer(fd, 404, "<html><body>Not Found</body></html>");
+        request.status = 404;
+    }
+    recordRequest(standIn, &request);
+}
+
+#pragma mark - thread
+
+static void * runStandIn(void * argument)
+{
+    HoneywellManageStandIn * standIn = argument;
+    
+    while (!isStopRequested(standIn)) {
+        struct pollfd pfd = { standIn->listenFd, POLLIN, 0 };
+        if (poll(&pfd, 1, 20) <= 0) {
+            continue;
+        }
+        int fd = accept(standIn->listenFd, NULL, NULL);
+        if (fd >= 0) {
+            serveConnection(standIn, fd);
+            close(fd);
+        }
+    }
+    return NULL;
+}
+
+HoneywellManageStandIn * HoneywellManageStandInStart(void)
+{
+    HoneywellManageStandIn * standIn = calloc(1, sizeof(HoneywellManageStandIn));
+    if (standIn == NULL) {
+        return NULL;
+    }
+    pthread_mutex_init(&standIn->lock, NULL);
+    
+    standIn->listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addressLength = sizeof(address);
+    
+    if (standIn->listenFd < 0
+        || bind(standIn->listenFd, (struct sockaddr *)&address, sizeof(address)) != 0
+        || listen(standIn->listenFd, 4) != 0
+        || getsockname(standIn->listenFd, (struct sockaddr *)&address, &addressLength) != 0
+        || pthread_create(&standIn->thread, NULL, runStandIn, standIn) != 0) {
+        if (standIn->listenFd >= 0) {
+            close(standIn->listenFd);
+        }
+        pthread_mutex_destroy(&standIn->lock);
+        free(standIn);
+        return NULL;
+    }
+    standIn->port = ntohs(address.sin_port);
+    return standIn;
+}
+
+void HoneywellManageStandInStop(HoneywellManageStandIn * standIn)
+{
+    if (standIn == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&standIn->lock);
+    standIn->stopRequested = 1;
+    pthread_mutex_unlock(&standIn->lock);
+    
+    pthread_join(standIn->thread, NULL);
+    close(standIn->listenFd);
+    for (size_t i = 0; i < standIn->fileCount; i++) {
+        free(standIn->files[i].bytes);
+    }
+    free(standIn->files);
+    free(standIn->requests);
+    pthread_mutex_destroy(&standIn->lock);
+    free(standIn);
+}
+
+#pragma mark - state
+
+int HoneywellManageStandInPort(const HoneywellManageStandIn * standIn)
+{
+    return standIn->port;
+}
+
+size_t HoneywellManageStandInRequestCount(HoneywellManageStandIn * standIn)
+{
+    pthread_mutex_lock(&standIn->lock);
+    size_t count = standIn->requestCount;
+    pthread_mutex_unlock(&standIn->lock);
+    return count;
+}
+
+int HoneywellManageStandInRequestAt(HoneywellManageStandIn * standIn, size_t index, HoneywellManageRequest * request)
+{
+    pthread_mutex_lock(&standIn->lock);
+    int found = index < standIn->requestCount;
+    if (found) {
+        *request = standIn->requests[index];
+    }
+    pthread_mutex_unlock(&standIn->lock);
+    return found ? 0 : -1;
+}
+
+uint8_t * HoneywellManageStandInStoredFile(HoneywellManageStandIn * standIn, const char * name, size_t * length)
+{
+    uint8_t * copy = NULL;
+    pthread_mutex_lock(&standIn->lock);
+    for (size_t i = standIn->fileCount; i > 0; i--) {
+        const HoneywellManageFile * file = &standIn->files[i - 1];
+        if (file->stored && strcmp(file->name, name) == 0) {
+            copy = malloc(file->length > 0 ? file->length : 1);
+            if (copy != NULL) {
+                memcpy(copy, file->bytes, file->length);
+                *length = file->length;
+            }
+            break;
+        }
+    }
+    pthread_mutex_unlock(&standIn->lock);
+    return copy;
+}
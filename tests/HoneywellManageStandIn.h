@@ -0,0 +1,62 @@
+//
+//  HoneywellManageStandIn.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#ifndef HoneywellManageStandIn_h
+#define HoneywellManageStandIn_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+
+ A stand-in for the PC42t's web server on a loopback port, run on its own
+ thread, for the image upload the app does through /manage:
+
+ - POST /manage/upload.lp?type=image with a multipart/form-data body. The
+   body has to be exactly Content-Length bytes, a request without one is
+   answered 411, a short or malformed body 400. Each file part is kept and
+   the answer is the printer's page redirecting to upload_done.lp.
+ - GET /manage/upload_done.lp?file=<name> stores the file kept under name,
+   as the printer does once the browser follows the redirect, and answers
+   200. Anything else is 404.
+
+ One request per connection, the answer closes it.
+
+ */
+
+typedef struct HoneywellManageStandIn HoneywellManageStandIn;
+
+typedef struct {
+    char method[8];
+    char path[256];
+    // -1 if the request had no Content-Length
+    long long contentLength;
+    // body bytes that arrived before the client finished sending
+    unsigned long long bodyLength;
+    // the largest single read of the body, shows it arrived in pieces
+    size_t largestRead;
+    int status;
+} HoneywellManageRequest;
+
+// listens on a free loopback port, NULL on failure
+HoneywellManageStandIn * HoneywellManageStandInStart(void);
+
+// waits for the current request to finish and frees the stand-in
+void HoneywellManageStandInStop(HoneywellManageStandIn * standIn);
+
+int HoneywellManageStandInPort(const HoneywellManageStandIn * standIn);
+
+// requests answered so far, in order
+size_t HoneywellManageStandInRequestCount(HoneywellManageStandIn * standIn);
+int HoneywellManageStandInRequestAt(HoneywellManageStandIn * standIn, size_t index, HoneywellManageRequest * request);
+
+/* a copy of the stored file's contents the caller frees, NULL if no file of
+   that name was stored */
+uint8_t * HoneywellManageStandInStoredFile(HoneywellManageStandIn * standIn, const char * name, size_t * length);
+
+#endif /* HoneywellManageStandIn_h */
@@ -0,0 +1,426 @@
+//
+//  HoneywellMultipartTests.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+/*
+
+ Checks the streamed upload body: its bytes are the form the printer has
+ always been sent, Content-Length matches them without the body being
+ built, file contents are handed out from where they lie, and an upload
+ through the /manage stand-in stores exactly the file, also when the socket
+ takes it in short writes.
+
+    HoneywellMultipartTests <directory with 1bitleaf and puzzle>
+
+ */
+
+/* POSIX sockets and mkstemp under -std=c11 on Linux */
+#define _POSIX_C_SOURCE 200809L
+
+#include "HoneywellManageStandIn.h"
+#include "HoneywellMultipart.h"
+#include "HoneywellTest.h"
+#include "HoneywellTestFiles.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+// what HoneywellImageLibrary uploads with
+static const char kBoundary[] = "------WebKitFormBoundary";
+
+// HoneywellMultipartBody's bound pair buffer
+#define BODY_CHUNK_LENGTH (32 * 1024)
+
+/* walks the whole body like the producer does, writing at most step bytes
+   of each chunk to show short writes resume. Returns the bytes, caller frees. */
+static uint8_t * collectBody(const HoneywellMultipart * body, size_t maxLength, size_t step, size_t * length,
+                             const uint8_t * file, size_t fileLength, size_t * fromFile)
+{
+    size_t capacity = (size_t)HoneywellMultipartContentLength(body);
+    uint8_t * bytes = malloc(capacity + 1);
+    *length = 0;
+    *fromFile = 0;
+    if (bytes == NULL) {
+        return NULL;
+    }
+    
+    HoneywellMultipartCursor cursor = { 0, 0 };
+    size_t chunkLength;
+    const uint8_t * chunk;
+    while ((chunk = HoneywellMultipartNextChunk(body, &cursor, maxLength, &chunkLength)) != NULL) {
+        HONEYWELL_CHECK(chunkLength > 0 && chunkLength <= maxLength);
+        size_t written = chunkLength < step ? chunkLength : step;
+        if (*length + written > capacity) {
+            HONEYWELL_CHECK(!"body longer than its Content-Length");
+            break;
+        }
+        memcpy(bytes + *length, chunk, written);
+        *length += written;
+        if (file != NULL && chunk >= file && chunk < file + fileLength) {
+            *fromFile += written;
+        }
+        HoneywellMultipartAdvance(body, &cursor, written);
+    }
+    return bytes;
+}
+
+static size_t formatPart(char * out, size_t capacity, const char * filename)
+{
+    return (size_t)snprintf(out, capacity, "\r\n--%s\r\n"
+                            "Content-Disposition: form-data; name=\"file\"; filename=\"%s\"\r\n"
+                            "Content-Type: application/octet-stream\r\n\r\n", kBoundary, filename);
+}
+
+#pragma mark - body
+
+static void testBodyLayout(void)
+{
+    static const uint8_t file[] = { 'P', 'C', 'X', 0, 0xff, '\r', '\n', '-', '-', 1, 2 };
+    HoneywellMultipart * body = HoneywellMultipartCreate(kBoundary);
+    HONEYWELL_CHECK(body != NULL);
+    if (body == NULL) {
+        return;
+    }
+    HONEYWELL_CHECK(HoneywellMultipartAppendFile(body, "file", "LOGO.PCX", file, sizeof(file)) == 0);
+    
+    /* the layout uploadImage always sent, closing delimiter without -- included */
+    char expected[512];
+    size_t expectedLength = formatPart(expected, sizeof(expected), "LOGO.PCX");
+    memcpy(expected + expectedLength, file, sizeof(file));
+    expectedLength += sizeof(file);
+    expectedLength += (size_t)snprintf(expected + expectedLength, sizeof(expected) - expectedLength, "\r\n--%s\r\n", kBoundary);
+    HONEYWELL_CHECK(HoneywellMultipartContentLength(body) == expectedLength);
+    
+    size_t steps[] = { 1, 3, BODY_CHUNK_LENGTH };
+    for (size_t i = 0; i < sizeof(steps) / sizeof(steps[0]); i++) {
+        size_t length;
+        size_t fromFile;
+        uint8_t * bytes = collectBody(body, 7, steps[i], &length, file, sizeof(file), &fromFile);
+        HONEYWELL_CHECK(bytes != NULL && length == expectedLength && memcmp(bytes, expected, expectedLength) == 0);
+        // every file byte came straight from the caller's buffer
+        HONEYWELL_CHECK(fromFile == sizeof(file));
+        free(bytes);
+    }
+    
+    /* past the end there is nothing more */
+    HoneywellMultipartCursor cursor = { 0, 0 };
+    HoneywellMultipartAdvance(body, &cursor, expectedLength + 100);
+    size_t chunkLength = 1;
+    HONEYWELL_CHECK(HoneywellMultipartNextChunk(body, &cursor, 7, &chunkLength) == NULL && chunkLength == 0);
+    
+    HoneywellMultipartDestroy(body);
+}
+
+static void testMappedFile(const char * directory)
+{
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/1bitleaf", directory);
+    size_t fileLength = 0;
+    uint8_t * file = HoneywellTestReadFile(path, &fileLength);
+    HONEYWELL_CHECK(file != NULL);
+    
+    HoneywellMultipart * body = HoneywellMultipartCreate(kBoundary);
+    HONEYWELL_CHECK(body != NULL);
+    if (file == NULL || body == NULL) {
+        free(file);
+        HoneywellMultipartDestroy(body);
+        return;
+    }
+    
+    /* a file that can not be read adds nothing */
+    uint64_t emptyLength = HoneywellMultipartContentLength(body);
+    HONEYWELL_CHECK(HoneywellMultipartAppendFileAtPath(body, "file", "MISSING", "/nonexistent/1bitleaf") == -1);
+    HONEYWELL_CHECK(HoneywellMultipartAppendFileAtPath(body, "file", "DIRECTORY", directory) == -1);
+    HONEYWELL_CHECK(HoneywellMultipartContentLength(body) == emptyLength);
+    
+    HONEYWELL_CHECK(HoneywellMultipartAppendFileAtPath(body, "file", "1bitleaf", path) == 0);
+    
+    char head[512];
+    size_t headLength = formatPart(head, sizeof(head), "1bitleaf");
+    HONEYWELL_CHECK(HoneywellMultipartContentLength(body) == emptyLength + headLength + fileLength);
+    
+    size_t length;
+    size_t fromFile;
+    uint8_t * bytes = collectBody(body, BODY_CHUNK_LENGTH, BODY_CHUNK_LENGTH, &length, NULL, 0, &fromFile);
+    HONEYWELL_CHECK(bytes != NULL && length == HoneywellMultipartContentLength(body));
+    HONEYWELL_CHECK(bytes != NULL && memcmp(bytes, head, headLength) == 0 && memcmp(bytes + headLength, file, fileLength) == 0);
+    free(bytes);
+    HoneywellMultipartDestroy(body);
+    free(file);
+    
+    /* an empty file can not be mapped but is still a part */
+    char emptyPath[] = "/tmp/HoneywellMultipartTests.XXXXXX";
+    int fd = mkstemp(emptyPath);
+    HONEYWELL_CHECK(fd >= 0);
+    if (fd >= 0) {
+        close(fd);
+        body = HoneywellMultipartCreate(kBoundary);
+        HONEYWELL_CHECK(body != NULL && HoneywellMultipartAppendFileAtPath(body, "file", "EMPTY", emptyPath) == 0);
+        HONEYWELL_CHECK(body != NULL && HoneywellMultipartContentLength(body) == emptyLength + formatPart(head, sizeof(head), "EMPTY"));
+        HoneywellMultipartDestroy(body);
+        unlink(emptyPath);
+    }
+}
+
+#pragma mark - upload
+
+/* a small send buffer so the body goes out in many short writes */
+static int connectToStandIn(HoneywellManageStandIn * standIn)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    int sendBuffer = 4096;
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sendBuffer, sizeof(sendBuffer));
+    
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons((uint16_t)HoneywellManageStandInPort(standIn));
+    if (connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int sendAll(int fd, const void * bytes, size_t length)
+{
+    size_t offset = 0;
+    while (offset < length) {
+        ssize_t written = send(fd, (const uint8_t *)bytes + offset, length - offset, MSG_NOSIGNAL);
+        if (written <= 0) {
+            return -1;
+        }
+        offset += (size_t)written;
+    }
+    return 0;
+}
+
+/* reads the answer until the stand-in closes, returns its status or -1 */
+static int readResponse(int fd, char * page, size_t capacity)
+{
+    char response[4096];
+    size_t length = 0;
+    ssize_t received;
+    while (length < sizeof(response) - 1 && (received = recv(fd, response + length, sizeof(response) - 1 - length, 0)) > 0) {
+        length += (size_t)received;
+    }
+    response[length] = '\0';
+    
+    int status = -1;
+    if (sscanf(response, "HTTP/1.1 %d", &status) != 1) {
+        return -1;
+    }
+    const char * pageStart = strstr(response, "\r\n\r\n");
+    snprintf(page, capacity, "%s", pageStart != NULL ? pageStart + 4 : "");
+    return status;
+}
+
+/* the request uploadImageNamed: makes, the body written the way the
+   producer writes it, chunk by chunk from where the bytes lie */
+static int postBody(HoneywellManageStandIn * standIn, const HoneywellMultipart * body, char * page, size_t capacity)
+{
+    int fd = connectToStandIn(standIn);
+    if (fd < 0) {
+        return -1;
+    }
+    char head[512];
+    int headLength = snprintf(head, sizeof(head), "POST /manage/upload.lp?type=image HTTP/1.1\r\n"
+                              "Host: 127.0.0.1\r\n"
+                              "Content-Type: multipart/form-data; boundary=%s\r\n"
+                              "Content-Length: %llu\r\n"
+                              "Connection: close\r\n\r\n", kBoundary, (unsigned long long)HoneywellMultipartContentLength(body));
+    int failed = sendAll(fd, head, (size_t)headLength);
+    
+    HoneywellMultipartCursor cursor = { 0, 0 };
+    size_t chunkLength;
+    const uint8_t * chunk;
+    while (!failed && (chunk = HoneywellMultipartNextChunk(body, &cursor, BODY_CHUNK_LENGTH, &chunkLength)) != NULL) {
+        ssize_t written = send(fd, chunk, chunkLength, MSG_NOSIGNAL);
+        if (written <= 0) {
+            failed = 1;
+            break;
+        }
+        HoneywellMultipartAdvance(body, &cursor, (size_t)written);
+    }
+    
+    int status = failed ? -1 : readResponse(fd, page, capacity);
+    close(fd);
+    return status;
+}
+
+static int get(HoneywellManageStandIn * standIn, const char * target)
+{
+    int fd = connectToStandIn(standIn);
+    if (fd < 0) {
+        return -1;
+    }
+    char head[512];
+    int headLength = snprintf(head, sizeof(head), "GET %s HTTP/1.1\r\nHost: 127.0.0.1\r\nConnection: close\r\n\r\n", target);
+    char page[1024];
+    int status = sendAll(fd, head, (size_t)headLength) == 0 ? readResponse(fd, page, sizeof(page)) : -1;
+    close(fd);
+    return status;
+}
+
+/* what getRedirectURIFromHTMLString: takes, from url= to the tag's end before </head> */
+static int redirectURI(const char * page, char * uri, size_t capacity)
+{
+    const char * start = strstr(page, "url=");
+    const char * end = strstr(page, "</head>");
+    if (start == NULL || end == NULL || end - (start + 4) < 5) {
+        return -1;
+    }
+    start += 4;
+    snprintf(uri, capacity, "%.*s", (int)(end - start - 5), start);
+    return 0;
+}
+
+static void checkLastUpload(HoneywellManageStandIn * standIn, size_t index, uint64_t contentLength)
+{
+    HoneywellManageRequest request;
+    HONEYWELL_CHECK(HoneywellManageStandInRequestAt(standIn, index, &request) == 0);
+    HONEYWELL_CHECK(strcmp(request.method, "POST") == 0 && request.status == 200);
+    HONEYWELL_CHECK(request.contentLength >= 0 && (uint64_t)request.contentLength == contentLength);
+    HONEYWELL_CHECK(request.bodyLength == contentLength);
+}
+
+/* uploads name and follows the redirect like the app, then checks the stored file */
+static void uploadAndCheck(HoneywellManageStandIn * standIn, HoneywellMultipart * body, const char * name, const uint8_t * file, size_t fileLength)
+{
+    size_t requestIndex = HoneywellManageStandInRequestCount(standIn);
+    char page[1024];
+    HONEYWELL_CHECK(postBody(standIn, body, page, sizeof(page)) == 200);
+    checkLastUpload(standIn, requestIndex, HoneywellMultipartContentLength(body));
+    
+    char uri[256];
+    char target[300];
+    HONEYWELL_CHECK(redirectURI(page, uri, sizeof(uri)) == 0);
+    snprintf(target, sizeof(target), "/manage/%s", uri);
+    HONEYWELL_CHECK(get(standIn, target) == 200);
+    
+    size_t storedLength = 0;
+    uint8_t * stored = HoneywellManageStandInStoredFile(standIn, name, &storedLength);
+    HONEYWELL_CHECK(stored != NULL && storedLength == fileLength && memcmp(stored, file, fileLength) == 0);
+    free(stored);
+}
+
+static void testUpload(const char * directory)
+{
+    HoneywellManageStandIn * standIn = HoneywellManageStandInStart();
+    HONEYWELL_CHECK(standIn != NULL);
+    if (standIn == NULL) {
+        return;
+    }
+    
+    /* the logo mapped from disk */
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/1bitleaf", directory);
+    size_t fileLength = 0;
+    uint8_t * file = HoneywellTestReadFile(path, &fileLength);
+    HoneywellMultipart * body = HoneywellMultipartCreate(kBoundary);
+    HONEYWELL_CHECK(file != NULL && body != NULL && HoneywellMultipartAppendFileAtPath(body, "file", "1bitleaf", path) == 0);
+    if (file != NULL && body != NULL) {
+        uploadAndCheck(standIn, body, "1bitleaf", file, fileLength);
+        
+        // it arrived in pieces, never as one buffer
+        HoneywellManageRequest request;
+        HoneywellManageStandInRequestAt(standIn, HoneywellManageStandInRequestCount(standIn) - 2, &request);
+        HONEYWELL_CHECK(request.largestRead < fileLength);
+        
+        /* the same body can be sent again, e.g. after a failed attempt */
+        uploadAndCheck(standIn, body, "1bitleaf", file, fileLength);
+    }
+    HoneywellMultipartDestroy(body);
+    free(file);
+    
+    /* a photo sized buffer in memory */
+    fileLength = 3 * 1024 * 1024 + 17;
+    file = malloc(fileLength);
+    body = HoneywellMultipartCreate(kBoundary);
+    HONEYWELL_CHECK(file != NULL && body != NULL);
+    if (file != NULL && body != NULL) {
+        uint32_t state = 1;
+        for (size_t i = 0; i < fileLength; i++) {
+            state = state * 1664525u + 1013904223u;
+            file[i] = (uint8_t)(state >> 24);
+        }
+        /* a delimiter one character short, and one without its CRLF */
+        char lookalike[64];
+        int lookalikeLength = snprintf(lookalike, sizeof(lookalike), "\r\n--%s", kBoundary);
+        memcpy(file + 1000, lookalike, (size_t)lookalikeLength - 1);
+        memcpy(file + 5000, lookalike + 2, (size_t)lookalikeLength - 2);
+        file[4998] = 'x';
+        
+        HONEYWELL_CHECK(HoneywellMultipartAppendFile(body, "file", "PHOTO.PCX", file, fileLength) == 0);
+        uploadAndCheck(standIn, body, "PHOTO.PCX", file, fileLength);
+    }
+    HoneywellMultipartDestroy(body);
+    free(file);
+    
+    HoneywellManageStandInStop(standIn);
+}
+
+/* the stand-in has to refuse what the printer refuses, or the upload test proves nothing */
+static void testStandInIsStrict(void)
+{
+    HoneywellManageStandIn * standIn = HoneywellManageStandInStart();
+    HONEYWELL_CHECK(standIn != NULL);
+    if (standIn == NULL) {
+        return;
+    }
+    
+    char page[1024];
+    int fd = connectToStandIn(standIn);
+    static const char noLength[] = "POST /manage/upload.lp?type=image HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n";
+    HONEYWELL_CHECK(fd >= 0 && sendAll(fd, noLength, sizeof(noLength) - 1) == 0);
+    HONEYWELL_CHECK(readResponse(fd, page, sizeof(page)) == 411);
+    close(fd);
+    
+    /* a body shorter than its Content-Length */
+    fd = connectToStandIn(standIn);
+    char head[512];
+    int headLength = snprintf(head, sizeof(head), "POST /manage/upload.lp?type=image HTTP/1.1\r\n"
+                              "Content-Type: multipart/form-data; boundary=%s\r\nContent-Length: 1000\r\n\r\n"
+                              "\r\n--%s\r\n", kBoundary, kBoundary);
+    HONEYWELL_CHECK(fd >= 0 && sendAll(fd, head, (size_t)headLength) == 0);
+    shutdown(fd, SHUT_WR);
+    HONEYWELL_CHECK(readResponse(fd, page, sizeof(page)) == 400);
+    close(fd);
+    
+    HoneywellManageRequest request;
+    HONEYWELL_CHECK(HoneywellManageStandInRequestAt(standIn, 1, &request) == 0);
+    HONEYWELL_CHECK(request.contentLength == 1000 && request.bodyLength < 1000);
+    
+    HONEYWELL_CHECK(get(standIn, "/manage/upload_done.lp?file=NEVER") == 404);
+    HoneywellManageStandInStop(standIn);
+}
+
+int main(int argc, char * argv[])
+{
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <directory with 1bitleaf and puzzle>\n", argv[0]);
+        return 2;
+    }
+    
+    testBodyLayout();
+    testMappedFile(argv[1]);
+    testUpload(argv[1]);
+    testStandInIsStrict();
+    
+    return HONEYWELL_TEST_RESULT;
+}
@@ -0,0 +1,206 @@
+//
+//  HoneywellPrintDaemonTests.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+/*
+
+ Runs honeywellprintd against HoneywellSimulatedPrinter and checks that a
+ client's request comes out of the printer as labels and is answered once
+ they are acknowledged.
+
+    HoneywellPrintDaemonTests <path to honeywellprintd>
+
+ */
+
+/* POSIX processes and sockets under -std=c11 on Linux */
+#define _POSIX_C_SOURCE 200809L
+
+#include "HoneywellSimulatedPrinter.h"
+#include "HoneywellTest.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/* reads one line without its terminator, returns -1 if none arrives in time */
+static int readLine(int fd, char * line, size_t capacity, int timeoutMilliseconds)
+{
+    size_t length = 0;
+    while (length < capacity - 1) {
+        
+        struct pollfd entry = { fd, POLLIN, 0 };
+        if (poll(&entry, 1, timeoutMilliseconds) <= 0) {
+            return -1;
+        }
+        
+        char c;
+        ssize_t count = read(fd, &c, 1);
+        if (count <= 0) {
+            return -1;
+        }
+        if (c == '\n') {
+            break;
+        }
+        line[length++] = c;
+    }
+    line[length] = '\0';
+    return 0;
+}
+
+static pid_t startDaemon(const char * path, int * port)
+{
+    int output[2];
+    if (pipe(output) != 0) {
+        return -1;
+    }
+    
+    pid_t pid = fork();
+    if (pid == 0) {
+        dup2(output[1], STDOUT_FILENO);
+        close(output[0]);
+        close(output[1]);
+        execl(path, path, "-p", "0", (char *)NULL);
+        _exit(127);
+    }
+    close(output[1]);
+    
+    /* the daemon prints its port once it is listening */
+    char line[32];
+    int ready = (pid > 0 && readLine(output[0], line, sizeof(line), 5000) == 0);
+    close(output[0]);
+    if (!ready) {
+        return -1;
+    }
+    *port = atoi(line);
+    return pid;
+}
+
+static int connectToPort(int port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons((uint16_t)port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    
+    if (fd >= 0 && connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void sendText(int fd, const char * text)
+{
+    size_t length = strlen(text);
+    size_t offset = 0;
+    while (offset < length) {
+        ssize_t written = write(fd, text + offset, length - offset);
+        if (written <= 0) {
+            return;
+        }
+        offset += written;
+    }
+}
+
+static void testMalformedRequests(int client)
+{
+    char reply[256];
+    
+    sendText(client, "not json\n");
+    HONEYWELL_CHECK(readLine(client, reply, sizeof(reply), 5000) == 0);
+    HONEYWELL_CHECK(strcmp(reply, "{\"error\":\"invalid JSON\"}") == 0);
+    
+    sendText(client, "{\"id\":\"a\",\"records\":[]}\n");
+    HONEYWELL_CHECK(readLine(client, reply, sizeof(reply), 5000) == 0);
+    HONEYWELL_CHECK(strcmp(reply, "{\"id\":\"a\",\"error\":\"printer and records are required\"}") == 0);
+    
+    sendText(client, "{\"id\":3,\"printer\":\"127.0.0.1\",\"records\":[1]}\n");
+    HONEYWELL_CHECK(readLine(client, reply, sizeof(reply), 5000) == 0);
+    HONEYWELL_CHECK(strcmp(reply, "{\"id\":3,\"error\":\"records must be objects\"}") == 0);
+    
+    sendText(client, "{\"id\":4,\"printer\":\"127.0.0.1\",\"priority\":3,\"records\":[]}\n");
+    HONEYWELL_CHECK(readLine(client, reply, sizeof(reply), 5000) == 0);
+    HONEYWELL_CHECK(strcmp(reply, "{\"id\":4,\"error\":\"priority must be 0, 1 or 2\"}") == 0);
+}
+
+static void testRequestPrints(int client, HoneywellSimulatedPrinter * printer)
+{
+    char request[1024];
+    snprintf(request, sizeof(request),
+             "{\"id\":7,\"printer\":\"127.0.0.1\",\"port\":%d,\"template\":0,\"priority\":2,\"records\":["
+             "{\"itemPrice\":\"RM1.20\",\"itemDescription\":\"Kopi O\",\"barcodeTypeCode\":2,\"barcodeInput\":\"9556001234567\",\"image\":\"1bitleaf\"},"
+             "{\"itemPrice\":\"RM1.20\",\"itemDescription\":\"Kopi O\",\"barcodeTypeCode\":2,\"barcodeInput\":\"9556001234567\",\"image\":\"1bitleaf\"},"
+             "{\"itemPrice\":\"RM2.50\",\"itemDescription\":\"Caf\\u00e9 | ais\",\"barcodeTypeCode\":2,\"barcodeInput\":\"9556001234574\"}"
+             "]}\n",
+             HoneywellSimulatedPrinterPort(printer));
+    sendText(client, request);
+    
+    char reply[256];
+    HONEYWELL_CHECK(readLine(client, reply, sizeof(reply), 20000) == 0);
+    HONEYWELL_CHECK(strcmp(reply, "{\"id\":7,\"sent\":true}") == 0);
+    
+    /* identical neighbours print as one label with copies */
+    HONEYWELL_CHECK(HoneywellSimulatedPrinterLabelCount(printer) == 2);
+    
+    HoneywellSimulatedLabel label;
+    HONEYWELL_CHECK(HoneywellSimulatedPrinterLabelAt(printer, 0, &label) == 0);
+    HONEYWELL_CHECK(label.copies == 2);
+    HONEYWELL_CHECK(label.jobID != 0);
+    HONEYWELL_CHECK(strcmp(label.content, "#1BITLEAF|EAN13|70|3|9556001234567|Kopi O|RM1.20@") == 0);
+    
+    /* a field separator can not go into a LAYOUT RUN record, the label is sent inline */
+    HONEYWELL_CHECK(HoneywellSimulatedPrinterLabelAt(printer, 1, &label) == 0);
+    HONEYWELL_CHECK(label.copies == 1);
+    HONEYWELL_CHECK(strstr(label.content, "PT \"RM2.50\"") != NULL);
+    HONEYWELL_CHECK(strstr(label.content, "\"Caf? | ais\"") != NULL);
+    
+    /* the record names no image, the label shows the default one as in the app */
+    HONEYWELL_CHECK(strstr(label.content, "PM \"1BITLEAF\"") != NULL);
+}
+
+int main(int argc, char * argv[])
+{
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <path to honeywellprintd>\n", argv[0]);
+        return 2;
+    }
+    signal(SIGPIPE, SIG_IGN);
+    
+    HoneywellSimulatedPrinter * printer = HoneywellSimulatedPrinterStart();
+    HONEYWELL_CHECK(printer != NULL);
+    
+    int port = 0;
+    pid_t daemon = startDaemon(argv[1], &port);
+    HONEYWELL_CHECK(daemon > 0);
+    
+    int client = (printer != NULL && daemon > 0) ? connectToPort(port) : -1;
+    HONEYWELL_CHECK(client >= 0);
+    
+    if (client >= 0) {
+        testMalformedRequests(client);
+        testRequestPrints(client, printer);
+        close(client);
+    }
+    
+    if (daemon > 0) {
+        int status = 0;
+        kill(daemon, SIGTERM);
+        waitpid(daemon, &status, 0);
+        HONEYWELL_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+    HoneywellSimulatedPrinterStop(printer);
+    
+    return HONEYWELL_TEST_RESULT;
+}
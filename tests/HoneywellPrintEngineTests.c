@@ -0,0 +1,314 @@
+//
+//  HoneywellPrintEngineTests.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+/*
+
+ Drives HoneywellPrintEngine against a HoneywellSimulatedPrinter that keeps
+ dropping the connection, and checks that every label prints: none lost to
+ a drop and none confirmed before the printer printed it. A label prints
+ again after a reconnect only when the drop fell between its PF and its
+ ACK, the one case the engine can not tell from a label that never printed,
+ so every label is acknowledged exactly once and printed at least once.
+
+ */
+
+/* POSIX clocks and sockets under -std=c11 on Linux */
+#define _POSIX_C_SOURCE 200809L
+
+#include "HoneywellPrintEngine.h"
+#include "HoneywellSimulatedPrinter.h"
+#include "HoneywellTest.h"
+#include <poll.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* enough labels for a dozen or so drops at the rate below */
+#define LABEL_COUNT 240
+#define DROP_RATE 0.02
+
+/* a run that has not finished by then is a failure, not a slow machine */
+static const double kRunTimeout = 40.0;
+
+typedef struct {
+    uint64_t jobID;
+    unsigned copies;
+    int finishedCount;
+    int printed;
+    // the printer had printed the label when the engine confirmed it
+    int printedBeforeConfirmed;
+} TestJob;
+
+typedef struct {
+    HoneywellSimulatedPrinter * printer;
+    size_t finishedCount;
+} TestContext;
+
+static double monotonicTime(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/* the job a printed label is for, from its #LABEL n@ record, 0 if none */
+static uint64_t printedJobID(const HoneywellSimulatedLabel * label)
+{
+    unsigned long long jobID = 0;
+    if (sscanf(label->content, "#LABEL %llu@", &jobID) != 1) {
+        return 0;
+    }
+    return jobID;
+}
+
+static int printerHasPrinted(HoneywellSimulatedPrinter * printer, uint64_t jobID)
+{
+    size_t count = HoneywellSimulatedPrinterLabelCount(printer);
+    HoneywellSimulatedLabel label;
+    for (size_t i = 0; i < count; i++) {
+        if (HoneywellSimulatedPrinterLabelAt(printer, i, &label) == 0 && printedJobID(&label) == jobID) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+#pragma mark - callbacks
+
+static void engineConnected(void * context, HoneywellByteBuffer * commands)
+{
+    (void)context;
+    HoneywellByteBufferAppendString(commands, "SYSVAR(18)=-1 \r\n");
+}
+
+static void engineDisconnected(void * context, int fd)
+{
+    (void)context;
+    (void)fd;
+}
+
+static HoneywellEncodeResult engineEncodeLabel(void * context, void * job, HoneywellByteBuffer * commands)
+{
+    (void)context;
+    TestJob * label = job;
+    
+    char text[64];
+    snprintf(text, sizeof(text), "#LABEL %llu@\r\nPF %u\r\n", (unsigned long long)label->jobID, label->copies);
+    HoneywellByteBufferAppendString(commands, text);
+    return HONEYWELL_ENCODE_OK;
+}
+
+static void engineLabelWritten(void * context, void * job)
+{
+    (void)context;
+    (void)job;
+}
+
+static void engineLabelFinished(void * context, void * job, int printed)
+{
+    TestContext * test = context;
+    TestJob * label = job;
+    
+    label->finishedCount++;
+    label->printed = printed;
+    label->printedBeforeConfirmed = printerHasPrinted(test->printer, label->jobID);
+    test->finishedCount++;
+}
+
+static int engineTextLine(void * context, const char * line, size_t length)
+{
+    (void)context;
+    fprintf(stderr, "Unexpected printer line: %.*s\n", (int)length, line);
+    return 0;
+}
+
+#pragma mark - tests
+
+/* submits LABEL_COUNT labels, spread over priority lanes if lanes > 1, and
+   runs the engine until every one finished or the run times out */
+static void runLabels(TestJob * jobs, HoneywellSimulatedPrinter * printer, size_t lanes, const HoneywellPrintEngineOptions * options)
+{
+    TestContext test = { printer, 0 };
+    HoneywellPrintEngineCallbacks callbacks = {
+        &test,
+        engineConnected,
+        engineDisconnected,
+        engineEncodeLabel,
+        engineLabelWritten,
+        engineLabelFinished,
+        engineTextLine,
+        NULL
+    };
+    HoneywellPrintEngine * engine = HoneywellPrintEngineCreate(&callbacks, options);
+    HONEYWELL_CHECK(engine != NULL);
+    if (engine == NULL) {
+        return;
+    }
+    
+    for (size_t i = 0; i < LABEL_COUNT; i++) {
+        jobs[i].jobID = i + 1;
+        jobs[i].copies = 1 + i % 3;
+        HONEYWELL_CHECK(HoneywellPrintEngineSubmit(engine, &jobs[i], jobs[i].jobID, (int)(i % lanes), jobs[i].copies) == 0);
+    }
+    HoneywellPrintEngineConnect(engine, "127.0.0.1", HoneywellSimulatedPrinterPort(printer));
+    
+    double deadline = monotonicTime() + kRunTimeout;
+    while (test.finishedCount < LABEL_COUNT && monotonicTime() < deadline) {
+        
+        struct pollfd entry = { HoneywellPrintEngineFileDescriptor(engine), HoneywellPrintEnginePollEvents(engine), 0 };
+        double timeout = HoneywellPrintEngineTimeout(engine);
+        int milliseconds = (timeout < 0 || timeout > 0.1) ? 100 : (int)(timeout * 1000) + 1;
+        
+        if (poll(&entry, entry.fd >= 0 ? 1 : 0, milliseconds) < 0) {
+            entry.revents = 0;
+        }
+        HoneywellPrintEngineHandleEvents(engine, entry.fd >= 0 ? entry.revents : 0);
+    }
+    
+    HONEYWELL_CHECK(test.finishedCount == LABEL_COUNT);
+    HONEYWELL_CHECK(HoneywellPrintEngineJobCount(engine) == 0);
+    HoneywellPrintEngineDestroy(engine);
+}
+
+/* every job finished once as printed and the printer printed each at least
+   once, acknowledged once. Returns how many labels printed again. */
+static size_t checkEveryLabelPrinted(TestJob * jobs, HoneywellSimulatedPrinter * printer)
+{
+    for (size_t i = 0; i < LABEL_COUNT; i++) {
+        HONEYWELL_CHECK(jobs[i].finishedCount == 1);
+        HONEYWELL_CHECK(jobs[i].printed);
+        HONEYWELL_CHECK(jobs[i].printedBeforeConfirmed);
+    }
+    
+    int printCounts[LABEL_COUNT + 1] = { 0 };
+    int acknowledgedCounts[LABEL_COUNT + 1] = { 0 };
+    size_t count = HoneywellSimulatedPrinterLabelCount(printer);
+    HONEYWELL_CHECK(count >= LABEL_COUNT);
+    
+    for (size_t i = 0; i < count; i++) {
+        HoneywellSimulatedLabel label;
+        HONEYWELL_CHECK(HoneywellSimulatedPrinterLabelAt(printer, i, &label) == 0);
+        uint64_t jobID = printedJobID(&label);
+        HONEYWELL_CHECK(jobID >= 1 && jobID <= LABEL_COUNT);
+        if (jobID < 1 || jobID > LABEL_COUNT) {
+            continue;
+        }
+        printCounts[jobID]++;
+        
+        /* a print the printer acknowledged names its own label, one whose ACK
+           was lost to a drop names none */
+        HONEYWELL_CHECK(label.jobID == jobID || label.jobID == 0);
+        if (label.jobID == jobID) {
+            acknowledgedCounts[jobID]++;
+        }
+        HONEYWELL_CHECK(label.copies == jobs[jobID - 1].copies);
+    }
+    
+    size_t reprints = 0;
+    for (size_t jobID = 1; jobID <= LABEL_COUNT; jobID++) {
+        HONEYWELL_CHECK(printCounts[jobID] >= 1);
+        HONEYWELL_CHECK(acknowledgedCounts[jobID] == 1);
+        reprints += printCounts[jobID] > 1 ? printCounts[jobID] - 1 : 0;
+    }
+    
+    /* each drop loses at most the one ACK it fell in front of */
+    HONEYWELL_CHECK(reprints <= HoneywellSimulatedPrinterDropCount(printer));
+    return reprints;
+}
+
+static void testDropsLoseNoLabels(void)
+{
+    HoneywellSimulatedPrinter * printer = HoneywellSimulatedPrinterStart();
+    HONEYWELL_CHECK(printer != NULL);
+    if (printer == NULL) {
+        return;
+    }
+    HoneywellSimulatedPrinterSetDropRate(printer, DROP_RATE, 0x5EED0009);
+    
+    static TestJob jobs[LABEL_COUNT];
+    memset(jobs, 0, sizeof(jobs));
+    runLabels(jobs, printer, 1, NULL);
+    
+    /* the seed drops some connections between a PF and its ACK */
+    HONEYWELL_CHECK(checkEveryLabelPrinted(jobs, printer) > 0);
+    
+    /* one lane resumes at the first unconfirmed label, so print order is
+       submit order, with a label printed again right after itself */
+    uint64_t previous = 0;
+    for (size_t i = 0; i < HoneywellSimulatedPrinterLabelCount(printer); i++) {
+        HoneywellSimulatedLabel label;
+        HoneywellSimulatedPrinterLabelAt(printer, i, &label);
+        HONEYWELL_CHECK(printedJobID(&label) >= previous);
+        previous = printedJobID(&label);
+    }
+    
+    HONEYWELL_CHECK(HoneywellSimulatedPrinterDropCount(printer) > 0);
+    HONEYWELL_CHECK(HoneywellSimulatedPrinterConnectionCount(printer) > HoneywellSimulatedPrinterDropCount(printer));
+    HoneywellSimulatedPrinterStop(printer);
+}
+
+/* lanes and a deeper pipeline requeue labels out of job ID order, ACKs still confirm by position */
+static void testDropsAcrossLanesLoseNoLabels(void)
+{
+    HoneywellSimulatedPrinter * printer = HoneywellSimulatedPrinterStart();
+    HONEYWELL_CHECK(printer != NULL);
+    if (printer == NULL) {
+        return;
+    }
+    HoneywellSimulatedPrinterSetDropRate(printer, DROP_RATE, 0x5EED0014);
+    
+    HoneywellPrintEngineOptions options;
+    HoneywellPrintEngineDefaultOptions(&options);
+    options.maxLabelsInFlight = 6;
+    
+    static TestJob jobs[LABEL_COUNT];
+    memset(jobs, 0, sizeof(jobs));
+    runLabels(jobs, printer, HONEYWELL_PRINT_ENGINE_LANE_COUNT, &options);
+    checkEveryLabelPrinted(jobs, printer);
+    
+    HONEYWELL_CHECK(HoneywellSimulatedPrinterDropCount(printer) > 0);
+    HoneywellSimulatedPrinterStop(printer);
+}
+
+/* water marks below one chunk of labels hold encoding after every chunk, a
+   drop that empties the queue must not leave it held */
+static void testSmallWriteQueueNeitherStallsNorLosesLabels(void)
+{
+    HoneywellSimulatedPrinter * printer = HoneywellSimulatedPrinterStart();
+    HONEYWELL_CHECK(printer != NULL);
+    if (printer == NULL) {
+        return;
+    }
+    HoneywellSimulatedPrinterSetDropRate(printer, DROP_RATE, 0x5EED0004);
+    
+    HoneywellPrintEngineOptions options;
+    HoneywellPrintEngineDefaultOptions(&options);
+    options.maxLabelsInFlight = 6;
+    options.writeQueueHighWaterMark = 48;
+    options.writeQueueLowWaterMark = 16;
+    
+    static TestJob jobs[LABEL_COUNT];
+    memset(jobs, 0, sizeof(jobs));
+    runLabels(jobs, printer, 1, &options);
+    checkEveryLabelPrinted(jobs, printer);
+    
+    HONEYWELL_CHECK(HoneywellSimulatedPrinterDropCount(printer) > 0);
+    HoneywellSimulatedPrinterStop(printer);
+}
+
+int main(void)
+{
+    signal(SIGPIPE, SIG_IGN);
+    
+    testDropsLoseNoLabels();
+    testDropsAcrossLanesLoseNoLabels();
+    testSmallWriteQueueNeitherStallsNorLosesLabels();
+    
+    return HONEYWELL_TEST_RESULT;
+}
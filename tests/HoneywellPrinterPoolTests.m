@@ -0,0 +1,263 @@
+//
+//  HoneywellPrinterPoolTests.m
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+/*
+
+ Drives label batches through HoneywellMockPrinterBackend, on its own and
+ behind a HoneywellPrinterPool: flushes, copies, every label printed exactly
+ once across the printers, failed labels rerouted, affinity rules, and the
+ completion a batch reports. Needs only Foundation and libdispatch.
+
+ */
+
+#import <Foundation/Foundation.h>
+#import "HoneywellMockPrinterBackend.h"
+#import "HoneywellPrintJob.h"
+#import "HoneywellPrinterPool.h"
+#include "HoneywellTest.h"
+
+/* seconds a batch may take before the test gives up on it */
+static const NSTimeInterval kBatchTimeout = 20.0;
+
+/* completions arrive on the main queue, so the main run loop has to turn */
+static int waitForCompletion(const int * result)
+{
+    NSDate * deadline = [NSDate dateWithTimeIntervalSinceNow:kBatchTimeout];
+    while (*result < 0 && deadline.timeIntervalSinceNow > 0) {
+        [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+    }
+    return *result;
+}
+
+/* distinct records, so none of them are collapsed into copies */
+static NSArray * makeRecords(NSUInteger count, NSString * name)
+{
+    NSMutableArray * records = [[NSMutableArray alloc] initWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        [records addObject:@{ @"Name" : name, @"PLU" : [NSString stringWithFormat:@"%05lu", (unsigned long)i] }];
+    }
+    return records;
+}
+
+/* every label the printers printed, a job counts once per copy */
+static NSCountedSet * printedLabels(NSArray * printers)
+{
+    NSCountedSet * labels = [[NSCountedSet alloc] init];
+    for (HoneywellMockPrinterBackend * printer in printers) {
+        for (HoneywellPrintJob * job in printer.printedJobs) {
+            for (NSUInteger copy = 0; copy < job.copies; copy++) {
+                [labels addObject:job.record];
+            }
+        }
+    }
+    return labels;
+}
+
+static void checkPrintedExactlyOnce(NSArray * records, NSArray * printers)
+{
+    NSCountedSet * labels = printedLabels(printers);
+    HONEYWELL_CHECK(labels.count == records.count);
+    for (NSDictionary * record in records) {
+        HONEYWELL_CHECK([labels countForObject:record] == 1);
+    }
+}
+
+static int printOnPool(HoneywellPrinterPool * pool, NSArray * records, LabelTemplateType type)
+{
+    __block int result = -1;
+    [pool printBatch:records templateType:type completion:^(BOOL sent) {
+        result = sent;
+    }];
+    return waitForCompletion(&result);
+}
+
+#pragma mark - mock backend
+
+static void testMockBatchesAndConfirms(void)
+{
+    HoneywellMockPrinterBackend * printer = [[HoneywellMockPrinterBackend alloc] initWithPrinterID:@"mock"];
+    printer.labelsPerFlush = 16;
+    NSArray * records = makeRecords(40, @"Apple");
+    
+    __block int result = -1;
+    [printer printBatch:records templateType:STANDARD_PRICE_LABEL priority:PRINT_PRIORITY_NORMAL completion:^(BOOL sent) {
+        result = sent;
+    }];
+    HONEYWELL_CHECK(waitForCompletion(&result) == 1);
+    
+    /* 16 + 16 + 8, in the order they were handed over */
+    NSArray * jobs = printer.printedJobs;
+    HONEYWELL_CHECK(jobs.count == records.count);
+    HONEYWELL_CHECK(printer.flushCount == 3);
+    [jobs enumerateObjectsUsingBlock:^(HoneywellPrintJob * job, NSUInteger index, BOOL * stop) {
+        HONEYWELL_CHECK(index < records.count && [job.record isEqualToDictionary:records[index]]);
+        HONEYWELL_CHECK(job.copies == 1 && job.priority == PRINT_PRIORITY_NORMAL);
+        HONEYWELL_CHECK(job.enqueueTime > 0 && job.printTime >= job.enqueueTime);
+    }];
+    HONEYWELL_CHECK(printer.queuedByteCount == 0);
+}
+
+static void testMockPrintsNeighboursAsCopies(void)
+{
+    HoneywellMockPrinterBackend * printer = [[HoneywellMockPrinterBackend alloc] initWithPrinterID:@"mock"];
+    NSDictionary * record = @{ @"Name" : @"Pear", @"PLU" : @"00042" };
+    NSArray * records = @[record, record, record, record, record, @{ @"Name" : @"Plum", @"PLU" : @"00043" }];
+    
+    __block int result = -1;
+    [printer printBatch:records templateType:STANDARD_PRICE_LABEL priority:PRINT_PRIORITY_BULK completion:^(BOOL sent) {
+        result = sent;
+    }];
+    HONEYWELL_CHECK(waitForCompletion(&result) == 1);
+    
+    NSArray * jobs = printer.printedJobs;
+    HONEYWELL_CHECK(jobs.count == 2);
+    if (jobs.count == 2) {
+        HoneywellPrintJob * copies = jobs[0];
+        HoneywellPrintJob * single = jobs[1];
+        HONEYWELL_CHECK(copies.copies == 5 && [copies.record isEqualToDictionary:record]);
+        HONEYWELL_CHECK(single.copies == 1);
+    }
+    HONEYWELL_CHECK(printedLabels(@[printer]).count == 2);
+    HONEYWELL_CHECK([printedLabels(@[printer]) countForObject:record] == 5);
+}
+
+static void testMockReportsFailedLabels(void)
+{
+    HoneywellMockPrinterBackend * printer = [[HoneywellMockPrinterBackend alloc] initWithPrinterID:@"mock"];
+    printer.failsLabels = YES;
+    
+    __block int result = -1;
+    [printer printBatch:makeRecords(20, @"Fig") templateType:STANDARD_PRICE_LABEL priority:PRINT_PRIORITY_NORMAL completion:^(BOOL sent) {
+        result = sent;
+    }];
+    HONEYWELL_CHECK(waitForCompletion(&result) == 0);
+    HONEYWELL_CHECK(printer.printedJobs.count == 0);
+}
+
+#pragma mark - pool
+
+static void testPoolSpreadsBatchOverPrinters(void)
+{
+    HoneywellPrinterPool * pool = [[HoneywellPrinterPool alloc] init];
+    pool.chunkSize = 10;
+    HoneywellMockPrinterBackend * front = [[HoneywellMockPrinterBackend alloc] initWithPrinterID:@"front"];
+    HoneywellMockPrinterBackend * back = [[HoneywellMockPrinterBackend alloc] initWithPrinterID:@"back"];
+    [pool addBackend:front];
+    [pool addBackend:back];
+    
+    NSArray * records = makeRecords(500, @"Kiwi");
+    HONEYWELL_CHECK(printOnPool(pool, records, STANDARD_PRICE_LABEL) == 1);
+    checkPrintedExactlyOnce(records, @[front, back]);
+    
+    /* both printers had room for a chunk when the batch arrived */
+    HONEYWELL_CHECK(front.printedJobs.count > 0 && back.printedJobs.count > 0);
+    HONEYWELL_CHECK([pool outstandingLabelCountForPrinter:front] == 0);
+    HONEYWELL_CHECK([pool outstandingLabelCountForPrinter:back] == 0);
+    
+    [pool removeAllPrinters];
+}
+
+static void testPoolReroutesFailedLabels(void)
+{
+    HoneywellPrinterPool * pool = [[HoneywellPrinterPool alloc] init];
+    pool.chunkSize = 10;
+    HoneywellMockPrinterBackend * broken = [[HoneywellMockPrinterBackend alloc] initWithPrinterID:@"broken"];
+    broken.failsLabels = YES;
+    HoneywellMockPrinterBackend * working = [[HoneywellMockPrinterBackend alloc] initWithPrinterID:@"working"];
+    [pool addBackend:broken];
+    [pool addBackend:working];
+    
+    /* the first chunk goes to broken, the first printer among equals, and
+       starts with a run of copies that has to come back in full */
+    NSDictionary * repeated = @{ @"Name" : @"Lime", @"PLU" : @"99999" };
+    NSArray * distinct = makeRecords(200, @"Lime");
+    NSArray * records = [@[repeated, repeated, repeated, repeated] arrayByAddingObjectsFromArray:distinct];
+    HONEYWELL_CHECK(printOnPool(pool, records, STANDARD_PRICE_LABEL) == 1);
+    
+    NSCountedSet * labels = printedLabels(@[broken, working]);
+    HONEYWELL_CHECK(labels.count == distinct.count + 1);
+    HONEYWELL_CHECK([labels countForObject:repeated] == 4);
+    for (NSDictionary * record in distinct) {
+        HONEYWELL_CHECK([labels countForObject:record] == 1);
+    }
+    HONEYWELL_CHECK(broken.printedJobs.count == 0);
+    HONEYWELL_CHECK([pool outstandingLabelCountForPrinter:broken] == 0);
+    
+    [pool removeAllPrinters];
+}
+
+static void testPoolFailsWithNoPrinterLeft(void)
+{
+    HoneywellPrinterPool * pool = [[HoneywellPrinterPool alloc] init];
+    pool.chunkSize = 10;
+    
+    /* nothing to print is sent, nothing to print it on is not */
+    HONEYWELL_CHECK(printOnPool(pool, @[], STANDARD_PRICE_LABEL) == 1);
+    HONEYWELL_CHECK(printOnPool(pool, makeRecords(5, @"Date"), STANDARD_PRICE_LABEL) == 0);
+    
+    HoneywellMockPrinterBackend * first = [[HoneywellMockPrinterBackend alloc] initWithPrinterID:@"first"];
+    HoneywellMockPrinterBackend * second = [[HoneywellMockPrinterBackend alloc] initWithPrinterID:@"second"];
+    first.failsLabels = YES;
+    second.failsLabels = YES;
+    [pool addBackend:first];
+    [pool addBackend:second];
+    
+    /* each chunk is tried once on every printer, then the batch gives up */
+    HONEYWELL_CHECK(printOnPool(pool, makeRecords(50, @"Date"), STANDARD_PRICE_LABEL) == 0);
+    HONEYWELL_CHECK(first.printedJobs.count == 0 && second.printedJobs.count == 0);
+    
+    [pool removeAllPrinters];
+}
+
+static void testPoolKeepsTemplatesOnAllowedPrinters(void)
+{
+    HoneywellPrinterPool * pool = [[HoneywellPrinterPool alloc] init];
+    pool.chunkSize = 10;
+    HoneywellMockPrinterBackend * front = [[HoneywellMockPrinterBackend alloc] initWithPrinterID:@"front"];
+    HoneywellMockPrinterBackend * back = [[HoneywellMockPrinterBackend alloc] initWithPrinterID:@"back"];
+    [pool addBackend:front];
+    [pool addBackend:back];
+    [pool setAllowedPrinterHosts:@[@"back"] forTemplateType:FOOD_INFO_LABEL];
+    [pool setAllowedPrinterHosts:@[@"elsewhere"] forTemplateType:OTHER_LABEL];
+    
+    NSArray * food = makeRecords(200, @"Soup");
+    HONEYWELL_CHECK(printOnPool(pool, food, FOOD_INFO_LABEL) == 1);
+    checkPrintedExactlyOnce(food, @[back]);
+    HONEYWELL_CHECK(front.printedJobs.count == 0);
+    
+    /* no allowed printer in the pool, any printer takes the labels */
+    NSArray * other = makeRecords(30, @"Tray");
+    HONEYWELL_CHECK(printOnPool(pool, other, OTHER_LABEL) == 1);
+    NSCountedSet * labels = printedLabels(@[front, back]);
+    for (NSDictionary * record in other) {
+        HONEYWELL_CHECK([labels countForObject:record] == 1);
+    }
+    
+    /* the rule is lifted with an empty array */
+    [pool setAllowedPrinterHosts:@[] forTemplateType:FOOD_INFO_LABEL];
+    NSArray * more = makeRecords(200, @"Stew");
+    HONEYWELL_CHECK(printOnPool(pool, more, FOOD_INFO_LABEL) == 1);
+    HONEYWELL_CHECK(front.printedJobs.count > 0);
+    
+    [pool removeAllPrinters];
+}
+
+int main(void)
+{
+    @autoreleasepool {
+        testMockBatchesAndConfirms();
+        testMockPrintsNeighboursAsCopies();
+        testMockReportsFailedLabels();
+        
+        testPoolSpreadsBatchOverPrinters();
+        testPoolReroutesFailedLabels();
+        testPoolFailsWithNoPrinterLeft();
+        testPoolKeepsTemplatesOnAllowedPrinters();
+    }
+    return HONEYWELL_TEST_RESULT;
+}
@@ -0,0 +1,318 @@
+//
+//  HoneywellPrinterProfileTests.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+/*
+
+ Parses the command strings of printer_profiles.JSON with
+ HoneywellParseByteSequence, good ones and every way they can be wrong,
+ and writes them out with their placeholders filled. Then encodes a set of
+ profiles as the binary cache, reads it back and damages it in the header,
+ the strings, the sequences and the order, which all have to be rejected.
+
+ */
+
+#include "HoneywellPrinterProfile.h"
+#include "HoneywellTest.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    const char * text;
+    int result;
+    uint8_t length;
+    uint8_t bytes[8];
+    uint8_t placeholderCount;
+    uint8_t placeholders[4];
+} SequenceCase;
+
+static const SequenceCase kSequenceCases[] = {
+    { "[0x1b,0x77,!]", 0, 3, { 0x1b, 0x77, 0 }, 1, { 2 } },
+    { "[]", 0, 0, { 0 }, 0, { 0 } },
+    { " [ ] ", 0, 0, { 0 }, 0, { 0 } },
+    { " [ 27 , 0x21,\t255 ] ", 0, 3, { 27, 0x21, 255 }, 0, { 0 } },
+    { "[!,0x1b,!]", 0, 3, { 0, 0x1b, 0 }, 2, { 0, 2 } },
+    { "[0]", 0, 1, { 0 }, 0, { 0 } },
+    
+    { "", -1, 0, { 0 }, 0, { 0 } },
+    { "0x1b", -1, 0, { 0 }, 0, { 0 } },
+    { "[", -1, 0, { 0 }, 0, { 0 } },
+    { "[0x1b", -1, 0, { 0 }, 0, { 0 } },
+    { "[0x1b,]", -1, 0, { 0 }, 0, { 0 } },
+    { "[,0x1b]", -1, 0, { 0 }, 0, { 0 } },
+    { "[0x1b 0x77]", -1, 0, { 0 }, 0, { 0 } },
+    { "[256]", -1, 0, { 0 }, 0, { 0 } },
+    { "[-1]", -1, 0, { 0 }, 0, { 0 } },
+    { "[x]", -1, 0, { 0 }, 0, { 0 } },
+    { "[!!]", -1, 0, { 0 }, 0, { 0 } },
+    { "[0x1b]x", -1, 0, { 0 }, 0, { 0 } },
+    { "[]]", -1, 0, { 0 }, 0, { 0 } },
+};
+
+#pragma mark - byte sequences
+
+static void testSequenceTable(void)
+{
+    for (size_t i = 0; i < sizeof(kSequenceCases) / sizeof(kSequenceCases[0]); i++) {
+        const SequenceCase * test = &kSequenceCases[i];
+        HoneywellByteSequence sequence;
+        memset(&sequence, 0xa5, sizeof(sequence));
+        
+        int result = HoneywellParseByteSequence(test->text, &sequence);
+        if (result != test->result) {
+            fprintf(stderr, "\"%s\" parsed to %d, expected %d\n", test->text, result, test->result);
+        }
+        HONEYWELL_CHECK(result == test->result);
+        if (test->result != 0 || result != 0) {
+            continue;
+        }
+        
+        HONEYWELL_CHECK(sequence.length == test->length);
+        HONEYWELL_CHECK(memcmp(sequence.bytes, test->bytes, test->length) == 0);
+        HONEYWELL_CHECK(sequence.placeholderCount == test->placeholderCount);
+        HONEYWELL_CHECK(memcmp(sequence.placeholders, test->placeholders, test->placeholderCount) == 0);
+    }
+}
+
+/* the longest sequence and the most placeholders fit, one more does not */
+static void testSequenceCapacity(void)
+{
+    char text[HONEYWELL_PROFILE_SEQUENCE_CAPACITY * 5 + 8];
+    HoneywellByteSequence sequence;
+    
+    for (int count = HONEYWELL_PROFILE_SEQUENCE_CAPACITY; count <= HONEYWELL_PROFILE_SEQUENCE_CAPACITY + 1; count++) {
+        size_t length = 0;
+        text[length++] = '[';
+        for (int i = 0; i < count; i++) {
+            length += (size_t)snprintf(text + length, sizeof(text) - length, i > 0 ? ",%d" : "%d", i);
+        }
+        snprintf(text + length, sizeof(text) - length, "]");
+        
+        int result = HoneywellParseByteSequence(text, &sequence);
+        HONEYWELL_CHECK(result == (count <= HONEYWELL_PROFILE_SEQUENCE_CAPACITY ? 0 : -1));
+        if (result == 0) {
+            HONEYWELL_CHECK(sequence.length == count);
+            HONEYWELL_CHECK(sequence.bytes[count - 1] == count - 1);
+        }
+    }
+    
+    for (int count = HONEYWELL_PROFILE_PLACEHOLDER_CAPACITY; count <= HONEYWELL_PROFILE_PLACEHOLDER_CAPACITY + 1; count++) {
+        size_t length = 0;
+        text[length++] = '[';
+        for (int i = 0; i < count; i++) {
+            length += (size_t)snprintf(text + length, sizeof(text) - length, i > 0 ? ",!" : "!");
+        }
+        snprintf(text + length, sizeof(text) - length, "]");
+        
+        HONEYWELL_CHECK(HoneywellParseByteSequence(text, &sequence) == (count <= HONEYWELL_PROFILE_PLACEHOLDER_CAPACITY ? 0 : -1));
+    }
+}
+
+static void testSequenceWrite(void)
+{
+    HoneywellByteSequence sequence;
+    HONEYWELL_CHECK(HoneywellParseByteSequence("[!,0x1b,0x77,!]", &sequence) == 0);
+    
+    const uint8_t values[] = { 0x31, 0x32 };
+    uint8_t out[HONEYWELL_PROFILE_SEQUENCE_CAPACITY];
+    const uint8_t expected[] = { 0x31, 0x1b, 0x77, 0x32 };
+    HONEYWELL_CHECK(HoneywellByteSequenceWrite(&sequence, values, out) == sizeof(expected));
+    HONEYWELL_CHECK(memcmp(out, expected, sizeof(expected)) == 0);
+    
+    /* the sequence keeps 0 in its placeholders, writing does not fill them in */
+    HONEYWELL_CHECK(sequence.bytes[0] == 0 && sequence.bytes[3] == 0);
+}
+
+static void testNames(void)
+{
+    HONEYWELL_CHECK(HoneywellProfileSequenceNamed("BoldOff") == HONEYWELL_SEQUENCE_BOLD_OFF);
+    HONEYWELL_CHECK(HoneywellProfileSequenceNamed("boldoff") == -1);
+    HONEYWELL_CHECK(HoneywellProfileSettingNamed("BtconnectRetryDelay") == HONEYWELL_SETTING_BT_CONNECT_RETRY_DELAY);
+    HONEYWELL_CHECK(HoneywellProfileSettingNamed("BtConnectRetryDelay") == -1);
+    HONEYWELL_CHECK(HoneywellProfileFlagNamed("ValidateAttribOnNewLn") == HONEYWELL_FLAG_VALIDATE_ATTRIB_ON_NEW_LINE);
+    HONEYWELL_CHECK(HoneywellProfileFlagNamed("") == -1);
+}
+
+#pragma mark - binary cache
+
+#define PROFILE_COUNT 3
+#define SOURCE_HASH 0x0123456789abcdefull
+
+/* the cache header is magic, version, profile size, count, reserved and
+   the source hash, 24 bytes */
+#define HEADER_SIZE 24
+
+static void makeProfiles(HoneywellPrinterProfile * profiles)
+{
+    static const char * const printerIDs[PROFILE_COUNT] = { "PR3", "PB51", "PR2" };
+    
+    memset(profiles, 0, PROFILE_COUNT * sizeof(HoneywellPrinterProfile));
+    for (int i = 0; i < PROFILE_COUNT; i++) {
+        strcpy(profiles[i].printerID, printerIDs[i]);
+        snprintf(profiles[i].displayName, sizeof(profiles[i].displayName), "Honeywell %s", printerIDs[i]);
+        profiles[i].backend = HONEYWELL_BACKEND_LINE_PRINTER;
+        profiles[i].flags = 1u << HONEYWELL_FLAG_BOLD_IS_FONT;
+        profiles[i].settings[HONEYWELL_SETTING_PRINT_HEAD_WIDTH] = 384 + i;
+        HONEYWELL_CHECK(HoneywellParseByteSequence("[0x1b,0x77,!]", &profiles[i].sequences[HONEYWELL_SEQUENCE_BOLD_OFF]) == 0);
+    }
+    HoneywellProfileSort(profiles, PROFILE_COUNT);
+}
+
+/* malloc'ed copy of the cache with damage applied, malloc keeps it 8 byte aligned */
+static uint8_t * copyCache(const uint8_t * cache, size_t length)
+{
+    uint8_t * copy = malloc(length);
+    HONEYWELL_CHECK(copy != NULL);
+    if (copy != NULL) {
+        memcpy(copy, cache, length);
+    }
+    return copy;
+}
+
+static HoneywellPrinterProfile * profileInCopy(uint8_t * copy, int index)
+{
+    return (HoneywellPrinterProfile *)(copy + HEADER_SIZE) + index;
+}
+
+static void checkRejected(const uint8_t * copy, size_t length, const char * damage)
+{
+    uint32_t count = 0xffffffffu;
+    if (HoneywellProfileCacheProfiles(copy, length, SOURCE_HASH, &count) != NULL) {
+        fprintf(stderr, "cache with %s was accepted\n", damage);
+        HONEYWELL_CHECK(0);
+    }
+    HONEYWELL_CHECK(count == 0xffffffffu);
+}
+
+static void testCacheRoundTrip(void)
+{
+    HoneywellPrinterProfile profiles[PROFILE_COUNT];
+    makeProfiles(profiles);
+    HONEYWELL_CHECK(strcmp(profiles[0].printerID, "PB51") == 0 && strcmp(profiles[2].printerID, "PR3") == 0);
+    
+    size_t length = 0;
+    uint8_t * cache = HoneywellProfileCacheEncode(profiles, PROFILE_COUNT, SOURCE_HASH, &length);
+    HONEYWELL_CHECK(cache != NULL);
+    if (cache == NULL) {
+        return;
+    }
+    HONEYWELL_CHECK(length == HEADER_SIZE + sizeof(profiles));
+    
+    /* read in place, the same profiles come back and can be looked up */
+    uint32_t count = 0;
+    const HoneywellPrinterProfile * cached = HoneywellProfileCacheProfiles(cache, length, SOURCE_HASH, &count);
+    HONEYWELL_CHECK(cached == (const HoneywellPrinterProfile *)(cache + HEADER_SIZE));
+    HONEYWELL_CHECK(count == PROFILE_COUNT);
+    if (cached != NULL) {
+        HONEYWELL_CHECK(memcmp(cached, profiles, sizeof(profiles)) == 0);
+        const HoneywellPrinterProfile * found = HoneywellProfileFind(cached, count, "PR2");
+        HONEYWELL_CHECK(found != NULL && found->settings[HONEYWELL_SETTING_PRINT_HEAD_WIDTH] == 386);
+        HONEYWELL_CHECK(HoneywellProfileFind(cached, count, "PR4") == NULL);
+    }
+    
+    /* a cache of another JSON file, or cut short or run long */
+    HONEYWELL_CHECK(HoneywellProfileCacheProfiles(cache, length, SOURCE_HASH + 1, &count) == NULL);
+    HONEYWELL_CHECK(HoneywellProfileCacheProfiles(cache, length - 1, SOURCE_HASH, &count) == NULL);
+    HONEYWELL_CHECK(HoneywellProfileCacheProfiles(cache, HEADER_SIZE - 1, SOURCE_HASH, &count) == NULL);
+    HONEYWELL_CHECK(HoneywellProfileCacheProfiles(NULL, 0, SOURCE_HASH, &count) == NULL);
+    
+    uint8_t * longer = malloc(length + sizeof(HoneywellPrinterProfile));
+    if (longer != NULL) {
+        memcpy(longer, cache, length);
+        memset(longer + length, 0, sizeof(HoneywellPrinterProfile));
+        checkRejected(longer, length + sizeof(HoneywellPrinterProfile), "a trailing profile");
+        free(longer);
+    }
+    
+    /* magic, version, profile size, count and hash each break the header */
+    static const size_t headerOffsets[] = { 0, 4, 6, 8, 16 };
+    for (size_t i = 0; i < sizeof(headerOffsets) / sizeof(headerOffsets[0]); i++) {
+        uint8_t * copy = copyCache(cache, length);
+        if (copy != NULL) {
+            copy[headerOffsets[i]] ^= 0x01;
+            checkRejected(copy, length, "a damaged header");
+            free(copy);
+        }
+    }
+    
+    uint8_t * copy = copyCache(cache, length);
+    if (copy != NULL) {
+        memset(profileInCopy(copy, 1)->printerID, 'x', sizeof(profiles[1].printerID));
+        checkRejected(copy, length, "an unterminated printer ID");
+        free(copy);
+    }
+    copy = copyCache(cache, length);
+    if (copy != NULL) {
+        memset(profileInCopy(copy, 2)->labelSet, 'x', sizeof(profiles[2].labelSet));
+        checkRejected(copy, length, "an unterminated label set");
+        free(copy);
+    }
+    copy = copyCache(cache, length);
+    if (copy != NULL) {
+        profileInCopy(copy, 0)->sequences[HONEYWELL_SEQUENCE_BOLD_OFF].length = HONEYWELL_PROFILE_SEQUENCE_CAPACITY + 1;
+        checkRejected(copy, length, "a sequence longer than its bytes");
+        free(copy);
+    }
+    copy = copyCache(cache, length);
+    if (copy != NULL) {
+        profileInCopy(copy, 0)->sequences[HONEYWELL_SEQUENCE_BOLD_OFF].placeholderCount = HONEYWELL_PROFILE_PLACEHOLDER_CAPACITY + 1;
+        checkRejected(copy, length, "too many placeholders");
+        free(copy);
+    }
+    copy = copyCache(cache, length);
+    if (copy != NULL) {
+        profileInCopy(copy, 1)->sequences[HONEYWELL_SEQUENCE_BOLD_OFF].placeholders[0] = 3;
+        checkRejected(copy, length, "a placeholder past the sequence");
+        free(copy);
+    }
+    
+    /* lookups binary-search the profiles, they have to stay sorted and unique */
+    copy = copyCache(cache, length);
+    if (copy != NULL) {
+        HoneywellPrinterProfile first = *profileInCopy(copy, 0);
+        *profileInCopy(copy, 0) = *profileInCopy(copy, 1);
+        *profileInCopy(copy, 1) = first;
+        checkRejected(copy, length, "profiles out of order");
+        free(copy);
+    }
+    copy = copyCache(cache, length);
+    if (copy != NULL) {
+        *profileInCopy(copy, 1) = *profileInCopy(copy, 0);
+        checkRejected(copy, length, "a duplicate printer ID");
+        free(copy);
+    }
+    
+    free(cache);
+}
+
+static void testEmptyCache(void)
+{
+    size_t length = 0;
+    uint8_t * cache = HoneywellProfileCacheEncode(NULL, 0, SOURCE_HASH, &length);
+    HONEYWELL_CHECK(cache != NULL && length == HEADER_SIZE);
+    if (cache == NULL) {
+        return;
+    }
+    
+    uint32_t count = 1;
+    const HoneywellPrinterProfile * cached = HoneywellProfileCacheProfiles(cache, length, SOURCE_HASH, &count);
+    HONEYWELL_CHECK(cached != NULL && count == 0);
+    HONEYWELL_CHECK(HoneywellProfileFind(cached, count, "PR3") == NULL);
+    free(cache);
+}
+
+int main(void)
+{
+    testSequenceTable();
+    testSequenceCapacity();
+    testSequenceWrite();
+    testNames();
+    testCacheRoundTrip();
+    testEmptyCache();
+    
+    return HONEYWELL_TEST_RESULT;
+}
@@ -0,0 +1,243 @@
+//
+//  HoneywellResponseParserTests.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+/*
+
+ Feeds printer replies to HoneywellResponseParser through
+ HoneywellResponseParserAppend and checks the events. Every case of the
+ table is fed whole, split in two at every offset and a byte at a time, and
+ has to come out the same each way, as the socket may cut a reply anywhere.
+ Separate runs cover a line wrapping around the ring and lines too long
+ for it.
+
+ */
+
+#include "HoneywellResponseParser.h"
+#include "HoneywellTest.h"
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_EVENTS 8
+
+typedef struct {
+    HoneywellResponseType type;
+    long code;
+    long status;
+    const char * line;
+} ExpectedEvent;
+
+typedef struct {
+    const char * input;
+    ExpectedEvent events[MAX_EVENTS];
+    size_t eventCount;
+} ParserCase;
+
+static const ParserCase kCases[] = {
+    { "Ok\r\n", { { HONEYWELL_RESPONSE_OK, 0, 0, "Ok" } }, 1 },
+    { "ok\n", { { HONEYWELL_RESPONSE_OK, 0, 0, "ok" } }, 1 },
+    { "Ok\r", { { HONEYWELL_RESPONSE_OK, 0, 0, "Ok" } }, 1 },
+    { "Ok", { { 0 } }, 0 },
+    { "\r\n\n\r", { { 0 } }, 0 },
+    
+    { "Error 1019\r\n", { { HONEYWELL_RESPONSE_ERROR, 1019, 0, "Error 1019" } }, 1 },
+    { "Error 1031: Next label not found\r\n",
+        { { HONEYWELL_RESPONSE_ERROR, 1031, 0, "Error 1031: Next label not found" } }, 1 },
+    { "ERROR\n", { { HONEYWELL_RESPONSE_ERROR, 0, 0, "ERROR" } }, 1 },
+    { "Error 99999999999999999999999: overflow\n",
+        { { HONEYWELL_RESPONSE_ERROR, LONG_MAX, 0, "Error 99999999999999999999999: overflow" } }, 1 },
+    
+    { "0\r\n", { { HONEYWELL_RESPONSE_STATUS, 0, 0, "0" } }, 1 },
+    { "  4 \r\n", { { HONEYWELL_RESPONSE_STATUS, 4, 0, "  4 " } }, 1 },
+    { "-12\n", { { HONEYWELL_RESPONSE_STATUS, -12, 0, "-12" } }, 1 },
+    { "99999999999999999999999\n", { { HONEYWELL_RESPONSE_TEXT, 0, 0, "99999999999999999999999" } }, 1 },
+    
+    { "ACK 17 0\r\n", { { HONEYWELL_RESPONSE_ACK, 17, 0, "ACK 17 0" } }, 1 },
+    { "ack 18 4\n", { { HONEYWELL_RESPONSE_ACK, 18, 4, "ack 18 4" } }, 1 },
+    { "ACK 19\r", { { HONEYWELL_RESPONSE_ACK, 19, 0, "ACK 19" } }, 1 },
+    { "ACK 99999999999999999999999 0\n", { { HONEYWELL_RESPONSE_TEXT, 0, 0, "ACK 99999999999999999999999 0" } }, 1 },
+    { "ACK x 0\n", { { HONEYWELL_RESPONSE_TEXT, 0, 0, "ACK x 0" } }, 1 },
+    
+    { "Direct Protocol 8.70\r\n", { { HONEYWELL_RESPONSE_TEXT, 0, 0, "Direct Protocol 8.70" } }, 1 },
+    
+    /* replies run together, in any mix of line ends */
+    { "Ok\r\nACK 1 0\r\n\r\nError 1019\n4\rACK 2 0",
+        { { HONEYWELL_RESPONSE_OK, 0, 0, "Ok" },
+          { HONEYWELL_RESPONSE_ACK, 1, 0, "ACK 1 0" },
+          { HONEYWELL_RESPONSE_ERROR, 1019, 0, "Error 1019" },
+          { HONEYWELL_RESPONSE_STATUS, 4, 0, "4" } }, 4 },
+};
+
+typedef struct {
+    HoneywellResponseType type;
+    long code;
+    long status;
+    size_t length;
+    char line[HONEYWELL_RESPONSE_LINE_CAPACITY];
+} RecordedEvent;
+
+typedef struct {
+    RecordedEvent * events;
+    size_t capacity;
+    size_t count;
+} Recorder;
+
+static void recordEvent(void * context, const HoneywellResponseEvent * event)
+{
+    Recorder * recorder = context;
+    HONEYWELL_CHECK(event->line[event->length] == '\0');
+    HONEYWELL_CHECK(event->length < HONEYWELL_RESPONSE_LINE_CAPACITY);
+    if (recorder->count < recorder->capacity) {
+        RecordedEvent * recorded = &recorder->events[recorder->count];
+        recorded->type = event->type;
+        recorded->code = event->code;
+        recorded->status = event->status;
+        recorded->length = event->length;
+        memcpy(recorded->line, event->line, event->length + 1);
+    }
+    recorder->count++;
+}
+
+static void append(HoneywellResponseParser * parser, const char * text, size_t length)
+{
+    HoneywellResponseParserAppend(parser, (const uint8_t *)text, length);
+}
+
+static void checkEvents(const ParserCase * parserCase, const Recorder * recorder, size_t split)
+{
+    HONEYWELL_CHECK(recorder->count == parserCase->eventCount);
+    for (size_t i = 0; i < parserCase->eventCount && i < recorder->count; i++) {
+        const ExpectedEvent * expected = &parserCase->events[i];
+        const RecordedEvent * event = &recorder->events[i];
+        int matches = event->type == expected->type
+            && event->code == expected->code
+            && event->status == expected->status
+            && strcmp(event->line, expected->line) == 0;
+        if (!matches) {
+            fprintf(stderr, "\"%s\" split at %zu: event %zu is type %d code %ld status %ld \"%s\"\n",
+                    expected->line, split, i, (int)event->type, event->code, event->status, event->line);
+        }
+        HONEYWELL_CHECK(matches);
+    }
+}
+
+/* split 0 feeds the input whole, SIZE_MAX a byte at a time */
+static void runCase(const ParserCase * parserCase, size_t split)
+{
+    RecordedEvent events[MAX_EVENTS];
+    Recorder recorder = { events, MAX_EVENTS, 0 };
+    HoneywellResponseParser parser;
+    HoneywellResponseParserInit(&parser, recordEvent, &recorder);
+    
+    size_t length = strlen(parserCase->input);
+    if (split == SIZE_MAX) {
+        for (size_t i = 0; i < length; i++) {
+            append(&parser, parserCase->input + i, 1);
+        }
+    } else {
+        append(&parser, parserCase->input, split);
+        append(&parser, parserCase->input + split, length - split);
+    }
+    checkEvents(parserCase, &recorder, split);
+}
+
+static void testTable(void)
+{
+    for (size_t i = 0; i < sizeof(kCases) / sizeof(kCases[0]); i++) {
+        size_t length = strlen(kCases[i].input);
+        for (size_t split = 0; split <= length; split++) {
+            runCase(&kCases[i], split);
+        }
+        runCase(&kCases[i], SIZE_MAX);
+    }
+}
+
+/* thousands of acknowledgements go round the ring several times, lines cut by its end included */
+static void testRingWrap(void)
+{
+    enum { ACK_COUNT = 3000 };
+    Recorder recorder = { calloc(ACK_COUNT, sizeof(RecordedEvent)), ACK_COUNT, 0 };
+    HONEYWELL_CHECK(recorder.events != NULL);
+    if (recorder.events == NULL) {
+        return;
+    }
+    HoneywellResponseParser parser;
+    HoneywellResponseParserInit(&parser, recordEvent, &recorder);
+    
+    /* a partial line dropped by a reset is gone, the ring still wraps cleanly after it */
+    append(&parser, "ACK 9", 5);
+    HoneywellResponseParserReset(&parser);
+    
+    char line[32];
+    for (long id = 1; id <= ACK_COUNT; id++) {
+        int length = snprintf(line, sizeof(line), "ACK %ld %ld\r\n", id, id % 5);
+        /* reads of varying size, so where a read ends moves against the ring */
+        size_t cut = (size_t)(id % length);
+        append(&parser, line, cut);
+        append(&parser, line + cut, (size_t)length - cut);
+    }
+    
+    HONEYWELL_CHECK(parser.writeIndex > 4 * HONEYWELL_RESPONSE_RING_SIZE);
+    HONEYWELL_CHECK(recorder.count == ACK_COUNT);
+    for (size_t i = 0; i < ACK_COUNT && i < recorder.count; i++) {
+        HONEYWELL_CHECK(recorder.events[i].type == HONEYWELL_RESPONSE_ACK);
+        HONEYWELL_CHECK(recorder.events[i].code == (long)i + 1);
+        HONEYWELL_CHECK(recorder.events[i].status == (long)(i + 1) % 5);
+    }
+    free(recorder.events);
+}
+
+static int isRunOf(const RecordedEvent * event, char c, size_t length)
+{
+    if (event->type != HONEYWELL_RESPONSE_TEXT || event->length != length) {
+        return 0;
+    }
+    for (size_t i = 0; i < length; i++) {
+        if (event->line[i] != c) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* a line longer than the line capacity is cut to it, one longer than the
+   ring comes out in pieces, and the parser carries on with the next line */
+static void testOverlongLines(void)
+{
+    RecordedEvent events[MAX_EVENTS];
+    Recorder recorder = { events, MAX_EVENTS, 0 };
+    HoneywellResponseParser parser;
+    HoneywellResponseParserInit(&parser, recordEvent, &recorder);
+    size_t truncated = HONEYWELL_RESPONSE_LINE_CAPACITY - 1;
+    
+    static char longLine[HONEYWELL_RESPONSE_RING_SIZE + 1000];
+    memset(longLine, 'x', 1000);
+    append(&parser, longLine, 1000);
+    append(&parser, "\r\nOk\r\n", 6);
+    HONEYWELL_CHECK(recorder.count == 2);
+    HONEYWELL_CHECK(isRunOf(&events[0], 'x', truncated));
+    HONEYWELL_CHECK(events[1].type == HONEYWELL_RESPONSE_OK);
+    
+    recorder.count = 0;
+    memset(longLine, 'y', sizeof(longLine));
+    append(&parser, longLine, sizeof(longLine));
+    append(&parser, "\nACK 5 0\n", 9);
+    HONEYWELL_CHECK(recorder.count == 3);
+    HONEYWELL_CHECK(isRunOf(&events[0], 'y', truncated));
+    HONEYWELL_CHECK(isRunOf(&events[1], 'y', truncated));
+    HONEYWELL_CHECK(events[2].type == HONEYWELL_RESPONSE_ACK && events[2].code == 5);
+}
+
+int main(void)
+{
+    testTable();
+    testRingWrap();
+    testOverlongLines();
+    
+    return HONEYWELL_TEST_RESULT;
+}
@@ -0,0 +1,432 @@
+//
+//  HoneywellSimulatedPrinter.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+/* POSIX sockets and threads under -std=c11 on Linux */
+#define _POSIX_C_SOURCE 200809L
+
+#include "HoneywellSimulatedPrinter.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+#define LINE_CAPACITY 4096
+
+struct HoneywellSimulatedPrinter {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    int stopRequested;
+    
+    int listenFd;
+    int port;
+    int fd;
+    size_t connectionCount;
+    long status;
+    
+    /* drops are decided per executed line, a dropped connection is only
+       half closed until the client hangs up, so replies still arrive */
+    double dropProbability;
+    uint64_t dropState;
+    size_t dropCount;
+    int dropping;
+    
+    char line[LINE_CAPACITY];
+    size_t lineLength;
+    
+    /* the label being built, and whether the last one printed on this
+       connection still waits for its acknowledgement */
+    char content[sizeof(((HoneywellSimulatedLabel *)0)->content)];
+    int awaitsAcknowledgement;
+    
+    HoneywellSimulatedLabel * labels;
+    size_t labelCount;
+    size_t labelCapacity;
+};
+
+static void copyContent(char * destination, const char * source)
+{
+    size_t capacity = sizeof(((HoneywellSimulatedLabel *)0)->content);
+    size_t length = strlen(source);
+    if (length >= capacity) {
+        length = capacity - 1;
+    }
+    memcpy(destination, source, length);
+    destination[length] = '\0';
+}
+
+#pragma mark - printing
+
+static int printLabel(HoneywellSimulatedPrinter * printer, HoneywellSimulatedLabel * label)
+{
+    pthread_mutex_lock(&printer->lock);
+    if (printer->labelCount == printer->labelCapacity) {
+        size_t capacity = printer->labelCapacity > 0 ? printer->labelCapacity * 2 : 64;
+        HoneywellSimulatedLabel * labels = realloc(printer->labels, capacity * sizeof(HoneywellSimulatedLabel));
+        if (labels == NULL) {
+            pthread_mutex_unlock(&printer->lock);
+            return -1;
+        }
+        printer->labels = labels;
+        printer->labelCapacity = capacity;
+    }
+    printer->labels[printer->labelCount++] = *label;
+    pthread_mutex_unlock(&printer->lock);
+    return 0;
+}
+
+static void reply(HoneywellSimulatedPrinter * printer, const char * text)
+{
+    size_t length = strlen(text);
+    size_t offset = 0;
+    while (offset < length) {
+        ssize_t written = send(printer->fd, text + offset, length - offset, MSG_NOSIGNAL);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return;
+        }
+        offset += written;
+    }
+}
+
+static long currentStatus(HoneywellSimulatedPrinter * printer)
+{
+    pthread_mutex_lock(&printer->lock);
+    long status = printer->status;
+    pthread_mutex_unlock(&printer->lock);
+    return status;
+}
+
+static void feedLabel(HoneywellSimulatedPrinter * printer, unsigned copies)
+{
+    HoneywellSimulatedLabel label;
+    label.jobID = 0;
+    label.copies = copies;
+    copyContent(label.content, printer->content);
+    printer->content[0] = '\0';
+    
+    printer->awaitsAcknowledgement = (printLabel(printer, &label) == 0);
+}
+
+static void acknowledge(HoneywellSimulatedPrinter * printer, uint64_t jobID)
+{
+    if (printer->awaitsAcknowledgement) {
+        pthread_mutex_lock(&printer->lock);
+        if (printer->labelCount > 0) {
+            printer->labels[printer->labelCount - 1].jobID = jobID;
+        }
+        pthread_mutex_unlock(&printer->lock);
+        printer->awaitsAcknowledgement = 0;
+    }
+    
+    char text[64];
+    snprintf(text, sizeof(text), "ACK %llu %ld\r\n", (unsigned long long)jobID, currentStatus(printer));
+    reply(printer, text);
+}
+
+#pragma mark - statements
+
+/* line is the whole line the statement is part of */
+static void handleStatement(HoneywellSimulatedPrinter * printer, const char * line, const char * statement, size_t length)
+{
+    while (length > 0 && statement[0] == ' ') {
+        statement++;
+        length--;
+    }
+    while (length > 0 && statement[length - 1] == ' ') {
+        length--;
+    }
+    
+    if (length >= 2 && memcmp(statement, "PF", 2) == 0 && (length == 2 || statement[2] == ' ')) {
+        unsigned copies = (length > 2) ? (unsigned)strtoul(statement + 3, NULL, 10) : 1;
+        if (printer->content[0] == '\0') {
+            copyContent(printer->content, line);
+        }
+        feedLabel(printer, copies > 0 ? copies : 1);
+        return;
+    }
+    
+    static const char ackPrefix[] = "PRINT \"ACK ";
+    if (length > sizeof(ackPrefix) - 1 && memcmp(statement, ackPrefix, sizeof(ackPrefix) - 1) == 0) {
+        acknowledge(printer, strtoull(statement + sizeof(ackPrefix) - 1, NULL, 10));
+        return;
+    }
+    
+    static const char statusQuery[] = "PRINT PRSTAT";
+    if (length == sizeof(statusQuery) - 1 && memcmp(statement, statusQuery, length) == 0) {
+        char text[32];
+        snprintf(text, sizeof(text), "%ld\r\n", currentStatus(printer));
+        reply(printer, text);
+    }
+}
+
+static void handleLine(HoneywellSimulatedPrinter * printer, char * line, size_t length)
+{
+    if (length > 0 && line[length - 1] == '\r') {
+        line[--length] = '\0';
+    }
+    
+    /* a LAYOUT RUN record is the label, otherwise the line ending in PF is */
+    if (line[0] == '#') {
+        copyContent(printer->content, line);
+        return;
+    }
+    
+    int quoted = 0;
+    size_t start = 0;
+    for (size_t i = 0; i <= length; i++) {
+        if (i < length && line[i] == '"') {
+            quoted = !quoted;
+        }
+        if (i == length || (line[i] == ':' && !quoted)) {
+            handleStatement(printer, line, line + start, i - start);
+            start = i + 1;
+        }
+    }
+}
+
+static void forgetConnectionState(HoneywellSimulatedPrinter * printer)
+{
+    /* a label printed but not acknowledged stays printed, nameless */
+    printer->awaitsAcknowledgement = 0;
+    printer->content[0] = '\0';
+    printer->lineLength = 0;
+}
+
+static void dropConnection(HoneywellSimulatedPrinter * printer)
+{
+    if (printer->fd >= 0) {
+        close(printer->fd);
+        printer->fd = -1;
+    }
+    printer->dropping = 0;
+    forgetConnectionState(printer);
+}
+
+/* xorshift64, seeded by the test so a failing drop pattern can be rerun */
+static int shouldDrop(HoneywellSimulatedPrinter * printer)
+{
+    pthread_mutex_lock(&printer->lock);
+    int drop = 0;
+    if (printer->dropProbability > 0) {
+        uint64_t x = printer->dropState;
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        printer->dropState = x;
+        drop = (x % 1000000) < printer->dropProbability * 1000000;
+    }
+    if (drop) {
+        printer->dropCount++;
+    }
+    pthread_mutex_unlock(&printer->lock);
+    return drop;
+}
+
+/* sends FIN after the replies already written, the client sees them and then the hang up */
+static void hangUp(HoneywellSimulatedPrinter * printer)
+{
+    shutdown(printer->fd, SHUT_WR);
+    printer->dropping = 1;
+    forgetConnectionState(printer);
+}
+
+/* returns -1 once the connection is gone */
+static int readConnection(HoneywellSimulatedPrinter * printer)
+{
+    char buffer[4096];
+    ssize_t length = recv(printer->fd, buffer, sizeof(buffer), 0);
+    if (length < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return 0;
+    }
+    if (length <= 0) {
+        return -1;
+    }
+    
+    for (ssize_t i = 0; i < length && !printer->dropping; i++) {
+        if (buffer[i] == '\n') {
+            printer->line[printer->lineLength] = '\0';
+            handleLine(printer, printer->line, printer->lineLength);
+            printer->lineLength = 0;
+            if (shouldDrop(printer)) {
+                hangUp(printer);
+            }
+        } else if (printer->lineLength < LINE_CAPACITY - 1) {
+            printer->line[printer->lineLength++] = buffer[i];
+        }
+    }
+    return 0;
+}
+
+#pragma mark - thread
+
+static int isStopRequested(HoneywellSimulatedPrinter * printer)
+{
+    pthread_mutex_lock(&printer->lock);
+    int stop = printer->stopRequested;
+    pthread_mutex_unlock(&printer->lock);
+    return stop;
+}
+
+static void * runPrinter(void * argument)
+{
+    HoneywellSimulatedPrinter * printer = argument;
+    
+    while (!isStopRequested(printer)) {
+        
+        struct pollfd fds[2] = {
+            { printer->listenFd, POLLIN, 0 },
+            { printer->fd, POLLIN, 0 }
+        };
+        if (poll(fds, 2, 20) <= 0) {
+            continue;
+        }
+        
+        /* like the printer, a new connection takes over from the old one */
+        if (fds[0].revents & POLLIN) {
+            int fd = accept(printer->listenFd, NULL, NULL);
+            if (fd >= 0) {
+                dropConnection(printer);
+                printer->fd = fd;
+                pthread_mutex_lock(&printer->lock);
+                printer->connectionCount++;
+                pthread_mutex_unlock(&printer->lock);
+                continue;
+            }
+        }
+        
+        if (printer->fd >= 0 && (fds[1].revents & (POLLIN | POLLHUP | POLLERR)) && readConnection(printer) != 0) {
+            dropConnection(printer);
+        }
+    }
+    
+    dropConnection(printer);
+    return NULL;
+}
+
+HoneywellSimulatedPrinter * HoneywellSimulatedPrinterStart(void)
+{
+    HoneywellSimulatedPrinter * printer = calloc(1, sizeof(HoneywellSimulatedPrinter));
+    if (printer == NULL) {
+        return NULL;
+    }
+    pthread_mutex_init(&printer->lock, NULL);
+    printer->fd = -1;
+    
+    printer->listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addressLength = sizeof(address);
+    
+    if (printer->listenFd < 0
+        || bind(printer->listenFd, (struct sockaddr *)&address, sizeof(address)) != 0
+        || listen(printer->listenFd, 4) != 0
+        || getsockname(printer->listenFd, (struct sockaddr *)&address, &addressLength) != 0) {
+        if (printer->listenFd >= 0) {
+            close(printer->listenFd);
+        }
+        pthread_mutex_destroy(&printer->lock);
+        free(printer);
+        return NULL;
+    }
+    printer->port = ntohs(address.sin_port);
+    
+    if (pthread_create(&printer->thread, NULL, runPrinter, printer) != 0) {
+        close(printer->listenFd);
+        pthread_mutex_destroy(&printer->lock);
+        free(printer);
+        return NULL;
+    }
+    return printer;
+}
+
+void HoneywellSimulatedPrinterStop(HoneywellSimulatedPrinter * printer)
+{
+    if (printer == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&printer->lock);
+    printer->stopRequested = 1;
+    pthread_mutex_unlock(&printer->lock);
+    
+    pthread_join(printer->thread, NULL);
+    close(printer->listenFd);
+    pthread_mutex_destroy(&printer->lock);
+    free(printer->labels);
+    free(printer);
+}
+
+#pragma mark - state
+
+int HoneywellSimulatedPrinterPort(const HoneywellSimulatedPrinter * printer)
+{
+    return printer->port;
+}
+
+void HoneywellSimulatedPrinterSetStatus(HoneywellSimulatedPrinter * printer, long status)
+{
+    pthread_mutex_lock(&printer->lock);
+    printer->status = status;
+    pthread_mutex_unlock(&printer->lock);
+}
+
+void HoneywellSimulatedPrinterSetDropRate(HoneywellSimulatedPrinter * printer, double probability, uint64_t seed)
+{
+    pthread_mutex_lock(&printer->lock);
+    printer->dropProbability = probability;
+    printer->dropState = seed != 0 ? seed : 1;
+    pthread_mutex_unlock(&printer->lock);
+}
+
+size_t HoneywellSimulatedPrinterDropCount(HoneywellSimulatedPrinter * printer)
+{
+    pthread_mutex_lock(&printer->lock);
+    size_t count = printer->dropCount;
+    pthread_mutex_unlock(&printer->lock);
+    return count;
+}
+
+size_t HoneywellSimulatedPrinterLabelCount(HoneywellSimulatedPrinter * printer)
+{
+    pthread_mutex_lock(&printer->lock);
+    size_t count = printer->labelCount;
+    pthread_mutex_unlock(&printer->lock);
+    return count;
+}
+
+int HoneywellSimulatedPrinterLabelAt(HoneywellSimulatedPrinter * printer, size_t index, HoneywellSimulatedLabel * label)
+{
+    pthread_mutex_lock(&printer->lock);
+    int found = index < printer->labelCount;
+    if (found) {
+        *label = printer->labels[index];
+    }
+    pthread_mutex_unlock(&printer->lock);
+    return found ? 0 : -1;
+}
+
+size_t HoneywellSimulatedPrinterConnectionCount(HoneywellSimulatedPrinter * printer)
+{
+    pthread_mutex_lock(&printer->lock);
+    size_t count = printer->connectionCount;
+    pthread_mutex_unlock(&printer->lock);
+    return count;
+}
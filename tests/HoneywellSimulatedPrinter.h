@@ -0,0 +1,76 @@
+//
+//  HoneywellSimulatedPrinter.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#ifndef HoneywellSimulatedPrinter_h
+#define HoneywellSimulatedPrinter_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+
+ A stand-in for a PC42t on a loopback TCP port, run on its own thread, for
+ tests driving the print core end to end. It understands as much Direct
+ Protocol as the core sends:
+
+ - PF [n] feeds the label built up since the last one, with n copies.
+ - PRINT "ACK n ";PRSTAT echoes ACK n <status>, PRINT PRSTAT echoes the
+   status alone.
+ - Lines starting with # are LAYOUT RUN records, they become the label's
+   content, as do inline lines ending in PF.
+ - Everything else is accepted silently.
+
+ As on a PC42t a label prints when its PF is executed, the acknowledgement
+ that follows only names it after the fact.
+
+ Drops: with a drop rate set, the printer may hang up after any line it
+ executed, like a PC42t losing Wi-Fi. Replies already sent still arrive and
+ everything received after that line is discarded. A drop between a PF and
+ its acknowledgement leaves the label printed but never acknowledged, the
+ case a client can not tell from a label that never printed.
+
+ */
+
+typedef struct HoneywellSimulatedPrinter HoneywellSimulatedPrinter;
+
+typedef struct {
+    // the ACK id, 0 for a label printed without one or whose ACK was lost to a drop
+    uint64_t jobID;
+    unsigned copies;
+    // the record or inline label line, NUL terminated
+    char content[512];
+} HoneywellSimulatedLabel;
+
+// listens on a free loopback port, NULL on failure
+HoneywellSimulatedPrinter * HoneywellSimulatedPrinterStart(void);
+
+// closes every connection and frees the printer
+void HoneywellSimulatedPrinterStop(HoneywellSimulatedPrinter * printer);
+
+int HoneywellSimulatedPrinterPort(const HoneywellSimulatedPrinter * printer);
+
+// PRSTAT reported from now on, e.g. 4 while out of labels
+void HoneywellSimulatedPrinterSetStatus(HoneywellSimulatedPrinter * printer, long status);
+
+/* hangs up after each executed line with probability, 0 never does. seed
+   makes a run's drop pattern repeatable. */
+void HoneywellSimulatedPrinterSetDropRate(HoneywellSimulatedPrinter * printer, double probability, uint64_t seed);
+
+// connections hung up by the drop rate so far
+size_t HoneywellSimulatedPrinterDropCount(HoneywellSimulatedPrinter * printer);
+
+// labels printed so far, each with its copies, in print order
+size_t HoneywellSimulatedPrinterLabelCount(HoneywellSimulatedPrinter * printer);
+
+// copies label index out, returns -1 if there is no such label
+int HoneywellSimulatedPrinterLabelAt(HoneywellSimulatedPrinter * printer, size_t index, HoneywellSimulatedLabel * label);
+
+// connections accepted so far
+size_t HoneywellSimulatedPrinterConnectionCount(HoneywellSimulatedPrinter * printer);
+
+#endif /* HoneywellSimulatedPrinter_h */
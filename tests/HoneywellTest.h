@@ -0,0 +1,32 @@
+//
+//  HoneywellTest.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#ifndef HoneywellTest_h
+#define HoneywellTest_h
+
+#include <stdio.h>
+
+/*
+
+ Checks for the C tests. A failed check is reported and the test carries
+ on, main returns HONEYWELL_TEST_RESULT so ctest sees any failure.
+
+ */
+
+static int honeywellTestFailures;
+
+#define HONEYWELL_CHECK(condition) do { \
+        if (!(condition)) { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            honeywellTestFailures++; \
+        } \
+    } while (0)
+
+#define HONEYWELL_TEST_RESULT (honeywellTestFailures == 0 ? 0 : 1)
+
+#endif /* HoneywellTest_h */
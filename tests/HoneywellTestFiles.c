@@ -0,0 +1,50 @@
+//
+//  HoneywellTestFiles.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#include "HoneywellTestFiles.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+uint8_t * HoneywellTestReadFile(const char * path, size_t * length)
+{
+    FILE * file = fopen(path, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+    
+    size_t capacity = 4096;
+    size_t used = 0;
+    uint8_t * bytes = malloc(capacity);
+    while (bytes != NULL) {
+        used += fread(bytes + used, 1, capacity - used, file);
+        if (used < capacity) {
+            break;
+        }
+        uint8_t * grown = realloc(bytes, capacity * 2);
+        if (grown == NULL) {
+            free(bytes);
+            bytes = NULL;
+            break;
+        }
+        bytes = grown;
+        capacity *= 2;
+    }
+    fclose(file);
+    *length = used;
+    return bytes;
+}
+
+int HoneywellTestWriteFile(const char * path, const void * bytes, size_t length)
+{
+    FILE * file = fopen(path, "wb");
+    if (file == NULL) {
+        return -1;
+    }
+    size_t written = fwrite(bytes, 1, length, file);
+    return (fclose(file) == 0 && written == length) ? 0 : -1;
+}
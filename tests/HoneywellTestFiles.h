@@ -0,0 +1,21 @@
+//
+//  HoneywellTestFiles.h
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+#ifndef HoneywellTestFiles_h
+#define HoneywellTestFiles_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+// the whole file, caller frees it, NULL if it can not be read
+uint8_t * HoneywellTestReadFile(const char * path, size_t * length);
+
+// 0 or -1
+int HoneywellTestWriteFile(const char * path, const void * bytes, size_t length);
+
+#endif /* HoneywellTestFiles_h */
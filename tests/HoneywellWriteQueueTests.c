@@ -0,0 +1,188 @@
+//
+//  HoneywellWriteQueueTests.c
+//  honeywelllabeprinter
+//
+//  Created by pohyee on 17/10/2026.
+//  Copyright © 2026 ritebozz. All rights reserved.
+//
+
+/*
+
+ Drains a HoneywellWriteQueue into one end of a socket pair whose send
+ buffer is far smaller than what is queued, so every drain stops at a short
+ write. The other end must still read back every byte in order, and the
+ water mark handler must see each crossing exactly once, including the
+ low one when HoneywellWriteQueueRemoveAll empties the queue.
+
+ */
+
+/* POSIX sockets under -std=c11 on Linux */
+#define _POSIX_C_SOURCE 200809L
+
+#include "HoneywellWriteQueue.h"
+#include "HoneywellTest.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define HIGH_WATER_MARK (96 * 1024)
+#define LOW_WATER_MARK (32 * 1024)
+
+/* more than the socket pair buffers, in pieces of uneven size */
+#define PAYLOAD_LENGTH (400 * 1024)
+
+typedef struct {
+    int transitions[8];
+    size_t transitionCount;
+} TestHandler;
+
+static void recordWaterMark(void * context, int aboveHighWaterMark)
+{
+    TestHandler * handler = context;
+    if (handler->transitionCount < sizeof(handler->transitions) / sizeof(handler->transitions[0])) {
+        handler->transitions[handler->transitionCount] = aboveHighWaterMark;
+    }
+    handler->transitionCount++;
+}
+
+static uint8_t payloadByte(size_t offset)
+{
+    return (uint8_t)(offset * 31 + offset / 251);
+}
+
+static void enqueuePayload(HoneywellWriteQueue * queue, size_t start, size_t length)
+{
+    uint8_t piece[7001];
+    size_t offset = start;
+    while (offset < start + length) {
+        size_t pieceLength = 1 + (offset * 7) % sizeof(piece);
+        if (pieceLength > start + length - offset) {
+            pieceLength = start + length - offset;
+        }
+        for (size_t i = 0; i < pieceLength; i++) {
+            piece[i] = payloadByte(offset + i);
+        }
+        /* whole buffers are taken over, single writes copied, use both */
+        if (pieceLength % 2 == 0) {
+            HoneywellByteBuffer buffer = { 0 };
+            HONEYWELL_CHECK(HoneywellByteBufferAppend(&buffer, piece, pieceLength) == 0);
+            HONEYWELL_CHECK(HoneywellWriteQueueEnqueueBuffer(queue, &buffer) == 0);
+            HONEYWELL_CHECK(buffer.bytes == NULL && buffer.length == 0);
+        } else {
+            HONEYWELL_CHECK(HoneywellWriteQueueEnqueue(queue, piece, pieceLength) == 0);
+        }
+        offset += pieceLength;
+    }
+}
+
+/* reads what is there without blocking, checking it against the payload */
+static size_t readAvailable(int fd, size_t * received)
+{
+    uint8_t buffer[16 * 1024];
+    size_t total = 0;
+    for (;;) {
+        ssize_t length = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (length <= 0) {
+            break;
+        }
+        for (ssize_t i = 0; i < length; i++) {
+            if (buffer[i] != payloadByte(*received + i)) {
+                HONEYWELL_CHECK(buffer[i] == payloadByte(*received + i));
+                break;
+            }
+        }
+        *received += length;
+        total += length;
+    }
+    return total;
+}
+
+static void testShortWritesAndWaterMarks(void)
+{
+    int fds[2];
+    HONEYWELL_CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    int sendBufferSize = 4096;
+    setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &sendBufferSize, sizeof(sendBufferSize));
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+    
+    HoneywellWriteQueue * queue = HoneywellWriteQueueCreate();
+    HONEYWELL_CHECK(queue != NULL);
+    if (queue == NULL) {
+        return;
+    }
+    TestHandler handler = { { 0 }, 0 };
+    HoneywellWriteQueueSetWaterMarks(queue, HIGH_WATER_MARK, LOW_WATER_MARK, recordWaterMark, &handler);
+    
+    /* below the high water mark the handler stays quiet */
+    enqueuePayload(queue, 0, HIGH_WATER_MARK);
+    HONEYWELL_CHECK(handler.transitionCount == 0);
+    enqueuePayload(queue, HIGH_WATER_MARK, PAYLOAD_LENGTH - HIGH_WATER_MARK);
+    HONEYWELL_CHECK(handler.transitionCount == 1 && handler.transitions[0] == 1);
+    HONEYWELL_CHECK(HoneywellWriteQueueQueuedByteCount(queue) == PAYLOAD_LENGTH);
+    HONEYWELL_CHECK(HoneywellWriteQueueTotalBytesEnqueued(queue) == PAYLOAD_LENGTH);
+    
+    /* the first drain fills the socket and stops short */
+    long written = HoneywellWriteQueueDrainToSocket(queue, fds[0]);
+    HONEYWELL_CHECK(written > 0 && written < PAYLOAD_LENGTH);
+    HONEYWELL_CHECK(HoneywellWriteQueueQueuedByteCount(queue) == PAYLOAD_LENGTH - (size_t)written);
+    HONEYWELL_CHECK(HoneywellWriteQueueTotalBytesWritten(queue) == (uint64_t)written);
+    HONEYWELL_CHECK(HoneywellWriteQueueDrainToSocket(queue, fds[0]) == 0);
+    
+    /* each drain resumes where the last one stopped, the low crossing fires once */
+    size_t received = 0;
+    size_t drains = 1;
+    while (received < PAYLOAD_LENGTH) {
+        size_t length = readAvailable(fds[1], &received);
+        written = HoneywellWriteQueueDrainToSocket(queue, fds[0]);
+        HONEYWELL_CHECK(written >= 0);
+        if (length == 0 && written == 0) {
+            break;
+        }
+        drains++;
+        
+        size_t queued = HoneywellWriteQueueQueuedByteCount(queue);
+        HONEYWELL_CHECK(handler.transitionCount == (queued < LOW_WATER_MARK ? 2 : 1));
+    }
+    HONEYWELL_CHECK(received == PAYLOAD_LENGTH);
+    HONEYWELL_CHECK(drains > 2);
+    HONEYWELL_CHECK(HoneywellWriteQueueQueuedByteCount(queue) == 0);
+    HONEYWELL_CHECK(HoneywellWriteQueueTotalBytesWritten(queue) == PAYLOAD_LENGTH);
+    HONEYWELL_CHECK(handler.transitionCount == 2 && handler.transitions[1] == 0);
+    
+    /* a drop empties the queue above the high water mark, the producer is told */
+    enqueuePayload(queue, 0, HIGH_WATER_MARK + 1);
+    HONEYWELL_CHECK(handler.transitionCount == 3 && handler.transitions[2] == 1);
+    HoneywellWriteQueueRemoveAll(queue);
+    HONEYWELL_CHECK(handler.transitionCount == 4 && handler.transitions[3] == 0);
+    HONEYWELL_CHECK(HoneywellWriteQueueQueuedByteCount(queue) == 0);
+    HONEYWELL_CHECK(HoneywellWriteQueueTotalBytesEnqueued(queue) == PAYLOAD_LENGTH);
+    
+    /* emptying a queue below the high water mark is no crossing */
+    enqueuePayload(queue, 0, LOW_WATER_MARK);
+    HoneywellWriteQueueRemoveAll(queue);
+    HONEYWELL_CHECK(handler.transitionCount == 4);
+    
+    /* a socket the other end closed fails the drain */
+    close(fds[1]);
+    enqueuePayload(queue, 0, 100);
+    HONEYWELL_CHECK(HoneywellWriteQueueDrainToSocket(queue, fds[0]) == -1);
+    HONEYWELL_CHECK(errno == EPIPE);
+    HONEYWELL_CHECK(HoneywellWriteQueueQueuedByteCount(queue) == 100);
+    
+    HoneywellWriteQueueDestroy(queue);
+    HONEYWELL_CHECK(handler.transitionCount == 4);
+    close(fds[0]);
+}
+
+int main(void)
+{
+    signal(SIGPIPE, SIG_IGN);
+    
+    testShortWritesAndWaterMarks();
+    
+    return HONEYWELL_TEST_RESULT;
+}